@@ -323,8 +323,21 @@ enum sched_type {
     kmp_sch_static_balanced_chunked   = 45,   /**< static with chunk adjustment (e.g., simd) */
 #endif
 
+    /* accessible only through OMP_SCHEDULE environment variable */
+    kmp_sch_hier_dynamic_chunked      = 46,   /**< dynamic, iterations partitioned across NUMA domains */
+    kmp_sch_hier_guided_chunked       = 47,   /**< guided, iterations partitioned across NUMA domains */
+
+    /* also accessible through OMP_SCHEDULE (static_aligned) and KMP_SCHEDULE (static,aligned) */
+    kmp_sch_static_aligned            = 48,   /**< static balanced, thread boundaries rounded to a multiple of the chunk */
+
+    /* accessible only through OMP_SCHEDULE environment variable */
+    kmp_sch_sticky_dynamic_chunked    = 49,   /**< dynamic, chunks offered first to the threads that ran them last time */
+
+    /* used internally for the dynamic loops of a distribute construct under KMP_DIST_SCHEDULE=dynamic */
+    kmp_sch_dist_dynamic_chunked      = 50,   /**< dynamic within the team, blocks pulled by the teams of the league */
+
     /* accessible only through KMP_SCHEDULE environment variable */
-    kmp_sch_upper                     = 46,   /**< upper bound for unordered values */
+    kmp_sch_upper                     = 51,   /**< upper bound for unordered values */
 
     kmp_ord_lower                     = 64,   /**< lower bound for ordered values, must be power of 2 */
     kmp_ord_static_chunked            = 65,
@@ -502,6 +515,34 @@ enum _reduction_method {
 
 typedef int PACKED_REDUCTION_METHOD_T;
 
+// Typed reduction descriptors passed to __kmpc_reduce_typed*().
+// A descriptor has one item per reduction variable; item i describes the data
+// pointed to by ((void **)reduce_data)[i] as count elements of the given type
+// combined with the given operation.  When every item is recognized, the
+// barrier gather combines the data with the kernels in kmp_barrier.cpp instead
+// of calling the compiler-generated reduce_func.
+enum kmp_reduction_op {
+    kmp_red_op_none = 0,
+    kmp_red_op_sum,
+    kmp_red_op_prod,
+    kmp_red_op_min,
+    kmp_red_op_max
+};
+
+enum kmp_reduction_elem {
+    kmp_red_elem_none = 0,
+    kmp_red_elem_int32,
+    kmp_red_elem_int64,
+    kmp_red_elem_float32,
+    kmp_red_elem_float64
+};
+
+typedef struct kmp_reduction_item {
+    kmp_int32 op;     /* enum kmp_reduction_op */
+    kmp_int32 elem;   /* enum kmp_reduction_elem */
+    size_t    count;  /* number of elements */
+} kmp_reduction_item_t;
+
 /* -- end of fast reduction stuff ----------------------------------------- */
 
 /* ------------------------------------------------------------------------ */
@@ -722,6 +763,8 @@ extern int __kmp_affinity_respect_mask; /* Respect process' initial affinity mas
 extern char * __kmp_affinity_proclist; /* proc ID list */
 extern kmp_affin_mask_t *__kmp_affinity_masks;
 extern unsigned __kmp_affinity_num_masks;
+extern int *__kmp_affinity_place_package; /* package of every place, NULL if unknown */
+extern int __kmp_affinity_num_packages; /* packages of the machine, 0 if unknown */
 extern void __kmp_affinity_bind_thread(int which);
 
 extern kmp_affin_mask_t *__kmp_affin_fullMask;
@@ -871,6 +914,7 @@ extern int __kmp_place_num_threads_per_core;
 #define KMP_BLOCKTIME_MULTIPLIER     (1000)    /* number of blocktime units per second */
 #define KMP_MIN_BLOCKTIME            (0)
 #define KMP_MAX_BLOCKTIME            (INT_MAX) /* Must be this for "infinite" setting the work */
+#define KMP_MAX_TEAM_POOL            64        /* Teams parked in __kmp_team_pool beyond this are reaped */
 #define KMP_DEFAULT_BLOCKTIME        (200)     /*  __kmp_blocktime is in milliseconds  */
 
 #if KMP_USE_MONITOR
@@ -904,6 +948,8 @@ extern int __kmp_place_num_threads_per_core;
 #define KMP_MAX_CHUNK           (INT_MAX-1)
 #define KMP_DEFAULT_CHUNK       1
 
+#define KMP_DEFAULT_STATIC_ALIGN 8  /* iterations, when static_aligned is given no alignment */
+
 #define KMP_MIN_INIT_WAIT       1
 #define KMP_MAX_INIT_WAIT       (INT_MAX/2)
 #define KMP_DEFAULT_INIT_WAIT   2048U
@@ -913,6 +959,9 @@ extern int __kmp_place_num_threads_per_core;
 #define KMP_DEFAULT_NEXT_WAIT   1024U
 
 #define KMP_DFLT_DISP_NUM_BUFF  7
+#define KMP_DFLT_DOACROSS_WINDOW  (1 << 16)
+#define KMP_MAX_DOACROSS_WINDOW   (1 << 30)
+#define KMP_MAX_DISP_HIER_DOMAINS 32
 #define KMP_MAX_ORDERED         8
 
 #define KMP_MAX_FIELDS          32
@@ -1100,6 +1149,7 @@ typedef struct kmp_cpuinfo {
     int        stepping;     // CPUID(1).EAX[3:0] ( Stepping )
     int        sse2;         // 0 if SSE2 instructions are not supported, 1 otherwise.
     int        rtm;          // 0 if RTM instructions are not supported, 1 otherwise.
+    int        cx16;         // 0 if CMPXCHG16B instruction is not supported, 1 otherwise.
     int        cpu_stackoffset;
     int        apic_id;
     int        physical_id;
@@ -1533,6 +1583,16 @@ typedef struct dispatch_shared_info64 {
     kmp_int64   ordered_dummy[KMP_MAX_ORDERED-3]; // to retain the structure size after making ordered_iteration scalar
 } dispatch_shared_info64_t;
 
+struct kmp_auto_site;
+struct kmp_disp_hier_domain;
+struct kmp_disp_ordered_owner;
+
+/* dynamic distribute: block of the league the team works on and the next chunk in it */
+typedef struct kmp_dist_team {
+    volatile kmp_uint64           word;  // (block + 1) << 32 | next chunk of the block, 0 if no block yet
+    struct kmp_dist_league_slot  *slot;  // league counter of the loop
+} kmp_dist_team_t;
+
 typedef struct dispatch_shared_info {
     union shared_info {
         dispatch_shared_info32_t  s32;
@@ -1544,6 +1604,15 @@ typedef struct dispatch_shared_info {
     volatile kmp_uint32    *doacross_flags;    // shared array of iteration flags (0/1)
     kmp_int32               doacross_num_done; // count finished threads
 #endif
+    volatile kmp_int32      auto_sched;        // schedule(auto): candidate chosen for the loop + 1, 0 if none
+    struct kmp_auto_site   *auto_site;         // schedule(auto): history of the loop site
+    kmp_uint64              auto_start;        // schedule(auto): loop start time stamp
+    volatile kmp_uint64     auto_first_done;   // schedule(auto): time stamp of the first thread finishing
+    volatile kmp_uint32     hier_state;        // hierarchical and sticky schedules: 0 idle, 1 setting up, 2 ready
+    struct kmp_disp_hier_domain *hier_domains; // hierarchical schedules: per-domain counters, kept with the buffer
+    struct kmp_disp_ordered_owner *ordered_owners; // ordered dynamic loops: owners of the chunks in flight, kept with the buffer
+    struct kmp_sticky_site *sticky_site;       // sticky schedule: chunk owners of the loop site, NULL to run as dynamic
+    kmp_dist_team_t         dist;              // dynamic distribute: the team's block
 #if KMP_USE_HWLOC
     // When linking with libhwloc, the ORDERED EPCC test slows down on big
     // machines (> 48 cores). Performance analysis showed that a cache thrash
@@ -1578,6 +1647,16 @@ typedef struct kmp_disp {
     void* dummy_padding[2]; // make it 64 bytes on Intel(R) 64
 #endif
 #endif
+    /* KMP_LOOP_STATS: site of the dynamic loop the thread is in, with the start of the loop,
+       the time spent in the dispatcher so far and the chunks received */
+    void                    *th_loop_site;
+    kmp_uint64               th_loop_start;
+    kmp_uint64               th_loop_wait;
+    kmp_uint64               th_loop_chunks;
+    kmp_dist_team_t          th_dist;             /* dynamic distribute loops of a serialized team */
+    /* ordered loops: ticket (loop buffer index, iteration) handed over to the thread by the
+       thread finishing the previous iteration; on its own line, the thread spins on it */
+    KMP_ALIGN_CACHE volatile kmp_uint64 th_ordered_grant;
 #if KMP_USE_INTERNODE_ALIGNMENT
     char more_padding[INTERNODE_CACHE_LINE];
 #endif
@@ -1828,6 +1907,8 @@ typedef struct kmp_local {
 #endif
 
     PACKED_REDUCTION_METHOD_T packed_reduction_method; /* stored by __kmpc_reduce*(), used by __kmpc_end_reduce*() */
+    const kmp_reduction_item_t *reduce_desc;           /* set by __kmpc_reduce*_typed() for the barrier gather */
+    kmp_int32              reduce_num_vars;            /* number of items in reduce_desc */
 
 } kmp_local_t;
 
@@ -2213,6 +2294,8 @@ typedef struct KMP_ALIGN_CACHE kmp_base_info {
     microtask_t       th_teams_microtask; /* save entry address for teams construct */
     int               th_teams_level;     /* save initial level of teams construct */
                                           /* it is 0 on device but may be any on host */
+    struct kmp_dist_league *th_dist_league; /* dynamic distribute: block counters of the league the thread is a team master in */
+    kmp_uint32        th_dist_loops;      /* dynamic distribute: distribute loops started by the thread's team */
 #endif
 
     /* The blocktime info is copied from the team struct to the thread sruct */
@@ -2251,6 +2334,10 @@ typedef struct KMP_ALIGN_CACHE kmp_base_info {
     kmp_uint64              th_bar_min_time;              /* minimum arrival time at the barrier */
     kmp_uint64              th_frame_time;                /* frame timestamp */
 #endif /* USE_ITT_BUILD */
+#if KMP_STATS_ENABLED
+    kmp_int64               th_stats_bar_arrive;          /* tick count at arrival to the last team barrier */
+    kmp_int64               th_stats_bar_depart;          /* tick count at departure from the last team barrier */
+#endif
     kmp_local_t             th_local;
     struct private_common  *th_pri_head;
 
@@ -2270,6 +2357,16 @@ typedef struct KMP_ALIGN_CACHE kmp_base_info {
 
     volatile kmp_uint32     th_spin_here;   /* thread-local location for spinning */
                                             /* while awaiting queuing lock acquire */
+#if KMP_USE_DYNAMIC_LOCK && KMP_USE_TSX
+    void                   *th_spec_site;   /* construct of the speculating critical section */
+#endif
+#if KMP_USE_DYNAMIC_LOCK
+    kmp_indirect_lock_t    *th_i_lock_pool[KMP_NUM_I_LOCKS]; /* indirect locks destroyed by the thread */
+    kmp_uint32              th_i_lock_pool_size[KMP_NUM_I_LOCKS];
+    kmp_lock_index_t        th_i_lock_next; /* lock table entries reserved by the thread, */
+    kmp_lock_index_t        th_i_lock_end;  /* [next, end) */
+    kmp_lock_profile_held_t th_lock_held[KMP_LOCK_PROFILE_HELD]; /* locks held, for KMP_LOCK_PROFILE */
+#endif
 
     volatile void          *th_sleep_loc;   // this points at a kmp_flag<T>
 
@@ -2383,6 +2480,10 @@ typedef struct KMP_ALIGN_CACHE kmp_base_team {
     ident_t                 *t_ident;        // if volatile, have to change too much other crud to volatile too
     kmp_team_p              *t_parent;       // parent team
     kmp_team_p              *t_next_pool;    // next free team in the team pool
+    kmp_team_p              *t_pool_parent;  // parent team of the last use, kept while in the team pool
+    int                      t_pool_level;   // nesting level of the last use, kept while in the team pool
+    kmp_info_p              *t_pool_master;  // master thread of the last use, kept while in the team pool
+    int                      t_pool_nth;     // threads (master included) still attached while in the team pool, 0 if none
     kmp_disp_t              *t_dispatch;     // thread's dispatch data
     kmp_task_team_t         *t_task_team[2]; // Task team struct; switch between 2
 #if OMP_40_ENABLED
@@ -2391,6 +2492,12 @@ typedef struct KMP_ALIGN_CACHE kmp_base_team {
 #if USE_ITT_BUILD
     kmp_uint64               t_region_time;  // region begin timestamp
 #endif /* USE_ITT_BUILD */
+#if KMP_STATS_ENABLED
+    int                      t_stats_bar_pending;     // last barrier waits for its release latency to be recorded
+    ident_t                 *t_stats_bar_loc;         // its source location
+    kmp_int64                t_stats_bar_skew;        // its arrival skew
+    kmp_int64                t_stats_bar_last_arrive; // its last arrival tick count
+#endif
 
     // Master write, workers read --------------------------------------------------------------------------
     KMP_ALIGN_CACHE void   **t_argv;
@@ -2714,6 +2821,15 @@ extern kmp_uint32 __kmp_init_mxcsr;      /* init thread's mxscr */
 
 extern int        __kmp_dflt_max_active_levels; /* max_active_levels for nested parallelism enabled by default a la OMP_MAX_ACTIVE_LEVELS */
 extern int        __kmp_dispatch_num_buffers; /* max possible dynamic loops in concurrent execution per team */
+extern int        __kmp_auto_adaptive;  /* schedule(auto) learns the schedule of each loop from its previous executions */
+extern int        __kmp_dispatch_hier_domains; /* domains of the hierarchical schedules, 0 - NUMA domains from the topology */
+extern int        __kmp_doacross_window; /* min iterations tracked by the doacross window, 0 - one flag per iteration */
+extern int        __kmp_loop_stats;     /* record per loop site dispatch statistics, reported at exit */
+extern int        __kmp_dispatch_fast_path; /* hand out the chunks of unordered dynamic and guided loops inline */
+#if OMP_40_ENABLED
+extern int        __kmp_dist_dynamic;   /* teams of a league pull the blocks of dynamic distribute loops from a shared counter */
+extern int        __kmp_dist_block;     /* iterations per block of the dynamic distribute loops, 0 - chosen from the trip count */
+#endif
 #if KMP_NESTED_HOT_TEAMS
 extern int        __kmp_hot_teams_mode;
 extern int        __kmp_hot_teams_max_level;
@@ -2773,6 +2889,8 @@ extern int __kmp_omp_cancellation;      /* TRUE or FALSE */
 extern          kmp_info_t **__kmp_threads;      /* Descriptors for the threads */
 /* read/write: lock */
 extern volatile kmp_team_t  *     __kmp_team_pool;
+extern int                        __kmp_team_pool_nteams; /* number of teams parked in __kmp_team_pool */
+extern int                        __kmp_team_pool_nth;    /* worker threads kept by the teams in __kmp_team_pool */
 extern volatile kmp_info_t  *     __kmp_thread_pool;
 
 /* total number of threads reachable from some root thread including all root threads*/
@@ -2879,6 +2997,8 @@ extern unsigned short __kmp_get_random( kmp_info_t * thread );
 extern void __kmp_init_random( kmp_info_t * thread );
 
 extern kmp_r_sched_t __kmp_get_schedule_global( void );
+extern kmp_uint64 __kmp_static_aligned_bound( kmp_uint64 trip_count, kmp_uint32 nth, kmp_uint32 tid,
+                                              kmp_uint64 align, kmp_uint64 offset );
 extern void __kmp_adjust_num_threads( int new_nproc );
 
 extern void * ___kmp_allocate( size_t size KMP_SRC_LOC_DECL );
@@ -3131,6 +3251,32 @@ KMP_EXPORT void  kmpc_free( void *ptr );
 extern int  __kmp_barrier( enum barrier_type bt, int gtid, int is_split,
                            size_t reduce_size, void *reduce_data, void (*reduce)(void *, void *) );
 extern void __kmp_end_split_barrier ( enum barrier_type bt, int gtid );
+extern void __kmp_barrier_arrive( enum barrier_type bt, int gtid );
+extern void __kmp_barrier_wait( enum barrier_type bt, int gtid );
+
+/* Reusable barrier for a fixed number of threads, behind kmp_named_barrier_t */
+typedef struct KMP_ALIGN_CACHE kmp_user_barrier_waiter {
+    volatile kmp_uint32 go;           /* bumped when the phases that use the slot complete */
+    kmp_uint32          checker;      /* value of go that releases the current waiter */
+    kmp_info_p         *thr;          /* current waiter, to wake it up if it sleeps */
+} kmp_user_barrier_waiter_t;
+
+typedef struct kmp_user_barrier {
+    volatile kmp_uint64        ub_arrived; /* arrivals since the initialization */
+    kmp_int32                  ub_count;   /* number of participating threads */
+    kmp_user_barrier_waiter_t *ub_waiters; /* two banks of ub_count waiter slots */
+} kmp_user_barrier_t;
+
+extern void       __kmp_init_named_barrier( kmp_user_barrier_t *bar, int count );
+extern void       __kmp_destroy_named_barrier( kmp_user_barrier_t *bar );
+extern kmp_uint32 __kmp_named_barrier_arrive( kmp_user_barrier_t *bar );
+extern void       __kmp_named_barrier_wait( kmp_user_barrier_t *bar, kmp_uint32 slot );
+extern int  __kmp_reduction_desc_supported( const kmp_reduction_item_t *desc, kmp_int32 num_vars );
+extern void __kmp_reduce_typed_combine( const kmp_reduction_item_t *desc, kmp_int32 num_vars,
+                                        void *lhs_data, void *rhs_data );
+extern void __kmp_reduce_typed_slice( const kmp_reduction_item_t *item, void *lhs, void *rhs,
+                                      size_t first, size_t count );
+extern size_t __kmp_reduction_elem_size( kmp_int32 elem );
 
 /*!
  * Tell the fork call which compiler generated the fork call, and therefore how to deal with the call.
@@ -3236,6 +3382,20 @@ extern void __kmp_tasking_barrier( kmp_team_t *team, kmp_info_t *thread, int gti
 extern int  __kmp_is_address_mapped( void *addr );
 extern kmp_uint64 __kmp_hardware_timestamp(void);
 
+extern void __kmp_dispatch_auto_print( FILE *out );
+extern void __kmp_dispatch_loop_stats_print( FILE *out );
+#if KMP_USE_DYNAMIC_LOCK
+extern void __kmp_lock_profile_print( FILE *out );
+extern void __kmp_lock_profile_reset( void );
+extern void __kmp_reap_indirect_locks( kmp_info_t *th );
+# if KMP_USE_TSX
+extern void __kmp_critical_speculation_print( FILE *out );
+# endif
+#endif
+#if OMP_40_ENABLED
+extern struct kmp_dist_league *__kmp_dist_league_allocate( void );
+#endif
+
 #if KMP_OS_UNIX
 extern int  __kmp_read_from_file( char const *path, char const *format, ... );
 #endif
@@ -3289,6 +3449,8 @@ KMP_EXPORT void   __kmpc_end_serialized_parallel ( ident_t *, kmp_int32 global_t
 
 KMP_EXPORT void   __kmpc_flush              ( ident_t *);
 KMP_EXPORT void   __kmpc_barrier            ( ident_t *, kmp_int32 global_tid );
+KMP_EXPORT void   __kmpc_barrier_arrive     ( ident_t *, kmp_int32 global_tid );
+KMP_EXPORT void   __kmpc_barrier_wait       ( ident_t *, kmp_int32 global_tid );
 KMP_EXPORT kmp_int32  __kmpc_master         ( ident_t *, kmp_int32 global_tid );
 KMP_EXPORT void   __kmpc_end_master         ( ident_t *, kmp_int32 global_tid );
 KMP_EXPORT void   __kmpc_ordered            ( ident_t *, kmp_int32 global_tid );
@@ -3299,6 +3461,8 @@ KMP_EXPORT void   __kmpc_end_critical       ( ident_t *, kmp_int32 global_tid, k
 #if OMP_45_ENABLED
 KMP_EXPORT void   __kmpc_critical_with_hint ( ident_t *, kmp_int32 global_tid, kmp_critical_name *, uintptr_t hint );
 #endif
+KMP_EXPORT void   __kmpc_critical_combine   ( ident_t *, kmp_int32 global_tid, kmp_critical_name *, uintptr_t hint,
+                                              void (*body)( void * ), void * data );
 
 KMP_EXPORT kmp_int32  __kmpc_barrier_master ( ident_t *, kmp_int32 global_tid );
 KMP_EXPORT void   __kmpc_end_barrier_master ( ident_t *, kmp_int32 global_tid );
@@ -3313,6 +3477,15 @@ KMP_EXPORT void KMPC_FOR_STATIC_INIT    ( ident_t *loc, kmp_int32 global_tid, km
 
 KMP_EXPORT void __kmpc_for_static_fini  ( ident_t *loc, kmp_int32 global_tid );
 
+/* dispatch statistics of the dynamic loop sites (KMP_LOOP_STATS), for tools */
+KMP_EXPORT void       __kmpc_set_loop_stats   ( kmp_int32 enable );
+KMP_EXPORT kmp_int32  __kmpc_loop_stats_sites ( void );
+KMP_EXPORT ident_t *  __kmpc_loop_stats_site  ( kmp_int32 index, kmp_int32 *schedule, kmp_uint64 *runs,
+                                                kmp_uint64 *iterations );
+KMP_EXPORT kmp_uint64 __kmpc_loop_stats_thread( kmp_int32 index, kmp_int32 tid, kmp_uint64 *chunks,
+                                                kmp_uint64 *busy, kmp_uint64 *wait );
+KMP_EXPORT void       __kmpc_loop_stats_reset ( void );
+
 KMP_EXPORT void __kmpc_copyprivate( ident_t *loc, kmp_int32 global_tid, size_t cpy_size, void *cpy_data, void(*cpy_func)(void*,void*), kmp_int32 didit );
 
 extern void KMPC_SET_NUM_THREADS        ( int arg );
@@ -3420,6 +3593,23 @@ KMP_EXPORT void __kmpc_init_lock_with_hint( ident_t *loc, kmp_int32 gtid, void *
 KMP_EXPORT void __kmpc_init_nest_lock_with_hint( ident_t *loc, kmp_int32 gtid, void **user_lock, uintptr_t hint );
 #endif
 
+#if KMP_USE_DYNAMIC_LOCK
+KMP_EXPORT void __kmpc_rw_lock_init( ident_t *loc, kmp_int32 gtid, void **user_lock );
+KMP_EXPORT void __kmpc_rw_lock_destroy( ident_t *loc, kmp_int32 gtid, void **user_lock );
+KMP_EXPORT void __kmpc_rw_lock_rdlock( ident_t *loc, kmp_int32 gtid, void **user_lock );
+KMP_EXPORT void __kmpc_rw_lock_wrlock( ident_t *loc, kmp_int32 gtid, void **user_lock );
+KMP_EXPORT void __kmpc_rw_lock_unlock( ident_t *loc, kmp_int32 gtid, void **user_lock );
+KMP_EXPORT int __kmpc_rw_lock_tryrdlock( ident_t *loc, kmp_int32 gtid, void **user_lock );
+KMP_EXPORT int __kmpc_rw_lock_trywrlock( ident_t *loc, kmp_int32 gtid, void **user_lock );
+
+/* lock profile (KMP_LOCK_PROFILE) */
+KMP_EXPORT void __kmpc_lock_profile_report( void );
+KMP_EXPORT void __kmpc_lock_profile_reset( void );
+
+/* per-construct speculation of critical sections (KMP_CRITICAL_SPECULATION) */
+KMP_EXPORT void __kmpc_critical_speculation_report( void );
+#endif
+
 /* ------------------------------------------------------------------------ */
 
 /*
@@ -3445,6 +3635,26 @@ KMP_EXPORT kmp_int32 __kmpc_reduce_nowait41( ident_t *loc, kmp_int32 global_tid,
                                            kmp_int32 num_vars, size_t reduce_size,
                                            void *reduce_data, void *reduce_array_size, void (*reduce_func)(void *lhs_data, void *rhs_data),
                                            kmp_critical_name *lck );
+KMP_EXPORT kmp_int32 __kmpc_reduce_typed( ident_t *loc, kmp_int32 global_tid,
+                                    kmp_int32 num_vars, size_t reduce_size,
+                                    void *reduce_data, const kmp_reduction_item_t *reduce_desc,
+                                    void (*reduce_func)(void *lhs_data, void *rhs_data),
+                                    kmp_critical_name *lck );
+KMP_EXPORT kmp_int32 __kmpc_reduce_nowait_typed( ident_t *loc, kmp_int32 global_tid,
+                                           kmp_int32 num_vars, size_t reduce_size,
+                                           void *reduce_data, const kmp_reduction_item_t *reduce_desc,
+                                           void (*reduce_func)(void *lhs_data, void *rhs_data),
+                                           kmp_critical_name *lck );
+KMP_EXPORT kmp_int32 __kmpc_reduce_array( ident_t *loc, kmp_int32 global_tid,
+                                    kmp_int32 num_vars, size_t reduce_size,
+                                    void *reduce_data, const kmp_reduction_item_t *reduce_desc,
+                                    void (*reduce_func)(void *lhs_data, void *rhs_data),
+                                    kmp_critical_name *lck );
+KMP_EXPORT kmp_int32 __kmpc_reduce_nowait_array( ident_t *loc, kmp_int32 global_tid,
+                                           kmp_int32 num_vars, size_t reduce_size,
+                                           void *reduce_data, const kmp_reduction_item_t *reduce_desc,
+                                           void (*reduce_func)(void *lhs_data, void *rhs_data),
+                                           kmp_critical_name *lck );
 /*
  * internal fast reduction routines
  */
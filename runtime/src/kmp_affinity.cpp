@@ -4151,6 +4151,26 @@ __kmp_aux_affinity_initialize(void)
         KMP_ASSERT2(0, "Unexpected affinity setting");
     }
 
+    //
+    // Remember the package of every place, the hierarchical loop schedules
+    // partition the iterations by package.
+    //
+    __kmp_affinity_place_package = (int *)__kmp_allocate(sizeof(int)
+      * __kmp_affinity_num_masks);
+    {
+        unsigned i;
+        int j;
+        for (i = 0; i < __kmp_affinity_num_masks; i++) {
+            kmp_affin_mask_t *mask = KMP_CPU_INDEX(__kmp_affinity_masks, i);
+            for (j = 0; j < __kmp_avail_proc; j++) {
+                if (KMP_CPU_ISSET(address2os[j].second, mask)) {
+                    __kmp_affinity_place_package[i] = address2os[j].first.childNums[0];
+                    break;
+                }
+            }
+        }
+    }
+
     KMP_CPU_FREE_ARRAY(osId2Mask, maxIndex+1);
     machine_hierarchy.init(address2os, __kmp_avail_proc);
 }
@@ -4182,6 +4202,8 @@ __kmp_affinity_initialize(void)
     if (disabled) {
         __kmp_affinity_type = affinity_disabled;
     }
+    // The topology is known even when the threads are not bound
+    __kmp_affinity_num_packages = nPackages;
 }
 
 
@@ -4196,6 +4218,11 @@ __kmp_affinity_uninitialize(void)
         KMP_CPU_FREE(__kmp_affin_fullMask);
         __kmp_affin_fullMask = NULL;
     }
+    if (__kmp_affinity_place_package != NULL) {
+        __kmp_free(__kmp_affinity_place_package);
+        __kmp_affinity_place_package = NULL;
+    }
+    __kmp_affinity_num_packages = 0;
     __kmp_affinity_num_masks = 0;
 # if OMP_40_ENABLED
     __kmp_affinity_num_places = 0;
@@ -561,18 +561,7 @@ int __kmp_atomic_mode = 2;      // GOMP compatibility
 KMP_ALIGN(128)
 
 kmp_atomic_lock_t __kmp_atomic_lock;     /* Control access to all user coded atomics in Gnu compat mode   */
-kmp_atomic_lock_t __kmp_atomic_lock_1i;  /* Control access to all user coded atomics for 1-byte fixed data types */
-kmp_atomic_lock_t __kmp_atomic_lock_2i;  /* Control access to all user coded atomics for 2-byte fixed data types */
-kmp_atomic_lock_t __kmp_atomic_lock_4i;  /* Control access to all user coded atomics for 4-byte fixed data types */
-kmp_atomic_lock_t __kmp_atomic_lock_4r;  /* Control access to all user coded atomics for kmp_real32 data type    */
-kmp_atomic_lock_t __kmp_atomic_lock_8i;  /* Control access to all user coded atomics for 8-byte fixed data types */
-kmp_atomic_lock_t __kmp_atomic_lock_8r;  /* Control access to all user coded atomics for kmp_real64 data type    */
-kmp_atomic_lock_t __kmp_atomic_lock_8c;  /* Control access to all user coded atomics for complex byte data type  */
-kmp_atomic_lock_t __kmp_atomic_lock_10r; /* Control access to all user coded atomics for long double data type   */
-kmp_atomic_lock_t __kmp_atomic_lock_16r; /* Control access to all user coded atomics for _Quad data type         */
-kmp_atomic_lock_t __kmp_atomic_lock_16c; /* Control access to all user coded atomics for double complex data type*/
-kmp_atomic_lock_t __kmp_atomic_lock_20c; /* Control access to all user coded atomics for long double complex type*/
-kmp_atomic_lock_t __kmp_atomic_lock_32c; /* Control access to all user coded atomics for _Quad complex data type */
+kmp_atomic_lock_t __kmp_atomic_lock_table[ KMP_ATOMIC_LOCK_TABLE_SIZE ]; /* All other user coded atomics, by target address */
 
 
 /*
@@ -637,20 +626,21 @@ RET_TYPE __kmpc_atomic_##TYPE_ID##_##OP_ID( ident_t *id_ref, int gtid, TYPE * lh
     KA_TRACE(100,("__kmpc_atomic_" #TYPE_ID "_" #OP_ID ": T#%d\n", gtid ));
 
 // ------------------------------------------------------------------------
-// Lock variables used for critical sections for various size operands
-#define ATOMIC_LOCK0   __kmp_atomic_lock       // all types, for Gnu compat
-#define ATOMIC_LOCK1i  __kmp_atomic_lock_1i    // char
-#define ATOMIC_LOCK2i  __kmp_atomic_lock_2i    // short
-#define ATOMIC_LOCK4i  __kmp_atomic_lock_4i    // long int
-#define ATOMIC_LOCK4r  __kmp_atomic_lock_4r    // float
-#define ATOMIC_LOCK8i  __kmp_atomic_lock_8i    // long long int
-#define ATOMIC_LOCK8r  __kmp_atomic_lock_8r    // double
-#define ATOMIC_LOCK8c  __kmp_atomic_lock_8c    // float complex
-#define ATOMIC_LOCK10r __kmp_atomic_lock_10r   // long double
-#define ATOMIC_LOCK16r __kmp_atomic_lock_16r   // _Quad
-#define ATOMIC_LOCK16c __kmp_atomic_lock_16c   // double complex
-#define ATOMIC_LOCK20c __kmp_atomic_lock_20c   // long double complex
-#define ATOMIC_LOCK32c __kmp_atomic_lock_32c   // _Quad complex
+// Lock variables used for critical sections for various size operands;
+// ADDR is the target of the operation
+#define ATOMIC_LOCK0(ADDR)   (& __kmp_atomic_lock)          // all types, for Gnu compat
+#define ATOMIC_LOCK1i(ADDR)  __kmp_get_atomic_lock( ADDR )  // char
+#define ATOMIC_LOCK2i(ADDR)  __kmp_get_atomic_lock( ADDR )  // short
+#define ATOMIC_LOCK4i(ADDR)  __kmp_get_atomic_lock( ADDR )  // long int
+#define ATOMIC_LOCK4r(ADDR)  __kmp_get_atomic_lock( ADDR )  // float
+#define ATOMIC_LOCK8i(ADDR)  __kmp_get_atomic_lock( ADDR )  // long long int
+#define ATOMIC_LOCK8r(ADDR)  __kmp_get_atomic_lock( ADDR )  // double
+#define ATOMIC_LOCK8c(ADDR)  __kmp_get_atomic_lock( ADDR )  // float complex
+#define ATOMIC_LOCK10r(ADDR) __kmp_get_atomic_lock( ADDR )  // long double
+#define ATOMIC_LOCK16r(ADDR) __kmp_get_atomic_lock( ADDR )  // _Quad
+#define ATOMIC_LOCK16c(ADDR) __kmp_get_atomic_lock( ADDR )  // double complex
+#define ATOMIC_LOCK20c(ADDR) __kmp_get_atomic_lock( ADDR )  // long double complex
+#define ATOMIC_LOCK32c(ADDR) __kmp_get_atomic_lock( ADDR )  // _Quad complex
 
 // ------------------------------------------------------------------------
 // Operation on *lhs, rhs bound by critical section
@@ -659,11 +649,11 @@ RET_TYPE __kmpc_atomic_##TYPE_ID##_##OP_ID( ident_t *id_ref, int gtid, TYPE * lh
 // Note: don't check gtid as it should always be valid
 // 1, 2-byte - expect valid parameter, other - check before this macro
 #define OP_CRITICAL(OP,LCK_ID) \
-    __kmp_acquire_atomic_lock( & ATOMIC_LOCK##LCK_ID, gtid );                    \
+    __kmp_acquire_atomic_lock( ATOMIC_LOCK##LCK_ID( lhs ), gtid );               \
                                                                           \
     (*lhs) OP (rhs);                                                      \
                                                                           \
-    __kmp_release_atomic_lock( & ATOMIC_LOCK##LCK_ID, gtid );
+    __kmp_release_atomic_lock( ATOMIC_LOCK##LCK_ID( lhs ), gtid );
 
 // ------------------------------------------------------------------------
 // For GNU compatibility, we may need to use a critical section,
@@ -758,6 +748,56 @@ RET_TYPE __kmpc_atomic_##TYPE_ID##_##OP_ID( ident_t *id_ref, int gtid, TYPE * lh
 // end of the first part of the workaround for C78287
 #endif // USE_CMPXCHG_FIX
 
+// ------------------------------------------------------------------------
+// 16-byte operands (double complex, _Quad) are updated with cmpxchg16b if the processor
+// supports it and the operand is 16-byte aligned, otherwise in a critical section.
+// The choice depends only on the processor and the address, so all entry points
+// protect a given operand the same way.
+#if KMP_HAVE_CAS128
+#define KMP_ATOMIC_USE_CAS128(ADDR) ( __kmp_cpuinfo.cx16 && ! ( (kmp_uintptr_t) (ADDR) & 0xF ) )
+
+// Reads *addr as two words; a torn value fails the compare_and_store that follows.
+template< typename TYPE >
+static inline void
+__kmp_atomic_load128( TYPE *addr, TYPE *value )
+{
+    kmp_int64 bits[ 2 ];
+    bits[ 0 ] = ( (kmp_int64 volatile *) addr )[ 0 ];
+    bits[ 1 ] = ( (kmp_int64 volatile *) addr )[ 1 ];
+    KMP_MEMCPY( value, bits, sizeof( bits ) );
+}
+
+template< typename TYPE >
+static inline int
+__kmp_atomic_cas128( TYPE *addr, TYPE const *old_value, TYPE const *new_value )
+{
+    kmp_int64 old_bits[ 2 ], new_bits[ 2 ];
+    KMP_MEMCPY( old_bits, old_value, sizeof( old_bits ) );
+    KMP_MEMCPY( new_bits, new_value, sizeof( new_bits ) );
+    return KMP_COMPARE_AND_STORE_ACQ128( (kmp_int64 volatile *) addr,
+                                         old_bits[ 0 ], old_bits[ 1 ], new_bits[ 0 ], new_bits[ 1 ] );
+}
+
+// Operation on a 16-byte operand using cmpxchg16b
+//     ADDR    - operand address (lhs or loc)
+//     EXPR    - new value, computed from old_value (and rhs)
+// old_value and new_value must be declared by the caller; on exit they hold
+// the replaced and the stored value.
+#define OP_CMPXCHG128(ADDR,EXPR)                                          \
+    __kmp_atomic_load128( ADDR, & old_value );                            \
+    new_value = EXPR;                                                     \
+    while ( ! __kmp_atomic_cas128( ADDR, & old_value, & new_value ) )     \
+    {                                                                     \
+        KMP_DO_PAUSE;                                                     \
+                                                                          \
+        __kmp_atomic_load128( ADDR, & old_value );                        \
+        new_value = EXPR;                                                 \
+    }
+#else
+#define KMP_ATOMIC_USE_CAS128(ADDR) 0
+#define OP_CMPXCHG128(ADDR,EXPR)
+#endif /* KMP_HAVE_CAS128 */
+
 #if KMP_ARCH_X86 || KMP_ARCH_X86_64
 
 // ------------------------------------------------------------------------
@@ -962,12 +1002,12 @@ ATOMIC_CMPX_L( fixed8,  orl, kmp_int64, 64, ||, 8i, 7, KMP_ARCH_X86 )  // __kmpc
 // MIN and MAX need separate macros
 // OP - operator to check if we need any actions?
 #define MIN_MAX_CRITSECT(OP,LCK_ID)                                        \
-    __kmp_acquire_atomic_lock( & ATOMIC_LOCK##LCK_ID, gtid );                     \
+    __kmp_acquire_atomic_lock( ATOMIC_LOCK##LCK_ID( lhs ), gtid );                \
                                                                            \
     if ( *lhs OP rhs ) {                 /* still need actions? */         \
         *lhs = rhs;                                                        \
     }                                                                      \
-    __kmp_release_atomic_lock( & ATOMIC_LOCK##LCK_ID, gtid );
+    __kmp_release_atomic_lock( ATOMIC_LOCK##LCK_ID( lhs ), gtid );
 
 // -------------------------------------------------------------------------
 #ifdef KMP_GOMP_COMPAT
@@ -1008,6 +1048,20 @@ ATOMIC_BEGIN(TYPE_ID,OP_ID,TYPE,void)                                      \
         MIN_MAX_CRITSECT(OP,LCK_ID)                                        \
     }                                                                      \
 }
+// -------------------------------------------------------------------------
+// 16-byte operands - use cmpxchg16b if possible, critical section otherwise
+#define MIN_MAX_CRITICAL_128(TYPE_ID,OP_ID,TYPE,OP,LCK_ID,GOMP_FLAG)       \
+ATOMIC_BEGIN(TYPE_ID,OP_ID,TYPE,void)                                      \
+    if ( *lhs OP rhs ) {     /* need actions? */                           \
+        GOMP_MIN_MAX_CRITSECT(OP,GOMP_FLAG)                                \
+        if ( KMP_ATOMIC_USE_CAS128( lhs ) ) {                              \
+            TYPE old_value, new_value;                                     \
+            OP_CMPXCHG128( lhs, ( old_value OP rhs ) ? rhs : old_value )   \
+        } else {                                                           \
+            MIN_MAX_CRITSECT(OP,LCK_ID)                                    \
+        }                                                                  \
+    }                                                                      \
+}
 
 #if KMP_ARCH_X86 || KMP_ARCH_X86_64
 
@@ -1051,8 +1105,8 @@ MIN_MAX_COMPXCHG( float4,  min, kmp_real32, 32, >, 4r, 3, KMP_ARCH_X86 ) // __km
 MIN_MAX_COMPXCHG( float8,  max, kmp_real64, 64, <, 8r, 7, KMP_ARCH_X86 ) // __kmpc_atomic_float8_max
 MIN_MAX_COMPXCHG( float8,  min, kmp_real64, 64, >, 8r, 7, KMP_ARCH_X86 ) // __kmpc_atomic_float8_min
 #if KMP_HAVE_QUAD
-MIN_MAX_CRITICAL( float16, max,     QUAD_LEGACY,      <, 16r,   1 )            // __kmpc_atomic_float16_max
-MIN_MAX_CRITICAL( float16, min,     QUAD_LEGACY,      >, 16r,   1 )            // __kmpc_atomic_float16_min
+MIN_MAX_CRITICAL_128( float16, max,     QUAD_LEGACY,      <, 16r,   1 )        // __kmpc_atomic_float16_max
+MIN_MAX_CRITICAL_128( float16, min,     QUAD_LEGACY,      >, 16r,   1 )        // __kmpc_atomic_float16_min
 #if ( KMP_ARCH_X86 )
     MIN_MAX_CRITICAL( float16, max_a16, Quad_a16_t,     <, 16r,   1 )            // __kmpc_atomic_float16_max_a16
     MIN_MAX_CRITICAL( float16, min_a16, Quad_a16_t,     >, 16r,   1 )            // __kmpc_atomic_float16_min_a16
@@ -1112,6 +1166,17 @@ ATOMIC_BEGIN(TYPE_ID,OP_ID,TYPE,void)                                     \
     OP_GOMP_CRITICAL(OP##=,GOMP_FLAG)  /* send assignment */              \
     OP_CRITICAL(OP##=,LCK_ID)          /* send assignment */              \
 }
+// 16-byte operands - use cmpxchg16b if possible, critical section otherwise
+#define ATOMIC_CRITICAL_128(TYPE_ID,OP_ID,TYPE,OP,LCK_ID,GOMP_FLAG)        \
+ATOMIC_BEGIN(TYPE_ID,OP_ID,TYPE,void)                                      \
+    OP_GOMP_CRITICAL(OP##=,GOMP_FLAG)  /* send assignment */               \
+    if ( KMP_ATOMIC_USE_CAS128( lhs ) ) {                                  \
+        TYPE old_value, new_value;                                         \
+        OP_CMPXCHG128( lhs, old_value OP rhs )                             \
+    } else {                                                               \
+        OP_CRITICAL(OP##=,LCK_ID)      /* send assignment */               \
+    }                                                                      \
+}
 
 /* ------------------------------------------------------------------------- */
 // routines for long double type
@@ -1121,10 +1186,10 @@ ATOMIC_CRITICAL( float10, mul, long double,     *, 10r,   1 )            // __km
 ATOMIC_CRITICAL( float10, div, long double,     /, 10r,   1 )            // __kmpc_atomic_float10_div
 #if KMP_HAVE_QUAD
 // routines for _Quad type
-ATOMIC_CRITICAL( float16, add, QUAD_LEGACY,     +, 16r,   1 )            // __kmpc_atomic_float16_add
-ATOMIC_CRITICAL( float16, sub, QUAD_LEGACY,     -, 16r,   1 )            // __kmpc_atomic_float16_sub
-ATOMIC_CRITICAL( float16, mul, QUAD_LEGACY,     *, 16r,   1 )            // __kmpc_atomic_float16_mul
-ATOMIC_CRITICAL( float16, div, QUAD_LEGACY,     /, 16r,   1 )            // __kmpc_atomic_float16_div
+ATOMIC_CRITICAL_128( float16, add, QUAD_LEGACY,     +, 16r,   1 )        // __kmpc_atomic_float16_add
+ATOMIC_CRITICAL_128( float16, sub, QUAD_LEGACY,     -, 16r,   1 )        // __kmpc_atomic_float16_sub
+ATOMIC_CRITICAL_128( float16, mul, QUAD_LEGACY,     *, 16r,   1 )        // __kmpc_atomic_float16_mul
+ATOMIC_CRITICAL_128( float16, div, QUAD_LEGACY,     /, 16r,   1 )        // __kmpc_atomic_float16_div
 #if ( KMP_ARCH_X86 )
     ATOMIC_CRITICAL( float16, add_a16, Quad_a16_t, +, 16r, 1 )           // __kmpc_atomic_float16_add_a16
     ATOMIC_CRITICAL( float16, sub_a16, Quad_a16_t, -, 16r, 1 )           // __kmpc_atomic_float16_sub_a16
@@ -1148,10 +1213,10 @@ ATOMIC_CRITICAL( cmplx4,  mul, kmp_cmplx32,     *,  8c,   1 )            // __km
 ATOMIC_CRITICAL( cmplx4,  div, kmp_cmplx32,     /,  8c,   1 )            // __kmpc_atomic_cmplx4_div
 #endif // USE_CMPXCHG_FIX
 
-ATOMIC_CRITICAL( cmplx8,  add, kmp_cmplx64,     +, 16c,   1 )            // __kmpc_atomic_cmplx8_add
-ATOMIC_CRITICAL( cmplx8,  sub, kmp_cmplx64,     -, 16c,   1 )            // __kmpc_atomic_cmplx8_sub
-ATOMIC_CRITICAL( cmplx8,  mul, kmp_cmplx64,     *, 16c,   1 )            // __kmpc_atomic_cmplx8_mul
-ATOMIC_CRITICAL( cmplx8,  div, kmp_cmplx64,     /, 16c,   1 )            // __kmpc_atomic_cmplx8_div
+ATOMIC_CRITICAL_128( cmplx8,  add, kmp_cmplx64,     +, 16c,   1 )        // __kmpc_atomic_cmplx8_add
+ATOMIC_CRITICAL_128( cmplx8,  sub, kmp_cmplx64,     -, 16c,   1 )        // __kmpc_atomic_cmplx8_sub
+ATOMIC_CRITICAL_128( cmplx8,  mul, kmp_cmplx64,     *, 16c,   1 )        // __kmpc_atomic_cmplx8_mul
+ATOMIC_CRITICAL_128( cmplx8,  div, kmp_cmplx64,     /, 16c,   1 )        // __kmpc_atomic_cmplx8_div
 ATOMIC_CRITICAL( cmplx10, add, kmp_cmplx80,     +, 20c,   1 )            // __kmpc_atomic_cmplx10_add
 ATOMIC_CRITICAL( cmplx10, sub, kmp_cmplx80,     -, 20c,   1 )            // __kmpc_atomic_cmplx10_sub
 ATOMIC_CRITICAL( cmplx10, mul, kmp_cmplx80,     *, 20c,   1 )            // __kmpc_atomic_cmplx10_mul
@@ -1182,11 +1247,11 @@ ATOMIC_CRITICAL( cmplx16, div, CPLX128_LEG,     /, 32c,   1 )            // __km
 // Note: don't check gtid as it should always be valid
 // 1, 2-byte - expect valid parameter, other - check before this macro
 #define OP_CRITICAL_REV(OP,LCK_ID) \
-    __kmp_acquire_atomic_lock( & ATOMIC_LOCK##LCK_ID, gtid );             \
+    __kmp_acquire_atomic_lock( ATOMIC_LOCK##LCK_ID( lhs ), gtid );        \
                                                                           \
     (*lhs) = (rhs) OP (*lhs);                                             \
                                                                           \
-    __kmp_release_atomic_lock( & ATOMIC_LOCK##LCK_ID, gtid );
+    __kmp_release_atomic_lock( ATOMIC_LOCK##LCK_ID( lhs ), gtid );
 
 #ifdef KMP_GOMP_COMPAT
 #define OP_GOMP_CRITICAL_REV(OP,FLAG)                                     \
@@ -1302,6 +1367,17 @@ ATOMIC_BEGIN_REV(TYPE_ID,OP_ID,TYPE,void)                                     \
     OP_GOMP_CRITICAL_REV(OP,GOMP_FLAG)                                        \
     OP_CRITICAL_REV(OP,LCK_ID)                                                \
 }
+// 16-byte operands - use cmpxchg16b if possible, critical section otherwise
+#define ATOMIC_CRITICAL_REV_128(TYPE_ID,OP_ID,TYPE,OP,LCK_ID,GOMP_FLAG)    \
+ATOMIC_BEGIN_REV(TYPE_ID,OP_ID,TYPE,void)                                  \
+    OP_GOMP_CRITICAL_REV(OP,GOMP_FLAG)                                     \
+    if ( KMP_ATOMIC_USE_CAS128( lhs ) ) {                                  \
+        TYPE old_value, new_value;                                         \
+        OP_CMPXCHG128( lhs, rhs OP old_value )                             \
+    } else {                                                               \
+        OP_CRITICAL_REV(OP,LCK_ID)                                         \
+    }                                                                      \
+}
 
 /* ------------------------------------------------------------------------- */
 // routines for long double type
@@ -1309,8 +1385,8 @@ ATOMIC_CRITICAL_REV( float10, sub, long double,     -, 10r,   1 )            //
 ATOMIC_CRITICAL_REV( float10, div, long double,     /, 10r,   1 )            // __kmpc_atomic_float10_div_rev
 #if KMP_HAVE_QUAD
 // routines for _Quad type
-ATOMIC_CRITICAL_REV( float16, sub, QUAD_LEGACY,     -, 16r,   1 )            // __kmpc_atomic_float16_sub_rev
-ATOMIC_CRITICAL_REV( float16, div, QUAD_LEGACY,     /, 16r,   1 )            // __kmpc_atomic_float16_div_rev
+ATOMIC_CRITICAL_REV_128( float16, sub, QUAD_LEGACY,     -, 16r,   1 )        // __kmpc_atomic_float16_sub_rev
+ATOMIC_CRITICAL_REV_128( float16, div, QUAD_LEGACY,     /, 16r,   1 )        // __kmpc_atomic_float16_div_rev
 #if ( KMP_ARCH_X86 )
     ATOMIC_CRITICAL_REV( float16, sub_a16, Quad_a16_t, -, 16r, 1 )           // __kmpc_atomic_float16_sub_a16_rev
     ATOMIC_CRITICAL_REV( float16, div_a16, Quad_a16_t, /, 16r, 1 )           // __kmpc_atomic_float16_div_a16_rev
@@ -1320,8 +1396,8 @@ ATOMIC_CRITICAL_REV( float16, div, QUAD_LEGACY,     /, 16r,   1 )            //
 // routines for complex types
 ATOMIC_CRITICAL_REV( cmplx4,  sub, kmp_cmplx32,     -, 8c,    1 )            // __kmpc_atomic_cmplx4_sub_rev
 ATOMIC_CRITICAL_REV( cmplx4,  div, kmp_cmplx32,     /, 8c,    1 )            // __kmpc_atomic_cmplx4_div_rev
-ATOMIC_CRITICAL_REV( cmplx8,  sub, kmp_cmplx64,     -, 16c,   1 )            // __kmpc_atomic_cmplx8_sub_rev
-ATOMIC_CRITICAL_REV( cmplx8,  div, kmp_cmplx64,     /, 16c,   1 )            // __kmpc_atomic_cmplx8_div_rev
+ATOMIC_CRITICAL_REV_128( cmplx8,  sub, kmp_cmplx64,     -, 16c,   1 )        // __kmpc_atomic_cmplx8_sub_rev
+ATOMIC_CRITICAL_REV_128( cmplx8,  div, kmp_cmplx64,     /, 16c,   1 )        // __kmpc_atomic_cmplx8_div_rev
 ATOMIC_CRITICAL_REV( cmplx10, sub, kmp_cmplx80,     -, 20c,   1 )            // __kmpc_atomic_cmplx10_sub_rev
 ATOMIC_CRITICAL_REV( cmplx10, div, kmp_cmplx80,     /, 20c,   1 )            // __kmpc_atomic_cmplx10_div_rev
 #if KMP_HAVE_QUAD
@@ -1596,11 +1672,11 @@ RET_TYPE __kmpc_atomic_##TYPE_ID##_##OP_ID( ident_t *id_ref, int gtid, TYPE * lo
 // Note: don't check gtid as it should always be valid
 // 1, 2-byte - expect valid parameter, other - check before this macro
 #define OP_CRITICAL_READ(OP,LCK_ID)                                       \
-    __kmp_acquire_atomic_lock( & ATOMIC_LOCK##LCK_ID, gtid );                    \
+    __kmp_acquire_atomic_lock( ATOMIC_LOCK##LCK_ID( loc ), gtid );               \
                                                                           \
     new_value = (*loc);                                                   \
                                                                           \
-    __kmp_release_atomic_lock( & ATOMIC_LOCK##LCK_ID, gtid );
+    __kmp_release_atomic_lock( ATOMIC_LOCK##LCK_ID( loc ), gtid );
 
 // -------------------------------------------------------------------------
 #ifdef KMP_GOMP_COMPAT
@@ -1641,6 +1717,20 @@ ATOMIC_BEGIN_READ(TYPE_ID,OP_ID,TYPE,TYPE)                                \
     OP_CRITICAL_READ(OP,LCK_ID)          /* send assignment */            \
     return new_value;                                                     \
 }
+// 16-byte operands - use cmpxchg16b if possible, critical section otherwise;
+// the value read is stored back unchanged to check that it was read atomically
+#define ATOMIC_CRITICAL_READ_128(TYPE_ID,OP_ID,TYPE,OP,LCK_ID,GOMP_FLAG)   \
+ATOMIC_BEGIN_READ(TYPE_ID,OP_ID,TYPE,TYPE)                                 \
+    TYPE new_value;                                                        \
+    OP_GOMP_CRITICAL_READ(OP##=,GOMP_FLAG)  /* send assignment */          \
+    if ( KMP_ATOMIC_USE_CAS128( loc ) ) {                                  \
+        TYPE old_value;                                                    \
+        OP_CMPXCHG128( loc, old_value )                                    \
+        return new_value;                                                  \
+    }                                                                      \
+    OP_CRITICAL_READ(OP,LCK_ID)          /* send assignment */             \
+    return new_value;                                                      \
+}
 
 // ------------------------------------------------------------------------
 // Fix for cmplx4 read (CQ220361) on Windows* OS. Regular routine with return value doesn't work.
@@ -1649,11 +1739,11 @@ ATOMIC_BEGIN_READ(TYPE_ID,OP_ID,TYPE,TYPE)                                \
 #if ( KMP_OS_WINDOWS )
 
 #define OP_CRITICAL_READ_WRK(OP,LCK_ID)                                   \
-    __kmp_acquire_atomic_lock( & ATOMIC_LOCK##LCK_ID, gtid );                    \
+    __kmp_acquire_atomic_lock( ATOMIC_LOCK##LCK_ID( loc ), gtid );               \
                                                                           \
     (*out) = (*loc);                                                      \
                                                                           \
-    __kmp_release_atomic_lock( & ATOMIC_LOCK##LCK_ID, gtid );
+    __kmp_release_atomic_lock( ATOMIC_LOCK##LCK_ID( loc ), gtid );
 // ------------------------------------------------------------------------
 #ifdef KMP_GOMP_COMPAT
 #define OP_GOMP_CRITICAL_READ_WRK(OP,FLAG)                                \
@@ -1693,7 +1783,7 @@ ATOMIC_CMPXCHG_READ( fixed2,  rd, kmp_int16,  16, +,  KMP_ARCH_X86 )  // __kmpc_
 
 ATOMIC_CRITICAL_READ( float10, rd, long double, +, 10r,   1 )         // __kmpc_atomic_float10_rd
 #if KMP_HAVE_QUAD
-ATOMIC_CRITICAL_READ( float16, rd, QUAD_LEGACY, +, 16r,   1 )         // __kmpc_atomic_float16_rd
+ATOMIC_CRITICAL_READ_128( float16, rd, QUAD_LEGACY, +, 16r,   1 )     // __kmpc_atomic_float16_rd
 #endif // KMP_HAVE_QUAD
 
 // Fix for CQ220361 on Windows* OS
@@ -1702,7 +1792,7 @@ ATOMIC_CRITICAL_READ( float16, rd, QUAD_LEGACY, +, 16r,   1 )         // __kmpc_
 #else
     ATOMIC_CRITICAL_READ( cmplx4,  rd, kmp_cmplx32, +,  8c, 1 )       // __kmpc_atomic_cmplx4_rd
 #endif
-ATOMIC_CRITICAL_READ( cmplx8,  rd, kmp_cmplx64, +, 16c, 1 )           // __kmpc_atomic_cmplx8_rd
+ATOMIC_CRITICAL_READ_128( cmplx8,  rd, kmp_cmplx64, +, 16c, 1 )       // __kmpc_atomic_cmplx8_rd
 ATOMIC_CRITICAL_READ( cmplx10, rd, kmp_cmplx80, +, 20c, 1 )           // __kmpc_atomic_cmplx10_rd
 #if KMP_HAVE_QUAD
 ATOMIC_CRITICAL_READ( cmplx16, rd, CPLX128_LEG, +, 32c, 1 )           // __kmpc_atomic_cmplx16_rd
@@ -1773,6 +1863,17 @@ ATOMIC_BEGIN(TYPE_ID,OP_ID,TYPE,void)                                     \
     OP_GOMP_CRITICAL(OP,GOMP_FLAG)       /* send assignment */            \
     OP_CRITICAL(OP,LCK_ID)               /* send assignment */            \
 }
+// 16-byte operands - use cmpxchg16b if possible, critical section otherwise
+#define ATOMIC_CRITICAL_WR_128(TYPE_ID,OP_ID,TYPE,OP,LCK_ID,GOMP_FLAG)     \
+ATOMIC_BEGIN(TYPE_ID,OP_ID,TYPE,void)                                      \
+    OP_GOMP_CRITICAL(OP,GOMP_FLAG)       /* send assignment */             \
+    if ( KMP_ATOMIC_USE_CAS128( lhs ) ) {                                  \
+        TYPE old_value, new_value;                                         \
+        OP_CMPXCHG128( lhs, rhs )                                          \
+    } else {                                                               \
+        OP_CRITICAL(OP,LCK_ID)           /* send assignment */             \
+    }                                                                      \
+}
 // -------------------------------------------------------------------------
 
 ATOMIC_XCHG_WR( fixed1,  wr, kmp_int8,    8, =,  KMP_ARCH_X86 )  // __kmpc_atomic_fixed1_wr
@@ -1793,10 +1894,10 @@ ATOMIC_XCHG_FLOAT_WR( float4, wr, kmp_real32, 32, =, KMP_ARCH_X86 )         // _
 
 ATOMIC_CRITICAL_WR( float10, wr, long double, =, 10r,   1 )         // __kmpc_atomic_float10_wr
 #if KMP_HAVE_QUAD
-ATOMIC_CRITICAL_WR( float16, wr, QUAD_LEGACY, =, 16r,   1 )         // __kmpc_atomic_float16_wr
+ATOMIC_CRITICAL_WR_128( float16, wr, QUAD_LEGACY, =, 16r,   1 )     // __kmpc_atomic_float16_wr
 #endif
 ATOMIC_CRITICAL_WR( cmplx4,  wr, kmp_cmplx32, =,  8c,   1 )         // __kmpc_atomic_cmplx4_wr
-ATOMIC_CRITICAL_WR( cmplx8,  wr, kmp_cmplx64, =, 16c,   1 )         // __kmpc_atomic_cmplx8_wr
+ATOMIC_CRITICAL_WR_128( cmplx8,  wr, kmp_cmplx64, =, 16c,   1 )     // __kmpc_atomic_cmplx8_wr
 ATOMIC_CRITICAL_WR( cmplx10, wr, kmp_cmplx80, =, 20c,   1 )         // __kmpc_atomic_cmplx10_wr
 #if KMP_HAVE_QUAD
 ATOMIC_CRITICAL_WR( cmplx16, wr, CPLX128_LEG, =, 32c,   1 )         // __kmpc_atomic_cmplx16_wr
@@ -1828,7 +1929,7 @@ RET_TYPE __kmpc_atomic_##TYPE_ID##_##OP_ID( ident_t *id_ref, int gtid, TYPE * lh
 // Note: don't check gtid as it should always be valid
 // 1, 2-byte - expect valid parameter, other - check before this macro
 #define OP_CRITICAL_CPT(OP,LCK_ID)                                        \
-    __kmp_acquire_atomic_lock( & ATOMIC_LOCK##LCK_ID, gtid );             \
+    __kmp_acquire_atomic_lock( ATOMIC_LOCK##LCK_ID( lhs ), gtid );        \
                                                                           \
     if( flag ) {                                                          \
         (*lhs) OP rhs;                                                    \
@@ -1838,7 +1939,7 @@ RET_TYPE __kmpc_atomic_##TYPE_ID##_##OP_ID( ident_t *id_ref, int gtid, TYPE * lh
         (*lhs) OP rhs;                                                    \
     }                                                                     \
                                                                           \
-    __kmp_release_atomic_lock( & ATOMIC_LOCK##LCK_ID, gtid );             \
+    __kmp_release_atomic_lock( ATOMIC_LOCK##LCK_ID( lhs ), gtid );        \
     return new_value;
 
 // ------------------------------------------------------------------------
@@ -2069,14 +2170,14 @@ ATOMIC_CRITICAL_CPT_MIX( float10, long double, div_cpt, /, fp, _Quad, 10r,   1 )
 // Note: don't check gtid as it should always be valid
 // 1, 2-byte - expect valid parameter, other - check before this macro
 #define OP_CRITICAL_L_CPT(OP,LCK_ID)                                      \
-    __kmp_acquire_atomic_lock( & ATOMIC_LOCK##LCK_ID, gtid );                    \
+    __kmp_acquire_atomic_lock( ATOMIC_LOCK##LCK_ID( lhs ), gtid );               \
                                                                           \
     if( flag ) {                                                          \
         new_value OP rhs;                                                 \
     } else                                                                \
         new_value = (*lhs);                                               \
                                                                           \
-    __kmp_release_atomic_lock( & ATOMIC_LOCK##LCK_ID, gtid );
+    __kmp_release_atomic_lock( ATOMIC_LOCK##LCK_ID( lhs ), gtid );
 
 // ------------------------------------------------------------------------
 #ifdef KMP_GOMP_COMPAT
@@ -2120,7 +2221,7 @@ ATOMIC_CMPX_L_CPT( fixed8,  orl_cpt, kmp_int64, 64, ||, KMP_ARCH_X86 )  // __kmp
 // MIN and MAX need separate macros
 // OP - operator to check if we need any actions?
 #define MIN_MAX_CRITSECT_CPT(OP,LCK_ID)                                    \
-    __kmp_acquire_atomic_lock( & ATOMIC_LOCK##LCK_ID, gtid );                     \
+    __kmp_acquire_atomic_lock( ATOMIC_LOCK##LCK_ID( lhs ), gtid );                \
                                                                            \
     if ( *lhs OP rhs ) {                 /* still need actions? */         \
         old_value = *lhs;                                                  \
@@ -2130,7 +2231,7 @@ ATOMIC_CMPX_L_CPT( fixed8,  orl_cpt, kmp_int64, 64, ||, KMP_ARCH_X86 )  // __kmp
         else                                                               \
             new_value = old_value;                                         \
     }                                                                      \
-    __kmp_release_atomic_lock( & ATOMIC_LOCK##LCK_ID, gtid );                     \
+    __kmp_release_atomic_lock( ATOMIC_LOCK##LCK_ID( lhs ), gtid );                \
     return new_value;                                                      \
 
 // -------------------------------------------------------------------------
@@ -2178,6 +2279,21 @@ ATOMIC_BEGIN_CPT(TYPE_ID,OP_ID,TYPE,TYPE)                                  \
     return *lhs;                                                           \
 }
 
+// 16-byte operands - use cmpxchg16b if possible, critical section otherwise
+#define MIN_MAX_CRITICAL_CPT_128(TYPE_ID,OP_ID,TYPE,OP,LCK_ID,GOMP_FLAG)   \
+ATOMIC_BEGIN_CPT(TYPE_ID,OP_ID,TYPE,TYPE)                                  \
+    TYPE new_value, old_value;                                             \
+    if ( *lhs OP rhs ) {     /* need actions? */                           \
+        GOMP_MIN_MAX_CRITSECT_CPT(OP,GOMP_FLAG)                            \
+        if ( KMP_ATOMIC_USE_CAS128( lhs ) ) {                              \
+            OP_CMPXCHG128( lhs, ( old_value OP rhs ) ? rhs : old_value )   \
+            return flag ? new_value : old_value;                           \
+        }                                                                  \
+        MIN_MAX_CRITSECT_CPT(OP,LCK_ID)                                    \
+    }                                                                      \
+    return *lhs;                                                           \
+}
+
 #define MIN_MAX_COMPXCHG_CPT(TYPE_ID,OP_ID,TYPE,BITS,OP,GOMP_FLAG)         \
 ATOMIC_BEGIN_CPT(TYPE_ID,OP_ID,TYPE,TYPE)                                  \
     TYPE new_value, old_value;                                             \
@@ -2202,8 +2318,8 @@ MIN_MAX_COMPXCHG_CPT( float4,  min_cpt, kmp_real32, 32, >, KMP_ARCH_X86 ) // __k
 MIN_MAX_COMPXCHG_CPT( float8,  max_cpt, kmp_real64, 64, <, KMP_ARCH_X86 ) // __kmpc_atomic_float8_max_cpt
 MIN_MAX_COMPXCHG_CPT( float8,  min_cpt, kmp_real64, 64, >, KMP_ARCH_X86 ) // __kmpc_atomic_float8_min_cpt
 #if KMP_HAVE_QUAD
-MIN_MAX_CRITICAL_CPT( float16, max_cpt, QUAD_LEGACY,    <, 16r,   1 )     // __kmpc_atomic_float16_max_cpt
-MIN_MAX_CRITICAL_CPT( float16, min_cpt, QUAD_LEGACY,    >, 16r,   1 )     // __kmpc_atomic_float16_min_cpt
+MIN_MAX_CRITICAL_CPT_128( float16, max_cpt, QUAD_LEGACY,    <, 16r,   1 ) // __kmpc_atomic_float16_max_cpt
+MIN_MAX_CRITICAL_CPT_128( float16, min_cpt, QUAD_LEGACY,    >, 16r,   1 ) // __kmpc_atomic_float16_min_cpt
 #if ( KMP_ARCH_X86 )
     MIN_MAX_CRITICAL_CPT( float16, max_a16_cpt, Quad_a16_t, <, 16r,  1 )  // __kmpc_atomic_float16_max_a16_cpt
     MIN_MAX_CRITICAL_CPT( float16, min_a16_cpt, Quad_a16_t, >, 16r,  1 )  // __kmpc_atomic_float16_mix_a16_cpt
@@ -2251,12 +2367,25 @@ ATOMIC_BEGIN_CPT(TYPE_ID,OP_ID,TYPE,TYPE)                           \
     OP_CRITICAL_CPT(OP##=,LCK_ID)          /* send assignment */    \
 }
 
+// 16-byte operands - use cmpxchg16b if possible, critical section otherwise
+#define ATOMIC_CRITICAL_CPT_128(TYPE_ID,OP_ID,TYPE,OP,LCK_ID,GOMP_FLAG)    \
+ATOMIC_BEGIN_CPT(TYPE_ID,OP_ID,TYPE,TYPE)                                  \
+    TYPE new_value;                                                        \
+    OP_GOMP_CRITICAL_CPT(OP,GOMP_FLAG)  /* send assignment */              \
+    if ( KMP_ATOMIC_USE_CAS128( lhs ) ) {                                  \
+        TYPE old_value;                                                    \
+        OP_CMPXCHG128( lhs, old_value OP rhs )                             \
+        return flag ? new_value : old_value;                               \
+    }                                                                      \
+    OP_CRITICAL_CPT(OP##=,LCK_ID)       /* send assignment */              \
+}
+
 // ------------------------------------------------------------------------
 
 // Workaround for cmplx4. Regular routines with return value don't work
 // on Win_32e. Let's return captured values through the additional parameter.
 #define OP_CRITICAL_CPT_WRK(OP,LCK_ID)                                    \
-    __kmp_acquire_atomic_lock( & ATOMIC_LOCK##LCK_ID, gtid );             \
+    __kmp_acquire_atomic_lock( ATOMIC_LOCK##LCK_ID( lhs ), gtid );        \
                                                                           \
     if( flag ) {                                                          \
         (*lhs) OP rhs;                                                    \
@@ -2266,7 +2395,7 @@ ATOMIC_BEGIN_CPT(TYPE_ID,OP_ID,TYPE,TYPE)                           \
         (*lhs) OP rhs;                                                    \
     }                                                                     \
                                                                           \
-    __kmp_release_atomic_lock( & ATOMIC_LOCK##LCK_ID, gtid );             \
+    __kmp_release_atomic_lock( ATOMIC_LOCK##LCK_ID( lhs ), gtid );        \
     return;
 // ------------------------------------------------------------------------
 
@@ -2303,10 +2432,10 @@ ATOMIC_CRITICAL_CPT( float10, mul_cpt, long double,     *, 10r,   1 )
 ATOMIC_CRITICAL_CPT( float10, div_cpt, long double,     /, 10r,   1 )            // __kmpc_atomic_float10_div_cpt
 #if KMP_HAVE_QUAD
 // routines for _Quad type
-ATOMIC_CRITICAL_CPT( float16, add_cpt, QUAD_LEGACY,     +, 16r,   1 )            // __kmpc_atomic_float16_add_cpt
-ATOMIC_CRITICAL_CPT( float16, sub_cpt, QUAD_LEGACY,     -, 16r,   1 )            // __kmpc_atomic_float16_sub_cpt
-ATOMIC_CRITICAL_CPT( float16, mul_cpt, QUAD_LEGACY,     *, 16r,   1 )            // __kmpc_atomic_float16_mul_cpt
-ATOMIC_CRITICAL_CPT( float16, div_cpt, QUAD_LEGACY,     /, 16r,   1 )            // __kmpc_atomic_float16_div_cpt
+ATOMIC_CRITICAL_CPT_128( float16, add_cpt, QUAD_LEGACY,     +, 16r,   1 )        // __kmpc_atomic_float16_add_cpt
+ATOMIC_CRITICAL_CPT_128( float16, sub_cpt, QUAD_LEGACY,     -, 16r,   1 )        // __kmpc_atomic_float16_sub_cpt
+ATOMIC_CRITICAL_CPT_128( float16, mul_cpt, QUAD_LEGACY,     *, 16r,   1 )        // __kmpc_atomic_float16_mul_cpt
+ATOMIC_CRITICAL_CPT_128( float16, div_cpt, QUAD_LEGACY,     /, 16r,   1 )        // __kmpc_atomic_float16_div_cpt
 #if ( KMP_ARCH_X86 )
     ATOMIC_CRITICAL_CPT( float16, add_a16_cpt, Quad_a16_t, +, 16r,  1 )          // __kmpc_atomic_float16_add_a16_cpt
     ATOMIC_CRITICAL_CPT( float16, sub_a16_cpt, Quad_a16_t, -, 16r,  1 )          // __kmpc_atomic_float16_sub_a16_cpt
@@ -2323,10 +2452,10 @@ ATOMIC_CRITICAL_CPT_WRK( cmplx4,  sub_cpt, kmp_cmplx32, -, 8c,    1 )
 ATOMIC_CRITICAL_CPT_WRK( cmplx4,  mul_cpt, kmp_cmplx32, *, 8c,    1 )            // __kmpc_atomic_cmplx4_mul_cpt
 ATOMIC_CRITICAL_CPT_WRK( cmplx4,  div_cpt, kmp_cmplx32, /, 8c,    1 )            // __kmpc_atomic_cmplx4_div_cpt
 
-ATOMIC_CRITICAL_CPT( cmplx8,  add_cpt, kmp_cmplx64, +, 16c,   1 )            // __kmpc_atomic_cmplx8_add_cpt
-ATOMIC_CRITICAL_CPT( cmplx8,  sub_cpt, kmp_cmplx64, -, 16c,   1 )            // __kmpc_atomic_cmplx8_sub_cpt
-ATOMIC_CRITICAL_CPT( cmplx8,  mul_cpt, kmp_cmplx64, *, 16c,   1 )            // __kmpc_atomic_cmplx8_mul_cpt
-ATOMIC_CRITICAL_CPT( cmplx8,  div_cpt, kmp_cmplx64, /, 16c,   1 )            // __kmpc_atomic_cmplx8_div_cpt
+ATOMIC_CRITICAL_CPT_128( cmplx8,  add_cpt, kmp_cmplx64, +, 16c,   1 )        // __kmpc_atomic_cmplx8_add_cpt
+ATOMIC_CRITICAL_CPT_128( cmplx8,  sub_cpt, kmp_cmplx64, -, 16c,   1 )        // __kmpc_atomic_cmplx8_sub_cpt
+ATOMIC_CRITICAL_CPT_128( cmplx8,  mul_cpt, kmp_cmplx64, *, 16c,   1 )        // __kmpc_atomic_cmplx8_mul_cpt
+ATOMIC_CRITICAL_CPT_128( cmplx8,  div_cpt, kmp_cmplx64, /, 16c,   1 )        // __kmpc_atomic_cmplx8_div_cpt
 ATOMIC_CRITICAL_CPT( cmplx10, add_cpt, kmp_cmplx80, +, 20c,   1 )            // __kmpc_atomic_cmplx10_add_cpt
 ATOMIC_CRITICAL_CPT( cmplx10, sub_cpt, kmp_cmplx80, -, 20c,   1 )            // __kmpc_atomic_cmplx10_sub_cpt
 ATOMIC_CRITICAL_CPT( cmplx10, mul_cpt, kmp_cmplx80, *, 20c,   1 )            // __kmpc_atomic_cmplx10_mul_cpt
@@ -2356,7 +2485,7 @@ ATOMIC_CRITICAL_CPT( cmplx16, div_cpt, CPLX128_LEG, /, 32c,   1 )            //
 // Note: don't check gtid as it should always be valid
 // 1, 2-byte - expect valid parameter, other - check before this macro
 #define OP_CRITICAL_CPT_REV(OP,LCK_ID)                                    \
-    __kmp_acquire_atomic_lock( & ATOMIC_LOCK##LCK_ID, gtid );             \
+    __kmp_acquire_atomic_lock( ATOMIC_LOCK##LCK_ID( lhs ), gtid );        \
                                                                           \
     if( flag ) {                                                          \
         /*temp_val = (*lhs);*/\
@@ -2366,7 +2495,7 @@ ATOMIC_CRITICAL_CPT( cmplx16, div_cpt, CPLX128_LEG, /, 32c,   1 )            //
         new_value = (*lhs);\
         (*lhs) = (rhs) OP (*lhs);                                         \
     }                                                                     \
-    __kmp_release_atomic_lock( & ATOMIC_LOCK##LCK_ID, gtid );             \
+    __kmp_release_atomic_lock( ATOMIC_LOCK##LCK_ID( lhs ), gtid );        \
     return new_value;
 
 // ------------------------------------------------------------------------
@@ -2465,6 +2594,19 @@ ATOMIC_BEGIN_CPT(TYPE_ID,OP_ID,TYPE,TYPE)                               \
     OP_CRITICAL_CPT_REV(OP,LCK_ID)                                      \
 }
 
+// 16-byte operands - use cmpxchg16b if possible, critical section otherwise
+#define ATOMIC_CRITICAL_CPT_REV_128(TYPE_ID,OP_ID,TYPE,OP,LCK_ID,GOMP_FLAG) \
+ATOMIC_BEGIN_CPT(TYPE_ID,OP_ID,TYPE,TYPE)                                  \
+    TYPE new_value;                                                        \
+    OP_GOMP_CRITICAL_CPT_REV(OP,GOMP_FLAG)                                 \
+    if ( KMP_ATOMIC_USE_CAS128( lhs ) ) {                                  \
+        TYPE old_value;                                                    \
+        OP_CMPXCHG128( lhs, rhs OP old_value )                             \
+        return flag ? new_value : old_value;                               \
+    }                                                                      \
+    OP_CRITICAL_CPT_REV(OP,LCK_ID)                                         \
+}
+
 
 /* ------------------------------------------------------------------------- */
 // routines for long double type
@@ -2472,8 +2614,8 @@ ATOMIC_CRITICAL_CPT_REV( float10, sub_cpt_rev, long double,     -, 10r,   1 )
 ATOMIC_CRITICAL_CPT_REV( float10, div_cpt_rev, long double,     /, 10r,   1 )            // __kmpc_atomic_float10_div_cpt_rev
 #if KMP_HAVE_QUAD
 // routines for _Quad type
-ATOMIC_CRITICAL_CPT_REV( float16, sub_cpt_rev, QUAD_LEGACY,     -, 16r,   1 )            // __kmpc_atomic_float16_sub_cpt_rev
-ATOMIC_CRITICAL_CPT_REV( float16, div_cpt_rev, QUAD_LEGACY,     /, 16r,   1 )            // __kmpc_atomic_float16_div_cpt_rev
+ATOMIC_CRITICAL_CPT_REV_128( float16, sub_cpt_rev, QUAD_LEGACY,     -, 16r,   1 )        // __kmpc_atomic_float16_sub_cpt_rev
+ATOMIC_CRITICAL_CPT_REV_128( float16, div_cpt_rev, QUAD_LEGACY,     /, 16r,   1 )        // __kmpc_atomic_float16_div_cpt_rev
 #if ( KMP_ARCH_X86 )
     ATOMIC_CRITICAL_CPT_REV( float16, sub_a16_cpt_rev, Quad_a16_t, -, 16r,  1 )          // __kmpc_atomic_float16_sub_a16_cpt_rev
     ATOMIC_CRITICAL_CPT_REV( float16, div_a16_cpt_rev, Quad_a16_t, /, 16r,  1 )          // __kmpc_atomic_float16_div_a16_cpt_rev
@@ -2487,7 +2629,7 @@ ATOMIC_CRITICAL_CPT_REV( float16, div_cpt_rev, QUAD_LEGACY,     /, 16r,   1 )
 // Workaround for cmplx4. Regular routines with return value don't work
 // on Win_32e. Let's return captured values through the additional parameter.
 #define OP_CRITICAL_CPT_REV_WRK(OP,LCK_ID)                                \
-    __kmp_acquire_atomic_lock( & ATOMIC_LOCK##LCK_ID, gtid );             \
+    __kmp_acquire_atomic_lock( ATOMIC_LOCK##LCK_ID( lhs ), gtid );        \
                                                                           \
     if( flag ) {                                                          \
         (*lhs) = (rhs) OP (*lhs);                                         \
@@ -2497,7 +2639,7 @@ ATOMIC_CRITICAL_CPT_REV( float16, div_cpt_rev, QUAD_LEGACY,     /, 16r,   1 )
         (*lhs) = (rhs) OP (*lhs);                                         \
     }                                                                     \
                                                                           \
-    __kmp_release_atomic_lock( & ATOMIC_LOCK##LCK_ID, gtid );             \
+    __kmp_release_atomic_lock( ATOMIC_LOCK##LCK_ID( lhs ), gtid );        \
     return;
 // ------------------------------------------------------------------------
 
@@ -2525,8 +2667,8 @@ ATOMIC_BEGIN_WRK(TYPE_ID,OP_ID,TYPE)                                          \
 ATOMIC_CRITICAL_CPT_REV_WRK( cmplx4,  sub_cpt_rev, kmp_cmplx32, -, 8c,    1 )            // __kmpc_atomic_cmplx4_sub_cpt_rev
 ATOMIC_CRITICAL_CPT_REV_WRK( cmplx4,  div_cpt_rev, kmp_cmplx32, /, 8c,    1 )            // __kmpc_atomic_cmplx4_div_cpt_rev
 
-ATOMIC_CRITICAL_CPT_REV( cmplx8,  sub_cpt_rev, kmp_cmplx64, -, 16c,   1 )            // __kmpc_atomic_cmplx8_sub_cpt_rev
-ATOMIC_CRITICAL_CPT_REV( cmplx8,  div_cpt_rev, kmp_cmplx64, /, 16c,   1 )            // __kmpc_atomic_cmplx8_div_cpt_rev
+ATOMIC_CRITICAL_CPT_REV_128( cmplx8,  sub_cpt_rev, kmp_cmplx64, -, 16c,   1 )        // __kmpc_atomic_cmplx8_sub_cpt_rev
+ATOMIC_CRITICAL_CPT_REV_128( cmplx8,  div_cpt_rev, kmp_cmplx64, /, 16c,   1 )        // __kmpc_atomic_cmplx8_div_cpt_rev
 ATOMIC_CRITICAL_CPT_REV( cmplx10, sub_cpt_rev, kmp_cmplx80, -, 20c,   1 )            // __kmpc_atomic_cmplx10_sub_cpt_rev
 ATOMIC_CRITICAL_CPT_REV( cmplx10, div_cpt_rev, kmp_cmplx80, /, 20c,   1 )            // __kmpc_atomic_cmplx10_div_cpt_rev
 #if KMP_HAVE_QUAD
@@ -2602,12 +2744,12 @@ TYPE __kmpc_atomic_##TYPE_ID##_swp( ident_t *id_ref, int gtid, TYPE * lhs, TYPE
     KA_TRACE(100,("__kmpc_atomic_" #TYPE_ID "_swp: T#%d\n", gtid ));
 
 #define CRITICAL_SWP(LCK_ID)                                              \
-    __kmp_acquire_atomic_lock( & ATOMIC_LOCK##LCK_ID, gtid );             \
+    __kmp_acquire_atomic_lock( ATOMIC_LOCK##LCK_ID( lhs ), gtid );        \
                                                                           \
     old_value = (*lhs);                                                   \
     (*lhs) = rhs;                                                         \
                                                                           \
-    __kmp_release_atomic_lock( & ATOMIC_LOCK##LCK_ID, gtid );             \
+    __kmp_release_atomic_lock( ATOMIC_LOCK##LCK_ID( lhs ), gtid );        \
     return old_value;
 
 // ------------------------------------------------------------------------
@@ -2690,6 +2832,19 @@ ATOMIC_BEGIN_SWP(TYPE_ID,TYPE)                                          \
     CRITICAL_SWP(LCK_ID)                                                \
 }
 
+// 16-byte operands - use cmpxchg16b if possible, critical section otherwise
+#define ATOMIC_CRITICAL_SWP_128(TYPE_ID,TYPE,LCK_ID,GOMP_FLAG)             \
+ATOMIC_BEGIN_SWP(TYPE_ID,TYPE)                                             \
+    TYPE old_value;                                                        \
+    GOMP_CRITICAL_SWP(GOMP_FLAG)                                           \
+    if ( KMP_ATOMIC_USE_CAS128( lhs ) ) {                                  \
+        TYPE new_value;                                                    \
+        OP_CMPXCHG128( lhs, rhs )                                          \
+        return old_value;                                                  \
+    }                                                                      \
+    CRITICAL_SWP(LCK_ID)                                                   \
+}
+
 // ------------------------------------------------------------------------
 
 // !!! TODO: check if we need to return void for cmplx4 routines
@@ -2704,12 +2859,12 @@ void __kmpc_atomic_##TYPE_ID##_swp( ident_t *id_ref, int gtid, TYPE * lhs, TYPE
 
 
 #define CRITICAL_SWP_WRK(LCK_ID)                                          \
-    __kmp_acquire_atomic_lock( & ATOMIC_LOCK##LCK_ID, gtid );             \
+    __kmp_acquire_atomic_lock( ATOMIC_LOCK##LCK_ID( lhs ), gtid );        \
                                                                           \
     tmp = (*lhs);                                                         \
     (*lhs) = (rhs);                                                       \
     (*out) = tmp;                                                         \
-    __kmp_release_atomic_lock( & ATOMIC_LOCK##LCK_ID, gtid );             \
+    __kmp_release_atomic_lock( ATOMIC_LOCK##LCK_ID( lhs ), gtid );        \
     return;
 
 // ------------------------------------------------------------------------
@@ -2736,7 +2891,7 @@ ATOMIC_BEGIN_SWP_WRK(TYPE_ID,TYPE)                                        \
 
 ATOMIC_CRITICAL_SWP( float10, long double, 10r,   1 )              // __kmpc_atomic_float10_swp
 #if KMP_HAVE_QUAD
-ATOMIC_CRITICAL_SWP( float16, QUAD_LEGACY, 16r,   1 )              // __kmpc_atomic_float16_swp
+ATOMIC_CRITICAL_SWP_128( float16, QUAD_LEGACY, 16r,   1 )          // __kmpc_atomic_float16_swp
 #endif
 // cmplx4 routine to return void
 ATOMIC_CRITICAL_SWP_WRK( cmplx4, kmp_cmplx32,  8c,   1 )           // __kmpc_atomic_cmplx4_swp
@@ -2744,7 +2899,7 @@ ATOMIC_CRITICAL_SWP_WRK( cmplx4, kmp_cmplx32,  8c,   1 )           // __kmpc_ato
 //ATOMIC_CRITICAL_SWP( cmplx4, kmp_cmplx32,  8c,   1 )           // __kmpc_atomic_cmplx4_swp
 
 
-ATOMIC_CRITICAL_SWP( cmplx8,  kmp_cmplx64, 16c,   1 )              // __kmpc_atomic_cmplx8_swp
+ATOMIC_CRITICAL_SWP_128( cmplx8,  kmp_cmplx64, 16c,   1 )          // __kmpc_atomic_cmplx8_swp
 ATOMIC_CRITICAL_SWP( cmplx10, kmp_cmplx80, 20c,   1 )              // __kmpc_atomic_cmplx10_swp
 #if KMP_HAVE_QUAD
 ATOMIC_CRITICAL_SWP( cmplx16, CPLX128_LEG, 32c,   1 )              // __kmpc_atomic_cmplx16_swp
@@ -2809,7 +2964,7 @@ __kmpc_atomic_1( ident_t *id_ref, int gtid, void* lhs, void* rhs, void (*f)( voi
         }
         else
 #endif /* KMP_GOMP_COMPAT */
-	__kmp_acquire_atomic_lock( & __kmp_atomic_lock_1i, gtid );
+	__kmp_acquire_atomic_lock( __kmp_get_atomic_lock( lhs ), gtid );
 
 	(*f)( lhs, lhs, rhs );
 
@@ -2819,7 +2974,7 @@ __kmpc_atomic_1( ident_t *id_ref, int gtid, void* lhs, void* rhs, void (*f)( voi
         }
         else
 #endif /* KMP_GOMP_COMPAT */
-	__kmp_release_atomic_lock( & __kmp_atomic_lock_1i, gtid );
+	__kmp_release_atomic_lock( __kmp_get_atomic_lock( lhs ), gtid );
     }
 }
 
@@ -2864,7 +3019,7 @@ __kmpc_atomic_2( ident_t *id_ref, int gtid, void* lhs, void* rhs, void (*f)( voi
         }
         else
 #endif /* KMP_GOMP_COMPAT */
-	__kmp_acquire_atomic_lock( & __kmp_atomic_lock_2i, gtid );
+	__kmp_acquire_atomic_lock( __kmp_get_atomic_lock( lhs ), gtid );
 
 	(*f)( lhs, lhs, rhs );
 
@@ -2874,7 +3029,7 @@ __kmpc_atomic_2( ident_t *id_ref, int gtid, void* lhs, void* rhs, void (*f)( voi
         }
         else
 #endif /* KMP_GOMP_COMPAT */
-	__kmp_release_atomic_lock( & __kmp_atomic_lock_2i, gtid );
+	__kmp_release_atomic_lock( __kmp_get_atomic_lock( lhs ), gtid );
     }
 }
 
@@ -2914,8 +3069,8 @@ __kmpc_atomic_4( ident_t *id_ref, int gtid, void* lhs, void* rhs, void (*f)( voi
     }
     else {
         //
-        // Use __kmp_atomic_lock_4i for all 4-byte data,
-        // even if it isn't of integer data type.
+        // Lock the table entry for the address, the same one the typed
+        // entry points use for this data.
         //
 
 #ifdef KMP_GOMP_COMPAT
@@ -2924,7 +3079,7 @@ __kmpc_atomic_4( ident_t *id_ref, int gtid, void* lhs, void* rhs, void (*f)( voi
         }
         else
 #endif /* KMP_GOMP_COMPAT */
-	__kmp_acquire_atomic_lock( & __kmp_atomic_lock_4i, gtid );
+	__kmp_acquire_atomic_lock( __kmp_get_atomic_lock( lhs ), gtid );
 
 	(*f)( lhs, lhs, rhs );
 
@@ -2934,7 +3089,7 @@ __kmpc_atomic_4( ident_t *id_ref, int gtid, void* lhs, void* rhs, void (*f)( voi
         }
         else
 #endif /* KMP_GOMP_COMPAT */
-	__kmp_release_atomic_lock( & __kmp_atomic_lock_4i, gtid );
+	__kmp_release_atomic_lock( __kmp_get_atomic_lock( lhs ), gtid );
     }
 }
 
@@ -2971,8 +3126,8 @@ __kmpc_atomic_8( ident_t *id_ref, int gtid, void* lhs, void* rhs, void (*f)( voi
 	return;
     } else {
         //
-        // Use __kmp_atomic_lock_8i for all 8-byte data,
-        // even if it isn't of integer data type.
+        // Lock the table entry for the address, the same one the typed
+        // entry points use for this data.
         //
 
 #ifdef KMP_GOMP_COMPAT
@@ -2981,7 +3136,7 @@ __kmpc_atomic_8( ident_t *id_ref, int gtid, void* lhs, void* rhs, void (*f)( voi
         }
         else
 #endif /* KMP_GOMP_COMPAT */
-	__kmp_acquire_atomic_lock( & __kmp_atomic_lock_8i, gtid );
+	__kmp_acquire_atomic_lock( __kmp_get_atomic_lock( lhs ), gtid );
 
 	(*f)( lhs, lhs, rhs );
 
@@ -2991,7 +3146,7 @@ __kmpc_atomic_8( ident_t *id_ref, int gtid, void* lhs, void* rhs, void (*f)( voi
         }
         else
 #endif /* KMP_GOMP_COMPAT */
-	__kmp_release_atomic_lock( & __kmp_atomic_lock_8i, gtid );
+	__kmp_release_atomic_lock( __kmp_get_atomic_lock( lhs ), gtid );
     }
 }
 
@@ -3006,7 +3161,7 @@ __kmpc_atomic_10( ident_t *id_ref, int gtid, void* lhs, void* rhs, void (*f)( vo
     }
     else
 #endif /* KMP_GOMP_COMPAT */
-    __kmp_acquire_atomic_lock( & __kmp_atomic_lock_10r, gtid );
+    __kmp_acquire_atomic_lock( __kmp_get_atomic_lock( lhs ), gtid );
 
     (*f)( lhs, lhs, rhs );
 
@@ -3016,7 +3171,7 @@ __kmpc_atomic_10( ident_t *id_ref, int gtid, void* lhs, void* rhs, void (*f)( vo
     }
     else
 #endif /* KMP_GOMP_COMPAT */
-    __kmp_release_atomic_lock( & __kmp_atomic_lock_10r, gtid );
+    __kmp_release_atomic_lock( __kmp_get_atomic_lock( lhs ), gtid );
 }
 
 void
@@ -3024,13 +3179,38 @@ __kmpc_atomic_16( ident_t *id_ref, int gtid, void* lhs, void* rhs, void (*f)( vo
 {
     KMP_DEBUG_ASSERT( __kmp_init_serial );
 
+#if KMP_HAVE_CAS128
+    if (
+#ifdef KMP_GOMP_COMPAT
+        __kmp_atomic_mode != 2 &&
+#endif /* KMP_GOMP_COMPAT */
+        KMP_ATOMIC_USE_CAS128( lhs ) )
+    {
+        //
+        // Same protocol as the typed 16-byte entry points use for this address.
+        //
+        KMP_ALIGN( 16 ) kmp_int64 old_value[ 2 ], new_value[ 2 ];
+
+        __kmp_atomic_load128( (kmp_int64 (*)[ 2 ]) lhs, & old_value );
+        (*f)( new_value, old_value, rhs );
+        while ( ! __kmp_atomic_cas128( (kmp_int64 (*)[ 2 ]) lhs, & old_value, & new_value ) )
+        {
+            KMP_DO_PAUSE;
+
+            __kmp_atomic_load128( (kmp_int64 (*)[ 2 ]) lhs, & old_value );
+            (*f)( new_value, old_value, rhs );
+        }
+        return;
+    }
+#endif /* KMP_HAVE_CAS128 */
+
 #ifdef KMP_GOMP_COMPAT
     if ( __kmp_atomic_mode == 2 ) {
         __kmp_acquire_atomic_lock( & __kmp_atomic_lock, gtid );
     }
     else
 #endif /* KMP_GOMP_COMPAT */
-    __kmp_acquire_atomic_lock( & __kmp_atomic_lock_16c, gtid );
+    __kmp_acquire_atomic_lock( __kmp_get_atomic_lock( lhs ), gtid );
 
     (*f)( lhs, lhs, rhs );
 
@@ -3040,7 +3220,7 @@ __kmpc_atomic_16( ident_t *id_ref, int gtid, void* lhs, void* rhs, void (*f)( vo
     }
     else
 #endif /* KMP_GOMP_COMPAT */
-    __kmp_release_atomic_lock( & __kmp_atomic_lock_16c, gtid );
+    __kmp_release_atomic_lock( __kmp_get_atomic_lock( lhs ), gtid );
 }
 
 void
@@ -3054,7 +3234,7 @@ __kmpc_atomic_20( ident_t *id_ref, int gtid, void* lhs, void* rhs, void (*f)( vo
     }
     else
 #endif /* KMP_GOMP_COMPAT */
-    __kmp_acquire_atomic_lock( & __kmp_atomic_lock_20c, gtid );
+    __kmp_acquire_atomic_lock( __kmp_get_atomic_lock( lhs ), gtid );
 
     (*f)( lhs, lhs, rhs );
 
@@ -3064,7 +3244,7 @@ __kmpc_atomic_20( ident_t *id_ref, int gtid, void* lhs, void* rhs, void (*f)( vo
     }
     else
 #endif /* KMP_GOMP_COMPAT */
-    __kmp_release_atomic_lock( & __kmp_atomic_lock_20c, gtid );
+    __kmp_release_atomic_lock( __kmp_get_atomic_lock( lhs ), gtid );
 }
 
 void
@@ -3078,7 +3258,7 @@ __kmpc_atomic_32( ident_t *id_ref, int gtid, void* lhs, void* rhs, void (*f)( vo
     }
     else
 #endif /* KMP_GOMP_COMPAT */
-    __kmp_acquire_atomic_lock( & __kmp_atomic_lock_32c, gtid );
+    __kmp_acquire_atomic_lock( __kmp_get_atomic_lock( lhs ), gtid );
 
     (*f)( lhs, lhs, rhs );
 
@@ -3088,7 +3268,7 @@ __kmpc_atomic_32( ident_t *id_ref, int gtid, void* lhs, void* rhs, void (*f)( vo
     }
     else
 #endif /* KMP_GOMP_COMPAT */
-    __kmp_release_atomic_lock( & __kmp_atomic_lock_32c, gtid );
+    __kmp_release_atomic_lock( __kmp_get_atomic_lock( lhs ), gtid );
 }
 
 // AC: same two routines as GOMP_atomic_start/end, but will be called by our compiler
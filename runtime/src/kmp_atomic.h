@@ -430,18 +430,24 @@ __kmp_destroy_atomic_lock( kmp_atomic_lock_t *lck )
 // Global Locks
 
 extern kmp_atomic_lock_t __kmp_atomic_lock;    /* Control access to all user coded atomics in Gnu compat mode   */
-extern kmp_atomic_lock_t __kmp_atomic_lock_1i;  /* Control access to all user coded atomics for 1-byte fixed data types */
-extern kmp_atomic_lock_t __kmp_atomic_lock_2i;  /* Control access to all user coded atomics for 2-byte fixed data types */
-extern kmp_atomic_lock_t __kmp_atomic_lock_4i;  /* Control access to all user coded atomics for 4-byte fixed data types */
-extern kmp_atomic_lock_t __kmp_atomic_lock_4r;  /* Control access to all user coded atomics for kmp_real32 data type    */
-extern kmp_atomic_lock_t __kmp_atomic_lock_8i;  /* Control access to all user coded atomics for 8-byte fixed data types */
-extern kmp_atomic_lock_t __kmp_atomic_lock_8r;  /* Control access to all user coded atomics for kmp_real64 data type    */
-extern kmp_atomic_lock_t __kmp_atomic_lock_8c;  /* Control access to all user coded atomics for complex byte data type  */
-extern kmp_atomic_lock_t __kmp_atomic_lock_10r; /* Control access to all user coded atomics for long double data type   */
-extern kmp_atomic_lock_t __kmp_atomic_lock_16r; /* Control access to all user coded atomics for _Quad data type         */
-extern kmp_atomic_lock_t __kmp_atomic_lock_16c; /* Control access to all user coded atomics for double complex data type*/
-extern kmp_atomic_lock_t __kmp_atomic_lock_20c; /* Control access to all user coded atomics for long double complex type*/
-extern kmp_atomic_lock_t __kmp_atomic_lock_32c; /* Control access to all user coded atomics for _Quad complex data type */
+
+//
+// All other user coded atomics that need a critical section are serialized on a table of locks
+// indexed by a hash of the target address, so that atomics on unrelated data do not contend.
+// The size must be a power of two; each lock is padded to a cache line.
+//
+
+#define KMP_ATOMIC_LOCK_TABLE_SIZE 1024
+
+extern kmp_atomic_lock_t __kmp_atomic_lock_table[ KMP_ATOMIC_LOCK_TABLE_SIZE ];
+
+static inline kmp_atomic_lock_t *
+__kmp_get_atomic_lock( void *addr )
+{
+    // Drop the low bits and fold in higher ones so that strided arrays spread over the table.
+    kmp_uintptr_t a = (kmp_uintptr_t) addr >> 2;
+    return & __kmp_atomic_lock_table[ ( a ^ ( a >> 10 ) ) & ( KMP_ATOMIC_LOCK_TABLE_SIZE - 1 ) ];
+}
 
 //
 //  Below routines for atomic UPDATE are listed
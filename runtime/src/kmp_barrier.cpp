@@ -42,6 +42,113 @@
 
 void __kmp_print_structure(void); // Forward declaration
 
+// ---------------------------- Typed Reduction Kernels ----------------------------
+
+// The loops below are kept free of calls and cross-iteration dependences so that
+// the compiler vectorizes them; they replace one indirect reduce_func call per
+// barrier tree edge when the compiler supplied a reduction descriptor.
+template <typename T>
+static void
+__kmp_reduce_typed_kernel(kmp_int32 op, T *lhs, const T *rhs, size_t count)
+{
+    size_t i;
+    switch (op) {
+    case kmp_red_op_sum:
+        for (i=0; i<count; ++i)
+            lhs[i] += rhs[i];
+        break;
+    case kmp_red_op_prod:
+        for (i=0; i<count; ++i)
+            lhs[i] *= rhs[i];
+        break;
+    case kmp_red_op_min:
+        for (i=0; i<count; ++i)
+            lhs[i] = (rhs[i] < lhs[i]) ? rhs[i] : lhs[i];
+        break;
+    case kmp_red_op_max:
+        for (i=0; i<count; ++i)
+            lhs[i] = (rhs[i] > lhs[i]) ? rhs[i] : lhs[i];
+        break;
+    default:
+        KMP_ASSERT(0); // rejected by __kmp_reduction_desc_supported()
+    }
+}
+
+// Returns TRUE if every item of the descriptor can be combined by __kmp_reduce_typed_combine().
+int
+__kmp_reduction_desc_supported(const kmp_reduction_item_t *desc, kmp_int32 num_vars)
+{
+    kmp_int32 i;
+    if (desc == NULL || num_vars <= 0)
+        return FALSE;
+    for (i=0; i<num_vars; ++i) {
+        if (desc[i].op <= kmp_red_op_none || desc[i].op > kmp_red_op_max)
+            return FALSE;
+        if (desc[i].elem <= kmp_red_elem_none || desc[i].elem > kmp_red_elem_float64)
+            return FALSE;
+    }
+    return TRUE;
+}
+
+size_t
+__kmp_reduction_elem_size(kmp_int32 elem)
+{
+    switch (elem) {
+    case kmp_red_elem_int32:   return sizeof(kmp_int32);
+    case kmp_red_elem_int64:   return sizeof(kmp_int64);
+    case kmp_red_elem_float32: return sizeof(kmp_real32);
+    case kmp_red_elem_float64: return sizeof(kmp_real64);
+    }
+    return 0;
+}
+
+// Combine elements [first, first+count) of the variable described by item.
+void
+__kmp_reduce_typed_slice(const kmp_reduction_item_t *item, void *lhs, void *rhs,
+                         size_t first, size_t count)
+{
+    switch (item->elem) {
+    case kmp_red_elem_int32:
+        __kmp_reduce_typed_kernel(item->op, (kmp_int32 *)lhs + first, (const kmp_int32 *)rhs + first, count);
+        break;
+    case kmp_red_elem_int64:
+        __kmp_reduce_typed_kernel(item->op, (kmp_int64 *)lhs + first, (const kmp_int64 *)rhs + first, count);
+        break;
+    case kmp_red_elem_float32:
+        __kmp_reduce_typed_kernel(item->op, (kmp_real32 *)lhs + first, (const kmp_real32 *)rhs + first, count);
+        break;
+    case kmp_red_elem_float64:
+        __kmp_reduce_typed_kernel(item->op, (kmp_real64 *)lhs + first, (const kmp_real64 *)rhs + first, count);
+        break;
+    default:
+        KMP_ASSERT(0); // rejected by __kmp_reduction_desc_supported()
+    }
+}
+
+// lhs_data and rhs_data are reduce lists: arrays of num_vars pointers to the reduction variables.
+void
+__kmp_reduce_typed_combine(const kmp_reduction_item_t *desc, kmp_int32 num_vars,
+                           void *lhs_data, void *rhs_data)
+{
+    void **lhs = (void **)lhs_data;
+    void **rhs = (void **)rhs_data;
+    kmp_int32 i;
+    for (i=0; i<num_vars; ++i)
+        __kmp_reduce_typed_slice(&desc[i], lhs[i], rhs[i], 0, desc[i].count);
+}
+
+// Combine other_thr's reduction data into this_thr's during a barrier gather.
+static inline void
+__kmp_barrier_reduce(kmp_info_t *this_thr, kmp_info_t *other_thr, void (*reduce)(void *, void *))
+{
+    const kmp_reduction_item_t *desc = this_thr->th.th_local.reduce_desc;
+    if (desc != NULL)
+        __kmp_reduce_typed_combine(desc, this_thr->th.th_local.reduce_num_vars,
+                                   this_thr->th.th_local.reduce_data, other_thr->th.th_local.reduce_data);
+    else
+        (*reduce)(this_thr->th.th_local.reduce_data, other_thr->th.th_local.reduce_data);
+}
+
 // ---------------------------- Barrier Algorithms ----------------------------
 
 // Linear Barrier
@@ -110,8 +217,7 @@ __kmp_linear_barrier_gather(enum barrier_type bt, kmp_info_t *this_thr, int gtid
                 KA_TRACE(100, ("__kmp_linear_barrier_gather: T#%d(%d:%d) += T#%d(%d:%d)\n", gtid,
                                team->t.t_id, tid, __kmp_gtid_from_tid(i, team), team->t.t_id, i));
                 ANNOTATE_REDUCE_AFTER(reduce);
-                (*reduce)(this_thr->th.th_local.reduce_data,
-                          other_threads[i]->th.th_local.reduce_data);
+                __kmp_barrier_reduce(this_thr, other_threads[i], reduce);
                 ANNOTATE_REDUCE_BEFORE(reduce);
                 ANNOTATE_REDUCE_BEFORE(&team->t.t_bar);
             }
@@ -280,7 +386,7 @@ __kmp_tree_barrier_gather(enum barrier_type bt, kmp_info_t *this_thr, int gtid,
                                gtid, team->t.t_id, tid, __kmp_gtid_from_tid(child_tid, team),
                                team->t.t_id, child_tid));
                 ANNOTATE_REDUCE_AFTER(reduce);
-                (*reduce)(this_thr->th.th_local.reduce_data, child_thr->th.th_local.reduce_data);
+                __kmp_barrier_reduce(this_thr, child_thr, reduce);
                 ANNOTATE_REDUCE_BEFORE(reduce);
                 ANNOTATE_REDUCE_BEFORE(&team->t.t_bar);
             }
@@ -507,7 +613,7 @@ __kmp_hyper_barrier_gather(enum barrier_type bt, kmp_info_t *this_thr, int gtid,
                                gtid, team->t.t_id, tid, __kmp_gtid_from_tid(child_tid, team),
                                team->t.t_id, child_tid));
                 ANNOTATE_REDUCE_AFTER(reduce);
-                (*reduce)(this_thr->th.th_local.reduce_data, child_thr->th.th_local.reduce_data);
+                __kmp_barrier_reduce(this_thr, child_thr, reduce);
                 ANNOTATE_REDUCE_BEFORE(reduce);
                 ANNOTATE_REDUCE_BEFORE(&team->t.t_bar);
             }
@@ -788,7 +894,7 @@ __kmp_hierarchical_barrier_gather(enum barrier_type bt, kmp_info_t *this_thr,
                         KA_TRACE(100, ("__kmp_hierarchical_barrier_gather: T#%d(%d:%d) += T#%d(%d:%d)\n",
                                        gtid, team->t.t_id, tid, __kmp_gtid_from_tid(child_tid, team),
                                        team->t.t_id, child_tid));
-                        (*reduce)(this_thr->th.th_local.reduce_data, other_threads[child_tid]->th.th_local.reduce_data);
+                        __kmp_barrier_reduce(this_thr, other_threads[child_tid], reduce);
                     }
                     ANNOTATE_REDUCE_BEFORE(reduce);
                     ANNOTATE_REDUCE_BEFORE(&team->t.t_bar);
@@ -814,7 +920,7 @@ __kmp_hierarchical_barrier_gather(enum barrier_type bt, kmp_info_t *this_thr,
                                        gtid, team->t.t_id, tid, __kmp_gtid_from_tid(child_tid, team),
                                        team->t.t_id, child_tid));
                         ANNOTATE_REDUCE_AFTER(reduce);
-                        (*reduce)(this_thr->th.th_local.reduce_data, child_thr->th.th_local.reduce_data);
+                        __kmp_barrier_reduce(this_thr, child_thr, reduce);
                         ANNOTATE_REDUCE_BEFORE(reduce);
                         ANNOTATE_REDUCE_BEFORE(&team->t.t_bar);
                     }
@@ -840,7 +946,7 @@ __kmp_hierarchical_barrier_gather(enum barrier_type bt, kmp_info_t *this_thr,
                                        gtid, team->t.t_id, tid, __kmp_gtid_from_tid(child_tid, team),
                                        team->t.t_id, child_tid));
                         ANNOTATE_REDUCE_AFTER(reduce);
-                        (*reduce)(this_thr->th.th_local.reduce_data, child_thr->th.th_local.reduce_data);
+                        __kmp_barrier_reduce(this_thr, child_thr, reduce);
                         ANNOTATE_REDUCE_BEFORE(reduce);
                         ANNOTATE_REDUCE_BEFORE(&team->t.t_bar);
                     }
@@ -1059,6 +1165,108 @@ __kmp_hierarchical_barrier_release(enum barrier_type bt, kmp_info_t *this_thr, i
 
 // ---------------------------- End of Barrier Algorithms ----------------------------
 
+#if KMP_STATS_ENABLED
+/* Per-site barrier statistics.  Every thread stamps its arrival and departure at team barriers.
+   Once the gather is complete the master knows the arrival skew of this barrier; the departures
+   are only known at the next barrier of the team (or the join barrier), so that is where the
+   release latency of the previous barrier is computed and the sample is recorded. */
+static void
+__kmp_stats_barrier_gathered(kmp_info_t *this_thr, int gtid, kmp_team_t *team, ident_t *loc, int is_barrier)
+{
+    kmp_info_t **other_threads = team->t.t_threads;
+    int nproc = team->t.t_nproc;
+    int i;
+
+    if (team->t.t_stats_bar_pending) {
+        kmp_int64 depart = other_threads[0]->th.th_stats_bar_depart;
+        for (i = 1; i < nproc; ++i) {
+            if (other_threads[i]->th.th_stats_bar_depart > depart)
+                depart = other_threads[i]->th.th_stats_bar_depart;
+        }
+        ident_t *prev_loc = team->t.t_stats_bar_loc;
+        __kmp_stats_barrier_sample(gtid, prev_loc, prev_loc ? prev_loc->psource : NULL,
+                                   team->t.t_stats_bar_skew, depart - team->t.t_stats_bar_last_arrive);
+        team->t.t_stats_bar_pending = 0;
+    }
+    if (is_barrier && nproc > 1) {
+        kmp_int64 first = other_threads[0]->th.th_stats_bar_arrive;
+        kmp_int64 last = first;
+        for (i = 1; i < nproc; ++i) {
+            kmp_int64 arrive = other_threads[i]->th.th_stats_bar_arrive;
+            if (arrive < first)
+                first = arrive;
+            if (arrive > last)
+                last = arrive;
+        }
+        team->t.t_stats_bar_loc = loc;
+        team->t.t_stats_bar_skew = last - first;
+        team->t.t_stats_bar_last_arrive = last;
+        team->t.t_stats_bar_pending = 1;
+    }
+}
+#endif // KMP_STATS_ENABLED
+
+// Run the gather half of a barrier with the pattern configured for bt.
+static void
+__kmp_barrier_gather_phase(enum barrier_type bt, kmp_info_t *this_thr, int gtid, int tid,
+                           void (*reduce)(void *, void *)
+                           USE_ITT_BUILD_ARG(void *itt_sync_obj) )
+{
+    switch (__kmp_barrier_gather_pattern[bt]) {
+    case bp_hyper_bar: {
+        KMP_ASSERT(__kmp_barrier_gather_branch_bits[bt]); // don't set branch bits to 0; use linear
+        __kmp_hyper_barrier_gather(bt, this_thr, gtid, tid, reduce
+                                   USE_ITT_BUILD_ARG(itt_sync_obj) );
+        break;
+    }
+    case bp_hierarchical_bar: {
+        __kmp_hierarchical_barrier_gather(bt, this_thr, gtid, tid, reduce
+                                          USE_ITT_BUILD_ARG(itt_sync_obj));
+        break;
+    }
+    case bp_tree_bar: {
+        KMP_ASSERT(__kmp_barrier_gather_branch_bits[bt]); // don't set branch bits to 0; use linear
+        __kmp_tree_barrier_gather(bt, this_thr, gtid, tid, reduce
+                                  USE_ITT_BUILD_ARG(itt_sync_obj) );
+        break;
+    }
+    default: {
+        __kmp_linear_barrier_gather(bt, this_thr, gtid, tid, reduce
+                                    USE_ITT_BUILD_ARG(itt_sync_obj) );
+    }
+    }
+}
+
+// Run the release half of a barrier with the pattern configured for bt.
+static void
+__kmp_barrier_release_phase(enum barrier_type bt, kmp_info_t *this_thr, int gtid, int tid
+                            USE_ITT_BUILD_ARG(void *itt_sync_obj) )
+{
+    switch (__kmp_barrier_release_pattern[bt]) {
+    case bp_hyper_bar: {
+        KMP_ASSERT(__kmp_barrier_release_branch_bits[bt]);
+        __kmp_hyper_barrier_release(bt, this_thr, gtid, tid, FALSE
+                                    USE_ITT_BUILD_ARG(itt_sync_obj) );
+        break;
+    }
+    case bp_hierarchical_bar: {
+        __kmp_hierarchical_barrier_release(bt, this_thr, gtid, tid, FALSE
+                                           USE_ITT_BUILD_ARG(itt_sync_obj) );
+        break;
+    }
+    case bp_tree_bar: {
+        KMP_ASSERT(__kmp_barrier_release_branch_bits[bt]);
+        __kmp_tree_barrier_release(bt, this_thr, gtid, tid, FALSE
+                                   USE_ITT_BUILD_ARG(itt_sync_obj) );
+        break;
+    }
+    default: {
+        __kmp_linear_barrier_release(bt, this_thr, gtid, tid, FALSE
+                                     USE_ITT_BUILD_ARG(itt_sync_obj) );
+    }
+    }
+}
+
 // Internal function to do a barrier.
 /* If is_split is true, do a split barrier, otherwise, do a plain barrier
    If reduce is non-NULL, do a split reduction barrier, otherwise, do a split barrier
@@ -1154,34 +1362,19 @@ __kmp_barrier(enum barrier_type bt, int gtid, int is_split, size_t reduce_size,
         if (KMP_MASTER_TID(tid) && __kmp_tasking_mode != tskm_immediate_exec)
             __kmp_task_team_setup(this_thr, team, 0); // use 0 to only setup the current team if nthreads > 1
 
-        switch (__kmp_barrier_gather_pattern[bt]) {
-        case bp_hyper_bar: {
-            KMP_ASSERT(__kmp_barrier_gather_branch_bits[bt]); // don't set branch bits to 0; use linear
-            __kmp_hyper_barrier_gather(bt, this_thr, gtid, tid, reduce
-                                       USE_ITT_BUILD_ARG(itt_sync_obj) );
-            break;
-        }
-        case bp_hierarchical_bar: {
-            __kmp_hierarchical_barrier_gather(bt, this_thr, gtid, tid, reduce
-                                              USE_ITT_BUILD_ARG(itt_sync_obj));
-            break;
-        }
-        case bp_tree_bar: {
-            KMP_ASSERT(__kmp_barrier_gather_branch_bits[bt]); // don't set branch bits to 0; use linear
-            __kmp_tree_barrier_gather(bt, this_thr, gtid, tid, reduce
-                                      USE_ITT_BUILD_ARG(itt_sync_obj) );
-            break;
-        }
-        default: {
-            __kmp_linear_barrier_gather(bt, this_thr, gtid, tid, reduce
-                                        USE_ITT_BUILD_ARG(itt_sync_obj) );
-        }
-        }
+#if KMP_STATS_ENABLED
+        this_thr->th.th_stats_bar_arrive = tsc_tick_count::now().getValue();
+#endif
+        __kmp_barrier_gather_phase(bt, this_thr, gtid, tid, reduce
+                                   USE_ITT_BUILD_ARG(itt_sync_obj) );
 
         KMP_MB();
 
         if (KMP_MASTER_TID(tid)) {
             status = 0;
+#if KMP_STATS_ENABLED
+            __kmp_stats_barrier_gathered(this_thr, gtid, team, loc, TRUE);
+#endif
             if (__kmp_tasking_mode != tskm_immediate_exec) {
                 __kmp_task_team_wait(this_thr, team
                                      USE_ITT_BUILD_ARG(itt_sync_obj) );
@@ -1244,33 +1437,15 @@ __kmp_barrier(enum barrier_type bt, int gtid, int is_split, size_t reduce_size,
 #endif /* USE_ITT_BUILD */
         }
         if (status == 1 || ! is_split) {
-            switch (__kmp_barrier_release_pattern[bt]) {
-            case bp_hyper_bar: {
-                KMP_ASSERT(__kmp_barrier_release_branch_bits[bt]);
-                __kmp_hyper_barrier_release(bt, this_thr, gtid, tid, FALSE
-                                            USE_ITT_BUILD_ARG(itt_sync_obj) );
-                break;
-            }
-            case bp_hierarchical_bar: {
-                __kmp_hierarchical_barrier_release(bt, this_thr, gtid, tid, FALSE
-                                                   USE_ITT_BUILD_ARG(itt_sync_obj) );
-                break;
-            }
-            case bp_tree_bar: {
-                KMP_ASSERT(__kmp_barrier_release_branch_bits[bt]);
-                __kmp_tree_barrier_release(bt, this_thr, gtid, tid, FALSE
-                                           USE_ITT_BUILD_ARG(itt_sync_obj) );
-                break;
-            }
-            default: {
-                __kmp_linear_barrier_release(bt, this_thr, gtid, tid, FALSE
-                                             USE_ITT_BUILD_ARG(itt_sync_obj) );
-            }
-            }
+            __kmp_barrier_release_phase(bt, this_thr, gtid, tid
+                                        USE_ITT_BUILD_ARG(itt_sync_obj) );
             if (__kmp_tasking_mode != tskm_immediate_exec) {
                 __kmp_task_team_sync(this_thr, team);
             }
         }
+#if KMP_STATS_ENABLED
+        this_thr->th.th_stats_bar_depart = tsc_tick_count::now().getValue();
+#endif
 
 #if USE_ITT_BUILD
         /* GEH: TODO: Move this under if-condition above and also include in
@@ -1328,6 +1503,241 @@ __kmp_barrier(enum barrier_type bt, int gtid, int is_split, size_t reduce_size,
     return status;
 }
 
+/* Split-phase (fuzzy) team barrier.
+   __kmp_barrier_arrive() only signals the arrival of the thread, so that it may go on with work
+   that does not depend on the other threads; __kmp_barrier_wait() waits for the others and runs
+   the release half.  The arrival is linear whatever the gather pattern of bt: a worker bumps its
+   own b_arrived flag, and the master collects all of them in __kmp_barrier_wait(), which keeps
+   the per-thread barrier states the other patterns rely on.  Every thread of the team must call
+   both, in order, without encountering another barrier or worksharing construct in between. */
+void
+__kmp_barrier_arrive(enum barrier_type bt, int gtid)
+{
+    KMP_TIME_PARTITIONED_BLOCK(OMP_plain_barrier);
+    int tid = __kmp_tid_from_gtid(gtid);
+    kmp_info_t *this_thr = __kmp_threads[gtid];
+    kmp_team_t *team = this_thr->th.th_team;
+
+    KA_TRACE(15, ("__kmp_barrier_arrive: T#%d(%d:%d) has arrived\n", gtid, team->t.t_id, tid));
+    ANNOTATE_NEW_BARRIER_BEGIN(&team->t.t_bar);
+#if OMPT_SUPPORT && OMPT_BLAME
+    if (ompt_enabled && ompt_callbacks.ompt_callback(ompt_event_barrier_begin)) {
+        ompt_callbacks.ompt_callback(ompt_event_barrier_begin)(
+            team->t.ompt_team_info.parallel_id,
+            team->t.t_implicit_task_taskdata[tid].ompt_task_info.task_id);
+    }
+#endif
+    if (team->t.t_serialized)
+        return;
+
+#if USE_ITT_BUILD
+    void *itt_sync_obj = NULL;
+# if USE_ITT_NOTIFY
+    if (__itt_sync_create_ptr || KMP_ITT_DEBUG)
+        itt_sync_obj = __kmp_itt_barrier_object(gtid, bt, 1);
+# endif
+#endif /* USE_ITT_BUILD */
+    if (__kmp_tasking_mode == tskm_extra_barrier)
+        __kmp_tasking_barrier(team, this_thr, gtid);
+    if (__kmp_dflt_blocktime != KMP_MAX_BLOCKTIME) {
+#if KMP_USE_MONITOR
+        this_thr->th.th_team_bt_intervals = team->t.t_implicit_task_taskdata[tid].td_icvs.bt_intervals;
+#endif
+        this_thr->th.th_team_bt_set = team->t.t_implicit_task_taskdata[tid].td_icvs.bt_set;
+    }
+#if USE_ITT_BUILD
+    if (__itt_sync_create_ptr || KMP_ITT_DEBUG)
+        __kmp_itt_barrier_starting(gtid, itt_sync_obj);
+#endif /* USE_ITT_BUILD */
+#if USE_DEBUGGER
+    // Let the debugger know: the thread arrived to the barrier.
+    if (KMP_MASTER_TID(tid)) { // Master counter is stored in team structure.
+        team->t.t_bar[bt].b_master_arrived += 1;
+    } else {
+        this_thr->th.th_bar[bt].bb.b_worker_arrived += 1;
+    } // if
+#endif /* USE_DEBUGGER */
+    if (KMP_MASTER_TID(tid) && __kmp_tasking_mode != tskm_immediate_exec)
+        __kmp_task_team_setup(this_thr, team, 0);
+
+#if KMP_STATS_ENABLED
+    this_thr->th.th_stats_bar_arrive = tsc_tick_count::now().getValue();
+#endif
+    if (!KMP_MASTER_TID(tid)) {
+        // Mark arrival to the master thread, which waits for it in __kmp_barrier_wait()
+        __kmp_linear_barrier_gather(bt, this_thr, gtid, tid, NULL
+                                    USE_ITT_BUILD_ARG(itt_sync_obj) );
+    }
+    KA_TRACE(15, ("__kmp_barrier_arrive: T#%d(%d:%d) signalled arrival\n", gtid, team->t.t_id, tid));
+}
+
+void
+__kmp_barrier_wait(enum barrier_type bt, int gtid)
+{
+    KMP_TIME_PARTITIONED_BLOCK(OMP_plain_barrier);
+    KMP_SET_THREAD_STATE_BLOCK(PLAIN_BARRIER);
+    int tid = __kmp_tid_from_gtid(gtid);
+    kmp_info_t *this_thr = __kmp_threads[gtid];
+    kmp_team_t *team = this_thr->th.th_team;
+#if OMPT_SUPPORT && OMPT_BLAME
+    ompt_task_id_t my_task_id = team->t.t_implicit_task_taskdata[tid].ompt_task_info.task_id;
+    ompt_parallel_id_t my_parallel_id = team->t.ompt_team_info.parallel_id;
+#endif
+
+    KA_TRACE(15, ("__kmp_barrier_wait: T#%d(%d:%d) enter\n", gtid, team->t.t_id, tid));
+#if OMPT_SUPPORT
+    if (ompt_enabled)
+        this_thr->th.ompt_thread_info.state = ompt_state_wait_barrier;
+#endif
+
+    if (! team->t.t_serialized) {
+#if USE_ITT_BUILD
+        void *itt_sync_obj = NULL;
+# if USE_ITT_NOTIFY
+        if (__itt_sync_create_ptr || KMP_ITT_DEBUG)
+            itt_sync_obj = __kmp_itt_barrier_object(gtid, bt);
+# endif
+#endif /* USE_ITT_BUILD */
+        if (KMP_MASTER_TID(tid)) {
+            // Collect the workers; the flag waits execute tasks and sleep after the blocktime
+            __kmp_linear_barrier_gather(bt, this_thr, gtid, tid, NULL
+                                        USE_ITT_BUILD_ARG(itt_sync_obj) );
+            KMP_MB();
+#if KMP_STATS_ENABLED
+            __kmp_stats_barrier_gathered(this_thr, gtid, team, this_thr->th.th_ident, TRUE);
+#endif
+            if (__kmp_tasking_mode != tskm_immediate_exec)
+                __kmp_task_team_wait(this_thr, team
+                                     USE_ITT_BUILD_ARG(itt_sync_obj) );
+#if USE_DEBUGGER
+            // Let the debugger know: All threads are arrived and starting leaving the barrier.
+            team->t.t_bar[bt].b_team_arrived += 1;
+#endif
+        }
+#if USE_ITT_BUILD
+        if (__itt_sync_create_ptr || KMP_ITT_DEBUG)
+            __kmp_itt_barrier_middle(gtid, itt_sync_obj);
+#endif /* USE_ITT_BUILD */
+        __kmp_barrier_release_phase(bt, this_thr, gtid, tid
+                                    USE_ITT_BUILD_ARG(itt_sync_obj) );
+        if (__kmp_tasking_mode != tskm_immediate_exec)
+            __kmp_task_team_sync(this_thr, team);
+#if KMP_STATS_ENABLED
+        this_thr->th.th_stats_bar_depart = tsc_tick_count::now().getValue();
+#endif
+#if USE_ITT_BUILD
+        if (__itt_sync_create_ptr || KMP_ITT_DEBUG)
+            __kmp_itt_barrier_finished(gtid, itt_sync_obj);
+#endif /* USE_ITT_BUILD */
+    }
+    KA_TRACE(15, ("__kmp_barrier_wait: T#%d(%d:%d) is leaving\n", gtid, team->t.t_id, tid));
+
+#if OMPT_SUPPORT
+    if (ompt_enabled) {
+#if OMPT_BLAME
+        if (ompt_callbacks.ompt_callback(ompt_event_barrier_end)) {
+            ompt_callbacks.ompt_callback(ompt_event_barrier_end)(
+                my_parallel_id, my_task_id);
+        }
+#endif
+        this_thr->th.ompt_thread_info.state = ompt_state_work_parallel;
+    }
+#endif
+    ANNOTATE_NEW_BARRIER_END(&team->t.t_bar);
+}
+
+/* Named barriers: reusable counting barriers for a fixed number of arbitrary threads (e.g. a
+   subset of the team).  Every arrival takes a ticket; the ticket divided by the number of
+   threads is the phase, and the rest is the waiter slot of the thread in that phase.  Each
+   waiter waits on the flag of its own slot, so that it can go to sleep after the blocktime and
+   be woken up individually, and the slots alternate between two banks by the parity of the
+   phase: the threads released from one phase can go on to the next one while the last arriving
+   thread is still releasing the others. */
+void
+__kmp_init_named_barrier(kmp_user_barrier_t *bar, int count)
+{
+    KMP_DEBUG_ASSERT(bar != NULL);
+    bar->ub_arrived = 0;
+    bar->ub_count = (count > 0) ? count : 1;
+    bar->ub_waiters = (kmp_user_barrier_waiter_t *)
+                      __kmp_allocate(2 * bar->ub_count * sizeof(kmp_user_barrier_waiter_t));
+    KMP_MB();
+}
+
+void
+__kmp_destroy_named_barrier(kmp_user_barrier_t *bar)
+{
+    KMP_DEBUG_ASSERT(bar != NULL);
+    __kmp_free(bar->ub_waiters);
+    bar->ub_waiters = NULL;
+}
+
+// Returns the token of the waiter slot of the calling thread, to be passed to
+// __kmp_named_barrier_wait().
+kmp_uint32
+__kmp_named_barrier_arrive(kmp_user_barrier_t *bar)
+{
+    kmp_info_t *this_thr = __kmp_threads[__kmp_entry_gtid()];
+    kmp_uint64 ticket = KMP_TEST_THEN_INC64((volatile kmp_int64 *)&bar->ub_arrived);
+    kmp_uint64 phase = ticket / bar->ub_count;
+    kmp_uint32 slot = (kmp_uint32)(phase & 1) * bar->ub_count + (kmp_uint32)(ticket % bar->ub_count);
+    kmp_user_barrier_waiter_t *w = &bar->ub_waiters[slot];
+
+    // A slot of a bank is used once every other phase
+    w->checker = (kmp_uint32)((phase >> 1) + 1) * KMP_BARRIER_STATE_BUMP;
+    TCW_PTR(w->thr, this_thr);
+    if (ticket % bar->ub_count == (kmp_uint32)bar->ub_count - 1) {
+        // last arriver: release everybody in the phase, itself included
+        kmp_uint32 first = slot + 1 - bar->ub_count;
+        kmp_uint32 i;
+        KMP_MB();
+        for (i = first; i <= slot; ++i) {
+            kmp_user_barrier_waiter_t *wi = &bar->ub_waiters[i];
+            kmp_uint32 old = KMP_TEST_THEN_ADD4_32((volatile kmp_int32 *)&wi->go);
+            // The waiter stored itself before it could go to sleep, so it is known by now
+            if (old & KMP_BARRIER_SLEEP_STATE) {
+                kmp_flag_32 flag(&wi->go);
+                kmp_info_t *waiter = (kmp_info_t *)TCR_PTR(wi->thr);
+                __kmp_resume_32(waiter->th.th_info.ds.ds_gtid, &flag);
+            }
+        }
+    }
+    return slot;
+}
+
+void
+__kmp_named_barrier_wait(kmp_user_barrier_t *bar, kmp_uint32 slot)
+{
+    kmp_user_barrier_waiter_t *w = &bar->ub_waiters[slot];
+    if (TCR_4(w->go) == w->checker) {
+        KMP_MB();
+        return;
+    }
+
+    int gtid = __kmp_entry_gtid();
+    kmp_info_t *this_thr = __kmp_threads[gtid];
+    kmp_team_t *team = this_thr->th.th_team;
+    if (__kmp_dflt_blocktime != KMP_MAX_BLOCKTIME && team != NULL) {
+        int tid = __kmp_tid_from_gtid(gtid);
+#if KMP_USE_MONITOR
+        this_thr->th.th_team_bt_intervals = team->t.t_implicit_task_taskdata[tid].td_icvs.bt_intervals;
+#endif
+        this_thr->th.th_team_bt_set = team->t.t_implicit_task_taskdata[tid].td_icvs.bt_set;
+    }
+#if OMPT_SUPPORT
+    ompt_state_t ompt_state = this_thr->th.ompt_thread_info.state;
+    if (ompt_enabled)
+        this_thr->th.ompt_thread_info.state = ompt_state_wait_barrier;
+#endif
+    kmp_flag_32 flag(&w->go, w->checker);
+    flag.wait(this_thr, FALSE
+              USE_ITT_BUILD_ARG(NULL) );
+#if OMPT_SUPPORT
+    if (ompt_enabled)
+        this_thr->th.ompt_thread_info.state = ompt_state;
+#endif
+    KMP_MB();
+}
 
 void
 __kmp_end_split_barrier(enum barrier_type bt, int gtid)
@@ -1496,6 +1906,8 @@ __kmp_join_barrier(int gtid)
                                  USE_ITT_BUILD_ARG(itt_sync_obj) );
         }
 #if KMP_STATS_ENABLED
+        // Record the release latency of the last team barrier of the region.
+        __kmp_stats_barrier_gathered(this_thr, gtid, team, NULL, FALSE);
         // Have master thread flag the workers to indicate they are now waiting for
         // next parallel region, Also wake them up so they switch their timers to idle.
         for (int i=0; i<team->t.t_nproc; ++i) {
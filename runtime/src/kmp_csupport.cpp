@@ -410,6 +410,10 @@ __kmpc_fork_teams(ident_t *loc, kmp_int32 argc, kmpc_micro microtask, ...)
     KMP_DEBUG_ASSERT(this_thr->th.th_teams_size.nteams >= 1);
     KMP_DEBUG_ASSERT(this_thr->th.th_teams_size.nth >= 1);
 
+    // block counters of the dynamic distribute loops, shared by the teams of the league
+    if ( __kmp_dist_dynamic )
+        this_thr->th.th_dist_league = __kmp_dist_league_allocate();
+
     __kmp_fork_call( loc, gtid, fork_context_intel,
             argc,
 #if OMPT_SUPPORT
@@ -429,6 +433,10 @@ __kmpc_fork_teams(ident_t *loc, kmp_int32 argc, kmpc_micro microtask, ...)
 #endif
     );
 
+    if ( this_thr->th.th_dist_league != NULL ) {
+        __kmp_free( this_thr->th.th_dist_league );
+        this_thr->th.th_dist_league = NULL;
+    }
     this_thr->th.th_teams_microtask = NULL;
     this_thr->th.th_teams_level = 0;
     *(kmp_int64*)(&this_thr->th.th_teams_size) = 0L;
@@ -698,6 +706,53 @@ __kmpc_barrier(ident_t *loc, kmp_int32 global_tid)
 #endif
 }
 
+/*!
+@ingroup SYNCHRONIZATION
+@param loc source location information
+@param global_tid thread id.
+
+Signal arrival at a split-phase barrier of the current team. The thread may execute work that
+does not depend on the other threads before completing the barrier with __kmpc_barrier_wait().
+No other barrier or worksharing construct may be encountered in between.
+*/
+void
+__kmpc_barrier_arrive(ident_t *loc, kmp_int32 global_tid)
+{
+    KMP_COUNT_BLOCK(OMP_BARRIER);
+    KC_TRACE( 10, ("__kmpc_barrier_arrive: called T#%d\n", global_tid ) );
+
+    if (! TCR_4(__kmp_init_parallel))
+        __kmp_parallel_initialize();
+
+    if ( __kmp_env_consistency_check ) {
+        if ( loc == 0 ) {
+            KMP_WARNING( ConstructIdentInvalid );
+        }; // if
+
+        __kmp_check_barrier( global_tid, ct_barrier, loc );
+    }
+
+    __kmp_threads[ global_tid ]->th.th_ident = loc;
+    __kmp_barrier_arrive( bs_plain_barrier, global_tid );
+}
+
+/*!
+@ingroup SYNCHRONIZATION
+@param loc source location information
+@param global_tid thread id.
+
+Complete a split-phase barrier started with __kmpc_barrier_arrive(). Returns when all threads
+of the team have arrived.
+*/
+void
+__kmpc_barrier_wait(ident_t *loc, kmp_int32 global_tid)
+{
+    KC_TRACE( 10, ("__kmpc_barrier_wait: called T#%d\n", global_tid ) );
+
+    __kmp_threads[ global_tid ]->th.th_ident = loc;
+    __kmp_barrier_wait( bs_plain_barrier, global_tid );
+}
+
 /* The BARRIER for a MASTER section is always explicit   */
 /*!
 @ingroup WORK_SHARING
@@ -1164,6 +1219,8 @@ __kmp_map_hint_to_lock(uintptr_t hint)
         return KMP_CPUINFO_RTM ? KMP_TSX_LOCK(rtm): __kmp_user_lock_seq;
     if (hint & kmp_lock_hint_adaptive)
         return KMP_CPUINFO_RTM ? KMP_TSX_LOCK(adaptive): __kmp_user_lock_seq;
+    if (hint & kmp_lock_hint_combining)
+        return lockseq_combining;
 
     // Rule out conflicting hints first by returning the default lock
     if ((hint & omp_lock_hint_contended) && (hint & omp_lock_hint_uncontended))
@@ -1173,7 +1230,7 @@ __kmp_map_hint_to_lock(uintptr_t hint)
 
     // Do not even consider speculation when it appears to be contended
     if (hint & omp_lock_hint_contended)
-        return lockseq_queuing;
+        return __kmp_cohort_lock_spans_nodes() ? lockseq_cohort : lockseq_queuing;
 
     // Uncontended lock without speculation
     if ((hint & omp_lock_hint_uncontended) && !(hint & omp_lock_hint_speculative))
@@ -1186,6 +1243,18 @@ __kmp_map_hint_to_lock(uintptr_t hint)
     return __kmp_user_lock_seq;
 }
 
+// Converts the hint of a critical construct to an internal lock implementation
+static __forceinline kmp_dyna_lockseq_t
+__kmp_map_critical_hint_to_lock(uintptr_t hint)
+{
+#if KMP_USE_TSX
+    // KMP_CRITICAL_SPECULATION lets critical sections without a hint speculate
+    if (hint == omp_lock_hint_none && __kmp_critical_speculation && KMP_CPUINFO_RTM)
+        return lockseq_rtm;
+#endif
+    return __kmp_map_hint_to_lock(hint);
+}
+
 /*!
 @ingroup WORK_SHARING
 @param loc  source location information.
@@ -1209,7 +1278,7 @@ __kmpc_critical_with_hint( ident_t * loc, kmp_int32 global_tid, kmp_critical_nam
     kmp_dyna_lock_t *lk = (kmp_dyna_lock_t *)crit;
     // Check if it is initialized.
     if (*lk == 0) {
-        kmp_dyna_lockseq_t lckseq = __kmp_map_hint_to_lock(hint);
+        kmp_dyna_lockseq_t lckseq = __kmp_map_critical_hint_to_lock(hint);
         if (KMP_IS_D_LOCK(lckseq)) {
             KMP_COMPARE_AND_STORE_ACQ32((volatile kmp_int32 *)crit, 0, KMP_GET_D_TAG(lckseq));
         } else {
@@ -1221,17 +1290,17 @@ __kmpc_critical_with_hint( ident_t * loc, kmp_int32 global_tid, kmp_critical_nam
     if (KMP_EXTRACT_D_TAG(lk) != 0) {
         lck = (kmp_user_lock_p)lk;
         if (__kmp_env_consistency_check) {
-            __kmp_push_sync(global_tid, ct_critical, loc, lck, __kmp_map_hint_to_lock(hint));
+            __kmp_push_sync(global_tid, ct_critical, loc, lck, __kmp_map_critical_hint_to_lock(hint));
         }
 # if USE_ITT_BUILD
         __kmp_itt_critical_acquiring(lck);
 # endif
 # if KMP_USE_INLINED_TAS
-        if (__kmp_user_lock_seq == lockseq_tas && !__kmp_env_consistency_check) {
+        if (__kmp_user_lock_seq == lockseq_tas && !__kmp_env_consistency_check && !__kmp_lock_profile) {
             KMP_ACQUIRE_TAS_LOCK(lck, global_tid);
         } else
 # elif KMP_USE_INLINED_FUTEX
-        if (__kmp_user_lock_seq == lockseq_futex && !__kmp_env_consistency_check) {
+        if (__kmp_user_lock_seq == lockseq_futex && !__kmp_env_consistency_check && !__kmp_lock_profile) {
             KMP_ACQUIRE_FUTEX_LOCK(lck, global_tid);
         } else
 # endif
@@ -1242,12 +1311,19 @@ __kmpc_critical_with_hint( ident_t * loc, kmp_int32 global_tid, kmp_critical_nam
         kmp_indirect_lock_t *ilk = *((kmp_indirect_lock_t **)lk);
         lck = ilk->lock;
         if (__kmp_env_consistency_check) {
-            __kmp_push_sync(global_tid, ct_critical, loc, lck, __kmp_map_hint_to_lock(hint));
+            __kmp_push_sync(global_tid, ct_critical, loc, lck, __kmp_map_critical_hint_to_lock(hint));
         }
 # if USE_ITT_BUILD
         __kmp_itt_critical_acquiring(lck);
 # endif
-        KMP_I_LOCK_FUNC(ilk, set)(lck, global_tid);
+# if KMP_USE_TSX
+        if (ilk->type == locktag_rtm) {
+            __kmp_acquire_critical_speculative((kmp_queuing_lock_t *)lck, loc, global_tid);
+        } else
+# endif
+        {
+            KMP_I_LOCK_FUNC(ilk, set)(lck, global_tid);
+        }
     }
 
 #if USE_ITT_BUILD
@@ -1277,7 +1353,8 @@ __kmpc_end_critical(ident_t *loc, kmp_int32 global_tid, kmp_critical_name *crit)
     KC_TRACE( 10, ("__kmpc_end_critical: called T#%d\n", global_tid ));
 
 #if KMP_USE_DYNAMIC_LOCK
-    if (KMP_IS_D_LOCK(__kmp_user_lock_seq)) {
+    // The hint may have chosen a lock of another kind than the default one
+    if (KMP_EXTRACT_D_TAG(crit) != 0) {
         lck = (kmp_user_lock_p)crit;
         KMP_ASSERT(lck != NULL);
         if (__kmp_env_consistency_check) {
@@ -1287,11 +1364,11 @@ __kmpc_end_critical(ident_t *loc, kmp_int32 global_tid, kmp_critical_name *crit)
         __kmp_itt_critical_releasing( lck );
 # endif
 # if KMP_USE_INLINED_TAS
-        if (__kmp_user_lock_seq == lockseq_tas && !__kmp_env_consistency_check) {
+        if (__kmp_user_lock_seq == lockseq_tas && !__kmp_env_consistency_check && !__kmp_lock_profile) {
             KMP_RELEASE_TAS_LOCK(lck, global_tid);
         } else
 # elif KMP_USE_INLINED_FUTEX
-        if (__kmp_user_lock_seq == lockseq_futex && !__kmp_env_consistency_check) {
+        if (__kmp_user_lock_seq == lockseq_futex && !__kmp_env_consistency_check && !__kmp_lock_profile) {
             KMP_RELEASE_FUTEX_LOCK(lck, global_tid);
         } else
 # endif
@@ -1308,7 +1385,14 @@ __kmpc_end_critical(ident_t *loc, kmp_int32 global_tid, kmp_critical_name *crit)
 # if USE_ITT_BUILD
         __kmp_itt_critical_releasing( lck );
 # endif
-        KMP_I_LOCK_FUNC(ilk, unset)(lck, global_tid);
+# if KMP_USE_TSX
+        if (ilk->type == locktag_rtm) {
+            __kmp_release_critical_speculative((kmp_queuing_lock_t *)lck, global_tid);
+        } else
+# endif
+        {
+            KMP_I_LOCK_FUNC(ilk, unset)(lck, global_tid);
+        }
     }
 
 #else // KMP_USE_DYNAMIC_LOCK
@@ -1351,6 +1435,54 @@ __kmpc_end_critical(ident_t *loc, kmp_int32 global_tid, kmp_critical_name *crit)
     KA_TRACE( 15, ("__kmpc_end_critical: done T#%d\n", global_tid ));
 }
 
+/*!
+@ingroup WORK_SHARING
+@param loc  source location information.
+@param global_tid  global thread number.
+@param crit identity of the critical section.
+@param hint the lock hint.
+@param body outlined body of the critical section.
+@param data argument of the body.
+
+Execute `body(data)` as the body of a `critical` construct with a hint. With kmp_lock_hint_combining the threads
+that wait for the critical section publish their bodies, and the thread that holds the lock executes them in a
+batch, so the body may run on a different thread than the one that called this function. Otherwise this is
+__kmpc_critical_with_hint, the body and __kmpc_end_critical.
+*/
+void
+__kmpc_critical_combine( ident_t * loc, kmp_int32 global_tid, kmp_critical_name * crit, uintptr_t hint,
+                         void (*body)( void * ), void * data )
+{
+#if KMP_USE_DYNAMIC_LOCK
+    kmp_dyna_lock_t *lk = (kmp_dyna_lock_t *)crit;
+
+    KC_TRACE( 10, ("__kmpc_critical_combine: called T#%d\n", global_tid ) );
+
+    if (*lk == 0) {
+        kmp_dyna_lockseq_t lckseq = __kmp_map_hint_to_lock(hint);
+        if (KMP_IS_D_LOCK(lckseq)) {
+            KMP_COMPARE_AND_STORE_ACQ32((volatile kmp_int32 *)crit, 0, KMP_GET_D_TAG(lckseq));
+        } else {
+            __kmp_init_indirect_csptr(crit, loc, global_tid, KMP_GET_I_TAG(lckseq));
+        }
+    }
+    if (KMP_EXTRACT_D_TAG(lk) == 0 && !__kmp_env_consistency_check) {
+        kmp_indirect_lock_t *ilk = *((kmp_indirect_lock_t **)lk);
+        if (ilk->type == locktag_combining) {
+            KMP_COUNT_BLOCK(OMP_CRITICAL);
+            __kmp_combine_critical((kmp_combining_lock_t *)ilk->lock, global_tid, body, data);
+            KA_TRACE( 15, ("__kmpc_critical_combine: done T#%d\n", global_tid ));
+            return;
+        }
+    }
+    __kmpc_critical_with_hint(loc, global_tid, crit, hint);
+#else
+    __kmpc_critical(loc, global_tid, crit);
+#endif // KMP_USE_DYNAMIC_LOCK
+    body(data);
+    __kmpc_end_critical(loc, global_tid, crit);
+}
+
 /*!
 @ingroup SYNCHRONIZATION
 @param loc source location information
@@ -1824,8 +1956,9 @@ __kmp_init_lock_with_hint(ident_t *loc, void **lock, kmp_dyna_lockseq_t seq)
 #endif
     } else {
         KMP_INIT_I_LOCK(lock, seq);
-#if USE_ITT_BUILD
         kmp_indirect_lock_t *ilk = KMP_LOOKUP_I_LOCK(lock);
+        KMP_SET_I_LOCK_LOCATION(ilk, loc);
+#if USE_ITT_BUILD
         __kmp_itt_lock_creating(ilk->lock, loc);
 #endif
     }
@@ -1862,8 +1995,9 @@ __kmp_init_nest_lock_with_hint(ident_t *loc, void **lock, kmp_dyna_lockseq_t seq
             seq = lockseq_nested_queuing;
     }
     KMP_INIT_I_LOCK(lock, seq);
-#if USE_ITT_BUILD
     kmp_indirect_lock_t *ilk = KMP_LOOKUP_I_LOCK(lock);
+    KMP_SET_I_LOCK_LOCATION(ilk, loc);
+#if USE_ITT_BUILD
     __kmp_itt_lock_creating(ilk->lock, loc);
 #endif
 }
@@ -2133,11 +2267,11 @@ __kmpc_set_lock( ident_t * loc, kmp_int32 gtid, void ** user_lock ) {
    __kmp_itt_lock_acquiring((kmp_user_lock_p)user_lock); // itt function will get to the right lock object.
 # endif
 # if KMP_USE_INLINED_TAS
-    if (tag == locktag_tas && !__kmp_env_consistency_check) {
+    if (tag == locktag_tas && !__kmp_env_consistency_check && !__kmp_lock_profile) {
         KMP_ACQUIRE_TAS_LOCK(user_lock, gtid);
     } else
 # elif KMP_USE_INLINED_FUTEX
-    if (tag == locktag_futex && !__kmp_env_consistency_check) {
+    if (tag == locktag_futex && !__kmp_env_consistency_check && !__kmp_lock_profile) {
         KMP_ACQUIRE_FUTEX_LOCK(user_lock, gtid);
     } else
 # endif
@@ -2258,11 +2392,11 @@ __kmpc_unset_lock( ident_t *loc, kmp_int32 gtid, void **user_lock )
     __kmp_itt_lock_releasing((kmp_user_lock_p)user_lock);
 # endif
 # if KMP_USE_INLINED_TAS
-    if (tag == locktag_tas && !__kmp_env_consistency_check) {
+    if (tag == locktag_tas && !__kmp_env_consistency_check && !__kmp_lock_profile) {
         KMP_RELEASE_TAS_LOCK(user_lock, gtid);
     } else
 # elif KMP_USE_INLINED_FUTEX
-    if (tag == locktag_futex && !__kmp_env_consistency_check) {
+    if (tag == locktag_futex && !__kmp_env_consistency_check && !__kmp_lock_profile) {
         KMP_RELEASE_FUTEX_LOCK(user_lock, gtid);
     } else
 # endif
@@ -2398,11 +2532,11 @@ __kmpc_test_lock( ident_t *loc, kmp_int32 gtid, void **user_lock )
     __kmp_itt_lock_acquiring((kmp_user_lock_p)user_lock);
 # endif
 # if KMP_USE_INLINED_TAS
-    if (tag == locktag_tas && !__kmp_env_consistency_check) {
+    if (tag == locktag_tas && !__kmp_env_consistency_check && !__kmp_lock_profile) {
         KMP_TEST_TAS_LOCK(user_lock, gtid, rc);
     } else
 # elif KMP_USE_INLINED_FUTEX
-    if (tag == locktag_futex && !__kmp_env_consistency_check) {
+    if (tag == locktag_futex && !__kmp_env_consistency_check && !__kmp_lock_profile) {
         KMP_TEST_FUTEX_LOCK(user_lock, gtid, rc);
     } else
 # endif
@@ -2517,6 +2651,216 @@ __kmpc_test_nest_lock( ident_t *loc, kmp_int32 gtid, void **user_lock )
 #endif // KMP_USE_DYNAMIC_LOCK
 }
 
+#if KMP_USE_DYNAMIC_LOCK
+
+/*
+ * Reader-writer locks.  A kmp_rw_lock_t holds an indirect lock of the rw kind, so the lock
+ * table, ITT and the generic lock operations (which take it for writing) treat it as any
+ * other user lock; the read side goes straight to the lock object.
+ */
+
+static __forceinline kmp_rwlock_t *
+__kmp_lookup_rw_lock( void **user_lock, char const *func )
+{
+    kmp_indirect_lock_t *ilk;
+    if ( __kmp_env_consistency_check ) {
+        if ( user_lock == NULL || KMP_EXTRACT_D_TAG(user_lock) != 0 ) {
+            KMP_FATAL( LockIsUninitialized, func );
+        }
+        ilk = KMP_LOOKUP_I_LOCK(user_lock);
+        if ( ilk == NULL || ilk->type != locktag_rw
+          || ((kmp_rwlock_t *)ilk->lock)->lk.initialized != (kmp_rwlock_t *)ilk->lock ) {
+            KMP_FATAL( LockIsUninitialized, func );
+        }
+    } else {
+        ilk = KMP_LOOKUP_I_LOCK(user_lock);
+    }
+    return (kmp_rwlock_t *)ilk->lock;
+}
+
+void
+__kmpc_rw_lock_init( ident_t *loc, kmp_int32 gtid, void **user_lock )
+{
+    KMP_DEBUG_ASSERT(__kmp_init_serial);
+    if (__kmp_env_consistency_check && user_lock == NULL) {
+        KMP_FATAL(LockIsUninitialized, "kmp_rw_lock_init");
+    }
+    __kmp_init_lock_with_hint(loc, user_lock, lockseq_rw);
+
+#if OMPT_SUPPORT && OMPT_TRACE
+    if (ompt_enabled &&
+        ompt_callbacks.ompt_callback(ompt_event_init_lock)) {
+        ompt_callbacks.ompt_callback(ompt_event_init_lock)((uint64_t) __kmp_lookup_rw_lock(user_lock, "kmp_rw_lock_init"));
+    }
+#endif
+}
+
+void
+__kmpc_rw_lock_destroy( ident_t *loc, kmp_int32 gtid, void **user_lock )
+{
+    kmp_rwlock_t *lck = __kmp_lookup_rw_lock(user_lock, "kmp_rw_lock_destroy");
+
+#if OMPT_SUPPORT && OMPT_TRACE
+    if (ompt_enabled &&
+        ompt_callbacks.ompt_callback(ompt_event_destroy_lock)) {
+        ompt_callbacks.ompt_callback(ompt_event_destroy_lock)((uint64_t) lck);
+    }
+#endif
+#if USE_ITT_BUILD
+    __kmp_itt_lock_destroyed((kmp_user_lock_p)lck);
+#endif
+    KMP_D_LOCK_FUNC(user_lock, destroy)((kmp_dyna_lock_t *)user_lock);
+}
+
+void
+__kmpc_rw_lock_rdlock( ident_t *loc, kmp_int32 gtid, void **user_lock )
+{
+    kmp_rwlock_t *lck = __kmp_lookup_rw_lock(user_lock, "kmp_rw_lock_rdlock");
+
+#if USE_ITT_BUILD
+    __kmp_itt_lock_acquiring((kmp_user_lock_p)user_lock);
+#endif
+    __kmp_acquire_rw_lock_read(lck, gtid);
+#if USE_ITT_BUILD
+    __kmp_itt_lock_acquired((kmp_user_lock_p)user_lock);
+#endif
+
+#if OMPT_SUPPORT && OMPT_TRACE
+    if (ompt_enabled &&
+        ompt_callbacks.ompt_callback(ompt_event_acquired_lock)) {
+        ompt_callbacks.ompt_callback(ompt_event_acquired_lock)((uint64_t) lck);
+    }
+#endif
+}
+
+void
+__kmpc_rw_lock_wrlock( ident_t *loc, kmp_int32 gtid, void **user_lock )
+{
+    kmp_rwlock_t *lck = __kmp_lookup_rw_lock(user_lock, "kmp_rw_lock_wrlock");
+
+#if USE_ITT_BUILD
+    __kmp_itt_lock_acquiring((kmp_user_lock_p)user_lock);
+#endif
+    KMP_D_LOCK_FUNC(user_lock, set)((kmp_dyna_lock_t *)user_lock, gtid);
+#if USE_ITT_BUILD
+    __kmp_itt_lock_acquired((kmp_user_lock_p)user_lock);
+#endif
+
+#if OMPT_SUPPORT && OMPT_TRACE
+    if (ompt_enabled &&
+        ompt_callbacks.ompt_callback(ompt_event_acquired_lock)) {
+        ompt_callbacks.ompt_callback(ompt_event_acquired_lock)((uint64_t) lck);
+    }
+#endif
+}
+
+/* release the lock held for reading or for writing by the calling thread */
+void
+__kmpc_rw_lock_unlock( ident_t *loc, kmp_int32 gtid, void **user_lock )
+{
+    kmp_rwlock_t *lck = __kmp_lookup_rw_lock(user_lock, "kmp_rw_lock_unlock");
+
+#if USE_ITT_BUILD
+    __kmp_itt_lock_releasing((kmp_user_lock_p)user_lock);
+#endif
+    KMP_D_LOCK_FUNC(user_lock, unset)((kmp_dyna_lock_t *)user_lock, gtid);
+
+#if OMPT_SUPPORT && OMPT_BLAME
+    if (ompt_enabled &&
+        ompt_callbacks.ompt_callback(ompt_event_release_lock)) {
+        ompt_callbacks.ompt_callback(ompt_event_release_lock)((uint64_t) lck);
+    }
+#endif
+}
+
+int
+__kmpc_rw_lock_tryrdlock( ident_t *loc, kmp_int32 gtid, void **user_lock )
+{
+    kmp_rwlock_t *lck = __kmp_lookup_rw_lock(user_lock, "kmp_rw_lock_tryrdlock");
+    int rc;
+
+#if USE_ITT_BUILD
+    __kmp_itt_lock_acquiring((kmp_user_lock_p)user_lock);
+#endif
+    rc = __kmp_test_rw_lock_read(lck, gtid);
+#if USE_ITT_BUILD
+    if (rc) {
+        __kmp_itt_lock_acquired((kmp_user_lock_p)user_lock);
+    } else {
+        __kmp_itt_lock_cancelled((kmp_user_lock_p)user_lock);
+    }
+#endif
+
+#if OMPT_SUPPORT && OMPT_TRACE
+    if (rc && ompt_enabled &&
+        ompt_callbacks.ompt_callback(ompt_event_acquired_lock)) {
+        ompt_callbacks.ompt_callback(ompt_event_acquired_lock)((uint64_t) lck);
+    }
+#endif
+    return rc ? FTN_TRUE : FTN_FALSE;
+}
+
+int
+__kmpc_rw_lock_trywrlock( ident_t *loc, kmp_int32 gtid, void **user_lock )
+{
+    kmp_rwlock_t *lck = __kmp_lookup_rw_lock(user_lock, "kmp_rw_lock_trywrlock");
+    int rc;
+
+#if USE_ITT_BUILD
+    __kmp_itt_lock_acquiring((kmp_user_lock_p)user_lock);
+#endif
+    rc = KMP_D_LOCK_FUNC(user_lock, test)((kmp_dyna_lock_t *)user_lock, gtid);
+#if USE_ITT_BUILD
+    if (rc) {
+        __kmp_itt_lock_acquired((kmp_user_lock_p)user_lock);
+    } else {
+        __kmp_itt_lock_cancelled((kmp_user_lock_p)user_lock);
+    }
+#endif
+
+#if OMPT_SUPPORT && OMPT_TRACE
+    if (rc && ompt_enabled &&
+        ompt_callbacks.ompt_callback(ompt_event_acquired_lock)) {
+        ompt_callbacks.ompt_callback(ompt_event_acquired_lock)((uint64_t) lck);
+    }
+#endif
+    return rc ? FTN_TRUE : FTN_FALSE;
+}
+
+/*!
+Prints the KMP_LOCK_PROFILE figures of the locks and critical sections acquired so far to
+stderr, the longest total wait first.  Does nothing unless KMP_LOCK_PROFILE is set.
+*/
+void
+__kmpc_lock_profile_report( void )
+{
+    if ( __kmp_lock_profile )
+        __kmp_lock_profile_print( stderr );
+}
+
+/*!
+Clears the KMP_LOCK_PROFILE figures, for instance between the phases of a program.
+*/
+void
+__kmpc_lock_profile_reset( void )
+{
+    __kmp_lock_profile_reset();
+}
+
+/*!
+Prints the commits and aborts of the speculating critical sections entered so far to stderr,
+per construct.  Does nothing without KMP_CRITICAL_SPECULATION or RTM support.
+*/
+void
+__kmpc_critical_speculation_report( void )
+{
+#if KMP_USE_TSX
+    __kmp_critical_speculation_print( stderr );
+#endif
+}
+
+#endif // KMP_USE_DYNAMIC_LOCK
+
 
 /*--------------------------------------------------------------------------------------------------------------------*/
 
@@ -2638,28 +2982,17 @@ __kmp_end_critical_section_reduce_block( ident_t * loc, kmp_int32 global_tid, km
 
 
 /* 2.a.i. Reduce Block without a terminating barrier */
-/*!
-@ingroup SYNCHRONIZATION
-@param loc source location information
-@param global_tid global thread number
-@param num_vars number of items (variables) to be reduced
-@param reduce_size size of data in bytes to be reduced
-@param reduce_data pointer to data to be reduced
-@param reduce_func callback function providing reduction operation on two operands and returning result of reduction in lhs_data
-@param lck pointer to the unique lock data structure
-@result 1 for the master thread, 0 for all other team threads, 2 for all team threads if atomic reduction needed
 
-The nowait version is used for a reduce clause with the nowait argument.
-*/
-kmp_int32
-__kmpc_reduce_nowait(
+// Body of __kmpc_reduce_nowait(); packed_reduction_method is reduction_method_not_defined unless the
+// caller has already determined it.
+static kmp_int32
+__kmp_reduce_nowait_block(
     ident_t *loc, kmp_int32 global_tid,
     kmp_int32 num_vars, size_t reduce_size, void *reduce_data, void (*reduce_func)(void *lhs_data, void *rhs_data),
-    kmp_critical_name *lck ) {
+    kmp_critical_name *lck, PACKED_REDUCTION_METHOD_T packed_reduction_method ) {
 
     KMP_COUNT_BLOCK(REDUCE_nowait);
     int retval = 0;
-    PACKED_REDUCTION_METHOD_T packed_reduction_method;
 #if OMP_40_ENABLED
     kmp_team_t *team;
     kmp_info_t *th;
@@ -2712,7 +3045,8 @@ __kmpc_reduce_nowait(
     // a thread-specific "th_local.reduction_method" variable is used currently
     // each thread executes 'determine' and 'set' lines (no need to execute by one thread, to avoid unness extra syncs)
 
-    packed_reduction_method = __kmp_determine_reduction_method( loc, global_tid, num_vars, reduce_size, reduce_data, reduce_func, lck );
+    if ( packed_reduction_method == reduction_method_not_defined )
+        packed_reduction_method = __kmp_determine_reduction_method( loc, global_tid, num_vars, reduce_size, reduce_data, reduce_func, lck );
     __KMP_SET_REDUCTION_METHOD( global_tid, packed_reduction_method );
 
     if( packed_reduction_method == critical_reduce_block ) {
@@ -2782,6 +3116,29 @@ __kmpc_reduce_nowait(
     return retval;
 }
 
+/*!
+@ingroup SYNCHRONIZATION
+@param loc source location information
+@param global_tid global thread number
+@param num_vars number of items (variables) to be reduced
+@param reduce_size size of data in bytes to be reduced
+@param reduce_data pointer to data to be reduced
+@param reduce_func callback function providing reduction operation on two operands and returning result of reduction in lhs_data
+@param lck pointer to the unique lock data structure
+@result 1 for the master thread, 0 for all other team threads, 2 for all team threads if atomic reduction needed
+
+The nowait version is used for a reduce clause with the nowait argument.
+*/
+kmp_int32
+__kmpc_reduce_nowait(
+    ident_t *loc, kmp_int32 global_tid,
+    kmp_int32 num_vars, size_t reduce_size, void *reduce_data, void (*reduce_func)(void *lhs_data, void *rhs_data),
+    kmp_critical_name *lck ) {
+
+    return __kmp_reduce_nowait_block( loc, global_tid, num_vars, reduce_size, reduce_data, reduce_func, lck,
+                                      reduction_method_not_defined );
+}
+
 // Interface that also supports array reduction. Currently defaults to use the
 // version that does not do any array reduction.
 kmp_int32
@@ -2848,29 +3205,17 @@ __kmpc_end_reduce_nowait( ident_t *loc, kmp_int32 global_tid, kmp_critical_name
 
 /* 2.a.ii. Reduce Block with a terminating barrier */
 
-/*!
-@ingroup SYNCHRONIZATION
-@param loc source location information
-@param global_tid global thread number
-@param num_vars number of items (variables) to be reduced
-@param reduce_size size of data in bytes to be reduced
-@param reduce_data pointer to data to be reduced
-@param reduce_func callback function providing reduction operation on two operands and returning result of reduction in lhs_data
-@param lck pointer to the unique lock data structure
-@result 1 for the master thread, 0 for all other team threads, 2 for all team threads if atomic reduction needed
-
-A blocking reduce that includes an implicit barrier.
-*/
-kmp_int32
-__kmpc_reduce(
+// Body of __kmpc_reduce(); packed_reduction_method is reduction_method_not_defined unless the
+// caller has already determined it.
+static kmp_int32
+__kmp_reduce_block(
     ident_t *loc, kmp_int32 global_tid,
     kmp_int32 num_vars, size_t reduce_size, void *reduce_data,
     void (*reduce_func)(void *lhs_data, void *rhs_data),
-    kmp_critical_name *lck )
+    kmp_critical_name *lck, PACKED_REDUCTION_METHOD_T packed_reduction_method )
 {
     KMP_COUNT_BLOCK(REDUCE_wait);
     int retval = 0;
-    PACKED_REDUCTION_METHOD_T packed_reduction_method;
 
     KA_TRACE( 10, ( "__kmpc_reduce() enter: called T#%d\n", global_tid ) );
 
@@ -2891,7 +3236,8 @@ __kmpc_reduce(
         __kmp_push_sync( global_tid, ct_reduce, loc, NULL );
 #endif
 
-    packed_reduction_method = __kmp_determine_reduction_method( loc, global_tid, num_vars, reduce_size, reduce_data, reduce_func, lck );
+    if ( packed_reduction_method == reduction_method_not_defined )
+        packed_reduction_method = __kmp_determine_reduction_method( loc, global_tid, num_vars, reduce_size, reduce_data, reduce_func, lck );
     __KMP_SET_REDUCTION_METHOD( global_tid, packed_reduction_method );
 
     if( packed_reduction_method == critical_reduce_block ) {
@@ -2939,6 +3285,29 @@ __kmpc_reduce(
     return retval;
 }
 
+/*!
+@ingroup SYNCHRONIZATION
+@param loc source location information
+@param global_tid global thread number
+@param num_vars number of items (variables) to be reduced
+@param reduce_size size of data in bytes to be reduced
+@param reduce_data pointer to data to be reduced
+@param reduce_func callback function providing reduction operation on two operands and returning result of reduction in lhs_data
+@param lck pointer to the unique lock data structure
+@result 1 for the master thread, 0 for all other team threads, 2 for all team threads if atomic reduction needed
+
+A blocking reduce that includes an implicit barrier.
+*/
+kmp_int32
+__kmpc_reduce(
+    ident_t *loc, kmp_int32 global_tid,
+    kmp_int32 num_vars, size_t reduce_size, void *reduce_data,
+    void (*reduce_func)(void *lhs_data, void *rhs_data),
+    kmp_critical_name *lck )
+{
+    return __kmp_reduce_block( loc, global_tid, num_vars, reduce_size, reduce_data, reduce_func, lck,
+                               reduction_method_not_defined );
+}
 
 // Interface that also supports array reduction. Currently defaults to use the
 // version that does not do any array reduction.
@@ -3022,6 +3391,298 @@ __kmpc_end_reduce( ident_t *loc, kmp_int32 global_tid, kmp_critical_name *lck )
     return;
 }
 
+/* 2.a.iii. Reduce Blocks with a typed reduction descriptor */
+
+// Body of __kmpc_reduce_typed() and __kmpc_reduce_nowait_typed(); packed_reduction_method as for
+// __kmp_reduce_block().
+static kmp_int32
+__kmp_reduce_typed_block(
+    ident_t *loc, kmp_int32 global_tid, int nowait,
+    kmp_int32 num_vars, size_t reduce_size, void *reduce_data, const kmp_reduction_item_t *reduce_desc,
+    void (*reduce_func)(void *lhs_data, void *rhs_data),
+    kmp_critical_name *lck, PACKED_REDUCTION_METHOD_T packed_reduction_method ) {
+
+    kmp_info_t *th = __kmp_threads[ global_tid ];
+    kmp_int32 retval;
+
+    if ( __kmp_reduction_desc_supported( reduce_desc, num_vars ) ) {
+        th->th.th_local.reduce_desc = reduce_desc;
+        th->th.th_local.reduce_num_vars = num_vars;
+    }
+    if ( nowait )
+        retval = __kmp_reduce_nowait_block( loc, global_tid, num_vars, reduce_size, reduce_data, reduce_func, lck,
+                                            packed_reduction_method );
+    else
+        retval = __kmp_reduce_block( loc, global_tid, num_vars, reduce_size, reduce_data, reduce_func, lck,
+                                     packed_reduction_method );
+    th->th.th_local.reduce_desc = NULL;
+    return retval;
+}
+
+/*!
+@ingroup SYNCHRONIZATION
+@param loc source location information
+@param global_tid global thread number
+@param num_vars number of items (variables) to be reduced
+@param reduce_size size of data in bytes to be reduced
+@param reduce_data pointer to data to be reduced (an array of num_vars pointers to the variables)
+@param reduce_desc array of num_vars descriptors giving the operation, element type and element count of each variable
+@param reduce_func callback function providing reduction operation on two operands and returning result of reduction in lhs_data
+@param lck pointer to the unique lock data structure
+@result 1 for the master thread, 0 for all other team threads, 2 for all team threads if atomic reduction needed
+
+Same as __kmpc_reduce_nowait(), but if the tree reduction method is selected and every item of
+<tt>reduce_desc</tt> is supported, the barrier gather combines the data with typed kernels instead of
+calling <tt>reduce_func</tt> once per tree edge. <tt>reduce_func</tt> must still be supplied; it is used
+when <tt>reduce_desc</tt> is NULL or not supported. The block is finished with __kmpc_end_reduce_nowait().
+*/
+kmp_int32
+__kmpc_reduce_nowait_typed(
+    ident_t *loc, kmp_int32 global_tid,
+    kmp_int32 num_vars, size_t reduce_size, void *reduce_data, const kmp_reduction_item_t *reduce_desc,
+    void (*reduce_func)(void *lhs_data, void *rhs_data),
+    kmp_critical_name *lck ) {
+
+    return __kmp_reduce_typed_block( loc, global_tid, TRUE, num_vars, reduce_size, reduce_data, reduce_desc,
+                                     reduce_func, lck, reduction_method_not_defined );
+}
+
+/*!
+@ingroup SYNCHRONIZATION
+@param loc source location information
+@param global_tid global thread number
+@param num_vars number of items (variables) to be reduced
+@param reduce_size size of data in bytes to be reduced
+@param reduce_data pointer to data to be reduced (an array of num_vars pointers to the variables)
+@param reduce_desc array of num_vars descriptors giving the operation, element type and element count of each variable
+@param reduce_func callback function providing reduction operation on two operands and returning result of reduction in lhs_data
+@param lck pointer to the unique lock data structure
+@result 1 for the master thread, 0 for all other team threads, 2 for all team threads if atomic reduction needed
+
+Blocking version of __kmpc_reduce_nowait_typed(). The block is finished with __kmpc_end_reduce().
+*/
+kmp_int32
+__kmpc_reduce_typed(
+    ident_t *loc, kmp_int32 global_tid,
+    kmp_int32 num_vars, size_t reduce_size, void *reduce_data, const kmp_reduction_item_t *reduce_desc,
+    void (*reduce_func)(void *lhs_data, void *rhs_data),
+    kmp_critical_name *lck ) {
+
+    return __kmp_reduce_typed_block( loc, global_tid, FALSE, num_vars, reduce_size, reduce_data, reduce_desc,
+                                     reduce_func, lck, reduction_method_not_defined );
+}
+
+/* 2.a.iv. Reduce Blocks for arrays with a typed reduction descriptor */
+
+// Array reductions: the team reduces the private copies with a reduce-scatter instead of the
+// barrier tree. After a barrier publishes every thread's reduce list, thread tid combines slice
+// tid of each variable from all the private copies into the master's copy, so the work and the
+// memory traffic are spread over the team. A second barrier keeps the private copies alive until
+// all slices are done.
+
+// Returns TRUE if the reduce-scatter should be used for the given descriptor.
+static int
+__kmp_array_reduce_applicable( kmp_int32 global_tid, kmp_int32 num_vars, const kmp_reduction_item_t *desc ) {
+
+    kmp_info_t *th = __kmp_threads[ global_tid ];
+    kmp_team_t *team = th->th.th_team;
+    size_t max_bytes = 0;
+    kmp_int32 i;
+
+    if ( team->t.t_serialized || team->t.t_nproc == 1 )
+        return FALSE;
+#if OMP_40_ENABLED
+    if ( th->th.th_teams_microtask && team->t.t_level == th->th.th_teams_level )
+        return FALSE; // reduction at teams construct goes through the regular path
+#endif
+    if ( ! __kmp_reduction_desc_supported( desc, num_vars ) )
+        return FALSE;
+    for ( i = 0; i < num_vars; ++i ) {
+        size_t bytes = desc[ i ].count * __kmp_reduction_elem_size( desc[ i ].elem );
+        if ( bytes > max_bytes )
+            max_bytes = bytes;
+    }
+    // small arrays are cheaper to reduce through the barrier tree
+    return max_bytes >= (size_t)team->t.t_nproc * CACHE_LINE;
+}
+
+// The reduce-scatter only stands in for the tree gather: the method is chosen the same way as for
+// __kmpc_reduce(), so KMP_FORCE_REDUCTION and the critical/atomic choices for small teams are kept.
+// Returns reduction_method_not_defined if the descriptor does not qualify; the regular path
+// determines the method itself then.
+static PACKED_REDUCTION_METHOD_T
+__kmp_array_reduce_method( ident_t *loc, kmp_int32 global_tid, kmp_int32 num_vars, size_t reduce_size,
+                           void *reduce_data, const kmp_reduction_item_t *desc,
+                           void (*reduce_func)(void *lhs_data, void *rhs_data), kmp_critical_name *lck ) {
+
+    if ( desc == NULL || ! __kmp_array_reduce_applicable( global_tid, num_vars, desc ) )
+        return reduction_method_not_defined;
+    return __kmp_determine_reduction_method( loc, global_tid, num_vars, reduce_size, reduce_data, reduce_func, lck );
+}
+
+static void
+__kmp_array_reduce_scatter( ident_t *loc, kmp_int32 global_tid, kmp_int32 num_vars,
+                            void *reduce_data, const kmp_reduction_item_t *desc ) {
+
+    kmp_info_t *th = __kmp_threads[ global_tid ];
+    kmp_team_t *team = th->th.th_team;
+    kmp_info_t **other_threads = team->t.t_threads;
+    int tid = __kmp_tid_from_gtid( global_tid );
+    int nproc = team->t.t_nproc;
+    void **master_data;
+    kmp_int32 i;
+    int j;
+
+    th->th.th_local.reduce_data = reduce_data;
+#if USE_ITT_NOTIFY
+    th->th.th_ident = loc;
+#endif
+    __kmp_barrier( bs_plain_barrier, global_tid, FALSE, 0, NULL, NULL );
+
+    master_data = (void **)other_threads[ 0 ]->th.th_local.reduce_data;
+    for ( i = 0; i < num_vars; ++i ) {
+        size_t count = desc[ i ].count;
+        size_t esize = __kmp_reduction_elem_size( desc[ i ].elem );
+        size_t align = ( esize < CACHE_LINE ) ? CACHE_LINE / esize : 1;
+        // slices start on cache line boundaries (relative to the array start) to avoid false sharing
+        size_t chunk = ( count + nproc - 1 ) / nproc;
+        size_t first, len;
+        chunk = ( chunk + align - 1 ) / align * align;
+        first = (size_t)tid * chunk;
+        if ( first >= count )
+            continue;
+        len = ( count - first < chunk ) ? count - first : chunk;
+        KA_TRACE( 20, ( "__kmp_array_reduce_scatter: T#%d var %d elements [%llu, %llu)\n", global_tid, i,
+                        (unsigned long long)first, (unsigned long long)( first + len ) ) );
+        for ( j = 1; j < nproc; ++j ) {
+            void **rhs_data = (void **)other_threads[ j ]->th.th_local.reduce_data;
+            __kmp_reduce_typed_slice( &desc[ i ], master_data[ i ], rhs_data[ i ], first, len );
+        }
+    }
+}
+
+/*!
+@ingroup SYNCHRONIZATION
+@param loc source location information
+@param global_tid global thread number
+@param num_vars number of items (variables) to be reduced
+@param reduce_size size of data in bytes to be reduced
+@param reduce_data pointer to data to be reduced (an array of num_vars pointers to the private copies)
+@param reduce_desc NULL, or an array of num_vars <tt>kmp_reduction_item_t</tt> describing each variable
+@param reduce_func callback function providing reduction operation on two operands and returning result of reduction in lhs_data
+@param lck pointer to the unique lock data structure
+@result 1 for the master thread, 0 for all other team threads, 2 for all team threads if atomic reduction needed
+
+Same as __kmpc_reduce_nowait_typed(), but if the tree method is selected and <tt>reduce_desc</tt>
+describes large enough arrays, the private copies are combined into the master's copy by a parallel
+reduce-scatter over the team. The block is finished with __kmpc_end_reduce_nowait().
+*/
+kmp_int32
+__kmpc_reduce_nowait_array(
+    ident_t *loc, kmp_int32 global_tid,
+    kmp_int32 num_vars, size_t reduce_size, void *reduce_data, const kmp_reduction_item_t *reduce_desc,
+    void (*reduce_func)(void *lhs_data, void *rhs_data),
+    kmp_critical_name *lck ) {
+
+    PACKED_REDUCTION_METHOD_T packed_reduction_method;
+    int retval;
+
+    if( ! TCR_4( __kmp_init_parallel ) )
+        __kmp_parallel_initialize();
+
+    packed_reduction_method = __kmp_array_reduce_method( loc, global_tid, num_vars, reduce_size, reduce_data, reduce_desc, reduce_func, lck );
+    if ( ! TEST_REDUCTION_METHOD( packed_reduction_method, tree_reduce_block ) )
+        return __kmp_reduce_typed_block( loc, global_tid, TRUE, num_vars, reduce_size, reduce_data, reduce_desc,
+                                         reduce_func, lck, packed_reduction_method );
+
+    KMP_COUNT_BLOCK(REDUCE_nowait);
+    KA_TRACE( 10, ( "__kmpc_reduce_nowait_array() enter: called T#%d\n", global_tid ) );
+
+#if KMP_USE_DYNAMIC_LOCK
+    if ( __kmp_env_consistency_check )
+        __kmp_push_sync( global_tid, ct_reduce, loc, NULL, 0 );
+#else
+    if ( __kmp_env_consistency_check )
+        __kmp_push_sync( global_tid, ct_reduce, loc, NULL );
+#endif
+    // __kmpc_end_reduce_nowait() treats this as a tree reduction: only the master gets there
+    __KMP_SET_REDUCTION_METHOD( global_tid, PACK_REDUCTION_METHOD_AND_BARRIER( tree_reduce_block, bs_plain_barrier ) );
+
+    __kmp_array_reduce_scatter( loc, global_tid, num_vars, reduce_data, reduce_desc );
+    // the master's copy is complete and the private copies may be released after this barrier
+    __kmp_barrier( bs_plain_barrier, global_tid, FALSE, 0, NULL, NULL );
+
+    retval = KMP_MASTER_GTID( global_tid ) ? 1 : 0;
+    if ( __kmp_env_consistency_check ) {
+        if( retval == 0 ) {
+            __kmp_pop_sync( global_tid, ct_reduce, loc );
+        }
+    }
+
+    KA_TRACE( 10, ( "__kmpc_reduce_nowait_array() exit: called T#%d: returns %08x\n", global_tid, retval ) );
+    return retval;
+}
+
+/*!
+@ingroup SYNCHRONIZATION
+@param loc source location information
+@param global_tid global thread number
+@param num_vars number of items (variables) to be reduced
+@param reduce_size size of data in bytes to be reduced
+@param reduce_data pointer to data to be reduced (an array of num_vars pointers to the private copies)
+@param reduce_desc NULL, or an array of num_vars <tt>kmp_reduction_item_t</tt> describing each variable
+@param reduce_func callback function providing reduction operation on two operands and returning result of reduction in lhs_data
+@param lck pointer to the unique lock data structure
+@result 1 for the master thread, 0 for all other team threads, 2 for all team threads if atomic reduction needed
+
+Blocking version of __kmpc_reduce_nowait_array(). The workers are released when the master calls
+__kmpc_end_reduce().
+*/
+kmp_int32
+__kmpc_reduce_array(
+    ident_t *loc, kmp_int32 global_tid,
+    kmp_int32 num_vars, size_t reduce_size, void *reduce_data, const kmp_reduction_item_t *reduce_desc,
+    void (*reduce_func)(void *lhs_data, void *rhs_data),
+    kmp_critical_name *lck ) {
+
+    PACKED_REDUCTION_METHOD_T packed_reduction_method;
+    int retval;
+
+    if( ! TCR_4( __kmp_init_parallel ) )
+        __kmp_parallel_initialize();
+
+    packed_reduction_method = __kmp_array_reduce_method( loc, global_tid, num_vars, reduce_size, reduce_data, reduce_desc, reduce_func, lck );
+    if ( ! TEST_REDUCTION_METHOD( packed_reduction_method, tree_reduce_block ) )
+        return __kmp_reduce_typed_block( loc, global_tid, FALSE, num_vars, reduce_size, reduce_data, reduce_desc,
+                                         reduce_func, lck, packed_reduction_method );
+
+    KMP_COUNT_BLOCK(REDUCE_wait);
+    KA_TRACE( 10, ( "__kmpc_reduce_array() enter: called T#%d\n", global_tid ) );
+
+#if KMP_USE_DYNAMIC_LOCK
+    if ( __kmp_env_consistency_check )
+        __kmp_push_sync( global_tid, ct_reduce, loc, NULL, 0 );
+#else
+    if ( __kmp_env_consistency_check )
+        __kmp_push_sync( global_tid, ct_reduce, loc, NULL );
+#endif
+    // __kmpc_end_reduce() ends the split barrier below
+    __KMP_SET_REDUCTION_METHOD( global_tid, PACK_REDUCTION_METHOD_AND_BARRIER( tree_reduce_block, bs_plain_barrier ) );
+
+    __kmp_array_reduce_scatter( loc, global_tid, num_vars, reduce_data, reduce_desc );
+    retval = __kmp_barrier( bs_plain_barrier, global_tid, TRUE, 0, NULL, NULL );
+    retval = ( retval != 0 ) ? ( 0 ) : ( 1 );
+
+    if ( __kmp_env_consistency_check ) {
+        if( retval == 0 ) { // 0: all other workers; 1: master
+            __kmp_pop_sync( global_tid, ct_reduce, loc );
+        }
+    }
+
+    KA_TRACE( 10, ( "__kmpc_reduce_array() exit: called T#%d: returns %08x\n", global_tid, retval ) );
+    return retval;
+}
+
 #undef __KMP_GET_REDUCTION_METHOD
 #undef __KMP_SET_REDUCTION_METHOD
 
@@ -3073,6 +3734,240 @@ void __kmpc_place_threads(int nS, int sO, int nC, int cO, int nT)
 }
 
 #if OMP_45_ENABLED
+#if KMP_USE_FUTEX
+# include <unistd.h>
+# include <sys/syscall.h>
+# ifndef FUTEX_WAIT
+#  define FUTEX_WAIT 0
+# endif
+# ifndef FUTEX_WAKE
+#  define FUTEX_WAKE 1
+# endif
+#endif
+
+// Dependence tracking of a doacross loop.  The header is followed by the flag
+// bits.  Small loops keep one bit per iteration of the collapsed iteration space.
+// Big loops keep a ring of size bits (a power of 2) covering the iterations
+// [base, base + size), where base is the lowest iteration not posted yet.
+// The bit of a posted iteration holds its lap parity (((iter >> shift) & 1) ^ 1),
+// so the slots are reused by the next lap without clearing.  A post beyond the
+// window goes to one of the runs of the posting thread: a few ranges of
+// consecutive iterations it has posted, kept after the ring (a thread of a
+// static schedule posts its block in order far ahead of base).  base is advanced
+// by the posting threads; when it reaches a run it jumps to the end of the run,
+// after the window bits of the run's last lap are set.  A thread with all its
+// runs still ahead of base waits for base before it starts a new one.
+#define KMP_DOACROSS_RUNS 4
+
+// Runs of one thread, written by that thread only; end[k] == 0 - free slot.
+typedef struct KMP_ALIGN_CACHE kmp_doacross_runs {
+    volatile kmp_int64 start[KMP_DOACROSS_RUNS]; // first iteration of a run
+    volatile kmp_int64 end[KMP_DOACROSS_RUNS];   // iteration after the last one of a run
+} kmp_doacross_runs_t;
+
+typedef struct kmp_doacross_win {
+    kmp_int64 size;             // size of the window in iterations, 0 - one bit per iteration
+    kmp_int64 trace_count;      // total number of iterations
+    kmp_int32 shift;            // log2(size)
+    kmp_int32 nproc;            // number of threads owning runs
+    kmp_doacross_runs_t *runs;  // runs of the threads, indexed by tid
+    volatile kmp_int64 *run_lo; // lowest start of the live runs of a thread, indexed by tid
+    KMP_ALIGN_CACHE volatile kmp_int64 base; // lowest iteration which is not posted yet
+    volatile kmp_int32 moving;               // serializes the jumps of base over the runs
+    KMP_ALIGN_CACHE volatile kmp_int32 seq;  // futex word, bumped on each wake up
+    volatile kmp_int32 sleepers;             // number of threads blocked in the futex
+} kmp_doacross_win_t;
+
+// Number of yields before a doacross wait blocks in the futex
+#define KMP_DOACROSS_SPINS 200
+
+static inline kmp_uint32 *
+__kmp_doacross_win_flags( kmp_doacross_win_t *win )
+{
+    return (kmp_uint32 *)( win + 1 );
+}
+
+// Check the bit of iteration iter, which must be inside the window.
+static inline int
+__kmp_doacross_bit_posted( kmp_doacross_win_t *win, volatile kmp_uint32 *flags, kmp_int64 iter )
+{
+    kmp_int64 slot = iter & ( win->size - 1 );
+    kmp_uint32 bit = ( flags[slot >> 5] >> ( slot & 31 ) ) & 1;
+    return bit == ( ( ( iter >> win->shift ) & 1 ) ^ 1 );
+}
+
+// Return the end of a run holding iteration iter, 0 if there is none.  The runs
+// of thread tid are looked at first, then those of the threads below it (the
+// usual owners of the sink iterations).
+static kmp_int64
+__kmp_doacross_run_end( kmp_doacross_win_t *win, int tid, kmp_int64 iter )
+{
+    int i, k, t = tid;
+    for( i = 0; i < win->nproc; ++i, t = ( t ? t : win->nproc ) - 1 ) {
+        kmp_doacross_runs_t *runs = &win->runs[t];
+        if( TCR_8( win->run_lo[t] ) > iter )
+            continue;
+        for( k = 0; k < KMP_DOACROSS_RUNS; ++k ) {
+            // read end before start: a reused slot is free until its new start is stored
+            kmp_int64 end = TCR_8( runs->end[k] );
+            KMP_MB();
+            if( iter < end && TCR_8( runs->start[k] ) <= iter )
+                return end;
+        }
+    }
+    return 0;
+}
+
+static inline int
+__kmp_doacross_posted( kmp_doacross_win_t *win, volatile kmp_uint32 *flags, int tid, kmp_int64 iter )
+{
+    kmp_int64 base;
+    if( win->size == 0 ) {
+        return ( flags[iter >> 5] >> ( iter & 31 ) ) & 1;
+    }
+    // Read base before the bit: the slot of iter is not reused while iter >= base.
+    base = TCR_8( win->base );
+    KMP_MB();
+    if( iter < base )
+        return TRUE;
+    if( iter < base + win->size && __kmp_doacross_bit_posted( win, flags, iter ) )
+        return TRUE;
+    return __kmp_doacross_run_end( win, tid, iter ) != 0;
+}
+
+// Set the bit of iteration iter in the window; odd laps clear the bit set by the previous lap.
+static inline void
+__kmp_doacross_set_bit( kmp_doacross_win_t *win, volatile kmp_uint32 *flags, kmp_int64 iter )
+{
+    kmp_int64 slot = iter & ( win->size - 1 );
+    kmp_uint32 flag = 1 << ( slot & 31 );
+    if( ( iter >> win->shift ) & 1 ) {
+        KMP_TEST_THEN_AND32( (kmp_int32*)&flags[slot >> 5], (kmp_int32)~flag );
+    } else {
+        KMP_TEST_THEN_OR32( (kmp_int32*)&flags[slot >> 5], (kmp_int32)flag );
+    }
+}
+
+// Move base over the posted iterations.  Every poster tries it after setting its
+// bit or extending its run, so a post concurrent with the scan is never missed.
+// base jumps over a run under the moving lock while it still equals the scanned
+// iteration; the bits of the last lap of the run are set first, so the window
+// is valid at the new base, and a late jump never lands on slots of the next lap.
+static void
+__kmp_doacross_advance( kmp_doacross_win_t *win, volatile kmp_uint32 *flags, int tid )
+{
+    kmp_int64 base = TCR_8( win->base );
+    while( base < win->trace_count ) {
+        if( ! __kmp_doacross_bit_posted( win, flags, base ) ) {
+            kmp_int64 i, end = __kmp_doacross_run_end( win, tid, base );
+            if( end == 0 )
+                break;
+            while( ! KMP_COMPARE_AND_STORE_ACQ32( &win->moving, 0, 1 ) )
+                KMP_CPU_PAUSE();
+            if( TCR_8( win->base ) == base ) {
+                for( i = ( end - win->size > base ) ? end - win->size : base; i < end; ++i ) {
+                    if( ! __kmp_doacross_bit_posted( win, flags, i ) )
+                        __kmp_doacross_set_bit( win, flags, i );
+                }
+                KMP_MB();
+                KMP_COMPARE_AND_STORE_REL64( &win->base, base, end );
+            }
+            KMP_ST_REL32( &win->moving, 0 );
+            base = TCR_8( win->base );
+            continue;
+        }
+        if( KMP_COMPARE_AND_STORE_ACQ64( &win->base, base, base + 1 ) )
+            ++base;
+        else
+            base = TCR_8( win->base );
+    }
+}
+
+// Post iteration iter beyond the window in a run of thread tid: extend the run
+// ending at iter, or start a new run in a slot base has passed, waiting for base
+// if there is none.  Return FALSE if the window has come to hold iter meanwhile.
+static int
+__kmp_doacross_post_run( kmp_doacross_win_t *win, volatile kmp_uint32 *flags, int tid, kmp_int64 iter )
+{
+    kmp_doacross_runs_t *runs = &win->runs[tid];
+    kmp_int64 base, start = iter, lo = iter;
+    int k, slot;
+
+    for( slot = 0; slot < KMP_DOACROSS_RUNS; ++slot ) {
+        if( runs->end[slot] == iter ) {
+            start = runs->start[slot];
+            TCW_8( runs->end[slot], iter + 1 );
+            break;
+        }
+    }
+    if( slot == KMP_DOACROSS_RUNS ) {
+        for( ;; ) {
+            base = TCR_8( win->base );
+            if( iter < base + win->size )
+                return FALSE;
+            for( slot = 0; slot < KMP_DOACROSS_RUNS; ++slot ) {
+                if( runs->end[slot] <= base )
+                    break;
+            }
+            if( slot < KMP_DOACROSS_RUNS )
+                break;
+            KMP_YIELD( TRUE );
+        }
+        TCW_8( runs->end[slot], 0 );
+        KMP_MB();
+        TCW_8( runs->start[slot], iter );
+        KMP_MB();
+        TCW_8( runs->end[slot], iter + 1 );
+        for( k = 0; k < KMP_DOACROSS_RUNS; ++k ) {
+            if( runs->end[k] > base && runs->start[k] < lo )
+                lo = runs->start[k];
+        }
+        TCW_8( win->run_lo[tid], lo );
+    }
+    // either base has not reached the run yet, or we see it there and jump it
+    KMP_MB();
+    if( TCR_8( win->base ) >= start )
+        __kmp_doacross_advance( win, flags, tid );
+    return TRUE;
+}
+
+static inline void
+__kmp_doacross_notify( kmp_doacross_win_t *win )
+{
+    KMP_MB();
+    if( TCR_4( win->sleepers ) > 0 ) {
+        KMP_TEST_THEN_INC32( &win->seq );
+#if KMP_USE_FUTEX
+        syscall( __NR_futex, &win->seq, FUTEX_WAKE, INT_MAX, NULL, NULL, 0 );
+#endif
+    }
+}
+
+// Wait until iteration iter is posted.  Spin for a while, then sleep in the futex.
+static void
+__kmp_doacross_block( kmp_doacross_win_t *win, volatile kmp_uint32 *flags, int tid, kmp_int64 iter )
+{
+    int spins = 0;
+    for( ;; ) {
+        if( __kmp_doacross_posted( win, flags, tid, iter ) )
+            return;
+#if KMP_USE_FUTEX
+        if( spins >= KMP_DOACROSS_SPINS ) {
+            kmp_int32 seq;
+            KMP_TEST_THEN_INC32( &win->sleepers );
+            seq = TCR_4( win->seq );
+            if( ! __kmp_doacross_posted( win, flags, tid, iter ) ) {
+                syscall( __NR_futex, &win->seq, FUTEX_WAIT, seq, NULL, NULL, 0 );
+            }
+            KMP_TEST_THEN_DEC32( &win->sleepers );
+            continue;
+        }
+        ++spins;
+#endif
+        KMP_YIELD( TRUE );
+    }
+}
+
 /*!
 @ingroup WORK_SHARING
 @param loc  source location information.
@@ -3088,12 +3983,13 @@ void
 __kmpc_doacross_init(ident_t *loc, int gtid, int num_dims, struct kmp_dim * dims)
 {
     int j, idx;
-    kmp_int64 last, trace_count;
+    kmp_int64 last, trace_count, win_size;
     kmp_info_t *th = __kmp_threads[gtid];
     kmp_team_t *team = th->th.th_team;
     kmp_uint32 *flags;
     kmp_disp_t *pr_buf = th->th.th_dispatch;
     dispatch_shared_info_t *sh_buf;
+    kmp_doacross_win_t *win;
 
     KA_TRACE(20,("__kmpc_doacross_init() enter: called T#%d, num dims %d, active %d\n",
                  gtid, num_dims, !team->t.t_serialized));
@@ -3111,7 +4007,7 @@ __kmpc_doacross_init(ident_t *loc, int gtid, int num_dims, struct kmp_dim * dims
     // Save bounds info into allocated private buffer
     KMP_DEBUG_ASSERT(pr_buf->th_doacross_info == NULL);
     pr_buf->th_doacross_info =
-        (kmp_int64*)__kmp_thread_malloc(th, sizeof(kmp_int64)*(4 * num_dims + 1));
+        (kmp_int64*)__kmp_thread_malloc(th, sizeof(kmp_int64)*(4 * num_dims + 2));
     KMP_DEBUG_ASSERT(pr_buf->th_doacross_info != NULL);
     pr_buf->th_doacross_info[0] = (kmp_int64)num_dims; // first element is number of dimensions
     // Save also address of num_done in order to access it later without knowing the buffer index
@@ -3156,6 +4052,23 @@ __kmpc_doacross_init(ident_t *loc, int gtid, int num_dims, struct kmp_dim * dims
     }
     KMP_DEBUG_ASSERT(trace_count > 0);
 
+    // Size the window to hold a few rows of the outer dimension (the usual
+    // dependence distance) per thread, keep the full bitmap if it is not much bigger.
+    win_size = 0;
+    if( __kmp_doacross_window > 0 ) {
+        kmp_int64 row = 1, limit = trace_count / 4;
+        for( j = 1; j < num_dims; ++j ) {
+            row *= pr_buf->th_doacross_info[4 * j + 1];
+        }
+        if( row <= limit / (4 * team->t.t_nproc) ) {
+            win_size = 32;
+            while( win_size < 4 * team->t.t_nproc * row || win_size < __kmp_doacross_window )
+                win_size <<= 1;
+            if( win_size > limit )
+                win_size = 0;
+        }
+    }
+
     // Check if shared buffer is not occupied by other loop (idx - __kmp_dispatch_num_buffers)
     if( idx != sh_buf->doacross_buf_idx ) {
         // Shared buffer is occupied, wait for it to be free
@@ -3166,9 +4079,22 @@ __kmpc_doacross_init(ident_t *loc, int gtid, int num_dims, struct kmp_dim * dims
     flags = (kmp_uint32*)KMP_COMPARE_AND_STORE_RET64(
         (kmp_int64*)&sh_buf->doacross_flags,NULL,(kmp_int64)1);
     if( flags == NULL ) {
-        // we are the first thread, allocate the array of flags
-        kmp_int64 size = trace_count / 8 + 8; // in bytes, use single bit per iteration
-        sh_buf->doacross_flags = (kmp_uint32*)__kmp_thread_calloc(th, size, 1);
+        // we are the first thread, allocate the header, the array of flags and the runs
+        kmp_int64 size = (win_size ? win_size : trace_count) / 8 + 8; // in bytes, single bit per iteration
+        kmp_int32 nproc = win_size ? team->t.t_nproc : 0;
+        size = ( size + CACHE_LINE - 1 ) & ~( (kmp_int64)CACHE_LINE - 1 ); // runs start on a cache line
+        win = (kmp_doacross_win_t*)__kmp_allocate(sizeof(kmp_doacross_win_t) + size +
+                  nproc * ( sizeof(kmp_doacross_runs_t) + sizeof(kmp_int64) ));
+        win->size = win_size;
+        win->trace_count = trace_count;
+        for( win->shift = 0; ((kmp_int64)1 << win->shift) < win_size; ++win->shift );
+        win->nproc = nproc;
+        win->runs = (kmp_doacross_runs_t*)( (char*)__kmp_doacross_win_flags(win) + size );
+        win->run_lo = (volatile kmp_int64*)( win->runs + nproc );
+        for( j = 0; j < nproc; ++j )
+            win->run_lo[j] = trace_count; // no runs yet
+        KMP_MB();
+        sh_buf->doacross_flags = __kmp_doacross_win_flags(win);
     } else if( (kmp_int64)flags == 1 ) {
         // initialization is still in progress, need to wait
         while( (volatile kmp_int64)sh_buf->doacross_flags == 1 ) {
@@ -3178,19 +4104,23 @@ __kmpc_doacross_init(ident_t *loc, int gtid, int num_dims, struct kmp_dim * dims
     KMP_DEBUG_ASSERT((kmp_int64)sh_buf->doacross_flags > 1); // check value of pointer
     pr_buf->th_doacross_flags = sh_buf->doacross_flags;      // save private copy in order to not
                                                              // touch shared buffer on each iteration
+    // the header precedes the flags, keep its address after the bounds info
+    win = (kmp_doacross_win_t*)pr_buf->th_doacross_flags - 1;
+    pr_buf->th_doacross_info[4 * num_dims + 1] = (kmp_int64)win;
     KA_TRACE(20,("__kmpc_doacross_init() exit: T#%d\n", gtid));
 }
 
 void
 __kmpc_doacross_wait(ident_t *loc, int gtid, long long *vec)
 {
-    kmp_int32 shft, num_dims, i;
-    kmp_uint32 flag;
+    kmp_int32 num_dims, i;
     kmp_int64 iter_number; // iteration number of "collapsed" loop nest
     kmp_info_t *th = __kmp_threads[gtid];
     kmp_team_t *team = th->th.th_team;
     kmp_disp_t *pr_buf;
     kmp_int64 lo, up, st;
+    kmp_doacross_win_t *win;
+    int tid = __kmp_tid_from_gtid(gtid);
 
     KA_TRACE(20,("__kmpc_doacross_wait() enter: called T#%d\n", gtid));
     if( team->t.t_serialized ) {
@@ -3264,14 +4194,12 @@ __kmpc_doacross_wait(ident_t *loc, int gtid, long long *vec)
         }
         iter_number = iter + ln * iter_number;
     }
-    shft = iter_number % 32; // use 32-bit granularity
-    iter_number >>= 5;       // divided by 32
-    flag = 1 << shft;
-    while( (flag & pr_buf->th_doacross_flags[iter_number]) == 0 ) {
-        KMP_YIELD(TRUE);
+    win = (kmp_doacross_win_t*)pr_buf->th_doacross_info[4 * num_dims + 1];
+    if( ! __kmp_doacross_posted(win, pr_buf->th_doacross_flags, tid, iter_number) ) {
+        __kmp_doacross_block(win, pr_buf->th_doacross_flags, tid, iter_number);
     }
     KA_TRACE(20,("__kmpc_doacross_wait() exit: T#%d wait for iter %lld completed\n",
-                 gtid, (iter_number<<5)+shft));
+                 gtid, iter_number));
 }
 
 void
@@ -3283,7 +4211,9 @@ __kmpc_doacross_post(ident_t *loc, int gtid, long long *vec)
     kmp_info_t *th = __kmp_threads[gtid];
     kmp_team_t *team = th->th.th_team;
     kmp_disp_t *pr_buf;
-    kmp_int64 lo, st;
+    kmp_int64 lo, st, slot;
+    kmp_doacross_win_t *win;
+    int tid = __kmp_tid_from_gtid(gtid);
 
     KA_TRACE(20,("__kmpc_doacross_post() enter: called T#%d\n", gtid));
     if( team->t.t_serialized ) {
@@ -3319,13 +4249,24 @@ __kmpc_doacross_post(ident_t *loc, int gtid, long long *vec)
         }
         iter_number = iter + ln * iter_number;
     }
-    shft = iter_number % 32; // use 32-bit granularity
-    iter_number >>= 5;       // divided by 32
-    flag = 1 << shft;
-    if( (flag & pr_buf->th_doacross_flags[iter_number]) == 0 )
-        KMP_TEST_THEN_OR32( (kmp_int32*)&pr_buf->th_doacross_flags[iter_number], (kmp_int32)flag );
+    win = (kmp_doacross_win_t*)pr_buf->th_doacross_info[4 * num_dims + 1];
+    if( win->size ) {
+        // the slot of an iteration beyond the window still belongs to the previous lap
+        if( iter_number < TCR_8(win->base) + win->size ||
+            ! __kmp_doacross_post_run(win, pr_buf->th_doacross_flags, tid, iter_number) ) {
+            __kmp_doacross_set_bit(win, pr_buf->th_doacross_flags, iter_number);
+            __kmp_doacross_advance(win, pr_buf->th_doacross_flags, tid);
+        }
+    } else {
+        shft = iter_number % 32; // use 32-bit granularity
+        slot = iter_number >> 5; // divided by 32
+        flag = 1 << shft;
+        if( (flag & pr_buf->th_doacross_flags[slot]) == 0 )
+            KMP_TEST_THEN_OR32( (kmp_int32*)&pr_buf->th_doacross_flags[slot], (kmp_int32)flag );
+    }
+    __kmp_doacross_notify(win);
     KA_TRACE(20,("__kmpc_doacross_post() exit: T#%d iter %lld posted\n",
-                 gtid, (iter_number<<5)+shft));
+                 gtid, iter_number));
 }
 
 void
@@ -3349,7 +4290,9 @@ __kmpc_doacross_fini(ident_t *loc, int gtid)
         KMP_DEBUG_ASSERT(pr_buf->th_doacross_info[1] == (kmp_int64)&sh_buf->doacross_num_done);
         KMP_DEBUG_ASSERT(num_done == (kmp_int64)sh_buf->doacross_num_done);
         KMP_DEBUG_ASSERT(idx == sh_buf->doacross_buf_idx);
-        __kmp_thread_free(th, (void*)sh_buf->doacross_flags);
+        KMP_DEBUG_ASSERT(sh_buf->doacross_flags == pr_buf->th_doacross_flags);
+        kmp_doacross_win_t *win = (kmp_doacross_win_t*)pr_buf->th_doacross_info[4 * pr_buf->th_doacross_info[0] + 1];
+        __kmp_free(win); // header, flags and runs
         sh_buf->doacross_flags = NULL;
         sh_buf->doacross_num_done = 0;
         sh_buf->doacross_buf_idx += __kmp_dispatch_num_buffers; // free buffer for future re-use
@@ -186,6 +186,15 @@ struct dispatch_shared_info_template {
     kmp_uint32             *doacross_flags;    // array of iteration flags (0/1)
     kmp_int32               doacross_num_done; // count finished threads
 #endif
+    volatile kmp_int32      auto_sched;        // schedule(auto): candidate chosen for the loop + 1, 0 if none
+    struct kmp_auto_site   *auto_site;         // schedule(auto): history of the loop site
+    kmp_uint64              auto_start;        // schedule(auto): loop start time stamp
+    volatile kmp_uint64     auto_first_done;   // schedule(auto): time stamp of the first thread finishing
+    volatile kmp_uint32     hier_state;        // hierarchical and sticky schedules: 0 idle, 1 setting up, 2 ready
+    struct kmp_disp_hier_domain *hier_domains; // hierarchical schedules: per-domain counters, kept with the buffer
+    struct kmp_disp_ordered_owner *ordered_owners; // ordered dynamic loops: owners of the chunks in flight, kept with the buffer
+    struct kmp_sticky_site *sticky_site;       // sticky schedule: chunk owners of the loop site, NULL to run as dynamic
+    kmp_dist_team_t         dist;              // dynamic distribute: the team's block
 #if KMP_USE_HWLOC
     // When linking with libhwloc, the ORDERED EPCC test slowsdown on big
     // machines (> 48 cores). Performance analysis showed that a cache thrash
@@ -386,6 +395,152 @@ __kmp_dispatch_deo_error( int *gtid_ref, int *cid_ref, ident_t *loc_ref )
     }
 }
 
+// Ordered handoff.  Instead of all waiting threads spinning on the shared ordered_iteration,
+// the thread releasing the last iteration of its chunk writes a ticket (loop buffer index,
+// next iteration) to th_ordered_grant of the thread owning the next iteration, and every
+// thread spins on its own grant.  The owner is computed from the static schedules; under
+// the dynamic schedule each thread records the chunk it grabbed in a ring of chunk owners.
+// Grants only follow the increment of ordered_iteration, so a waiter checking
+// ordered_iteration after its grant was reset or its chunk was recorded never misses one.
+#define KMP_ORDERED_TICKET( buf, iter ) ( ( (kmp_uint64)(buf) << 32 ) | (kmp_uint32)(iter) )
+
+typedef struct KMP_ALIGN_CACHE kmp_disp_ordered_owner {
+    volatile kmp_uint64 chunk;  // chunk index
+    volatile kmp_int32  tid;    // thread executing the chunk
+    volatile kmp_uint32 buf;    // buffer index of the loop, the entry is stale if it differs
+} kmp_disp_ordered_owner_t;
+
+// At most nproc chunks of an ordered loop are in flight, twice that many entries never collide.
+static inline kmp_uint32
+__kmp_disp_ordered_ring_size( kmp_team_t *team )
+{
+    kmp_uint32 size = 2;
+    while ( size < 2 * (kmp_uint32)team->t.t_max_nproc )
+        size <<= 1;
+    return size;
+}
+
+template< typename UT >
+static inline int
+__kmp_dispatch_ordered_handoff( dispatch_private_info_template< UT > *pr )
+{
+    switch ( pr->schedule ) {
+    case kmp_sch_static_balanced:
+    case kmp_sch_static_greedy:
+    case kmp_sch_static_chunked:
+    case kmp_sch_dynamic_chunked:
+        return TRUE;
+    default:
+        return FALSE;
+    }
+}
+
+// Returns the thread executing the chunk which starts at iteration iter, -1 if not known yet.
+template< typename UT >
+static int
+__kmp_dispatch_ordered_owner( kmp_info_t *th, dispatch_private_info_template< UT > *pr,
+                              dispatch_shared_info_template< UT > volatile *sh, UT iter )
+{
+    UT nproc = th->th.th_team_nproc;
+
+    switch ( pr->schedule ) {
+    case kmp_sch_static_balanced:
+        {
+            UT tc = pr->u.p.tc;
+            UT small_chunk = tc / nproc;
+            UT extras = tc % nproc;
+            if ( tc < nproc )
+                return (int)iter;
+            if ( iter < extras * ( small_chunk + 1 ) )
+                return (int)( iter / ( small_chunk + 1 ) );
+            return (int)( extras + ( iter - extras * ( small_chunk + 1 ) ) / small_chunk );
+        }
+    case kmp_sch_static_greedy:
+    case kmp_sch_static_chunked:
+        return (int)( ( iter / (UT)pr->u.p.parm1 ) % nproc );
+    case kmp_sch_dynamic_chunked:
+        {
+            kmp_uint64 chunk = iter / (UT)pr->u.p.parm1;
+            kmp_disp_ordered_owner_t *o =
+                &sh->ordered_owners[ chunk & ( __kmp_disp_ordered_ring_size( th->th.th_team ) - 1 ) ];
+            if ( o->buf == sh->buffer_index ) {
+                KMP_MB();
+                if ( o->chunk == chunk ) {
+                    KMP_MB();
+                    return o->tid;
+                }
+            }
+            return -1;
+        }
+    default:
+        return -1;
+    }
+}
+
+// Records the owner of a chunk of an ordered dynamic loop.
+template< typename UT >
+static void
+__kmp_dispatch_ordered_register( dispatch_shared_info_template< UT > volatile *sh, kmp_team_t *team,
+                                 int tid, kmp_uint64 chunk )
+{
+    kmp_disp_ordered_owner_t *o = &sh->ordered_owners[ chunk & ( __kmp_disp_ordered_ring_size( team ) - 1 ) ];
+    o->tid = tid;
+    KMP_MB();
+    o->chunk = chunk;
+    // the exchange also keeps the entry ahead of reading ordered_iteration in the wait
+    KMP_XCHG_FIXED32( &o->buf, sh->buffer_index );
+}
+
+template< typename UT >
+static void
+__kmp_dispatch_ordered_wait( kmp_info_t *th, dispatch_private_info_template< UT > *pr,
+                             dispatch_shared_info_template< UT > volatile *sh, UT lower )
+{
+    if ( __kmp_dispatch_ordered_handoff( pr ) ) {
+        volatile kmp_uint64 *grant = &th->th.th_dispatch->th_ordered_grant;
+        kmp_uint64 ticket = KMP_ORDERED_TICKET( sh->buffer_index, lower );
+        if ( *grant != ticket && sh->u.s.ordered_iteration < lower ) {
+            kmp_uint32 spins;
+            KMP_FSYNC_SPIN_INIT( grant, NULL );
+            KMP_INIT_YIELD( spins );
+            while ( *grant != ticket ) {
+                KMP_FSYNC_SPIN_PREPARE( grant );
+                KMP_YIELD( TCR_4(__kmp_nth) > __kmp_avail_proc );
+                KMP_YIELD_SPIN( spins );
+            }
+            KMP_FSYNC_SPIN_ACQUIRED( grant );
+        }
+        return;
+    }
+    __kmp_wait_yield< UT >( &sh->u.s.ordered_iteration, lower, __kmp_ge< UT >
+                            USE_ITT_BUILD_ARG( NULL )
+                            );
+}
+
+// Bumps ordered_iteration by inc; at the end of the chunk hands the next iteration over to its owner.
+template< typename UT >
+static void
+__kmp_dispatch_ordered_release( kmp_info_t *th, dispatch_private_info_template< UT > *pr,
+                                dispatch_shared_info_template< UT > volatile *sh, UT inc )
+{
+    typedef typename traits_t< UT >::signed_t ST;
+    UT next = (UT)test_then_add< ST >( (volatile ST *) & sh->u.s.ordered_iteration, (ST)inc ) + inc;
+
+    if ( next > pr->u.p.ordered_upper && next < pr->u.p.tc && __kmp_dispatch_ordered_handoff( pr ) ) {
+        int tid = __kmp_dispatch_ordered_owner< UT >( th, pr, sh, next );
+        if ( tid >= 0 ) {
+            volatile kmp_uint64 *grant = &th->th.th_team->t.t_dispatch[ tid ].th_ordered_grant;
+            kmp_uint64 ticket = KMP_ORDERED_TICKET( sh->buffer_index, next );
+            kmp_uint64 old = *grant;
+            // a late grant must not overwrite the grant of a later (nowait) loop
+            while ( (kmp_int32)( (kmp_uint32)( old >> 32 ) - (kmp_uint32)( ticket >> 32 ) ) <= 0 &&
+                    ! KMP_COMPARE_AND_STORE_ACQ64( grant, old, ticket ) ) {
+                old = *grant;
+            }
+        }
+    }
+}
+
 template< typename UT >
 static void
 __kmp_dispatch_deo( int *gtid_ref, int *cid_ref, ident_t *loc_ref )
@@ -448,9 +603,7 @@ __kmp_dispatch_deo( int *gtid_ref, int *cid_ref, ident_t *loc_ref )
         }
         #endif
 
-        __kmp_wait_yield< UT >( &sh->u.s.ordered_iteration, lower, __kmp_ge< UT >
-                                USE_ITT_BUILD_ARG( NULL )
-                                );
+        __kmp_dispatch_ordered_wait< UT >( th, pr, sh, lower );
         KMP_MB();  /* is this necessary? */
         #ifdef KMP_DEBUG
         {
@@ -534,8 +687,7 @@ __kmp_dispatch_dxo( int *gtid_ref, int *cid_ref, ident_t *loc_ref )
 
         KMP_MB();       /* Flush all pending memory write invalidates.  */
 
-        /* TODO use general release procedure? */
-        test_then_inc< ST >( (volatile ST *) & sh->u.s.ordered_iteration );
+        __kmp_dispatch_ordered_release< UT >( th, pr, sh, 1 );
 
         KMP_MB();       /* Flush all pending memory write invalidates.  */
     }
@@ -587,6 +739,110 @@ __kmp_dispatch_guided_remaining(
     return r + 1;
 }
 
+#if KMP_STATIC_STEAL_ENABLED
+/* Stealing in the static_steal schedule works on the pair (count, ub) of the victim's private
+   buffer.  The pair is updated with one CAS: 8-byte for 4-byte induction variables, 16-byte
+   (cmpxchg16b) for 8-byte ones where available; otherwise the per-thread th_steal_lock is used. */
+template< typename T >
+union kmp_steal_pair {
+    struct {
+        typename traits_t< T >::unsigned_t count;
+        T                                  ub;
+    } p;
+    kmp_int64 b[ 2 ];
+};
+
+template< typename T >
+static inline int
+__kmp_steal_use_cas()
+{
+    if ( sizeof( T ) == 4 )
+        return 1;
+#if KMP_HAVE_CAS128
+    return __kmp_cpuinfo.cx16;
+#else
+    return 0;
+#endif
+}
+
+template< typename T >
+static inline void
+__kmp_steal_pair_read( dispatch_private_info_template< T > *pr, kmp_steal_pair< T > *v )
+{
+    // a torn read is harmless, the CAS that follows fails on it
+    volatile kmp_int64 *addr = (volatile kmp_int64 *)&pr->u.p.count;
+    v->b[ 0 ] = addr[ 0 ];
+    if ( sizeof( T ) > 4 )
+        v->b[ 1 ] = addr[ 1 ];
+}
+
+template< typename T >
+static inline int
+__kmp_steal_pair_cas( dispatch_private_info_template< T > *pr, kmp_steal_pair< T > const &vold,
+                      kmp_steal_pair< T > const &vnew )
+{
+    volatile kmp_int64 *addr = (volatile kmp_int64 *)&pr->u.p.count;
+    if ( sizeof( T ) == 4 )
+        return KMP_COMPARE_AND_STORE_ACQ64( addr, vold.b[ 0 ], vnew.b[ 0 ] );
+#if KMP_HAVE_CAS128
+    return KMP_COMPARE_AND_STORE_ACQ128( addr, vold.b[ 0 ], vold.b[ 1 ], vnew.b[ 0 ], vnew.b[ 1 ] );
+#else
+    KMP_ASSERT( 0 );
+    return 0;
+#endif
+}
+
+// Stores the pair atomically with respect to concurrent thieves.
+template< typename T >
+static inline void
+__kmp_steal_pair_write( dispatch_private_info_template< T > *pr, kmp_steal_pair< T > const &v )
+{
+    if ( sizeof( T ) == 4 ) {
+        #if KMP_ARCH_X86
+        KMP_XCHG_FIXED64( ( volatile kmp_int64 * )( &pr->u.p.count ), v.b[ 0 ] );
+        #else
+        *( volatile kmp_int64 * )( &pr->u.p.count ) = v.b[ 0 ];
+        #endif
+    } else {
+        kmp_steal_pair< T > vold;
+        do {
+            __kmp_steal_pair_read< T >( pr, &vold );
+        } while ( ! __kmp_steal_pair_cas< T >( pr, vold, v ) );
+    }
+}
+
+/* Victim search of the static_steal schedule.  The first attempt goes to the thread robbed last
+   time (it likely still has work), the next ones to the threads nearest in tid (tid^1, tid^2,
+   tid^4, ...), which share a core or a socket under compact placement, and the rest to random
+   threads.  Returns NULL if the chosen thread has not started this loop yet. */
+template< typename T >
+static dispatch_private_info_template< T > *
+__kmp_steal_victim( kmp_info_t *th, kmp_team_t *team, dispatch_private_info_template< T > *pr,
+                    int tid, int nproc, int attempt, T *victim_idx )
+{
+    dispatch_private_info_template< T > *victim;
+    int idx;
+
+    if ( attempt == 0 )
+        idx = (int)pr->u.p.parm4;
+    else if ( attempt < 31 && ( 1 << ( attempt - 1 ) ) < nproc )
+        idx = tid ^ ( 1 << ( attempt - 1 ) );
+    else
+        idx = nproc;
+    if ( idx >= nproc || idx == tid )
+        idx = __kmp_get_random( th ) % nproc;
+    if ( idx == tid )
+        return NULL;
+    victim = reinterpret_cast< dispatch_private_info_template< T >* >
+        ( team->t.t_threads[ idx ]->th.th_dispatch->th_dispatch_pr_current );
+    if ( victim == NULL ||
+         *(volatile T *)&victim->u.p.static_steal_counter != *(volatile T *)&pr->u.p.static_steal_counter )
+        return NULL;
+    *victim_idx = idx;
+    return victim;
+}
+#endif // KMP_STATIC_STEAL_ENABLED
+
 // Parameters of the guided-iterative algorithm:
 //   p2 = n * nproc * ( chunk + 1 )  // point of switching to dynamic
 //   p3 = 1 / ( n * nproc )          // remaining iterations multiplier
@@ -595,6 +851,743 @@ __kmp_dispatch_guided_remaining(
 static int guided_int_param = 2;
 static double guided_flt_param = 0.5;// = 1.0 / guided_int_param;
 
+/* ------------------------------------------------------------------------ */
+/* Self-tuning schedule(auto).
+   Every schedule(auto) loop site (ident_t) keeps a short history of its executions for each
+   candidate schedule: time per iteration, imbalance (first to last finishing thread) and the
+   number of chunks handed out.  A site first runs every candidate KMP_AUTO_WARMUP times, then
+   uses the cheapest one, preferring fewer chunks among candidates that cost about the same, and
+   re-runs one of the others every KMP_AUTO_EXPLORE_PERIOD executions (more often while the chosen
+   one is imbalanced) so the choice follows changes in the loop.  All threads of a team take the candidate chosen by
+   the first thread that reaches the shared dispatch buffer; the last thread to finish records the
+   sample.  Loops that cannot be tuned (serialized teams, no ident_t, table full) keep using
+   __kmp_auto. */
+
+#if KMP_ARCH_X86 || KMP_ARCH_X86_64
+# define KMP_AUTO_NOW() __kmp_hardware_timestamp()
+#else
+extern kmp_uint64 __kmp_now_nsec();
+# define KMP_AUTO_NOW() __kmp_now_nsec()
+#endif
+
+#define KMP_AUTO_SITES          256 // loop sites that can be tuned
+#define KMP_AUTO_WARMUP         2   // runs of each candidate before the best one is used
+#define KMP_AUTO_EXPLORE_PERIOD 64  // runs between re-explorations
+#define KMP_AUTO_TIE            0.05 // relative cost difference below which candidates are even
+#define KMP_AUTO_IMBALANCE      4   // imbalance above 1/4 of the loop time shortens the period
+
+enum kmp_auto_cand {
+    kmp_auto_static = 0,     // static balanced
+    kmp_auto_dynamic_fine,   // dynamic, about 64 chunks per thread
+    kmp_auto_dynamic_coarse, // dynamic, about 8 chunks per thread
+    kmp_auto_guided,         // guided analytical
+    kmp_auto_last
+};
+
+static char const * __kmp_auto_cand_names[ kmp_auto_last ] = {
+    "static", "dynamic,fine", "dynamic,coarse", "guided"
+};
+
+typedef struct kmp_auto_site {
+    ident_t * volatile  loc;
+    volatile kmp_int32  busy;                        // a sample is being recorded
+    kmp_uint32          runs;                        // recorded executions
+    kmp_uint64          last_tc;                     // trip count of the last recorded execution
+    kmp_uint32          samples[ kmp_auto_last ];
+    double              cost[ kmp_auto_last ];       // ticks per iteration (running average)
+    double              imbalance[ kmp_auto_last ];  // ticks between first and last finishing thread
+    double              chunks[ kmp_auto_last ];     // chunks handed out
+} kmp_auto_site_t;
+
+static kmp_auto_site_t __kmp_auto_sites[ KMP_AUTO_SITES ];
+
+static kmp_auto_site_t *
+__kmp_auto_find_site( ident_t *loc )
+{
+    kmp_uint32 h, probe;
+
+    if ( loc == NULL )
+        return NULL;
+    h = (kmp_uint32)( ( (kmp_uintptr_t)loc >> 4 ) % KMP_AUTO_SITES );
+    for ( probe = 0; probe < KMP_AUTO_SITES; ++probe, h = ( h + 1 ) % KMP_AUTO_SITES ) {
+        kmp_auto_site_t *site = &__kmp_auto_sites[ h ];
+        ident_t *cur = (ident_t *) TCR_PTR( site->loc );
+        if ( cur == NULL ) {
+            if ( KMP_COMPARE_AND_STORE_PTR( &site->loc, NULL, loc ) )
+                return site;
+            cur = (ident_t *) TCR_PTR( site->loc );
+        }
+        if ( cur == loc )
+            return site;
+    }
+    return NULL;
+}
+
+// The cheapest candidate; candidates within KMP_AUTO_TIE of it are ranked by the chunks they hand
+// out, since fewer chunks mean less contention on the shared buffer and better locality.
+static int
+__kmp_auto_best( kmp_auto_site_t const *site )
+{
+    int c, best = -1;
+    for ( c = 0; c < kmp_auto_last; ++c ) {
+        if ( site->samples[ c ] && ( best < 0 || site->cost[ c ] < site->cost[ best ] ) )
+            best = c;
+    }
+    if ( best >= 0 ) {
+        double limit = site->cost[ best ] * ( 1.0 + KMP_AUTO_TIE );
+        for ( c = 0; c < kmp_auto_last; ++c ) {
+            if ( site->samples[ c ] && site->cost[ c ] <= limit && site->chunks[ c ] < site->chunks[ best ] )
+                best = c;
+        }
+    }
+    return best;
+}
+
+static int
+__kmp_auto_choose( kmp_auto_site_t *site )
+{
+    int c, best;
+    kmp_uint32 runs, period;
+
+    for ( c = 0; c < kmp_auto_last; ++c ) {
+        if ( site->samples[ c ] < KMP_AUTO_WARMUP )
+            return c;
+    }
+    best = __kmp_auto_best( site );
+    // Explore sooner while the threads of the chosen candidate finish far apart: the load moved.
+    period = KMP_AUTO_EXPLORE_PERIOD;
+    if ( site->imbalance[ best ] * KMP_AUTO_IMBALANCE > site->cost[ best ] * site->last_tc )
+        period /= 8;
+    runs = site->runs;
+    if ( runs % period == period - 1 )
+        return ( runs / period ) % kmp_auto_last;
+    return best;
+}
+
+// Records one execution of the candidate cand; drops the sample if another team is recording one.
+static void
+__kmp_auto_record( kmp_auto_site_t *site, int cand, kmp_uint64 tc, kmp_uint64 elapsed,
+                   kmp_uint64 imbalance, kmp_uint64 chunks )
+{
+    double w;
+
+    if ( tc == 0 || ! KMP_COMPARE_AND_STORE_ACQ32( &site->busy, 0, 1 ) )
+        return;
+    // plain average while warming up, then weigh the recent executions more
+    w = ( site->samples[ cand ] < 4 ) ? 1.0 / ( site->samples[ cand ] + 1 ) : 0.25;
+    site->cost[ cand ]      += w * ( (double)elapsed / tc - site->cost[ cand ] );
+    site->imbalance[ cand ] += w * ( (double)imbalance - site->imbalance[ cand ] );
+    site->chunks[ cand ]    += w * ( (double)chunks - site->chunks[ cand ] );
+    site->samples[ cand ]++;
+    site->runs++;
+    site->last_tc = tc;
+    KMP_MB();
+    TCW_4( site->busy, 0 );
+}
+
+// Prints the history of the schedule(auto) sites, e.g. to hard-code the schedules they converged on.
+void
+__kmp_dispatch_auto_print( FILE *out )
+{
+    int i, c, header = 0;
+
+    for ( i = 0; i < KMP_AUTO_SITES; ++i ) {
+        kmp_auto_site_t const *site = &__kmp_auto_sites[ i ];
+        int best = __kmp_auto_best( site );
+        if ( site->loc == NULL || best < 0 )
+            continue;
+        if ( ! header ) {
+            fprintf( out, "\nschedule(auto) site,        Runs,  Last trip count,  Schedule\n" );
+            header = 1;
+        }
+        kmp_str_loc_t loc = __kmp_str_loc_init( site->loc->psource, 1 );
+        fprintf( out, "%s:%d (%s), %u, %llu, %s\n", loc.file ? loc.file : "unknown", loc.line,
+                 loc.func ? loc.func : "unknown", site->runs, (unsigned long long)site->last_tc,
+                 __kmp_auto_cand_names[ best ] );
+        __kmp_str_loc_free( &loc );
+        for ( c = 0; c < kmp_auto_last; ++c ) {
+            if ( site->samples[ c ] )
+                fprintf( out, "  %-16s, %u runs, %.2f ticks/iteration, %.0f ticks imbalance, %.0f chunks\n",
+                         __kmp_auto_cand_names[ c ], site->samples[ c ], site->cost[ c ],
+                         site->imbalance[ c ], site->chunks[ c ] );
+        }
+    }
+}
+
+// Maps a schedule(auto) candidate to the schedule and chunk used for a loop of tc iterations.
+template< typename T >
+static enum sched_type
+__kmp_auto_cand_schedule( int cand, typename traits_t< T >::unsigned_t tc, int nproc,
+                          typename traits_t< T >::signed_t *chunk )
+{
+    typedef typename traits_t< T >::unsigned_t  UT;
+    typedef typename traits_t< T >::signed_t    ST;
+    UT c;
+
+    switch ( cand ) {
+    case kmp_auto_dynamic_fine:
+    case kmp_auto_dynamic_coarse:
+        c = tc / ( (UT)nproc * ( cand == kmp_auto_dynamic_fine ? 64 : 8 ) );
+        *chunk = c > 0 ? (ST)c : 1;
+        return kmp_sch_dynamic_chunked;
+    case kmp_auto_guided:
+        return kmp_sch_guided_analytical_chunked;
+    default:
+        return kmp_sch_static_balanced;
+    }
+}
+
+/* ------------------------------------------------------------------------ */
+/* Dispatch statistics of the dynamic loops (KMP_LOOP_STATS).
+   Every loop site (ident_t) going through __kmp_dispatch_init gets an entry with the schedule it
+   ran under, its executions and trip counts, and for every thread of the team the chunks it got,
+   the time it spent in the dispatcher (init and next) and the time it spent in the loop body.
+   A thread keeps the figures of the loop it is in in its kmp_disp_t and adds them to the site
+   when the dispatcher returns no more work, so the shared entry is written once per loop and
+   thread.  Times are in KMP_AUTO_NOW() ticks.  The table is printed at exit and can be read with
+   the __kmpc_loop_stats_* entry points; it does not need LIBOMP_STATS. */
+
+#define KMP_LOOP_STATS_SITES   256 // loop sites that can be recorded
+#define KMP_LOOP_STATS_THREADS 64  // per-thread entries of a site, higher tids go to the last one
+
+typedef struct kmp_loop_thread_stats {
+    volatile kmp_uint64 loops;   // executions the thread took part in
+    volatile kmp_uint64 chunks;  // chunks handed out to the thread
+    volatile kmp_uint64 busy;    // ticks in the loop body
+    volatile kmp_uint64 wait;    // ticks in the dispatcher
+} kmp_loop_thread_stats_t;
+
+typedef struct kmp_loop_site {
+    ident_t * volatile        loc;
+    volatile kmp_int32        schedule;    // schedule of the last execution, ordered variant if ordered
+    volatile kmp_uint64       runs;        // executions of the loop
+    volatile kmp_uint64       iterations;  // sum of the trip counts
+    volatile kmp_uint64       max_tc;      // largest trip count
+    kmp_loop_thread_stats_t * volatile threads;
+} kmp_loop_site_t;
+
+static kmp_loop_site_t __kmp_loop_sites[ KMP_LOOP_STATS_SITES ];
+
+static kmp_loop_site_t *
+__kmp_loop_stats_find_site( ident_t *loc )
+{
+    kmp_uint32 h, probe;
+
+    if ( loc == NULL )
+        return NULL;
+    h = (kmp_uint32)( ( (kmp_uintptr_t)loc >> 4 ) % KMP_LOOP_STATS_SITES );
+    for ( probe = 0; probe < KMP_LOOP_STATS_SITES; ++probe, h = ( h + 1 ) % KMP_LOOP_STATS_SITES ) {
+        kmp_loop_site_t *site = &__kmp_loop_sites[ h ];
+        ident_t *cur = (ident_t *) TCR_PTR( site->loc );
+        if ( cur == NULL ) {
+            if ( KMP_COMPARE_AND_STORE_PTR( &site->loc, NULL, loc ) )
+                return site;
+            cur = (ident_t *) TCR_PTR( site->loc );
+        }
+        if ( cur == loc )
+            return site;
+    }
+    return NULL;
+}
+
+// Called at the end of __kmp_dispatch_init: starts the figures of the thread for this execution.
+static void
+__kmp_loop_stats_begin( kmp_info_t *th, ident_t *loc, int tid, enum sched_type schedule, int ordered,
+                        kmp_uint64 tc, kmp_uint64 start )
+{
+    kmp_disp_t *disp = th->th.th_dispatch;
+    kmp_loop_site_t *site = __kmp_loop_stats_find_site( loc );
+
+    disp->th_loop_site = NULL;
+    if ( site == NULL )
+        return;
+    if ( TCR_PTR( site->threads ) == NULL ) {
+        kmp_loop_thread_stats_t *threads = (kmp_loop_thread_stats_t *)__kmp_allocate(
+            sizeof( kmp_loop_thread_stats_t ) * KMP_LOOP_STATS_THREADS );
+        if ( ! KMP_COMPARE_AND_STORE_PTR( &site->threads, NULL, threads ) )
+            __kmp_free( threads );
+    }
+    if ( tid == 0 ) {
+        kmp_uint64 max_tc = site->max_tc;
+        TCW_4( site->schedule, ordered ? schedule + ( kmp_ord_lower - kmp_sch_lower ) : schedule );
+        KMP_TEST_THEN_INC64( (volatile kmp_int64 *)&site->runs );
+        KMP_TEST_THEN_ADD64( (volatile kmp_int64 *)&site->iterations, (kmp_int64)tc );
+        while ( tc > max_tc && ! KMP_COMPARE_AND_STORE_ACQ64( (volatile kmp_int64 *)&site->max_tc,
+                                                              (kmp_int64)max_tc, (kmp_int64)tc ) )
+            max_tc = site->max_tc;
+    }
+    disp->th_loop_start = start;
+    disp->th_loop_chunks = 0;
+    disp->th_loop_wait = KMP_AUTO_NOW() - start;
+    disp->th_loop_site = site;
+}
+
+// Called when the dispatcher returns no more work to the thread: adds its figures to the site.
+static void
+__kmp_loop_stats_end( kmp_info_t *th, kmp_uint64 now )
+{
+    kmp_disp_t *disp = th->th.th_dispatch;
+    kmp_loop_site_t *site = (kmp_loop_site_t *)disp->th_loop_site;
+    int tid = th->th.th_team->t.t_serialized ? 0 : th->th.th_info.ds.ds_tid;
+    kmp_loop_thread_stats_t *ts = &site->threads[ tid < KMP_LOOP_STATS_THREADS ? tid : KMP_LOOP_STATS_THREADS - 1 ];
+    kmp_uint64 elapsed = now - disp->th_loop_start;
+    kmp_uint64 wait = disp->th_loop_wait < elapsed ? disp->th_loop_wait : elapsed;
+
+    KMP_TEST_THEN_INC64( (volatile kmp_int64 *)&ts->loops );
+    KMP_TEST_THEN_ADD64( (volatile kmp_int64 *)&ts->chunks, (kmp_int64)disp->th_loop_chunks );
+    KMP_TEST_THEN_ADD64( (volatile kmp_int64 *)&ts->busy, (kmp_int64)( elapsed - wait ) );
+    KMP_TEST_THEN_ADD64( (volatile kmp_int64 *)&ts->wait, (kmp_int64)wait );
+    disp->th_loop_site = NULL;
+}
+
+static char const *
+__kmp_loop_stats_sched_name( int schedule )
+{
+    if ( schedule >= kmp_ord_lower && schedule < kmp_ord_upper )
+        schedule -= kmp_ord_lower - kmp_sch_lower;
+    switch ( schedule ) {
+    case kmp_sch_static_chunked:            return "static,chunked";
+    case kmp_sch_static_greedy:             return "static,greedy";
+    case kmp_sch_static_balanced:           return "static,balanced";
+#if OMP_45_ENABLED
+    case kmp_sch_static_balanced_chunked:   return "static,balanced_chunked";
+#endif
+    case kmp_sch_static_steal:              return "static_steal";
+    case kmp_sch_dynamic_chunked:           return "dynamic";
+    case kmp_sch_guided_iterative_chunked:  return "guided,iterative";
+    case kmp_sch_guided_analytical_chunked: return "guided,analytical";
+    case kmp_sch_trapezoidal:               return "trapezoidal";
+    case kmp_sch_hier_dynamic_chunked:      return "hier_dynamic";
+    case kmp_sch_hier_guided_chunked:       return "hier_guided";
+    case kmp_sch_sticky_dynamic_chunked:    return "sticky";
+    case kmp_sch_dist_dynamic_chunked:      return "dist_dynamic";
+    default:                                return "unknown";
+    }
+}
+
+// Prints the dispatch statistics of the loop sites; the imbalance is the busiest thread's time in
+// the loop body over the mean.
+void
+__kmp_dispatch_loop_stats_print( FILE *out )
+{
+    int i, t, header = 0;
+
+    for ( i = 0; i < KMP_LOOP_STATS_SITES; ++i ) {
+        kmp_loop_site_t const *site = &__kmp_loop_sites[ i ];
+        kmp_uint64 chunks = 0, busy = 0, wait = 0, max_busy = 0;
+        int nth = 0;
+        if ( site->loc == NULL || site->threads == NULL || site->runs == 0 )
+            continue;
+        for ( t = 0; t < KMP_LOOP_STATS_THREADS; ++t ) {
+            kmp_loop_thread_stats_t const *ts = &site->threads[ t ];
+            if ( ts->loops == 0 )
+                continue;
+            nth++;
+            chunks += ts->chunks;
+            busy += ts->busy;
+            wait += ts->wait;
+            if ( ts->busy > max_busy )
+                max_busy = ts->busy;
+        }
+        if ( ! header ) {
+            fprintf( out, "\nLoop site,        Schedule,  Runs,  Iterations,  Max trip count,  Chunks,"
+                          "  Busy ticks,  Dispatch ticks,  Imbalance\n" );
+            header = 1;
+        }
+        kmp_str_loc_t loc = __kmp_str_loc_init( site->loc->psource, 1 );
+        fprintf( out, "%s:%d (%s), %s%s, %llu, %llu, %llu, %llu, %llu, %llu, %.2f\n",
+                 loc.file ? loc.file : "unknown", loc.line, loc.func ? loc.func : "unknown",
+                 __kmp_loop_stats_sched_name( site->schedule ),
+                 site->schedule >= kmp_ord_lower ? ",ordered" : "",
+                 (unsigned long long)site->runs, (unsigned long long)site->iterations,
+                 (unsigned long long)site->max_tc, (unsigned long long)chunks,
+                 (unsigned long long)busy, (unsigned long long)wait,
+                 busy ? (double)max_busy * nth / busy : 1.0 );
+        __kmp_str_loc_free( &loc );
+        for ( t = 0; t < KMP_LOOP_STATS_THREADS; ++t ) {
+            kmp_loop_thread_stats_t const *ts = &site->threads[ t ];
+            if ( ts->loops )
+                fprintf( out, "  thread %2d%s, %llu runs, %llu chunks, %llu busy ticks, %llu dispatch ticks\n",
+                         t, t == KMP_LOOP_STATS_THREADS - 1 ? "+" : "", (unsigned long long)ts->loops,
+                         (unsigned long long)ts->chunks, (unsigned long long)ts->busy,
+                         (unsigned long long)ts->wait );
+        }
+    }
+}
+
+/* ------------------------------------------------------------------------ */
+/* Hierarchical dynamic and guided schedules (kmp_sch_hier_*).
+   The first thread to get the shared buffer splits the units of the loop (chunks under dynamic,
+   iterations under guided) across the NUMA domains of the team in proportion to the number of
+   threads in each.  Every domain hands out its part from its own counter in its own cache line,
+   so the threads of different sockets do not share a counter.  Threads of a drained domain move
+   on to the domain with the most remaining work.  The domains are the packages of the threads'
+   places when the threads are bound; otherwise the team is split into as many even blocks of
+   tids as the machine has packages (KMP_DISP_HIER_DOMAINS forces the number of blocks).  A team
+   that ends up in one domain is warned about once. */
+
+typedef struct KMP_ALIGN_CACHE kmp_disp_hier_domain {
+    volatile kmp_uint64 next;   // next unit of the domain to hand out
+    kmp_uint64          limit;  // end of the domain's units
+    kmp_uint32          nth;    // number of team threads in the domain
+} kmp_disp_hier_domain_t;
+
+static int __kmp_disp_hier_warned = FALSE;
+
+// Domain of thread tid: its package if the thread is bound to a place, else a block of tids.
+static int
+__kmp_disp_hier_domain_of( kmp_team_t *team, int tid, int nproc )
+{
+    int ndomains = __kmp_dispatch_hier_domains;
+
+    if ( ndomains == 0 ) {
+#if KMP_AFFINITY_SUPPORTED
+# if OMP_40_ENABLED
+        // Unbound threads all share the place of the full mask
+        if ( __kmp_affinity_place_package != NULL && __kmp_affinity_type != affinity_none &&
+             __kmp_affinity_type != affinity_disabled ) {
+            int place = team->t.t_threads[ tid ]->th.th_current_place;
+            if ( place >= 0 && place < (int)__kmp_affinity_num_masks )
+                return __kmp_affinity_place_package[ place ] % KMP_MAX_DISP_HIER_DOMAINS;
+        }
+# endif
+        ndomains = __kmp_affinity_num_packages;
+#endif
+        if ( ndomains < 1 )
+            ndomains = 1;
+        else if ( ndomains > KMP_MAX_DISP_HIER_DOMAINS )
+            ndomains = KMP_MAX_DISP_HIER_DOMAINS;
+    }
+    return tid * ndomains / nproc;
+}
+
+// Called by every thread once the shared buffer is free to use; returns the domain of the thread.
+template< typename UT >
+static int
+__kmp_disp_hier_setup( dispatch_shared_info_template< UT > volatile *sh, kmp_team_t *team, int tid,
+                       int nproc, kmp_uint64 units, enum sched_type schedule )
+{
+    if ( KMP_COMPARE_AND_STORE_ACQ32( (volatile kmp_int32 *)&sh->hier_state, 0, 1 ) ) {
+        kmp_disp_hier_domain_t *dom = sh->hier_domains;
+        kmp_uint32 nth[ KMP_MAX_DISP_HIER_DOMAINS ];
+        kmp_uint64 lo = 0, hi;
+        int d, i, seen = 0;
+
+        if ( dom == NULL ) {
+            dom = (kmp_disp_hier_domain_t *)__kmp_allocate( sizeof( kmp_disp_hier_domain_t ) *
+                                                            KMP_MAX_DISP_HIER_DOMAINS );
+            sh->hier_domains = dom;
+        }
+        for ( d = 0; d < KMP_MAX_DISP_HIER_DOMAINS; ++d )
+            nth[ d ] = 0;
+        for ( i = 0; i < nproc; ++i )
+            ++nth[ __kmp_disp_hier_domain_of( team, i, nproc ) ];
+        for ( d = 0; d < KMP_MAX_DISP_HIER_DOMAINS && nth[ d ] < (kmp_uint32)nproc; ++d );
+        if ( d < KMP_MAX_DISP_HIER_DOMAINS && ! __kmp_disp_hier_warned ) {
+            __kmp_disp_hier_warned = TRUE;
+            if ( schedule == kmp_sch_hier_dynamic_chunked )
+                KMP_WARNING( DispHierOneDomain, "hier_dynamic", "dynamic" );
+            else
+                KMP_WARNING( DispHierOneDomain, "hier_guided", "guided" );
+        }
+        for ( d = 0; d < KMP_MAX_DISP_HIER_DOMAINS; ++d ) {
+            seen += nth[ d ];
+            hi = ( units / nproc ) * seen + ( units % nproc ) * seen / nproc;
+            dom[ d ].next  = lo;
+            dom[ d ].limit = hi;
+            dom[ d ].nth   = nth[ d ];
+            lo = hi;
+        }
+        KMP_MB();
+        TCW_4( sh->hier_state, 2 );
+    } else {
+        __kmp_wait_yield< kmp_uint32 >( & sh->hier_state, 2, __kmp_eq< kmp_uint32 >
+                                        USE_ITT_BUILD_ARG( NULL )
+                                        );
+    }
+    return __kmp_disp_hier_domain_of( team, tid, nproc );
+}
+
+// Domain with the most units left, -1 if all are drained.
+static int
+__kmp_disp_hier_victim( kmp_disp_hier_domain_t *dom )
+{
+    int d, best = -1;
+    kmp_uint64 most = 0;
+    for ( d = 0; d < KMP_MAX_DISP_HIER_DOMAINS; ++d ) {
+        kmp_uint64 next = dom[ d ].next, limit = dom[ d ].limit;
+        if ( next < limit && limit - next > most ) {
+            most = limit - next;
+            best = d;
+        }
+    }
+    return best;
+}
+
+/* ------------------------------------------------------------------------ */
+/* Sticky dynamic schedule (kmp_sch_sticky_dynamic_chunked), affinity scheduling after Markatos
+   and LeBlanc.  Every loop site remembers which thread ran each chunk of its last execution.  The
+   next execution first offers every thread the chunks it ran last time, in order, so the data a
+   thread touched stays in its caches and NUMA node across the time steps of a program.  A thread
+   done with its own chunks takes the others' from the end of the loop down, away from where their
+   owners are working, and becomes their owner for the next execution.  The first execution, and
+   any execution of a different shape (trip count, chunk or team size), starts from blocks of
+   consecutive chunks as static would give.  A chunk is taken by writing the execution number
+   into it, so an owner and a thief never both run it.  The site is used by one team at a time,
+   other teams and sites that do not fit the table run the loop as plain dynamic. */
+
+#define KMP_STICKY_SITES      256     // loop sites that can be recorded
+#define KMP_STICKY_MAX_CHUNKS (1<<20) // larger loops run as plain dynamic
+
+typedef struct kmp_sticky_chunk {
+    volatile kmp_int32  owner;  // thread that ran the chunk last
+    volatile kmp_uint32 taken;  // execution that took the chunk
+} kmp_sticky_chunk_t;
+
+typedef struct kmp_sticky_site {
+    ident_t * volatile  loc;
+    volatile kmp_int32  busy;     // a team is running the loop
+    kmp_uint32          gen;      // number of the current execution, 0 never
+    kmp_int32           nproc;    // shape of the recorded execution
+    kmp_uint64          tc;
+    kmp_int64           chunk;
+    kmp_uint32          nchunks;
+    kmp_uint32          cap;      // chunks allocated
+    kmp_sticky_chunk_t *chunks;
+} kmp_sticky_site_t;
+
+static kmp_sticky_site_t __kmp_sticky_sites[ KMP_STICKY_SITES ];
+
+static kmp_sticky_site_t *
+__kmp_sticky_find_site( ident_t *loc )
+{
+    kmp_uint32 h, probe;
+
+    if ( loc == NULL )
+        return NULL;
+    h = (kmp_uint32)( ( (kmp_uintptr_t)loc >> 4 ) % KMP_STICKY_SITES );
+    for ( probe = 0; probe < KMP_STICKY_SITES; ++probe, h = ( h + 1 ) % KMP_STICKY_SITES ) {
+        kmp_sticky_site_t *site = &__kmp_sticky_sites[ h ];
+        ident_t *cur = (ident_t *) TCR_PTR( site->loc );
+        if ( cur == NULL ) {
+            if ( KMP_COMPARE_AND_STORE_PTR( &site->loc, NULL, loc ) )
+                return site;
+            cur = (ident_t *) TCR_PTR( site->loc );
+        }
+        if ( cur == loc )
+            return site;
+    }
+    return NULL;
+}
+
+// The first thread to get the shared buffer takes the site for the team and starts a new
+// execution; the others wait for it.  sh->sticky_site is left NULL if the site cannot be used.
+template< typename UT >
+static void
+__kmp_sticky_setup( dispatch_shared_info_template< UT > volatile *sh, ident_t *loc, int nproc,
+                    kmp_uint64 tc, kmp_int64 chunk, kmp_uint64 nchunks )
+{
+    if ( KMP_COMPARE_AND_STORE_ACQ32( (volatile kmp_int32 *)&sh->hier_state, 0, 1 ) ) {
+        kmp_sticky_site_t *site = NULL;
+        if ( nchunks <= KMP_STICKY_MAX_CHUNKS )
+            site = __kmp_sticky_find_site( loc );
+        if ( site != NULL && KMP_COMPARE_AND_STORE_ACQ32( &site->busy, 0, 1 ) ) {
+            kmp_uint32 c, n = (kmp_uint32)nchunks;
+            if ( site->nproc != nproc || site->tc != tc || site->chunk != chunk ) {
+                // no history for this shape: start from blocks of consecutive chunks
+                if ( site->cap < n ) {
+                    if ( site->chunks != NULL )
+                        __kmp_free( site->chunks );
+                    site->chunks = (kmp_sticky_chunk_t *)__kmp_allocate( sizeof( kmp_sticky_chunk_t ) * n );
+                    site->cap = n;
+                }
+                for ( c = 0; c < n; ++c ) {
+                    site->chunks[ c ].owner = (kmp_int32)( (kmp_uint64)c * nproc / n );
+                    site->chunks[ c ].taken = 0;
+                }
+                site->nproc = nproc;
+                site->tc = tc;
+                site->chunk = chunk;
+                site->nchunks = n;
+                site->gen = 0;
+            }
+            if ( ++site->gen == 0 ) {
+                // execution numbers wrapped around, forget which one took the chunks
+                for ( c = 0; c < n; ++c )
+                    site->chunks[ c ].taken = 0;
+                site->gen = 1;
+            }
+            sh->sticky_site = site;
+        } else {
+            sh->sticky_site = NULL;
+        }
+        KMP_MB();
+        TCW_4( sh->hier_state, 2 );
+    } else {
+        __kmp_wait_yield< kmp_uint32 >( & sh->hier_state, 2, __kmp_eq< kmp_uint32 >
+                                        USE_ITT_BUILD_ARG( NULL )
+                                        );
+    }
+}
+
+// Takes chunk c for the execution gen if nobody did.
+static inline int
+__kmp_sticky_take( kmp_sticky_chunk_t *ch, kmp_uint32 gen )
+{
+    kmp_uint32 taken = ch->taken;
+    return taken != gen && KMP_COMPARE_AND_STORE_ACQ32( (volatile kmp_int32 *)&ch->taken,
+                                                        (kmp_int32)taken, (kmp_int32)gen );
+}
+
+#if OMP_40_ENABLED
+/* ------------------------------------------------------------------------ */
+/* Dynamic distribute (KMP_DIST_SCHEDULE=dynamic).  The dynamic loops of a distribute parallel
+   for construct are cut into blocks of consecutive chunks that the teams of the league pull from
+   a league-wide counter, instead of every team getting a fixed share of the iterations up front.
+   Within its block a team hands out the chunks as dynamic does, on the team's own dispatch buffer;
+   the league counter is only touched when the block of the team runs out.  The team word packs
+   the block (plus one) in the high half and the number of its chunks taken in the low half, so a
+   chunk costs one CAS on a team-local line; the thread that finds the block empty locks the word
+   while it fetches the next block.  Successive distribute loops of a teams construct use the
+   KMP_DIST_LEAGUE_SLOTS counters in turn, a counter is reset by the last team to finish its loop
+   and taken up again KMP_DIST_LEAGUE_SLOTS loops later, so teams may run that many loops apart. */
+
+#define KMP_DIST_LEAGUE_SLOTS 4           // distribute loops in flight in a league
+#define KMP_DIST_BLOCKS_PER_TEAM 8        // blocks per team when KMP_DIST_SCHEDULE gives no size
+#define KMP_DIST_MAX_CHUNKS_PER_BLOCK ( (kmp_uint64)1 << 30 )
+#define KMP_DIST_MAX_BLOCKS ( (kmp_uint64)0xFFFFFFF0 )
+#define KMP_DIST_LOCKED ( (kmp_uint64)0xFFFFFFFF )       // low half: a thread is fetching a block
+#define KMP_DIST_DONE   ( (kmp_uint64)0xFFFFFFFF << 32 ) // no block left for the team
+
+typedef struct KMP_ALIGN_CACHE kmp_dist_league_slot {
+    volatile kmp_uint64 next;  // next block of the loop
+    volatile kmp_uint32 loop;  // distribute loop of the teams construct the counter serves
+    volatile kmp_uint32 done;  // teams done with the loop
+} kmp_dist_league_slot_t;
+
+typedef struct kmp_dist_league {
+    kmp_dist_league_slot_t slot[ KMP_DIST_LEAGUE_SLOTS ];
+} kmp_dist_league_t;
+
+// Called by the master of the teams construct before the league is forked; freed after the join.
+kmp_dist_league_t *
+__kmp_dist_league_allocate( void )
+{
+    int i;
+    kmp_dist_league_t *league = (kmp_dist_league_t *)__kmp_allocate( sizeof( kmp_dist_league_t ) );
+    for ( i = 0; i < KMP_DIST_LEAGUE_SLOTS; ++i )
+        league->slot[ i ].loop = i;
+    return league;
+}
+
+// Chunks per block of a loop of nchunks chunks of size chunk: the same in every team, 0 if the
+// loop has too many chunks to be numbered in the team word.
+static kmp_uint64
+__kmp_dist_chunks_per_block( kmp_uint64 tc, kmp_uint64 chunk, kmp_uint64 nchunks, int nteams )
+{
+    kmp_uint64 iters = __kmp_dist_block > 0 ? (kmp_uint64)__kmp_dist_block
+                                            : tc / ( (kmp_uint64)nteams * KMP_DIST_BLOCKS_PER_TEAM );
+    kmp_uint64 cpb = iters / chunk;
+
+    if ( cpb == 0 )
+        cpb = 1;
+    if ( nchunks / cpb >= KMP_DIST_MAX_BLOCKS )
+        cpb = nchunks / KMP_DIST_MAX_BLOCKS + 1;
+    return cpb <= KMP_DIST_MAX_CHUNKS_PER_BLOCK ? cpb : 0;
+}
+
+// Starts the next distribute loop of the team on the league counter serving it.
+static void
+__kmp_dist_team_start( kmp_info_t *master, kmp_dist_team_t volatile *dt )
+{
+    kmp_dist_league_t *league = master->th.th_dist_league;
+    kmp_uint32 loop = master->th.th_dist_loops++;
+    kmp_dist_league_slot_t *slot = &league->slot[ loop % KMP_DIST_LEAGUE_SLOTS ];
+
+    // the counter is free once every team is done with the loop KMP_DIST_LEAGUE_SLOTS earlier
+    __kmp_wait_yield< kmp_uint32 >( & slot->loop, loop, __kmp_eq< kmp_uint32 >
+                                    USE_ITT_BUILD_ARG( NULL )
+                                    );
+    dt->slot = slot;
+    dt->word = 0;
+}
+
+// Called once per team when the team is done with the loop; the last team resets the counter.
+static void
+__kmp_dist_team_done( kmp_dist_team_t volatile *dt, int nteams )
+{
+    kmp_dist_league_slot_t *slot = dt->slot;
+
+    if ( slot == NULL )
+        return;
+    dt->slot = NULL;
+    if ( (int)KMP_TEST_THEN_INC32( (volatile kmp_int32 *)&slot->done ) == nteams - 1 ) {
+        slot->next = 0;
+        slot->done = 0;
+        KMP_MB();
+        TCW_4( slot->loop, slot->loop + KMP_DIST_LEAGUE_SLOTS );
+    }
+}
+
+// Takes the next chunk of the team; returns 0 when the league has no block left.
+static int
+__kmp_dist_next( kmp_dist_team_t volatile *dt, kmp_uint64 nchunks, kmp_uint64 cpb, kmp_uint64 *chunk )
+{
+    kmp_uint64 nblocks = ( nchunks + cpb - 1 ) / cpb;
+
+    for ( ;; ) {
+        kmp_uint64 w = dt->word;
+        kmp_uint64 block = w >> 32;   // block plus one, 0 if none yet
+        kmp_uint64 taken = w & 0xFFFFFFFF;
+
+        if ( w == KMP_DIST_DONE )
+            return 0;
+        if ( taken == KMP_DIST_LOCKED ) {
+            KMP_CPU_PAUSE();
+            KMP_YIELD( TCR_4(__kmp_nth) > __kmp_avail_proc );
+            continue;
+        }
+        if ( block != 0 && ( block - 1 ) * cpb + taken < nchunks && taken < cpb ) {
+            if ( KMP_COMPARE_AND_STORE_ACQ64( (volatile kmp_int64 *)&dt->word, (kmp_int64)w, (kmp_int64)( w + 1 ) ) ) {
+                *chunk = ( block - 1 ) * cpb + taken;
+                return 1;
+            }
+            continue;
+        }
+        // the block of the team is used up: fetch the next one from the league
+        if ( ! KMP_COMPARE_AND_STORE_ACQ64( (volatile kmp_int64 *)&dt->word, (kmp_int64)w,
+                                            (kmp_int64)( ( w & ~(kmp_uint64)0xFFFFFFFF ) | KMP_DIST_LOCKED ) ) )
+            continue;
+        block = KMP_TEST_THEN_INC64( (volatile kmp_int64 *)&dt->slot->next );
+        KMP_MB();
+        if ( block >= nblocks ) {
+            dt->word = KMP_DIST_DONE;
+            return 0;
+        }
+        dt->word = ( ( block + 1 ) << 32 ) | 1;
+        *chunk = block * cpb;
+        return 1;
+    }
+}
+
+// The first thread of the team to get the shared buffer starts the loop on the league counter;
+// the others wait for it.
+template< typename UT >
+static void
+__kmp_dist_setup( dispatch_shared_info_template< UT > volatile *sh, kmp_info_t *master )
+{
+    if ( KMP_COMPARE_AND_STORE_ACQ32( (volatile kmp_int32 *)&sh->hier_state, 0, 1 ) ) {
+        __kmp_dist_team_start( master, &sh->dist );
+        KMP_MB();
+        TCW_4( sh->hier_state, 2 );
+    } else {
+        __kmp_wait_yield< kmp_uint32 >( & sh->hier_state, 2, __kmp_eq< kmp_uint32 >
+                                        USE_ITT_BUILD_ARG( NULL )
+                                        );
+    }
+}
+#endif /* OMP_40_ENABLED */
+
 // UT - unsigned flavor of T, ST - signed flavor of T,
 // DBL - double if sizeof(T)==4, or long double if sizeof(T)==8
 template< typename T >
@@ -621,6 +1614,8 @@ __kmp_dispatch_init(
     kmp_uint32                                     my_buffer_index;
     dispatch_private_info_template< T >          * pr;
     dispatch_shared_info_template< UT > volatile * sh;
+    kmp_auto_site_t                              * auto_site = NULL;
+    kmp_uint64                                     stats_start = __kmp_loop_stats ? KMP_AUTO_NOW() : 0;
 
     KMP_BUILD_ASSERT( sizeof( dispatch_private_info_template< T > ) == sizeof( dispatch_private_info ) );
     KMP_BUILD_ASSERT( sizeof( dispatch_shared_info_template< UT > ) == sizeof( dispatch_shared_info ) );
@@ -736,6 +1731,9 @@ __kmp_dispatch_init(
         if ( schedule == kmp_sch_auto ) {
             // mapping and differentiation: in the __kmp_do_serial_initialize()
             schedule = __kmp_auto;
+            // the self-tuning choice is made below once the trip count is known
+            if ( __kmp_auto_adaptive && active && th->th.th_team_nproc > 1 )
+                auto_site = __kmp_auto_find_site( loc );
             #ifdef KMP_DEBUG
             {
                 const char * buff;
@@ -794,6 +1792,40 @@ __kmp_dispatch_init(
         }
     }
 
+    if ( auto_site != NULL ) {
+        // All threads must run the same candidate: the first thread to get the shared buffer chooses.
+        // Waiting for the buffer before the switch below is safe, the wait after it then returns at once.
+        int cand = __kmp_auto_choose( auto_site );
+        __kmp_wait_yield< kmp_uint32 >( & sh->buffer_index, my_buffer_index, __kmp_eq< kmp_uint32 >
+                                        USE_ITT_BUILD_ARG( NULL )
+                                        );
+        if ( KMP_COMPARE_AND_STORE_ACQ32( &sh->auto_sched, 0, cand + 1 ) ) {
+            sh->auto_site = auto_site;
+            sh->auto_start = KMP_AUTO_NOW();
+        } else {
+            cand = TCR_4( sh->auto_sched ) - 1;
+        }
+        schedule = __kmp_auto_cand_schedule< T >( cand, tc, th->th.th_team_nproc, &chunk );
+        pr->u.p.parm1 = chunk;
+        KD_TRACE(100, ("__kmp_dispatch_init: T#%d kmp_sch_auto: candidate %d schedule:%d\n",
+                       gtid, cand, schedule ) );
+    }
+
+    if ( schedule == kmp_sch_hier_dynamic_chunked || schedule == kmp_sch_hier_guided_chunked ) {
+        // Nothing to partition in a serialized or one-thread team, and the ordered loops need
+        // the iterations in order: use the flat schedules there.
+        if ( ! active || th->th.th_team_nproc == 1 || pr->ordered ) {
+            schedule = ( schedule == kmp_sch_hier_dynamic_chunked ) ? kmp_sch_dynamic_chunked : __kmp_guided;
+            if ( schedule == kmp_sch_guided_analytical_chunked && th->th.th_team_nproc > 1<<20 )
+                schedule = kmp_sch_guided_iterative_chunked;
+        }
+    }
+    if ( schedule == kmp_sch_sticky_dynamic_chunked ) {
+        // no other thread to keep the chunks away from, and the ordered loops need them in order
+        if ( ! active || th->th.th_team_nproc == 1 || pr->ordered )
+            schedule = kmp_sch_dynamic_chunked;
+    }
+
     // Any half-decent optimizer will remove this test when the blocks are empty since the macros expand to nothing
     // when statistics are disabled.
     if (schedule == __kmp_static)
@@ -807,6 +1839,15 @@ __kmp_dispatch_init(
         KMP_COUNT_VALUE(FOR_dynamic_iterations, tc);
     }
 
+    // static_aligned from OMP_SCHEDULE or KMP_SCHEDULE: the balanced parts with the thread
+    // boundaries aligned to the chunk; the ordered loops keep the plain balanced parts.
+    UT align = 0;
+    if ( schedule == kmp_sch_static_aligned ) {
+        if ( ! pr->ordered )
+            align = chunk > 1 ? (UT)chunk : (UT)KMP_DEFAULT_STATIC_ALIGN;
+        schedule = kmp_sch_static_balanced;
+    }
+
     pr->u.p.lb = lb;
     pr->u.p.ub = ub;
     pr->u.p.st = st;
@@ -828,6 +1869,9 @@ __kmp_dispatch_init(
             pr->u.p.ordered_lower = 1;
             pr->u.p.ordered_upper = 0;
 
+            // forget the grants of the earlier loops, the buffer indices restart in every region
+            KMP_XCHG_FIXED64( &th->th.th_dispatch->th_ordered_grant, 0 );
+
             th -> th.th_dispatch -> th_deo_fcn = __kmp_dispatch_deo< UT >;
             th -> th.th_dispatch -> th_dxo_fcn = __kmp_dispatch_dxo< UT >;
         }
@@ -867,13 +1911,10 @@ __kmp_dispatch_init(
 
                 pr->u.p.parm2 = lb;
                 //pr->pfields.parm3 = 0; // it's not used in static_steal
-                pr->u.p.parm4 = (id + 1) % nproc; // remember neighbour tid
+                pr->u.p.parm4 = (id + 1) % nproc; // first victim to steal from
                 pr->u.p.st = st;
-                if ( ___kmp_size_type > 4 ) {
-                    // AC: TODO: check if 16-byte CAS available and use it to
-                    // improve performance (probably wait for explicit request
-                    // before spending time on this).
-                    // For now use dynamically allocated per-thread lock,
+                if ( ! __kmp_steal_use_cas< T >() ) {
+                    // No 16-byte CAS: use dynamically allocated per-thread lock,
                     // free memory in __kmp_dispatch_next when status==0.
                     KMP_DEBUG_ASSERT(th->th.th_dispatch->th_steal_lock == NULL);
                     th->th.th_dispatch->th_steal_lock =
@@ -911,6 +1952,28 @@ __kmp_dispatch_init(
                         pr->u.p.parm1 = FALSE;
                         break;
                     }
+                } else if ( align > 0 ) {
+                    UT offset = 0, start, end;
+                    if ( st == 1 || st == -1 ) {
+                        // first iteration whose index (plus one for decreasing loops) is a multiple of align
+                        ST rem = (ST)( ( st == 1 ? lb : lb + 1 ) % (ST)align );
+                        if ( rem < 0 )
+                            rem += align;
+                        if ( st == 1 )
+                            offset = rem ? align - rem : 0;
+                        else
+                            offset = rem;
+                    }
+                    start = (UT)__kmp_static_aligned_bound( tc, nproc, id, align, offset );
+                    end = (UT)__kmp_static_aligned_bound( tc, nproc, id + 1, align, offset );
+                    if ( start == end ) {
+                        pr->u.p.count = 1;  /* means no more chunks to execute */
+                        pr->u.p.parm1 = FALSE;
+                        break;
+                    }
+                    init = start;
+                    limit = end - 1;
+                    pr->u.p.parm1 = (end == tc);
                 } else {
                     T small_chunk = tc / nproc;
                     T extras = tc % nproc;
@@ -1108,6 +2171,49 @@ __kmp_dispatch_init(
         }
         KD_TRACE(100,("__kmp_dispatch_init: T#%d kmp_sch_static_chunked/kmp_sch_dynamic_chunked cases\n", gtid));
         break;
+    case kmp_sch_hier_dynamic_chunked :
+    case kmp_sch_hier_guided_chunked :
+        {
+            UT c;
+            if ( pr->u.p.parm1 <= 0 ) {
+                pr->u.p.parm1 = KMP_DEFAULT_CHUNK;
+            }
+            c = pr->u.p.parm1;
+            // units handed out by the domains: chunks under dynamic, iterations under guided
+            pr->u.p.parm2 = ( schedule == kmp_sch_hier_dynamic_chunked ) ? tc / c + ( tc % c != 0 ) : tc;
+            KD_TRACE(100,("__kmp_dispatch_init: T#%d kmp_sch_hier_dynamic_chunked/kmp_sch_hier_guided_chunked cases\n", gtid));
+        }
+        break;
+    case kmp_sch_sticky_dynamic_chunked :
+        {
+            UT c;
+            if ( pr->u.p.parm1 <= 0 ) {
+                pr->u.p.parm1 = KMP_DEFAULT_CHUNK;
+            }
+            c = pr->u.p.parm1;
+            pr->u.p.parm2 = tc / c + ( tc % c != 0 ); // number of chunks
+            pr->u.p.parm3 = 0;                        // next chunk to look at for one of the thread's own
+            KD_TRACE(100,("__kmp_dispatch_init: T#%d kmp_sch_sticky_dynamic_chunked case\n", gtid));
+        }
+        break;
+#if OMP_40_ENABLED
+    case kmp_sch_dist_dynamic_chunked :
+        {
+            UT c;
+            if ( pr->u.p.parm1 <= 0 ) {
+                pr->u.p.parm1 = KMP_DEFAULT_CHUNK;
+            }
+            c = pr->u.p.parm1;
+            pr->u.p.parm3 = tc / c + ( tc % c != 0 ); // number of chunks
+            pr->u.p.parm2 = __kmp_dist_chunks_per_block( (kmp_uint64)(UT)tc, c, (kmp_uint64)(UT)pr->u.p.parm3,
+                                                         th->th.th_teams_size.nteams );
+            KMP_DEBUG_ASSERT( pr->u.p.parm2 != 0 );
+            if ( ! active )
+                __kmp_dist_team_start( th, &th->th.th_dispatch->th_dist );
+            KD_TRACE(100,("__kmp_dispatch_init: T#%d kmp_sch_dist_dynamic_chunked case\n", gtid));
+        }
+        break;
+#endif
     case kmp_sch_trapezoidal :
         {
             /* TSS: trapezoid self-scheduling, minimum chunk_size = parm1 */
@@ -1183,6 +2289,27 @@ __kmp_dispatch_init(
         KD_TRACE(100, ("__kmp_dispatch_init: T#%d after wait: my_buffer_index:%d sh->buffer_index:%d\n",
                         gtid, my_buffer_index, sh->buffer_index) );
 
+        if ( pr->ordered && schedule == kmp_sch_dynamic_chunked && sh->ordered_owners == NULL ) {
+            kmp_disp_ordered_owner_t *owners = (kmp_disp_ordered_owner_t *)__kmp_allocate(
+                sizeof( kmp_disp_ordered_owner_t ) * __kmp_disp_ordered_ring_size( team ) );
+            if ( ! KMP_COMPARE_AND_STORE_PTR( &sh->ordered_owners, NULL, owners ) )
+                __kmp_free( owners );
+        }
+        if ( schedule == kmp_sch_hier_dynamic_chunked || schedule == kmp_sch_hier_guided_chunked ) {
+            // parm3 - domain the thread takes its chunks from
+            pr->u.p.parm3 = __kmp_disp_hier_setup< UT >( sh, team, __kmp_tid_from_gtid( gtid ),
+                                                         th->th.th_team_nproc, (kmp_uint64)(UT)pr->u.p.parm2,
+                                                         schedule );
+        }
+        if ( schedule == kmp_sch_sticky_dynamic_chunked ) {
+            __kmp_sticky_setup< UT >( sh, loc, th->th.th_team_nproc, (kmp_uint64)(UT)tc,
+                                      (kmp_int64)pr->u.p.parm1, (kmp_uint64)(UT)pr->u.p.parm2 );
+        }
+#if OMP_40_ENABLED
+        if ( schedule == kmp_sch_dist_dynamic_chunked )
+            __kmp_dist_setup< UT >( sh, team->t.t_threads[ 0 ] );
+#endif
+
         th -> th.th_dispatch -> th_dispatch_pr_current = (dispatch_private_info_t*) pr;
         th -> th.th_dispatch -> th_dispatch_sh_current = (dispatch_shared_info_t*)  sh;
 #if USE_ITT_BUILD
@@ -1201,10 +2328,14 @@ __kmp_dispatch_init(
                 cur_chunk = pr->u.p.parm1;
                 break;
             case kmp_sch_dynamic_chunked:
+            case kmp_sch_hier_dynamic_chunked:
+            case kmp_sch_sticky_dynamic_chunked:
+            case kmp_sch_dist_dynamic_chunked:
                 schedtype = 1;
                 break;
             case kmp_sch_guided_iterative_chunked:
             case kmp_sch_guided_analytical_chunked:
+            case kmp_sch_hier_guided_chunked:
                 schedtype = 2;
                 break;
             default:
@@ -1251,6 +2382,9 @@ __kmp_dispatch_init(
         *p = *p + 1;
       }
     #endif // ( KMP_STATIC_STEAL_ENABLED )
+    if ( stats_start != 0 )
+        __kmp_loop_stats_begin( th, loc, active ? __kmp_tid_from_gtid( gtid ) : 0, schedule, pr->ordered,
+                                (kmp_uint64)(UT)tc, stats_start );
 
 #if OMPT_SUPPORT && OMPT_TRACE
     if (ompt_enabled &&
@@ -1310,9 +2444,7 @@ __kmp_dispatch_finish( int gtid, ident_t *loc )
             }
             #endif
 
-            __kmp_wait_yield< UT >(&sh->u.s.ordered_iteration, lower, __kmp_ge< UT >
-                                   USE_ITT_BUILD_ARG(NULL)
-                                   );
+            __kmp_dispatch_ordered_wait< UT >( th, pr, sh, lower );
             KMP_MB();  /* is this necessary? */
             #ifdef KMP_DEBUG
             {
@@ -1326,7 +2458,7 @@ __kmp_dispatch_finish( int gtid, ident_t *loc )
             }
             #endif
 
-            test_then_inc< ST >( (volatile ST *) & sh->u.s.ordered_iteration );
+            __kmp_dispatch_ordered_release< UT >( th, pr, sh, 1 );
         } // if
     } // if
     KD_TRACE(100, ("__kmp_dispatch_finish: T#%d returned\n", gtid ) );
@@ -1380,9 +2512,7 @@ __kmp_dispatch_finish_chunk( int gtid, ident_t *loc )
                 }
                 #endif
 
-                __kmp_wait_yield< UT >(&sh->u.s.ordered_iteration, lower, __kmp_ge< UT >
-                                       USE_ITT_BUILD_ARG(NULL)
-                                       );
+                __kmp_dispatch_ordered_wait< UT >( th, pr, sh, lower );
 
                 KMP_MB();  /* is this necessary? */
                 KD_TRACE(1000, ("__kmp_dispatch_finish_chunk: T#%d resetting ordered_bumped to zero\n",
@@ -1402,7 +2532,7 @@ __kmp_dispatch_finish_chunk( int gtid, ident_t *loc )
                 }
                 #endif
 
-                test_then_add< ST >( (volatile ST *) & sh->u.s.ordered_iteration, inc);
+                __kmp_dispatch_ordered_release< UT >( th, pr, sh, inc );
             }
 //        }
     }
@@ -1483,6 +2613,40 @@ __kmp_dispatch_next(
                     pr->pushed_ws = __kmp_pop_workshare( gtid, pr->pushed_ws, loc );
                 }
             }
+#if OMP_40_ENABLED
+        } else if ( pr->schedule == kmp_sch_dist_dynamic_chunked ) {
+            kmp_dist_team_t *dt = &th->th.th_dispatch->th_dist;
+            T          chunk = pr->u.p.parm1;
+            kmp_uint64 c;
+
+            KD_TRACE(100, ("__kmp_dispatch_next: T#%d kmp_sch_dist_dynamic_chunked case\n", gtid ) );
+
+            if ( (status = __kmp_dist_next( dt, (UT)pr->u.p.parm3, (UT)pr->u.p.parm2, &c )) == 0 ) {
+                __kmp_dist_team_done( dt, th->th.th_teams_size.nteams );
+                pr->u.p.tc = 0;
+                *p_lb = 0;
+                *p_ub = 0;
+                if ( p_st != NULL )
+                    *p_st = 0;
+                if ( __kmp_env_consistency_check ) {
+                    if ( pr->pushed_ws != ct_none ) {
+                        pr->pushed_ws = __kmp_pop_workshare( gtid, pr->pushed_ws, loc );
+                    }
+                }
+            } else {
+                UT init  = (UT)c * chunk;
+                UT limit = init + chunk - 1;
+                UT trip  = pr->u.p.tc - 1;
+                if ( limit > trip )
+                    limit = trip;
+                if ( p_last != NULL )
+                    *p_last = ( limit == trip );
+                if ( p_st != NULL )
+                    *p_st = pr->u.p.st;
+                *p_lb = pr->u.p.lb + init * pr->u.p.st;
+                *p_ub = pr->u.p.lb + limit * pr->u.p.st;
+            }
+#endif
         } else if ( pr->nomerge ) {
             kmp_int32 last;
             T         start;
@@ -1607,9 +2771,8 @@ __kmp_dispatch_next(
 
                     trip = pr->u.p.tc - 1;
 
-                    if ( ___kmp_size_type > 4 ) {
-                        // use lock for 8-byte and CAS for 4-byte induction
-                        // variable. TODO (optional): check and use 16-byte CAS
+                    if ( ! __kmp_steal_use_cas< T >() ) {
+                        // use lock for 8-byte induction variable if 16-byte CAS is not available
                         kmp_lock_t * lck = th->th.th_dispatch->th_steal_lock;
                         KMP_DEBUG_ASSERT(lck != NULL);
                         if( pr->u.p.count < (UT)pr->u.p.ub ) {
@@ -1623,38 +2786,15 @@ __kmp_dispatch_next(
                         }
                         if( !status ) { // try to steal
                             kmp_info_t   **other_threads = team->t.t_threads;
-                            int          while_limit = nproc; // nproc attempts to find a victim
-                            int          while_index = 0;
-                            // TODO: algorithm of searching for a victim
-                            // should be cleaned up and measured
-                            while ( ( !status ) && ( while_limit != ++while_index ) ) {
-                                T remaining;
-                                T victimIdx    = pr->u.p.parm4;
-                                T oldVictimIdx = victimIdx ? victimIdx - 1 : nproc - 1;
+                            int          tid = __kmp_tid_from_gtid(gtid);
+                            int          attempt;
+                            for ( attempt = 0; !status && attempt < 2 * nproc; ++attempt ) {
+                                UT remaining;
+                                T  victimIdx;
                                 dispatch_private_info_template< T > * victim =
-                                    reinterpret_cast< dispatch_private_info_template< T >* >
-                                    (other_threads[victimIdx]->th.th_dispatch->th_dispatch_pr_current);
-                                while( ( victim == NULL || victim == pr ||
-                                    ( *(volatile T*)&victim->u.p.static_steal_counter !=
-                                    *(volatile T*)&pr->u.p.static_steal_counter ) ) &&
-                                    oldVictimIdx != victimIdx )
-                                {
-                                    victimIdx = (victimIdx + 1) % nproc;
-                                    victim = reinterpret_cast< dispatch_private_info_template< T >* >
-                                        (other_threads[victimIdx]->th.th_dispatch->th_dispatch_pr_current);
-                                };
-                                if( !victim ||
-                                    ( *(volatile T *)&victim->u.p.static_steal_counter !=
-                                    *(volatile T *)&pr->u.p.static_steal_counter ) )
-                                {
-                                    continue; // try once more (nproc attempts in total)
-                                    // no victim is ready yet to participate in stealing
-                                    // because all victims are still in kmp_init_dispatch
-                                }
-                                if( victim->u.p.count + 2 > (UT)victim->u.p.ub ) {
-                                    pr->u.p.parm4 = (victimIdx + 1) % nproc; // shift start tid
-                                    continue; // not enough chunks to steal, goto next victim
-                                }
+                                    __kmp_steal_victim< T >( th, team, pr, tid, nproc, attempt, &victimIdx );
+                                if ( victim == NULL || victim->u.p.count + 2 > (UT)victim->u.p.ub )
+                                    continue; // not ready yet or not enough chunks to steal, goto next victim
 
                                 lck = other_threads[victimIdx]->th.th_dispatch->th_steal_lock;
                                 KMP_ASSERT(lck != NULL);
@@ -1664,130 +2804,72 @@ __kmp_dispatch_next(
                                     (remaining = limit - victim->u.p.count) < 2 )
                                 {
                                     __kmp_release_lock(lck, gtid);
-                                    pr->u.p.parm4 = (victimIdx + 1) % nproc; // next victim
                                     continue; // not enough chunks to steal
                                 }
-                                // stealing succeded, reduce victim's ub by 1/4 of undone chunks or by 1
-                                if( remaining > 3 ) {
-                                    init = ( victim->u.p.ub -= (remaining>>2) ); // steal 1/4 of remaining
-                                } else {
-                                    init = ( victim->u.p.ub -= 1 ); // steal 1 chunk of 2 or 3 remaining
-                                }
+                                // stealing succeded, take the upper half of the undone chunks
+                                init = ( victim->u.p.ub -= (remaining>>1) );
                                 __kmp_release_lock(lck, gtid);
 
                                 KMP_DEBUG_ASSERT(init + 1 <= limit);
                                 pr->u.p.parm4 = victimIdx; // remember victim to steal from
                                 status = 1;
-                                while_index = 0;
                                 // now update own count and ub with stolen range but init chunk
                                 __kmp_acquire_lock(th->th.th_dispatch->th_steal_lock, gtid);
                                 pr->u.p.count = init + 1;
                                 pr->u.p.ub = limit;
                                 __kmp_release_lock(th->th.th_dispatch->th_steal_lock, gtid);
-                            } // while (search for victim)
+                            } // for (search for victim)
                         } // if (try to find victim and steal)
                     } else {
-                        // 4-byte induction variable, use 8-byte CAS for pair (count, ub)
-                        typedef union {
-                            struct {
-                                UT count;
-                                T  ub;
-                            } p;
-                            kmp_int64 b;
-                        } union_i4;
-                        // All operations on 'count' or 'ub' must be combined atomically together.
-                        {
-                            union_i4 vold, vnew;
-                            vold.b = *( volatile kmp_int64 * )(&pr->u.p.count);
+                        // 4-byte induction variable: 8-byte CAS, 8-byte induction variable: 16-byte CAS
+                        // on the pair (count, ub). All operations on 'count' or 'ub' must be combined
+                        // atomically together.
+                        kmp_steal_pair< T > vold, vnew;
+                        do {
+                            __kmp_steal_pair_read< T >( pr, &vold );
                             vnew = vold;
                             vnew.p.count++;
-                            while( ! KMP_COMPARE_AND_STORE_ACQ64(
-                                        ( volatile kmp_int64* )&pr->u.p.count,
-                                        *VOLATILE_CAST(kmp_int64 *)&vold.b,
-                                        *VOLATILE_CAST(kmp_int64 *)&vnew.b ) ) {
-                                KMP_CPU_PAUSE();
-                                vold.b = *( volatile kmp_int64 * )(&pr->u.p.count);
-                                vnew = vold;
-                                vnew.p.count++;
-                            }
-                            vnew = vold;
-                            init   = vnew.p.count;
-                            status = ( init < (UT)vnew.p.ub ) ;
-                        }
+                        } while ( ! __kmp_steal_pair_cas< T >( pr, vold, vnew ) && ( KMP_CPU_PAUSE(), 1 ) );
+                        init   = vold.p.count;
+                        status = ( init < (UT)vold.p.ub ) ;
 
                         if( !status ) {
-                            kmp_info_t   **other_threads = team->t.t_threads;
-                            int          while_limit = nproc; // nproc attempts to find a victim
-                            int          while_index = 0;
-
-                            // TODO: algorithm of searching for a victim
-                            // should be cleaned up and measured
-                            while ( ( !status ) && ( while_limit != ++while_index ) ) {
-                                union_i4  vold, vnew;
-                                kmp_int32 remaining;
-                                T         victimIdx    = pr->u.p.parm4;
-                                T oldVictimIdx = victimIdx ? victimIdx - 1 : nproc - 1;
+                            int          tid = __kmp_tid_from_gtid(gtid);
+                            int          attempt;
+                            for ( attempt = 0; !status && attempt < 2 * nproc; ++attempt ) {
+                                UT remaining;
+                                T  victimIdx;
                                 dispatch_private_info_template< T > * victim =
-                                    reinterpret_cast< dispatch_private_info_template< T >* >
-                                    (other_threads[victimIdx]->th.th_dispatch->th_dispatch_pr_current);
-                                while( (victim == NULL || victim == pr ||
-                                    (*(volatile T*)&victim->u.p.static_steal_counter !=
-                                    *(volatile T*)&pr->u.p.static_steal_counter)) &&
-                                    oldVictimIdx != victimIdx )
-                                {
-                                    victimIdx = (victimIdx + 1) % nproc;
-                                    victim = reinterpret_cast< dispatch_private_info_template< T >* >
-                                        ( other_threads[victimIdx]->th.th_dispatch->th_dispatch_pr_current );
-                                };
-                                if( !victim ||
-                                    ( *(volatile T *)&victim->u.p.static_steal_counter !=
-                                    *(volatile T *)&pr->u.p.static_steal_counter ) )
-                                {
-                                    continue; // try once more (nproc attempts in total)
-                                    // no victim is ready yet to participate in stealing
-                                    // because all victims are still in kmp_init_dispatch
-                                }
-                                pr->u.p.parm4 = victimIdx; // new victim found
+                                    __kmp_steal_victim< T >( th, team, pr, tid, nproc, attempt, &victimIdx );
+                                if ( victim == NULL )
+                                    continue; // no victim is ready yet to participate in stealing
                                 while( 1 ) { // CAS loop if victim has enough chunks to steal
-                                    vold.b = *( volatile kmp_int64 * )( &victim->u.p.count );
+                                    __kmp_steal_pair_read< T >( victim, &vold );
                                     vnew = vold;
 
                                     KMP_DEBUG_ASSERT( (vnew.p.ub - 1) * (UT)chunk <= trip );
                                     if ( vnew.p.count >= (UT)vnew.p.ub ||
                                         (remaining = vnew.p.ub - vnew.p.count) < 2 )
                                     {
-                                        pr->u.p.parm4 = (victimIdx + 1) % nproc; // shift start victim id
                                         break; // not enough chunks to steal, goto next victim
                                     }
-                                    if( remaining > 3 ) {
-                                        vnew.p.ub -= (remaining>>2); // try to steal 1/4 of remaining
-                                    } else {
-                                        vnew.p.ub -= 1; // steal 1 chunk of 2 or 3 remaining
-                                    }
+                                    vnew.p.ub -= (remaining>>1); // try to steal the upper half of remaining
                                     KMP_DEBUG_ASSERT((vnew.p.ub - 1) * (UT)chunk <= trip);
-                                    // TODO: Should this be acquire or release?
-                                    if ( KMP_COMPARE_AND_STORE_ACQ64(
-                                            ( volatile kmp_int64 * )&victim->u.p.count,
-                                            *VOLATILE_CAST(kmp_int64 *)&vold.b,
-                                            *VOLATILE_CAST(kmp_int64 *)&vnew.b ) ) {
-                                        // stealing succedded
+                                    if ( __kmp_steal_pair_cas< T >( victim, vold, vnew ) ) {
+                                        // stealing succedded, now update own count and ub
                                         status = 1;
-                                        while_index = 0;
-                                        // now update own count and ub
                                         init = vnew.p.ub;
-                                        vold.p.count = init + 1;
-                                        #if KMP_ARCH_X86
-                                        KMP_XCHG_FIXED64(( volatile kmp_int64 * )(&pr->u.p.count), vold.b);
-                                        #else
-                                        *( volatile kmp_int64 * )(&pr->u.p.count) = vold.b;
-                                        #endif
+                                        pr->u.p.parm4 = victimIdx; // remember victim to steal from
+                                        vnew.p.count = init + 1;
+                                        vnew.p.ub = vold.p.ub;
+                                        __kmp_steal_pair_write< T >( pr, vnew );
                                         break;
                                     } // if (check CAS result)
                                     KMP_CPU_PAUSE(); // CAS failed, repeate attempt
                                 } // while (try to steal from particular victim)
-                            } // while (search for victim)
+                            } // for (search for victim)
                         } // if (try to find victim and steal)
-                    } // if (4-byte induction variable)
+                    } // if (CAS on the pair)
                     if ( !status ) {
                         *p_lb = 0;
                         *p_ub = 0;
@@ -1917,8 +2999,11 @@ __kmp_dispatch_next(
                     KD_TRACE(100, ("__kmp_dispatch_next: T#%d kmp_sch_dynamic_chunked case\n",
                                    gtid ) );
 
-                    init = chunk * test_then_inc_acq< ST >((volatile ST *) & sh->u.s.iteration );
                     trip = pr->u.p.tc - 1;
+                    if ( pr->u.p.count )
+                        init = trip + 1; // the fast path has claimed past the end for this thread
+                    else
+                        init = chunk * test_then_inc_acq< ST >((volatile ST *) & sh->u.s.iteration );
 
                     if ( (status = (init <= trip)) == 0 ) {
                         *p_lb = 0;
@@ -1945,6 +3030,8 @@ __kmp_dispatch_next(
                         if ( pr->ordered ) {
                             pr->u.p.ordered_lower = init;
                             pr->u.p.ordered_upper = limit;
+                            __kmp_dispatch_ordered_register< UT >( sh, th->th.th_team,
+                                                                   __kmp_tid_from_gtid( gtid ), init / chunk );
                             #ifdef KMP_DEBUG
                             {
                                 const char * buff;
@@ -1961,6 +3048,161 @@ __kmp_dispatch_next(
                 } // case
                 break;
 
+            case kmp_sch_hier_dynamic_chunked:
+            case kmp_sch_hier_guided_chunked:
+                {
+                    T  chunk = pr->u.p.parm1;
+                    kmp_disp_hier_domain_t *dom = sh->hier_domains;
+                    int d = (int)pr->u.p.parm3;
+
+                    KD_TRACE(100, ("__kmp_dispatch_next: T#%d kmp_sch_hier_dynamic_chunked/kmp_sch_hier_guided_chunked case\n",
+                                   gtid ) );
+                    trip = pr->u.p.tc - 1;
+                    status = 0;
+                    while ( 1 ) {
+                        kmp_uint64 next = dom[ d ].next;
+                        kmp_uint64 lim  = dom[ d ].limit;
+                        if ( next < lim ) {
+                            if ( pr->schedule == kmp_sch_hier_dynamic_chunked ) {
+                                next = KMP_TEST_THEN_INC_ACQ64( (volatile kmp_int64 *)&dom[ d ].next );
+                                if ( next < lim ) {
+                                    init  = (UT)next * chunk;
+                                    limit = init + chunk - 1;
+                                    if ( limit > trip )
+                                        limit = trip;
+                                    status = 1;
+                                    break;
+                                }
+                            } else {
+                                // guided: a share of what is left in the domain, at least a chunk
+                                kmp_uint64 remaining = lim - next;
+                                kmp_uint64 size = remaining / ( 2 * dom[ d ].nth + 1 );
+                                if ( size < (kmp_uint64)chunk )
+                                    size = chunk;
+                                if ( size > remaining )
+                                    size = remaining;
+                                if ( KMP_COMPARE_AND_STORE_ACQ64( (volatile kmp_int64 *)&dom[ d ].next,
+                                                                  next, next + size ) ) {
+                                    init  = (UT)next;
+                                    limit = (UT)( next + size - 1 );
+                                    status = 1;
+                                    break;
+                                }
+                                KMP_CPU_PAUSE();
+                                continue; // CAS failed, retry in the same domain
+                            }
+                        }
+                        // the domain is drained, help the domain with the most work left
+                        d = __kmp_disp_hier_victim( dom );
+                        if ( d < 0 )
+                            break;
+                        pr->u.p.parm3 = d;
+                    } // while
+                    if ( status != 0 ) {
+                        start = pr->u.p.lb;
+                        incr  = pr->u.p.st;
+                        last  = ( limit == trip );
+                        if ( p_st != NULL )
+                            *p_st = incr;
+                        *p_lb = start + init * incr;
+                        *p_ub = start + limit * incr;
+                    } else {
+                        *p_lb = 0;
+                        *p_ub = 0;
+                        if ( p_st != NULL )
+                            *p_st = 0;
+                    } // if
+                } // case
+                break;
+
+            case kmp_sch_sticky_dynamic_chunked:
+                {
+                    T  chunk = pr->u.p.parm1;
+                    UT n = pr->u.p.parm2;
+                    kmp_sticky_site_t *site = sh->sticky_site;
+                    UT c = 0;
+
+                    KD_TRACE(100, ("__kmp_dispatch_next: T#%d kmp_sch_sticky_dynamic_chunked case\n", gtid ) );
+                    status = 0;
+                    if ( site != NULL ) {
+                        kmp_sticky_chunk_t *chunks = site->chunks;
+                        kmp_uint32 gen = site->gen;
+                        kmp_int32 tid = __kmp_tid_from_gtid( gtid );
+                        // the chunks the thread ran last time, in order
+                        for ( c = pr->u.p.parm3; c < n; ++c ) {
+                            if ( chunks[ c ].owner == tid && __kmp_sticky_take( &chunks[ c ], gen ) ) {
+                                status = 1;
+                                break;
+                            }
+                        }
+                        pr->u.p.parm3 = c < n ? c + 1 : n;
+                        // then the others', from the end of the loop down
+                        while ( ! status ) {
+                            UT k = test_then_inc< ST >( (volatile ST *) & sh->u.s.iteration );
+                            if ( k >= n )
+                                break;
+                            c = n - 1 - k;
+                            status = __kmp_sticky_take( &chunks[ c ], gen );
+                        }
+                        if ( status && chunks[ c ].owner != tid )
+                            chunks[ c ].owner = tid; // offer it to this thread next time
+                    } else {
+                        c = test_then_inc< ST >( (volatile ST *) & sh->u.s.iteration );
+                        status = ( c < n );
+                    }
+                    if ( status != 0 ) {
+                        trip  = pr->u.p.tc - 1;
+                        init  = c * chunk;
+                        limit = init + chunk - 1;
+                        if ( limit > trip )
+                            limit = trip;
+                        start = pr->u.p.lb;
+                        incr  = pr->u.p.st;
+                        last  = ( limit == trip );
+                        if ( p_st != NULL )
+                            *p_st = incr;
+                        *p_lb = start + init * incr;
+                        *p_ub = start + limit * incr;
+                    } else {
+                        *p_lb = 0;
+                        *p_ub = 0;
+                        if ( p_st != NULL )
+                            *p_st = 0;
+                    } // if
+                } // case
+                break;
+
+#if OMP_40_ENABLED
+            case kmp_sch_dist_dynamic_chunked:
+                {
+                    T          chunk = pr->u.p.parm1;
+                    kmp_uint64 c;
+
+                    KD_TRACE(100, ("__kmp_dispatch_next: T#%d kmp_sch_dist_dynamic_chunked case\n", gtid ) );
+                    status = __kmp_dist_next( &sh->dist, (UT)pr->u.p.parm3, (UT)pr->u.p.parm2, &c );
+                    if ( status != 0 ) {
+                        trip  = pr->u.p.tc - 1;
+                        init  = (UT)c * chunk;
+                        limit = init + chunk - 1;
+                        if ( limit > trip )
+                            limit = trip;
+                        start = pr->u.p.lb;
+                        incr  = pr->u.p.st;
+                        last  = ( limit == trip );
+                        if ( p_st != NULL )
+                            *p_st = incr;
+                        *p_lb = start + init * incr;
+                        *p_ub = start + limit * incr;
+                    } else {
+                        *p_lb = 0;
+                        *p_ub = 0;
+                        if ( p_st != NULL )
+                            *p_st = 0;
+                    } // if
+                } // case
+                break;
+#endif
+
             case kmp_sch_guided_iterative_chunked:
                 {
                     T  chunkspec = pr->u.p.parm1;
@@ -2208,7 +3450,14 @@ __kmp_dispatch_next(
 
         if ( status == 0 ) {
             UT   num_done;
+            kmp_int32 auto_sched = sh->auto_sched;
 
+            if ( auto_sched ) {
+                // schedule(auto) loop: the first thread to finish stamps the time
+                kmp_uint64 now = KMP_AUTO_NOW();
+                if ( sh->auto_first_done == 0 )
+                    KMP_COMPARE_AND_STORE_ACQ64( &sh->auto_first_done, 0, now );
+            }
             num_done = test_then_inc< ST >( (volatile ST *) & sh->u.s.num_done );
             #ifdef KMP_DEBUG
             {
@@ -2224,7 +3473,7 @@ __kmp_dispatch_next(
 
             if ( (ST)num_done == th->th.th_team_nproc - 1 ) {
                 #if ( KMP_STATIC_STEAL_ENABLED )
-                if( pr->schedule == kmp_sch_static_steal && ___kmp_size_type > 4 ) {
+                if( pr->schedule == kmp_sch_static_steal && ! __kmp_steal_use_cas< T >() ) {
                     int i;
                     kmp_info_t **other_threads = team->t.t_threads;
                     // loop complete, safe to destroy locks used for stealing
@@ -2237,12 +3486,34 @@ __kmp_dispatch_next(
                     }
                 }
                 #endif
+                if ( auto_sched ) {
+                    kmp_uint64 now = KMP_AUTO_NOW();
+                    int cand = auto_sched - 1;
+                    __kmp_auto_record( sh->auto_site, cand, pr->u.p.tc, now - sh->auto_start,
+                                       now - sh->auto_first_done,
+                                       cand == kmp_auto_static ? th->th.th_team_nproc : sh->u.s.iteration );
+                    sh->auto_site = NULL;
+                    sh->auto_first_done = 0;
+                    sh->auto_sched = 0;
+                }
+                if ( sh->sticky_site != NULL ) {
+                    // every chunk is done, the next team may take the site
+                    TCW_4( sh->sticky_site->busy, 0 );
+                    sh->sticky_site = NULL;
+                }
+#if OMP_40_ENABLED
+                if ( sh->dist.slot != NULL ) {
+                    // the team is done with the loop, count it on the league counter
+                    __kmp_dist_team_done( &sh->dist, th->th.th_teams_size.nteams );
+                }
+#endif
                 /* NOTE: release this buffer to be reused */
 
                 KMP_MB();       /* Flush all pending memory write invalidates.  */
 
                 sh->u.s.num_done = 0;
                 sh->u.s.iteration = 0;
+                sh->hier_state = 0;
 
                 /* TODO replace with general release procedure? */
                 if ( pr->ordered ) {
@@ -2297,6 +3568,112 @@ __kmp_dispatch_next(
     return status;
 }
 
+/* Fast path of __kmp_dispatch_next() for the chunks of the unordered dynamic and guided iterative
+   loops of active teams, the schedules most dynamic loops run under.  It hands out a chunk with
+   one atomic operation on the shared iteration counter and none of the bookkeeping of the other
+   schedules, and is inlined into the __kmpc_dispatch_next_* entry points.  Everything else,
+   including the call that finds the loop finished and releases the buffer, goes to
+   __kmp_dispatch_next().  The statistics builds always take the general path so their timers see
+   every call. */
+#if KMP_STATS_ENABLED
+# define KMP_DISPATCH_FAST_PATH 0
+#else
+# define KMP_DISPATCH_FAST_PATH 1
+#endif
+
+#if KMP_DISPATCH_FAST_PATH
+// Returns 1 with the next chunk, 0 if the call must take the general path.
+template< typename T >
+static __forceinline int
+__kmp_dispatch_next_fast( int gtid, kmp_int32 *p_last, T *p_lb, T *p_ub, typename traits_t< T >::signed_t *p_st )
+{
+    typedef typename traits_t< T >::unsigned_t  UT;
+    typedef typename traits_t< T >::signed_t    ST;
+
+    kmp_info_t *th = __kmp_threads[ gtid ];
+    dispatch_private_info_template< T > *pr;
+    dispatch_shared_info_template< UT > *sh;
+    UT init, limit, trip;
+    kmp_int32 last = 0;
+
+    if ( th->th.th_team->t.t_serialized )
+        return 0;
+    pr = reinterpret_cast< dispatch_private_info_template< T >* >( th->th.th_dispatch->th_dispatch_pr_current );
+    if ( pr->ordered || pr->u.p.tc == 0 )
+        return 0;
+    sh = reinterpret_cast< dispatch_shared_info_template< UT >* >( th->th.th_dispatch->th_dispatch_sh_current );
+    trip = pr->u.p.tc - 1;
+
+    if ( pr->schedule == kmp_sch_dynamic_chunked ) {
+        T chunk = pr->u.p.parm1;
+        init = chunk * test_then_inc_acq< ST >( (volatile ST *) & sh->u.s.iteration );
+        if ( init > trip ) {
+            // the general path counts the thread out without claiming again, so that the
+            // counter stays the number of chunks handed out (plus one per thread)
+            pr->u.p.count = 1;
+            return 0;
+        }
+        limit = chunk + init - 1;
+        if ( limit >= trip ) {
+            limit = trip;
+            last = 1;
+        }
+    } else if ( pr->schedule == kmp_sch_guided_iterative_chunked ) {
+        T chunkspec = pr->u.p.parm1;
+        while ( 1 ) {
+            ST remaining;
+            init = sh->u.s.iteration;
+            remaining = trip + 1 - init;
+            if ( remaining <= 0 )
+                return 0;
+            if ( (T)remaining < pr->u.p.parm2 ) {
+                // close to the end: fixed-size chunks
+                init = test_then_add< ST >( (ST*)&sh->u.s.iteration, (ST)chunkspec );
+                remaining = trip + 1 - init;
+                if ( remaining <= 0 )
+                    return 0;
+                if ( (T)remaining > chunkspec ) {
+                    limit = init + chunkspec - 1;
+                } else {
+                    last = 1;
+                    limit = init + remaining - 1;
+                }
+                break;
+            }
+            limit = init + (UT)( remaining * *(double*)&pr->u.p.parm3 );
+            if ( compare_and_swap< ST >( (ST*)&sh->u.s.iteration, (ST)init, (ST)limit ) ) {
+                --limit;
+                break;
+            }
+        }
+    } else {
+        return 0;
+    }
+
+    ST incr = pr->u.p.st;
+    T start = pr->u.p.lb;
+    if ( p_st != NULL )
+        *p_st = incr;
+    if ( incr == 1 ) {
+        *p_lb = start + init;
+        *p_ub = start + limit;
+    } else {
+        *p_lb = start + init * incr;
+        *p_ub = start + limit * incr;
+    }
+#if KMP_OS_WINDOWS
+    if ( last )
+        pr->u.p.last_upper = pr->u.p.ub;
+#endif /* KMP_OS_WINDOWS */
+    if ( p_last != NULL )
+        *p_last = last;
+#if INCLUDE_SSC_MARKS
+    SSC_MARK_DISPATCH_NEXT();
+#endif
+    return 1;
+}
+#endif // KMP_DISPATCH_FAST_PATH
+
 template< typename T >
 static void
 __kmp_dist_get_bounds(
@@ -2371,7 +3748,8 @@ __kmp_dist_get_bounds(
     if( trip_count <= nteams ) {
         KMP_DEBUG_ASSERT(
             __kmp_static == kmp_sch_static_greedy || \
-            __kmp_static == kmp_sch_static_balanced
+            __kmp_static == kmp_sch_static_balanced || \
+            __kmp_static == kmp_sch_static_aligned
         ); // Unknown static scheduling type.
         // only some teams get single iteration, others get nothing
         if( team_id < trip_count ) {
@@ -2382,7 +3760,7 @@ __kmp_dist_get_bounds(
         if( plastiter != NULL )
             *plastiter = ( team_id == trip_count - 1 );
     } else {
-        if( __kmp_static == kmp_sch_static_balanced ) {
+        if( __kmp_static != kmp_sch_static_greedy ) { // static,aligned splits the teams like balanced
             register UT chunk = trip_count / nteams;
             register UT extras = trip_count % nteams;
             *plower += incr * ( team_id * chunk + ( team_id < extras ? team_id : extras ) );
@@ -2417,6 +3795,66 @@ __kmp_dist_get_bounds(
     }
 }
 
+// __kmpc_dist_dispatch_init_*(): under KMP_DIST_SCHEDULE=dynamic the dynamic loops take their
+// blocks from the league counter, the other loops get the static share of the team.
+template< typename T >
+static void
+__kmp_dist_dispatch_init( ident_t *loc, kmp_int32 gtid, enum sched_type schedule, kmp_int32 *p_last,
+                          T lb, T ub, typename traits_t< T >::signed_t st,
+                          typename traits_t< T >::signed_t chunk )
+{
+    typedef typename traits_t< T >::unsigned_t  UT;
+
+#if OMP_40_ENABLED
+    if ( __kmp_dist_dynamic ) {
+        kmp_info_t *th = __kmp_threads[ gtid ];
+        kmp_team_t *team = th->th.th_team;
+        enum sched_type sched = SCHEDULE_WITHOUT_MODIFIERS( schedule );
+        UT tc = 0;
+
+        if ( sched == kmp_sch_runtime && team->t.t_sched.r_sched_type == kmp_sch_dynamic_chunked ) {
+            sched = kmp_sch_dynamic_chunked;
+            chunk = team->t.t_sched.chunk;
+        }
+        if ( st > 0 ? ub >= lb : st < 0 && lb >= ub )
+            tc = st > 0 ? (UT)( ub - lb ) / st + 1 : (UT)( lb - ub ) / ( -st ) + 1;
+        // every team sees the same loop, so they all take this path or none does
+        if ( sched == kmp_sch_dynamic_chunked && team->t.t_threads[ 0 ]->th.th_dist_league != NULL &&
+             tc != 0 && (kmp_uint64)tc < KMP_DIST_MAX_BLOCKS * ( KMP_DIST_MAX_CHUNKS_PER_BLOCK - 1 ) ) {
+            // the last chunk is flagged by __kmpc_dispatch_next in whichever team runs it
+            if ( p_last != NULL )
+                *p_last = 1;
+            __kmp_dispatch_init< T >( loc, gtid, kmp_sch_dist_dynamic_chunked, lb, ub, st, chunk, true );
+            return;
+        }
+    }
+#endif
+    __kmp_dist_get_bounds< T >( loc, gtid, p_last, &lb, &ub, st );
+    __kmp_dispatch_init< T >( loc, gtid, schedule, lb, ub, st, chunk, true );
+}
+
+// __kmp_dispatch_next() under KMP_LOOP_STATS: times the call and counts the chunks.
+template< typename T >
+static int
+__kmp_dispatch_next_stats( ident_t *loc, int gtid, kmp_int32 *p_last, T *p_lb, T *p_ub,
+                           typename traits_t< T >::signed_t *p_st )
+{
+    kmp_info_t *th = __kmp_threads[ gtid ];
+    kmp_disp_t *disp = th->th.th_dispatch;
+    kmp_uint64 start = KMP_AUTO_NOW();
+    int status = __kmp_dispatch_next< T >( loc, gtid, p_last, p_lb, p_ub, p_st );
+
+    if ( disp->th_loop_site != NULL ) {
+        kmp_uint64 now = KMP_AUTO_NOW();
+        disp->th_loop_wait += now - start;
+        if ( status )
+            disp->th_loop_chunks++;
+        else
+            __kmp_loop_stats_end( th, now );
+    }
+    return status;
+}
+
 //-----------------------------------------------------------------------------------------
 // Dispatch routines
 //    Transfer call to template< type T >
@@ -2495,8 +3933,7 @@ __kmpc_dist_dispatch_init_4( ident_t *loc, kmp_int32 gtid, enum sched_type sched
     kmp_int32 *p_last, kmp_int32 lb, kmp_int32 ub, kmp_int32 st, kmp_int32 chunk )
 {
     KMP_DEBUG_ASSERT( __kmp_init_serial );
-    __kmp_dist_get_bounds< kmp_int32 >( loc, gtid, p_last, &lb, &ub, st );
-    __kmp_dispatch_init< kmp_int32 >( loc, gtid, schedule, lb, ub, st, chunk, true );
+    __kmp_dist_dispatch_init< kmp_int32 >( loc, gtid, schedule, p_last, lb, ub, st, chunk );
 }
 
 void
@@ -2504,8 +3941,7 @@ __kmpc_dist_dispatch_init_4u( ident_t *loc, kmp_int32 gtid, enum sched_type sche
     kmp_int32 *p_last, kmp_uint32 lb, kmp_uint32 ub, kmp_int32 st, kmp_int32 chunk )
 {
     KMP_DEBUG_ASSERT( __kmp_init_serial );
-    __kmp_dist_get_bounds< kmp_uint32 >( loc, gtid, p_last, &lb, &ub, st );
-    __kmp_dispatch_init< kmp_uint32 >( loc, gtid, schedule, lb, ub, st, chunk, true );
+    __kmp_dist_dispatch_init< kmp_uint32 >( loc, gtid, schedule, p_last, lb, ub, st, chunk );
 }
 
 void
@@ -2513,8 +3949,7 @@ __kmpc_dist_dispatch_init_8( ident_t *loc, kmp_int32 gtid, enum sched_type sched
     kmp_int32 *p_last, kmp_int64 lb, kmp_int64 ub, kmp_int64 st, kmp_int64 chunk )
 {
     KMP_DEBUG_ASSERT( __kmp_init_serial );
-    __kmp_dist_get_bounds< kmp_int64 >( loc, gtid, p_last, &lb, &ub, st );
-    __kmp_dispatch_init< kmp_int64 >( loc, gtid, schedule, lb, ub, st, chunk, true );
+    __kmp_dist_dispatch_init< kmp_int64 >( loc, gtid, schedule, p_last, lb, ub, st, chunk );
 }
 
 void
@@ -2522,8 +3957,7 @@ __kmpc_dist_dispatch_init_8u( ident_t *loc, kmp_int32 gtid, enum sched_type sche
     kmp_int32 *p_last, kmp_uint64 lb, kmp_uint64 ub, kmp_int64 st, kmp_int64 chunk )
 {
     KMP_DEBUG_ASSERT( __kmp_init_serial );
-    __kmp_dist_get_bounds< kmp_uint64 >( loc, gtid, p_last, &lb, &ub, st );
-    __kmp_dispatch_init< kmp_uint64 >( loc, gtid, schedule, lb, ub, st, chunk, true );
+    __kmp_dist_dispatch_init< kmp_uint64 >( loc, gtid, schedule, p_last, lb, ub, st, chunk );
 }
 
 /*!
@@ -2542,6 +3976,12 @@ int
 __kmpc_dispatch_next_4( ident_t *loc, kmp_int32 gtid, kmp_int32 *p_last,
                         kmp_int32 *p_lb, kmp_int32 *p_ub, kmp_int32 *p_st )
 {
+    if ( __kmp_loop_stats )
+        return __kmp_dispatch_next_stats< kmp_int32 >( loc, gtid, p_last, p_lb, p_ub, p_st );
+#if KMP_DISPATCH_FAST_PATH
+    if ( __kmp_dispatch_fast_path && __kmp_dispatch_next_fast< kmp_int32 >( gtid, p_last, p_lb, p_ub, p_st ) )
+        return 1;
+#endif
     return __kmp_dispatch_next< kmp_int32 >( loc, gtid, p_last, p_lb, p_ub, p_st );
 }
 
@@ -2552,6 +3992,12 @@ int
 __kmpc_dispatch_next_4u( ident_t *loc, kmp_int32 gtid, kmp_int32 *p_last,
                         kmp_uint32 *p_lb, kmp_uint32 *p_ub, kmp_int32 *p_st )
 {
+    if ( __kmp_loop_stats )
+        return __kmp_dispatch_next_stats< kmp_uint32 >( loc, gtid, p_last, p_lb, p_ub, p_st );
+#if KMP_DISPATCH_FAST_PATH
+    if ( __kmp_dispatch_fast_path && __kmp_dispatch_next_fast< kmp_uint32 >( gtid, p_last, p_lb, p_ub, p_st ) )
+        return 1;
+#endif
     return __kmp_dispatch_next< kmp_uint32 >( loc, gtid, p_last, p_lb, p_ub, p_st );
 }
 
@@ -2562,6 +4008,12 @@ int
 __kmpc_dispatch_next_8( ident_t *loc, kmp_int32 gtid, kmp_int32 *p_last,
                         kmp_int64 *p_lb, kmp_int64 *p_ub, kmp_int64 *p_st )
 {
+    if ( __kmp_loop_stats )
+        return __kmp_dispatch_next_stats< kmp_int64 >( loc, gtid, p_last, p_lb, p_ub, p_st );
+#if KMP_DISPATCH_FAST_PATH
+    if ( __kmp_dispatch_fast_path && __kmp_dispatch_next_fast< kmp_int64 >( gtid, p_last, p_lb, p_ub, p_st ) )
+        return 1;
+#endif
     return __kmp_dispatch_next< kmp_int64 >( loc, gtid, p_last, p_lb, p_ub, p_st );
 }
 
@@ -2572,6 +4024,12 @@ int
 __kmpc_dispatch_next_8u( ident_t *loc, kmp_int32 gtid, kmp_int32 *p_last,
                         kmp_uint64 *p_lb, kmp_uint64 *p_ub, kmp_int64 *p_st )
 {
+    if ( __kmp_loop_stats )
+        return __kmp_dispatch_next_stats< kmp_uint64 >( loc, gtid, p_last, p_lb, p_ub, p_st );
+#if KMP_DISPATCH_FAST_PATH
+    if ( __kmp_dispatch_fast_path && __kmp_dispatch_next_fast< kmp_uint64 >( gtid, p_last, p_lb, p_ub, p_st ) )
+        return 1;
+#endif
     return __kmp_dispatch_next< kmp_uint64 >( loc, gtid, p_last, p_lb, p_ub, p_st );
 }
 
@@ -2615,6 +4073,122 @@ __kmpc_dispatch_fini_8u( ident_t *loc, kmp_int32 gtid )
 }
 /*! @} */
 
+/*!
+@ingroup WORK_SHARING
+@{
+*/
+/*!
+@param enable Non-zero to record the dispatch statistics of the dynamic loops
+
+Starts or stops the recording of the KMP_LOOP_STATS dispatch statistics. Loops already started
+when the recording is turned on are not recorded.
+*/
+void
+__kmpc_set_loop_stats( kmp_int32 enable )
+{
+    TCW_4( __kmp_loop_stats, enable != 0 );
+}
+
+/*!
+@return number of loop sites with dispatch statistics
+
+The sites are numbered from zero in an order that does not change while the program runs, a new
+site may take any number.
+*/
+kmp_int32
+__kmpc_loop_stats_sites( void )
+{
+    kmp_int32 i, n = 0;
+    for ( i = 0; i < KMP_LOOP_STATS_SITES; ++i ) {
+        if ( TCR_PTR( __kmp_loop_sites[ i ].loc ) != NULL )
+            n++;
+    }
+    return n;
+}
+
+static kmp_loop_site_t *
+__kmp_loop_stats_site_at( kmp_int32 index )
+{
+    kmp_int32 i;
+    for ( i = 0; i < KMP_LOOP_STATS_SITES; ++i ) {
+        if ( TCR_PTR( __kmp_loop_sites[ i ].loc ) != NULL && index-- == 0 )
+            return &__kmp_loop_sites[ i ];
+    }
+    return NULL;
+}
+
+/*!
+@param index      Loop site number, from 0 to __kmpc_loop_stats_sites() - 1
+@param schedule   Set to the schedule (enum sched_type) of the last execution of the loop
+@param runs       Set to the number of executions of the loop
+@param iterations Set to the sum of the trip counts of the executions
+@return source location of the loop, NULL if there is no such site
+
+Any of the output pointers may be NULL.
+*/
+ident_t *
+__kmpc_loop_stats_site( kmp_int32 index, kmp_int32 *schedule, kmp_uint64 *runs, kmp_uint64 *iterations )
+{
+    kmp_loop_site_t *site = __kmp_loop_stats_site_at( index );
+    if ( site == NULL )
+        return NULL;
+    if ( schedule )
+        *schedule = site->schedule;
+    if ( runs )
+        *runs = site->runs;
+    if ( iterations )
+        *iterations = site->iterations;
+    return site->loc;
+}
+
+/*!
+@param index  Loop site number
+@param tid    Thread number in the team; the threads from 63 on share the entry of thread 63
+@param chunks Set to the chunks handed out to the thread
+@param busy   Set to the time the thread spent in the loop body
+@param wait   Set to the time the thread spent in the dispatcher
+@return number of executions of the loop the thread finished
+
+The times are in timestamp counter ticks where the processor has one, in nanoseconds otherwise.
+Any of the output pointers may be NULL.
+*/
+kmp_uint64
+__kmpc_loop_stats_thread( kmp_int32 index, kmp_int32 tid, kmp_uint64 *chunks, kmp_uint64 *busy,
+                          kmp_uint64 *wait )
+{
+    kmp_loop_site_t *site = __kmp_loop_stats_site_at( index );
+    kmp_loop_thread_stats_t *ts;
+
+    if ( site == NULL || tid < 0 || TCR_PTR( site->threads ) == NULL )
+        return 0;
+    ts = &site->threads[ tid < KMP_LOOP_STATS_THREADS ? tid : KMP_LOOP_STATS_THREADS - 1 ];
+    if ( chunks )
+        *chunks = ts->chunks;
+    if ( busy )
+        *busy = ts->busy;
+    if ( wait )
+        *wait = ts->wait;
+    return ts->loops;
+}
+
+/*!
+Clears the dispatch statistics of all loop sites; the sites keep their numbers.
+Must not be called while dynamic loops are running.
+*/
+void
+__kmpc_loop_stats_reset( void )
+{
+    int i;
+    for ( i = 0; i < KMP_LOOP_STATS_SITES; ++i ) {
+        kmp_loop_site_t *site = &__kmp_loop_sites[ i ];
+        site->runs = site->iterations = site->max_tc = 0;
+        if ( site->threads != NULL )
+            memset( site->threads, 0, sizeof( kmp_loop_thread_stats_t ) * KMP_LOOP_STATS_THREADS );
+    }
+    KMP_MB();
+}
+/*! @} */
+
 //-----------------------------------------------------------------------------------------
 //Non-template routines from kmp_dispatch.cpp used in other sources
 
@@ -1264,6 +1264,154 @@ FTN_SET_WARNINGS_OFF( void )
     #endif
 }
 
+/* split-phase team barrier */
+void FTN_STDCALL
+FTN_BARRIER_ARRIVE( void )
+{
+    #ifndef KMP_STUB
+        int gtid = __kmp_entry_gtid();
+        if ( ! TCR_4(__kmp_init_parallel) ) {
+            __kmp_parallel_initialize();
+        }
+        __kmp_barrier_arrive( bs_plain_barrier, gtid );
+    #endif
+}
+
+void FTN_STDCALL
+FTN_BARRIER_WAIT( void )
+{
+    #ifndef KMP_STUB
+        __kmp_barrier_wait( bs_plain_barrier, __kmp_entry_gtid() );
+    #endif
+}
+
+/* named (reusable, subset) barriers */
+void FTN_STDCALL
+FTN_INIT_NAMED_BARRIER( void **bar, int KMP_DEREF count )
+{
+    #ifdef KMP_STUB
+        *bar = NULL;
+    #else
+        kmp_user_barrier_t *ub;
+        if ( ! TCR_4(__kmp_init_serial) ) {
+            __kmp_serial_initialize();
+        }
+        ub = (kmp_user_barrier_t *)__kmp_allocate( sizeof( kmp_user_barrier_t ) );
+        __kmp_init_named_barrier( ub, KMP_DEREF count );
+        *bar = ub;
+    #endif
+}
+
+void FTN_STDCALL
+FTN_DESTROY_NAMED_BARRIER( void **bar )
+{
+    #ifndef KMP_STUB
+        if ( *bar != NULL ) {
+            __kmp_destroy_named_barrier( (kmp_user_barrier_t *)*bar );
+            __kmp_free( *bar );
+            *bar = NULL;
+        }
+    #endif
+}
+
+int FTN_STDCALL
+FTN_NAMED_BARRIER_ARRIVE( void **bar )
+{
+    #ifdef KMP_STUB
+        return 0;
+    #else
+        KMP_DEBUG_ASSERT( *bar != NULL );
+        return (int)__kmp_named_barrier_arrive( (kmp_user_barrier_t *)*bar );
+    #endif
+}
+
+void FTN_STDCALL
+FTN_NAMED_BARRIER_WAIT( void **bar, int KMP_DEREF phase )
+{
+    #ifndef KMP_STUB
+        KMP_DEBUG_ASSERT( *bar != NULL );
+        __kmp_named_barrier_wait( (kmp_user_barrier_t *)*bar, (kmp_uint32)KMP_DEREF phase );
+    #endif
+}
+
+#if KMP_USE_DYNAMIC_LOCK
+/* reader-writer locks; the stub counts the readers in the lock, LOCKED for the writer */
+void FTN_STDCALL
+FTN_RW_LOCK_INIT( void **user_lock )
+{
+    #ifdef KMP_STUB
+        *((kmp_stub_lock_t *)user_lock) = UNLOCKED;
+    #else
+        __kmpc_rw_lock_init( NULL, __kmp_entry_gtid(), user_lock );
+    #endif
+}
+
+void FTN_STDCALL
+FTN_RW_LOCK_DESTROY( void **user_lock )
+{
+    #ifdef KMP_STUB
+        *((kmp_stub_lock_t *)user_lock) = UNINIT;
+    #else
+        __kmpc_rw_lock_destroy( NULL, __kmp_entry_gtid(), user_lock );
+    #endif
+}
+
+void FTN_STDCALL
+FTN_RW_LOCK_RDLOCK( void **user_lock )
+{
+    #ifdef KMP_STUB
+        ++ *((int *)user_lock);
+    #else
+        __kmpc_rw_lock_rdlock( NULL, __kmp_entry_gtid(), user_lock );
+    #endif
+}
+
+void FTN_STDCALL
+FTN_RW_LOCK_WRLOCK( void **user_lock )
+{
+    #ifdef KMP_STUB
+        *((kmp_stub_lock_t *)user_lock) = LOCKED;
+    #else
+        __kmpc_rw_lock_wrlock( NULL, __kmp_entry_gtid(), user_lock );
+    #endif
+}
+
+void FTN_STDCALL
+FTN_RW_LOCK_UNLOCK( void **user_lock )
+{
+    #ifdef KMP_STUB
+        -- *((int *)user_lock);
+    #else
+        __kmpc_rw_lock_unlock( NULL, __kmp_entry_gtid(), user_lock );
+    #endif
+}
+
+int FTN_STDCALL
+FTN_RW_LOCK_TRYRDLOCK( void **user_lock )
+{
+    #ifdef KMP_STUB
+        ++ *((int *)user_lock);
+        return 1;
+    #else
+        return __kmpc_rw_lock_tryrdlock( NULL, __kmp_entry_gtid(), user_lock );
+    #endif
+}
+
+int FTN_STDCALL
+FTN_RW_LOCK_TRYWRLOCK( void **user_lock )
+{
+    #ifdef KMP_STUB
+        if ( *((kmp_stub_lock_t *)user_lock) != UNLOCKED ) {
+            return 0;
+        }; // if
+        *((kmp_stub_lock_t *)user_lock) = LOCKED;
+        return 1;
+    #else
+        return __kmpc_rw_lock_trywrlock( NULL, __kmp_entry_gtid(), user_lock );
+    #endif
+}
+#endif // KMP_USE_DYNAMIC_LOCK
+
 void FTN_STDCALL
 FTN_SET_DEFAULTS( char const * str
     #ifndef PASS_ARGS_BY_VALUE
@@ -97,6 +97,19 @@
 
     #define FTN_SET_WARNINGS_ON                  kmp_set_warnings_on
     #define FTN_SET_WARNINGS_OFF                 kmp_set_warnings_off
+    #define FTN_BARRIER_ARRIVE                   kmp_barrier_arrive
+    #define FTN_BARRIER_WAIT                     kmp_barrier_wait
+    #define FTN_INIT_NAMED_BARRIER               kmp_init_named_barrier
+    #define FTN_DESTROY_NAMED_BARRIER            kmp_destroy_named_barrier
+    #define FTN_NAMED_BARRIER_ARRIVE             kmp_named_barrier_arrive
+    #define FTN_NAMED_BARRIER_WAIT               kmp_named_barrier_wait
+    #define FTN_RW_LOCK_INIT                     kmp_rw_lock_init
+    #define FTN_RW_LOCK_DESTROY                  kmp_rw_lock_destroy
+    #define FTN_RW_LOCK_RDLOCK                   kmp_rw_lock_rdlock
+    #define FTN_RW_LOCK_WRLOCK                   kmp_rw_lock_wrlock
+    #define FTN_RW_LOCK_UNLOCK                   kmp_rw_lock_unlock
+    #define FTN_RW_LOCK_TRYRDLOCK                kmp_rw_lock_tryrdlock
+    #define FTN_RW_LOCK_TRYWRLOCK                kmp_rw_lock_trywrlock
 
     #define FTN_GET_WTIME                        omp_get_wtime
     #define FTN_GET_WTICK                        omp_get_wtick
@@ -215,6 +228,19 @@
 
     #define FTN_SET_WARNINGS_ON                  kmp_set_warnings_on_
     #define FTN_SET_WARNINGS_OFF                 kmp_set_warnings_off_
+    #define FTN_BARRIER_ARRIVE                   kmp_barrier_arrive_
+    #define FTN_BARRIER_WAIT                     kmp_barrier_wait_
+    #define FTN_INIT_NAMED_BARRIER               kmp_init_named_barrier_
+    #define FTN_DESTROY_NAMED_BARRIER            kmp_destroy_named_barrier_
+    #define FTN_NAMED_BARRIER_ARRIVE             kmp_named_barrier_arrive_
+    #define FTN_NAMED_BARRIER_WAIT               kmp_named_barrier_wait_
+    #define FTN_RW_LOCK_INIT                     kmp_rw_lock_init_
+    #define FTN_RW_LOCK_DESTROY                  kmp_rw_lock_destroy_
+    #define FTN_RW_LOCK_RDLOCK                   kmp_rw_lock_rdlock_
+    #define FTN_RW_LOCK_WRLOCK                   kmp_rw_lock_wrlock_
+    #define FTN_RW_LOCK_UNLOCK                   kmp_rw_lock_unlock_
+    #define FTN_RW_LOCK_TRYRDLOCK                kmp_rw_lock_tryrdlock_
+    #define FTN_RW_LOCK_TRYWRLOCK                kmp_rw_lock_trywrlock_
 
     #define FTN_GET_WTIME                        omp_get_wtime_
     #define FTN_GET_WTICK                        omp_get_wtick_
@@ -334,6 +360,19 @@
 
     #define FTN_SET_WARNINGS_ON                  KMP_SET_WARNINGS_ON
     #define FTN_SET_WARNINGS_OFF                 KMP_SET_WARNINGS_OFF
+    #define FTN_BARRIER_ARRIVE                   KMP_BARRIER_ARRIVE
+    #define FTN_BARRIER_WAIT                     KMP_BARRIER_WAIT
+    #define FTN_INIT_NAMED_BARRIER               KMP_INIT_NAMED_BARRIER
+    #define FTN_DESTROY_NAMED_BARRIER            KMP_DESTROY_NAMED_BARRIER
+    #define FTN_NAMED_BARRIER_ARRIVE             KMP_NAMED_BARRIER_ARRIVE
+    #define FTN_NAMED_BARRIER_WAIT               KMP_NAMED_BARRIER_WAIT
+    #define FTN_RW_LOCK_INIT                     KMP_RW_LOCK_INIT
+    #define FTN_RW_LOCK_DESTROY                  KMP_RW_LOCK_DESTROY
+    #define FTN_RW_LOCK_RDLOCK                   KMP_RW_LOCK_RDLOCK
+    #define FTN_RW_LOCK_WRLOCK                   KMP_RW_LOCK_WRLOCK
+    #define FTN_RW_LOCK_UNLOCK                   KMP_RW_LOCK_UNLOCK
+    #define FTN_RW_LOCK_TRYRDLOCK                KMP_RW_LOCK_TRYRDLOCK
+    #define FTN_RW_LOCK_TRYWRLOCK                KMP_RW_LOCK_TRYWRLOCK
 
     #define FTN_GET_WTIME                        OMP_GET_WTIME
     #define FTN_GET_WTICK                        OMP_GET_WTICK
@@ -453,6 +492,19 @@
 
     #define FTN_SET_WARNINGS_ON                  KMP_SET_WARNINGS_ON_
     #define FTN_SET_WARNINGS_OFF                 KMP_SET_WARNINGS_OFF_
+    #define FTN_BARRIER_ARRIVE                   KMP_BARRIER_ARRIVE_
+    #define FTN_BARRIER_WAIT                     KMP_BARRIER_WAIT_
+    #define FTN_INIT_NAMED_BARRIER               KMP_INIT_NAMED_BARRIER_
+    #define FTN_DESTROY_NAMED_BARRIER            KMP_DESTROY_NAMED_BARRIER_
+    #define FTN_NAMED_BARRIER_ARRIVE             KMP_NAMED_BARRIER_ARRIVE_
+    #define FTN_NAMED_BARRIER_WAIT               KMP_NAMED_BARRIER_WAIT_
+    #define FTN_RW_LOCK_INIT                     KMP_RW_LOCK_INIT_
+    #define FTN_RW_LOCK_DESTROY                  KMP_RW_LOCK_DESTROY_
+    #define FTN_RW_LOCK_RDLOCK                   KMP_RW_LOCK_RDLOCK_
+    #define FTN_RW_LOCK_WRLOCK                   KMP_RW_LOCK_WRLOCK_
+    #define FTN_RW_LOCK_UNLOCK                   KMP_RW_LOCK_UNLOCK_
+    #define FTN_RW_LOCK_TRYRDLOCK                KMP_RW_LOCK_TRYRDLOCK_
+    #define FTN_RW_LOCK_TRYWRLOCK                KMP_RW_LOCK_TRYWRLOCK_
 
     #define FTN_GET_WTIME                        OMP_GET_WTIME_
     #define FTN_GET_WTICK                        OMP_GET_WTICK_
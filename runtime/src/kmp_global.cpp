@@ -27,6 +27,9 @@ kmp_cpuinfo_t   __kmp_cpuinfo = { 0 }; // Not initialized
 // lock for modifying the global __kmp_stats_list
 kmp_tas_lock_t __kmp_stats_lock;
 
+// lock for the global per-site barrier table
+kmp_tas_lock_t __kmp_stats_barrier_lock;
+
 // global list of per thread stats, the head is a sentinel node which accumulates all stats produced before __kmp_create_worker is called.
 kmp_stats_list* __kmp_stats_list;
 
@@ -130,6 +133,15 @@ int           __kmp_tp_capacity = 0;
 int             __kmp_tp_cached = 0;
 int           __kmp_dflt_nested = FALSE;
 int  __kmp_dispatch_num_buffers = KMP_DFLT_DISP_NUM_BUFF;
+int  __kmp_auto_adaptive = FALSE;
+int  __kmp_dispatch_hier_domains = 0;
+int  __kmp_doacross_window = KMP_DFLT_DOACROSS_WINDOW;
+int  __kmp_loop_stats = FALSE;
+int  __kmp_dispatch_fast_path = TRUE;
+#if OMP_40_ENABLED
+int  __kmp_dist_dynamic = FALSE;
+int  __kmp_dist_block = 0;
+#endif
 int __kmp_dflt_max_active_levels = KMP_MAX_ACTIVE_LEVELS_LIMIT; /* max_active_levels limit */
 #if KMP_NESTED_HOT_TEAMS
 int __kmp_hot_teams_mode         = 0; /* 0 - free extra threads when reduced */
@@ -254,6 +266,8 @@ int      __kmp_affinity_respect_mask = affinity_respect_mask_default;
 char *   __kmp_affinity_proclist     = NULL;
 kmp_affin_mask_t *__kmp_affinity_masks = NULL;
 unsigned __kmp_affinity_num_masks    = 0;
+int *    __kmp_affinity_place_package = NULL;
+int      __kmp_affinity_num_packages = 0;
 
 char const *  __kmp_cpuinfo_file     = NULL;
 
@@ -386,6 +400,8 @@ volatile int          __kmp_all_nth                = 0;
 int                   __kmp_thread_pool_nth        = 0;
 volatile kmp_info_t  *__kmp_thread_pool            = NULL;
 volatile kmp_team_t  *__kmp_team_pool              = NULL;
+int                   __kmp_team_pool_nteams       = 0;
+int                   __kmp_team_pool_nth          = 0;
 
 KMP_ALIGN_CACHE
 volatile int          __kmp_thread_pool_active_nth = 0;
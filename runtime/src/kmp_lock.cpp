@@ -30,7 +30,7 @@
 // We should really include <futex.h>, but that causes compatibility problems on different
 // Linux* OS distributions that either require that you include (or break when you try to include)
 // <pci/types.h>.
-// Since all we need is the two macros below (which are part of the kernel ABI, so can't change)
+// Since all we need is the few macros below (which are part of the kernel ABI, so can't change)
 // we just define the constants here and don't include <futex.h>
 # ifndef FUTEX_WAIT
 #  define FUTEX_WAIT    0
@@ -38,8 +38,39 @@
 # ifndef FUTEX_WAKE
 #  define FUTEX_WAKE    1
 # endif
+# ifndef FUTEX_WAIT_BITSET
+#  define FUTEX_WAIT_BITSET 9
+# endif
+# ifndef FUTEX_WAKE_BITSET
+#  define FUTEX_WAKE_BITSET 10
+# endif
+#endif
+
+// Time stamp counter
+#if KMP_ARCH_X86 || KMP_ARCH_X86_64
+# define __kmp_tsc() __kmp_hardware_timestamp()
+// Runtime's default backoff parameters
+kmp_backoff_t __kmp_spin_backoff_params = { 1, 4096, 100 };
+#else
+// Use nanoseconds for other platforms
+extern kmp_uint64 __kmp_now_nsec();
+kmp_backoff_t __kmp_spin_backoff_params = { 1, 256, 100 };
+# define __kmp_tsc() __kmp_now_nsec()
 #endif
 
+// A useful predicate for dealing with timestamps that may wrap.
+// Is a before b?
+// Since the timestamps may wrap, this is asking whether it's
+// shorter to go clockwise from a to b around the clock-face, or anti-clockwise.
+// Times where going clockwise is less distance than going anti-clockwise
+// are in the future, others are in the past.
+// e.g.) a = MAX-1, b = MAX+1 (=0), then a > b (true) does not mean a reached b
+//       whereas signed(a) = -2, signed(b) = 0 captures the actual difference
+static inline bool before(kmp_uint64 a, kmp_uint64 b)
+{
+    return ((kmp_int64)b - (kmp_int64)a) > 0;
+}
+
 /* Implement spin locks for internal library use.             */
 /* The algorithm implemented is Lamport's bakery lock [1974]. */
 
@@ -721,6 +752,55 @@ __kmp_destroy_nested_futex_lock_with_checks( kmp_futex_lock_t *lck )
     __kmp_destroy_nested_futex_lock( lck );
 }
 
+/* ------------------------------------------------------------------------ */
+/* spin-then-park waiting for ticket and queuing locks */
+
+// With KMP_LOCK_PARK set, ticket and queuing lock waiters spin (and yield)
+// for the blocktime and then sleep on a futex until it is their turn.
+// The release path wakes only the waiter it hands the lock to, so both
+// locks keep their FIFO order.
+
+int __kmp_lock_park = FALSE;
+
+extern double __kmp_ticks_per_nsec;
+
+// th_spin_here of a queuing lock waiter that is asleep on it
+#define KMP_LOCK_PARKED 2
+
+// Ticket lock waiters sleep on now_serving tagged with a bit of their ticket,
+// so a release wakes the next ticket only (and any waiter 32 tickets behind).
+#define KMP_TICKET_PARK_BIT( ticket ) ( 1U << ( ( ticket ) & 31 ) )
+
+// Time at which a waiter starting now gives up spinning; 0 for never.
+static kmp_uint64
+__kmp_lock_park_goal()
+{
+    if ( __kmp_dflt_blocktime == KMP_MAX_BLOCKTIME ) {
+        return 0;
+    }
+#if KMP_ARCH_X86 || KMP_ARCH_X86_64
+    return __kmp_tsc() + (kmp_uint64)( __kmp_dflt_blocktime * KMP_USEC_PER_SEC * __kmp_ticks_per_nsec );
+#else
+    return __kmp_tsc() + (kmp_uint64)__kmp_dflt_blocktime * KMP_USEC_PER_SEC;
+#endif
+}
+
+static inline bool
+__kmp_lock_park_now( kmp_uint64 goal, kmp_uint32 *spins )
+{
+    if ( goal != 0 && ! before( __kmp_tsc(), goal ) ) {
+        return true;
+    }
+    if ( TCR_4( __kmp_nth ) > ( __kmp_avail_proc ? __kmp_avail_proc :
+      __kmp_xproc ) ) {
+        KMP_YIELD( TRUE );
+    }
+    else {
+        KMP_YIELD_SPIN( *spins );
+    }
+    return false;
+}
+
 #endif // KMP_USE_FUTEX
 
 
@@ -745,6 +825,33 @@ __kmp_bakery_check( void *now_serving, kmp_uint32 my_ticket )
     return std::atomic_load_explicit( (std::atomic<unsigned> *)now_serving, std::memory_order_acquire ) == my_ticket;
 }
 
+#if KMP_USE_FUTEX
+static void
+__kmp_wait_ticket_lock_parked( kmp_ticket_lock_t *lck, kmp_uint32 my_ticket )
+{
+    kmp_uint64 goal = __kmp_lock_park_goal();
+    kmp_uint32 serving;
+    kmp_uint32 spins;
+
+    KMP_FSYNC_SPIN_INIT( lck, NULL );
+    KMP_INIT_YIELD( spins );
+    while ( ( serving = std::atomic_load_explicit( &lck->lk.now_serving, std::memory_order_acquire ) ) != my_ticket ) {
+        if ( __kmp_lock_park_now( goal, &spins ) ) {
+            // Announce the sleeper before the last look at now_serving; the releaser
+            // bumps now_serving before it checks for sleepers.
+            std::atomic_fetch_add_explicit( &lck->lk.parked, 1U, std::memory_order_seq_cst );
+            if ( std::atomic_load_explicit( &lck->lk.now_serving, std::memory_order_seq_cst ) == serving ) {
+                syscall( __NR_futex, &lck->lk.now_serving, FUTEX_WAIT_BITSET, serving, NULL, NULL,
+                  KMP_TICKET_PARK_BIT( my_ticket ) );
+            }
+            std::atomic_fetch_sub_explicit( &lck->lk.parked, 1U, std::memory_order_relaxed );
+        }
+        KMP_FSYNC_SPIN_PREPARE( lck );
+    }
+    KMP_FSYNC_SPIN_ACQUIRED( lck );
+}
+#endif // KMP_USE_FUTEX
+
 __forceinline static int
 __kmp_acquire_ticket_lock_timed_template( kmp_ticket_lock_t *lck, kmp_int32 gtid )
 {
@@ -759,6 +866,12 @@ __kmp_acquire_ticket_lock_timed_template( kmp_ticket_lock_t *lck, kmp_int32 gtid
     if ( std::atomic_load_explicit( &lck->lk.now_serving, std::memory_order_acquire ) == my_ticket ) {
         return KMP_LOCK_ACQUIRED_FIRST;
     }
+#if KMP_USE_FUTEX
+    if ( __kmp_lock_park ) {
+        __kmp_wait_ticket_lock_parked( lck, my_ticket );
+        return KMP_LOCK_ACQUIRED_FIRST;
+    }
+#endif
     KMP_WAIT_YIELD_PTR( &lck->lk.now_serving, my_ticket, __kmp_bakery_check, lck );
     return KMP_LOCK_ACQUIRED_FIRST;
 }
@@ -839,6 +952,18 @@ __kmp_release_ticket_lock( kmp_ticket_lock_t *lck, kmp_int32 gtid )
     kmp_uint32 distance = std::atomic_load_explicit( &lck->lk.next_ticket, std::memory_order_relaxed ) - std::atomic_load_explicit( &lck->lk.now_serving, std::memory_order_relaxed );
 
     ANNOTATE_TICKET_RELEASED(lck);
+#if KMP_USE_FUTEX
+    if ( __kmp_lock_park ) {
+        kmp_uint32 serving = std::atomic_fetch_add_explicit( &lck->lk.now_serving, 1U, std::memory_order_seq_cst ) + 1;
+        if ( std::atomic_load_explicit( &lck->lk.parked, std::memory_order_seq_cst ) != 0 ) {
+            // Wake all sleepers on the next ticket's bit: only the next ticket
+            // goes on, any others sharing the bit go back to sleep.
+            syscall( __NR_futex, &lck->lk.now_serving, FUTEX_WAKE_BITSET, INT_MAX, NULL, NULL,
+              KMP_TICKET_PARK_BIT( serving ) );
+        }
+        return KMP_LOCK_RELEASED;
+    }
+#endif
     std::atomic_fetch_add_explicit( &lck->lk.now_serving, 1U, std::memory_order_release );
 
     KMP_YIELD( distance
@@ -880,6 +1005,7 @@ __kmp_init_ticket_lock( kmp_ticket_lock_t * lck )
     std::atomic_store_explicit( &lck->lk.now_serving, 0U, std::memory_order_relaxed );
     std::atomic_store_explicit( &lck->lk.owner_id, 0, std::memory_order_relaxed ); // no thread owns the lock.
     std::atomic_store_explicit( &lck->lk.depth_locked, -1, std::memory_order_relaxed ); // -1 => not a nested lock.
+    std::atomic_store_explicit( &lck->lk.parked, 0U, std::memory_order_relaxed );
     std::atomic_store_explicit( &lck->lk.initialized, true, std::memory_order_release );
 }
 
@@ -1227,6 +1353,30 @@ __kmp_is_queuing_lock_nestable( kmp_queuing_lock_t *lck )
 }
 
 /* Acquire a lock using a the queuing lock implementation */
+#if KMP_USE_FUTEX
+// Waits for a releasing thread to clear spin_here_p, which it does after handing
+// us the lock.  Past the blocktime the waiter flips it to KMP_LOCK_PARKED and
+// sleeps; the release exchanges it back and wakes us if it finds that value.
+static void
+__kmp_wait_queuing_lock_parked( volatile kmp_uint32 *spin_here_p, kmp_queuing_lock_t *lck )
+{
+    kmp_uint64 goal = __kmp_lock_park_goal();
+    kmp_uint32 spins;
+
+    KMP_FSYNC_SPIN_INIT( lck, NULL );
+    KMP_INIT_YIELD( spins );
+    while ( TCR_4( *spin_here_p ) ) {
+        if ( __kmp_lock_park_now( goal, &spins ) ) {
+            KMP_COMPARE_AND_STORE_ACQ32( (volatile kmp_int32 *) spin_here_p, TRUE, KMP_LOCK_PARKED );
+            // returns at once unless we are still parked
+            syscall( __NR_futex, spin_here_p, FUTEX_WAIT, KMP_LOCK_PARKED, NULL, NULL, 0 );
+        }
+        KMP_FSYNC_SPIN_PREPARE( lck );
+    }
+    KMP_FSYNC_SPIN_ACQUIRED( lck );
+}
+#endif // KMP_USE_FUTEX
+
 template <bool takeTime>
 /* [TLW] The unused template above is left behind because of what BEB believes is a
    potential compiler problem with __forceinline. */
@@ -1387,6 +1537,11 @@ __kmp_acquire_queuing_lock_timed_template( kmp_queuing_lock_t *lck,
              *       throughput only here.
              */
             KMP_MB();
+#if KMP_USE_FUTEX
+            if ( __kmp_lock_park )
+                __kmp_wait_queuing_lock_parked( spin_here_p, lck );
+            else
+#endif
             KMP_WAIT_YIELD(spin_here_p, FALSE, KMP_EQ, lck);
 
 #ifdef DEBUG_QUEUING_LOCKS
@@ -1632,6 +1787,14 @@ __kmp_release_queuing_lock( kmp_queuing_lock_t *lck, kmp_int32 gtid )
 
             KMP_MB();
             /* reset spin value */
+#if KMP_USE_FUTEX
+            if ( __kmp_lock_park ) {
+                /* the waiter may have gone to sleep (see __kmp_wait_queuing_lock_parked) */
+                if ( KMP_XCHG_FIXED32( (volatile kmp_int32 *) &head_thr->th.th_spin_here, FALSE ) == KMP_LOCK_PARKED )
+                    syscall( __NR_futex, &head_thr->th.th_spin_here, FUTEX_WAKE, 1, NULL, NULL, 0 );
+            }
+            else
+#endif
             head_thr->th.th_spin_here = FALSE;
 
             KA_TRACE( 1000, ("__kmp_release_queuing_lock: lck:%p, T#%d exiting: after dequeuing\n",
@@ -2019,6 +2182,27 @@ static __inline void _xend()
     __asm__ volatile (".byte 0xC6; .byte 0xF8; .byte " STRINGIZE(ARG) :::"memory");
 #endif
 
+/*
+  Transaction test: nonzero when executing transactionally
+*/
+static __inline int _xtest()
+{
+    unsigned char res;
+#if KMP_OS_WINDOWS
+    _asm {
+        _emit 0x0f
+        _emit 0x01
+        _emit 0xd6
+        setnz res
+    }
+#else
+    __asm__ volatile (".byte 0x0f; .byte 0x01; .byte 0xd6\n"
+                      "   setnz %0"
+                      :"=r"(res)::"memory", "cc");
+#endif
+    return res;
+}
+
 #endif // KMP_COMPILER_ICC && __INTEL_COMPILER >= 1300
 
 //
@@ -3042,31 +3226,6 @@ __kmp_set_drdpa_lock_flags( kmp_drdpa_lock_t *lck, kmp_lock_flags_t flags )
     lck->lk.flags = flags;
 }
 
-// Time stamp counter
-#if KMP_ARCH_X86 || KMP_ARCH_X86_64
-# define __kmp_tsc() __kmp_hardware_timestamp()
-// Runtime's default backoff parameters
-kmp_backoff_t __kmp_spin_backoff_params = { 1, 4096, 100 };
-#else
-// Use nanoseconds for other platforms
-extern kmp_uint64 __kmp_now_nsec();
-kmp_backoff_t __kmp_spin_backoff_params = { 1, 256, 100 };
-# define __kmp_tsc() __kmp_now_nsec()
-#endif
-
-// A useful predicate for dealing with timestamps that may wrap.
-// Is a before b?
-// Since the timestamps may wrap, this is asking whether it's
-// shorter to go clockwise from a to b around the clock-face, or anti-clockwise.
-// Times where going clockwise is less distance than going anti-clockwise
-// are in the future, others are in the past.
-// e.g.) a = MAX-1, b = MAX+1 (=0), then a > b (true) does not mean a reached b
-//       whereas signed(a) = -2, signed(b) = 0 captures the actual difference
-static inline bool before(kmp_uint64 a, kmp_uint64 b)
-{
-    return ((kmp_int64)b - (kmp_int64)a) > 0;
-}
-
 // Truncated binary exponential backoff function
 void
 __kmp_spin_backoff(kmp_backoff_t *boff)
@@ -3247,154 +3406,1357 @@ __kmp_test_rtm_lock_with_checks(kmp_queuing_lock_t *lck, kmp_int32 gtid)
     return __kmp_test_rtm_lock(lck, gtid);
 }
 
-#endif // KMP_USE_TSX
-
-// Entry functions for indirect locks (first element of direct lock jump tables).
-static void __kmp_init_indirect_lock(kmp_dyna_lock_t * l, kmp_dyna_lockseq_t tag);
-static void __kmp_destroy_indirect_lock(kmp_dyna_lock_t * lock);
-static void __kmp_set_indirect_lock(kmp_dyna_lock_t * lock, kmp_int32);
-static int  __kmp_unset_indirect_lock(kmp_dyna_lock_t * lock, kmp_int32);
-static int  __kmp_test_indirect_lock(kmp_dyna_lock_t * lock, kmp_int32);
-static void __kmp_set_indirect_lock_with_checks(kmp_dyna_lock_t * lock, kmp_int32);
-static int  __kmp_unset_indirect_lock_with_checks(kmp_dyna_lock_t * lock, kmp_int32);
-static int  __kmp_test_indirect_lock_with_checks(kmp_dyna_lock_t * lock, kmp_int32);
+/* ------------------------------------------------------------------------ */
+/* speculative critical sections */
+
+// Critical sections on an rtm lock (all unhinted ones with KMP_CRITICAL_SPECULATION)
+// decide whether to speculate per construct rather than per lock: every ident_t has
+// the badness of an adaptive lock and its own commit and abort counts, since one
+// named (or the unnamed) critical lock may be entered from many places.
+
+int __kmp_critical_speculation = FALSE;
+int __kmp_critical_speculation_stats = FALSE;
+
+#define KMP_SPEC_SITES 256 // constructs that get their own entry
+
+typedef struct KMP_ALIGN_CACHE kmp_spec_site {
+    const ident_t * volatile loc;
+    volatile kmp_uint32      badness;       // as for adaptive locks
+    volatile kmp_uint64      commits;
+    volatile kmp_uint64      busy;          // aborted since the lock was taken for real
+    volatile kmp_uint64      conflicts;
+    volatile kmp_uint64      capacity;
+    volatile kmp_uint64      other;         // other aborts: system calls, interrupts, nesting, ...
+    volatile kmp_uint64      fallbacks;     // entries that took the lock for real
+} kmp_spec_site_t;
+
+static kmp_spec_site_t __kmp_spec_sites[ KMP_SPEC_SITES ];
+static kmp_spec_site_t __kmp_spec_site_other;  // no location, or no room left
+
+static kmp_spec_site_t *
+__kmp_spec_site_find( ident_t const *loc )
+{
+    kmp_uint32 h, probe;
+
+    if ( loc == NULL )
+        return &__kmp_spec_site_other;
+    h = (kmp_uint32)( ( (kmp_uintptr_t)loc >> 3 ) % KMP_SPEC_SITES );
+    for ( probe = 0; probe < KMP_SPEC_SITES; ++probe, h = ( h + 1 ) % KMP_SPEC_SITES ) {
+        kmp_spec_site_t *site = &__kmp_spec_sites[ h ];
+        const ident_t *cur = (const ident_t *)TCR_PTR( site->loc );
+        if ( cur == NULL ) {
+            if ( KMP_COMPARE_AND_STORE_PTR( &site->loc, NULL, (void *)loc ) )
+                return site;
+            cur = (const ident_t *)TCR_PTR( site->loc );
+        }
+        if ( cur == loc )
+            return site;
+    }
+    return &__kmp_spec_site_other;
+}
 
-//
-// Jump tables for the indirect lock functions.
-// Only fill in the odd entries, that avoids the need to shift out the low bit.
-//
+static void
+__kmp_spec_site_aborted( kmp_spec_site_t *site, kmp_uint32 status )
+{
+    if ( ( status & _XABORT_EXPLICIT ) && _XABORT_CODE( status ) == 0x01 )
+        KMP_TEST_THEN_INC64( (volatile kmp_int64 *)&site->busy );
+    else if ( status & _XABORT_CONFLICT )
+        KMP_TEST_THEN_INC64( (volatile kmp_int64 *)&site->conflicts );
+    else if ( status & _XABORT_CAPACITY )
+        KMP_TEST_THEN_INC64( (volatile kmp_int64 *)&site->capacity );
+    else
+        KMP_TEST_THEN_INC64( (volatile kmp_int64 *)&site->other );
+}
 
-// init functions
-#define expand(l, op) 0,__kmp_init_direct_lock,
-void (*__kmp_direct_init[])(kmp_dyna_lock_t *, kmp_dyna_lockseq_t)
-    = { __kmp_init_indirect_lock, 0, KMP_FOREACH_D_LOCK(expand, init) };
-#undef expand
+void
+__kmp_acquire_critical_speculative( kmp_queuing_lock_t *lck, ident_t const *loc, kmp_int32 gtid )
+{
+    kmp_spec_site_t *site;
 
-// destroy functions
-#define expand(l, op) 0,(void (*)(kmp_dyna_lock_t *))__kmp_##op##_##l##_lock,
-void (*__kmp_direct_destroy[])(kmp_dyna_lock_t *)
-    = { __kmp_destroy_indirect_lock, 0, KMP_FOREACH_D_LOCK(expand, destroy) };
-#undef expand
+    if ( _xtest() ) {
+        // Nested in a speculating critical section: its transaction covers this one,
+        // an abort here restarts the outer one.
+        _xbegin();
+        if ( ! __kmp_is_unlocked_queuing_lock( lck ) )
+            _xabort(0x01);
+        return;
+    }
 
-// set/acquire functions
-#define expand(l, op) 0,(void (*)(kmp_dyna_lock_t *, kmp_int32))__kmp_##op##_##l##_lock,
-static void (*direct_set[])(kmp_dyna_lock_t *, kmp_int32)
-    = { __kmp_set_indirect_lock, 0, KMP_FOREACH_D_LOCK(expand, acquire) };
-#undef expand
-#define expand(l, op) 0,(void (*)(kmp_dyna_lock_t *, kmp_int32))__kmp_##op##_##l##_lock_with_checks,
-static void (*direct_set_check[])(kmp_dyna_lock_t *, kmp_int32)
-    = { __kmp_set_indirect_lock_with_checks, 0, KMP_FOREACH_D_LOCK(expand, acquire) };
-#undef expand
+    site = __kmp_spec_site_find( loc );
+    if ( ( site->fallbacks & site->badness ) == 0 ) {
+        int retries = __kmp_adaptive_backoff_params.max_soft_retries;
+        kmp_uint32 status;
+        kmp_uint32 badness;
 
-// unset/release and test functions
-#define expand(l, op) 0,(int  (*)(kmp_dyna_lock_t *, kmp_int32))__kmp_##op##_##l##_lock,
-static int (*direct_unset[])(kmp_dyna_lock_t *, kmp_int32)
-    = { __kmp_unset_indirect_lock, 0, KMP_FOREACH_D_LOCK(expand, release) };
-static int  (*direct_test[])(kmp_dyna_lock_t *, kmp_int32)
-    = { __kmp_test_indirect_lock, 0, KMP_FOREACH_D_LOCK(expand, test) };
-#undef expand
-#define expand(l, op) 0,(int  (*)(kmp_dyna_lock_t *, kmp_int32))__kmp_##op##_##l##_lock_with_checks,
-static int (*direct_unset_check[])(kmp_dyna_lock_t *, kmp_int32)
-    = { __kmp_unset_indirect_lock_with_checks, 0, KMP_FOREACH_D_LOCK(expand, release) };
-static int (*direct_test_check[])(kmp_dyna_lock_t *, kmp_int32)
-    = { __kmp_test_indirect_lock_with_checks, 0, KMP_FOREACH_D_LOCK(expand, test) };
-#undef expand
+        // Let a real owner and its queue drain first (see __kmp_acquire_adaptive_lock).
+        while ( ! __kmp_is_unlocked_queuing_lock( lck ) )
+            __kmp_yield( TRUE );
 
-// Exposes only one set of jump tables (*lock or *lock_with_checks).
-void (*(*__kmp_direct_set))(kmp_dyna_lock_t *, kmp_int32) = 0;
-int (*(*__kmp_direct_unset))(kmp_dyna_lock_t *, kmp_int32) = 0;
-int (*(*__kmp_direct_test))(kmp_dyna_lock_t *, kmp_int32) = 0;
+        // Read back by the release, which does not know the construct
+        __kmp_thread_from_gtid( gtid )->th.th_spec_site = site;
+        do {
+            status = _xbegin();
+            if ( status == _XBEGIN_STARTED ) {
+                if ( __kmp_is_unlocked_queuing_lock( lck ) )
+                    return;
+                _xabort(0x01);
+            }
+            __kmp_spec_site_aborted( site, status );
+        } while ( ( status & SOFT_ABORT_MASK ) && retries-- );
 
-//
-// Jump tables for the indirect lock functions.
-//
-#define expand(l, op) (void (*)(kmp_user_lock_p))__kmp_##op##_##l##_##lock,
-void (*__kmp_indirect_init[])(kmp_user_lock_p) = { KMP_FOREACH_I_LOCK(expand, init) };
-void (*__kmp_indirect_destroy[])(kmp_user_lock_p) = { KMP_FOREACH_I_LOCK(expand, destroy) };
-#undef expand
+        badness = ( site->badness << 1 ) | 1;
+        if ( badness <= __kmp_adaptive_backoff_params.max_badness )
+            site->badness = badness;
+    }
 
-// set/acquire functions
-#define expand(l, op) (void (*)(kmp_user_lock_p, kmp_int32))__kmp_##op##_##l##_##lock,
-static void (*indirect_set[])(kmp_user_lock_p, kmp_int32) = { KMP_FOREACH_I_LOCK(expand, acquire) };
-#undef expand
-#define expand(l, op) (void (*)(kmp_user_lock_p, kmp_int32))__kmp_##op##_##l##_##lock_with_checks,
-static void (*indirect_set_check[])(kmp_user_lock_p, kmp_int32) = { KMP_FOREACH_I_LOCK(expand, acquire) };
-#undef expand
+    KMP_TEST_THEN_INC64( (volatile kmp_int64 *)&site->fallbacks );
+    __kmp_acquire_queuing_lock( lck, gtid );
+}
 
-// unset/release and test functions
-#define expand(l, op) (int  (*)(kmp_user_lock_p, kmp_int32))__kmp_##op##_##l##_##lock,
-static int (*indirect_unset[])(kmp_user_lock_p, kmp_int32) = { KMP_FOREACH_I_LOCK(expand, release) };
-static int (*indirect_test[])(kmp_user_lock_p, kmp_int32) = { KMP_FOREACH_I_LOCK(expand, test) };
-#undef expand
-#define expand(l, op) (int  (*)(kmp_user_lock_p, kmp_int32))__kmp_##op##_##l##_##lock_with_checks,
-static int (*indirect_unset_check[])(kmp_user_lock_p, kmp_int32) = { KMP_FOREACH_I_LOCK(expand, release) };
-static int (*indirect_test_check[])(kmp_user_lock_p, kmp_int32) = { KMP_FOREACH_I_LOCK(expand, test) };
-#undef expand
+int
+__kmp_release_critical_speculative( kmp_queuing_lock_t *lck, kmp_int32 gtid )
+{
+    if ( __kmp_is_unlocked_queuing_lock( lck ) ) {
+        // Releasing from speculation
+        _xend();
+        if ( ! _xtest() ) {
+            kmp_spec_site_t *site = (kmp_spec_site_t *)__kmp_thread_from_gtid( gtid )->th.th_spec_site;
+            KMP_TEST_THEN_INC64( (volatile kmp_int64 *)&site->commits );
+            if ( site->badness != 0 )
+                site->badness = 0;
+        }
+    }
+    else {
+        __kmp_release_queuing_lock( lck, gtid );
+    }
+    return KMP_LOCK_RELEASED;
+}
 
-// Exposes only one jump tables (*lock or *lock_with_checks).
-void (*(*__kmp_indirect_set))(kmp_user_lock_p, kmp_int32) = 0;
-int (*(*__kmp_indirect_unset))(kmp_user_lock_p, kmp_int32) = 0;
-int (*(*__kmp_indirect_test))(kmp_user_lock_p, kmp_int32) = 0;
+static int
+__kmp_spec_site_compare( const void *a, const void *b )
+{
+    const kmp_spec_site_t *x = *(const kmp_spec_site_t * const *)a;
+    const kmp_spec_site_t *y = *(const kmp_spec_site_t * const *)b;
+    kmp_uint64 nx = x->commits + x->fallbacks;
+    kmp_uint64 ny = y->commits + y->fallbacks;
+    if ( nx != ny )
+        return nx < ny ? 1 : -1;
+    return 0;
+}
 
-// Lock index table.
-kmp_indirect_lock_table_t __kmp_i_lock_table;
+// Prints the constructs that were entered, the most frequent first.
+void
+__kmp_critical_speculation_print( FILE *out )
+{
+    kmp_spec_site_t *sorted[ KMP_SPEC_SITES + 1 ];
+    int i, n = 0;
 
-// Size of indirect locks.
-static kmp_uint32 __kmp_indirect_lock_size[KMP_NUM_I_LOCKS] = { 0 };
+    for ( i = 0; i < KMP_SPEC_SITES; ++i ) {
+        kmp_spec_site_t *site = &__kmp_spec_sites[ i ];
+        if ( site->loc != NULL && site->commits + site->fallbacks != 0 )
+            sorted[ n++ ] = site;
+    }
+    if ( __kmp_spec_site_other.commits + __kmp_spec_site_other.fallbacks != 0 )
+        sorted[ n++ ] = &__kmp_spec_site_other;
+    if ( n == 0 )
+        return;
+    qsort( sorted, n, sizeof( sorted[ 0 ] ), __kmp_spec_site_compare );
+    fprintf( out, "\nCritical,  Entries,  Commits,  Busy aborts,  Conflict aborts,  Capacity aborts,"
+                  "  Other aborts,  Fallbacks,  Speculates\n" );
+    for ( i = 0; i < n; ++i ) {
+        kmp_spec_site_t const *site = sorted[ i ];
+        if ( site->loc != NULL && site->loc->psource != NULL ) {
+            kmp_str_loc_t loc = __kmp_str_loc_init( site->loc->psource, 1 );
+            fprintf( out, "%s:%d (%s)", loc.file ? loc.file : "unknown", loc.line,
+                     loc.func ? loc.func : "unknown" );
+            __kmp_str_loc_free( &loc );
+        } else {
+            fprintf( out, "other" );
+        }
+        // the last column is the share of entries that try speculation, 1 in badness+1
+        fprintf( out, ", %llu, %llu, %llu, %llu, %llu, %llu, %llu, 1/%u\n",
+                 (unsigned long long)( site->commits + site->fallbacks ),
+                 (unsigned long long)site->commits, (unsigned long long)site->busy,
+                 (unsigned long long)site->conflicts, (unsigned long long)site->capacity,
+                 (unsigned long long)site->other, (unsigned long long)site->fallbacks,
+                 site->badness + 1 );
+    }
+}
 
-// Jump tables for lock accessor/modifier.
-void (*__kmp_indirect_set_location[KMP_NUM_I_LOCKS])(kmp_user_lock_p, const ident_t *) = { 0 };
-void (*__kmp_indirect_set_flags[KMP_NUM_I_LOCKS])(kmp_user_lock_p, kmp_lock_flags_t) = { 0 };
-const ident_t * (*__kmp_indirect_get_location[KMP_NUM_I_LOCKS])(kmp_user_lock_p) = { 0 };
-kmp_lock_flags_t (*__kmp_indirect_get_flags[KMP_NUM_I_LOCKS])(kmp_user_lock_p) = { 0 };
+#endif // KMP_USE_TSX
 
-// Use different lock pools for different lock types.
+/* ------------------------------------------------------------------------ */
+/* Cohort locks                                                             */
+
+int __kmp_cohort_lock_passes = 64;
+int __kmp_cohort_lock_nodes  = 0;
+
+// Node the calling thread queues on: the package of its place, or a share of the gtids when
+// KMP_COHORT_LOCK_NODES is set.
+static inline kmp_int32
+__kmp_get_cohort_node( kmp_int32 gtid )
+{
+    if ( gtid < 0 )
+        return 0;
+    if ( __kmp_cohort_lock_nodes > 0 )
+        return gtid % __kmp_cohort_lock_nodes;
+#if KMP_AFFINITY_SUPPORTED && OMP_40_ENABLED
+    if ( __kmp_affinity_place_package != NULL ) {
+        int place = __kmp_threads[ gtid ]->th.th_current_place;
+        if ( place >= 0 && place < (int)__kmp_affinity_num_masks )
+            return __kmp_affinity_place_package[ place ] % KMP_COHORT_MAX_NODES;
+    }
+#endif
+    return 0;
+}
+
+// Whether the threads run on more than one NUMA node, where a cohort lock keeps contended data local.
+int
+__kmp_cohort_lock_spans_nodes()
+{
+    if ( __kmp_cohort_lock_nodes > 0 )
+        return __kmp_cohort_lock_nodes > 1;
+#if KMP_AFFINITY_SUPPORTED
+    if ( __kmp_affinity_place_package != NULL ) {
+        for ( unsigned i = 1; i < __kmp_affinity_num_masks; ++i )
+            if ( __kmp_affinity_place_package[ i ] != __kmp_affinity_place_package[ 0 ] )
+                return TRUE;
+    }
+#endif
+    return FALSE;
+}
+
+static kmp_int32
+__kmp_get_cohort_lock_owner( kmp_cohort_lock_t *lck )
+{
+    return TCR_4( lck->lk.owner_id ) - 1;
+}
+
+static inline bool
+__kmp_is_cohort_lock_nestable( kmp_cohort_lock_t *lck )
+{
+    return lck->lk.depth_locked != -1;
+}
+
+static int
+__kmp_acquire_cohort_lock( kmp_cohort_lock_t *lck, kmp_int32 gtid )
+{
+    kmp_int32 n = __kmp_get_cohort_node( gtid );
+    struct kmp_cohort_node *node = &lck->lk.nodes[ n ];
+    kmp_uint32 ticket = KMP_TEST_THEN_INC32( (kmp_int32 *)&node->next_ticket );
+
+    KMP_FSYNC_PREPARE( lck );
+    if ( TCR_4( node->now_serving ) != ticket )
+        KMP_WAIT_YIELD( &node->now_serving, ticket, __kmp_eq_4, lck );
+
+    // The previous owner may have left the global lock to the node
+    if ( ! node->global_held ) {
+        ticket = KMP_TEST_THEN_INC32( (kmp_int32 *)&lck->lk.global_next );
+        if ( TCR_4( lck->lk.global_serving ) != ticket )
+            KMP_WAIT_YIELD( &lck->lk.global_serving, ticket, __kmp_eq_4, lck );
+        node->global_held = TRUE;
+        node->passes = 0;
+    }
+    KMP_FSYNC_ACQUIRED( lck );
+    lck->lk.owner_node = n;
+    return KMP_LOCK_ACQUIRED_FIRST;
+}
+
+static int
+__kmp_acquire_cohort_lock_with_checks( kmp_cohort_lock_t *lck, kmp_int32 gtid )
+{
+    char const * const func = "omp_set_lock";
+    if ( lck->lk.initialized != lck ) {
+        KMP_FATAL( LockIsUninitialized, func );
+    }
+    if ( __kmp_is_cohort_lock_nestable( lck ) ) {
+        KMP_FATAL( LockNestableUsedAsSimple, func );
+    }
+    if ( ( gtid >= 0 ) && ( __kmp_get_cohort_lock_owner( lck ) == gtid ) ) {
+        KMP_FATAL( LockIsAlreadyOwned, func );
+    }
+
+    __kmp_acquire_cohort_lock( lck, gtid );
+
+    lck->lk.owner_id = gtid + 1;
+    return KMP_LOCK_ACQUIRED_FIRST;
+}
+
+static int
+__kmp_test_cohort_lock( kmp_cohort_lock_t *lck, kmp_int32 gtid )
+{
+    kmp_int32 n = __kmp_get_cohort_node( gtid );
+    struct kmp_cohort_node *node = &lck->lk.nodes[ n ];
+    kmp_uint32 ticket = TCR_4( node->next_ticket );
+
+    if ( TCR_4( node->now_serving ) != ticket
+      || ! KMP_COMPARE_AND_STORE_ACQ32( (volatile kmp_int32 *)&node->next_ticket, ticket, ticket + 1 ) ) {
+        return FALSE;
+    }
+    if ( ! node->global_held ) {
+        kmp_uint32 global = TCR_4( lck->lk.global_next );
+        if ( TCR_4( lck->lk.global_serving ) != global
+          || ! KMP_COMPARE_AND_STORE_ACQ32( (volatile kmp_int32 *)&lck->lk.global_next, global, global + 1 ) ) {
+            // Back out of the node lock; a thread that queued behind us takes the global lock itself
+            KMP_ST_REL32( &node->now_serving, ticket + 1 );
+            return FALSE;
+        }
+        node->global_held = TRUE;
+        node->passes = 0;
+    }
+    KMP_FSYNC_ACQUIRED( lck );
+    lck->lk.owner_node = n;
+    return TRUE;
+}
+
+static int
+__kmp_test_cohort_lock_with_checks( kmp_cohort_lock_t *lck, kmp_int32 gtid )
+{
+    char const * const func = "omp_test_lock";
+    if ( lck->lk.initialized != lck ) {
+        KMP_FATAL( LockIsUninitialized, func );
+    }
+    if ( __kmp_is_cohort_lock_nestable( lck ) ) {
+        KMP_FATAL( LockNestableUsedAsSimple, func );
+    }
+
+    int retval = __kmp_test_cohort_lock( lck, gtid );
+
+    if ( retval ) {
+        lck->lk.owner_id = gtid + 1;
+    }
+    return retval;
+}
+
+static int
+__kmp_release_cohort_lock( kmp_cohort_lock_t *lck, kmp_int32 gtid )
+{
+    struct kmp_cohort_node *node = &lck->lk.nodes[ lck->lk.owner_node ];
+    kmp_uint32 serving = node->now_serving;
+
+    KMP_FSYNC_RELEASING( lck );
+    // Hand the global lock over within the node while it has waiters, up to the pass limit
+    if ( TCR_4( node->next_ticket ) - serving > 1 && node->passes < (kmp_uint32)__kmp_cohort_lock_passes ) {
+        node->passes++;
+    } else {
+        node->global_held = FALSE;
+        KMP_ST_REL32( &lck->lk.global_serving, lck->lk.global_serving + 1 );
+    }
+    KMP_ST_REL32( &node->now_serving, serving + 1 );
+    return KMP_LOCK_RELEASED;
+}
+
+static int
+__kmp_release_cohort_lock_with_checks( kmp_cohort_lock_t *lck, kmp_int32 gtid )
+{
+    char const * const func = "omp_unset_lock";
+    KMP_MB();  /* in case another processor initialized lock */
+    if ( lck->lk.initialized != lck ) {
+        KMP_FATAL( LockIsUninitialized, func );
+    }
+    if ( __kmp_is_cohort_lock_nestable( lck ) ) {
+        KMP_FATAL( LockNestableUsedAsSimple, func );
+    }
+    if ( __kmp_get_cohort_lock_owner( lck ) == -1 ) {
+        KMP_FATAL( LockUnsettingFree, func );
+    }
+    if ( ( gtid >= 0 ) && ( __kmp_get_cohort_lock_owner( lck ) >= 0 )
+      && ( __kmp_get_cohort_lock_owner( lck ) != gtid ) ) {
+        KMP_FATAL( LockUnsettingSetByAnother, func );
+    }
+    lck->lk.owner_id = 0;
+    return __kmp_release_cohort_lock( lck, gtid );
+}
+
+static void
+__kmp_init_cohort_lock( kmp_cohort_lock_t *lck )
+{
+    int i;
+    lck->lk.location = NULL;
+    lck->lk.flags = 0;
+    lck->lk.global_next = 0;
+    lck->lk.global_serving = 0;
+    for ( i = 0; i < KMP_COHORT_MAX_NODES; ++i ) {
+        lck->lk.nodes[ i ].next_ticket = 0;
+        lck->lk.nodes[ i ].now_serving = 0;
+        lck->lk.nodes[ i ].global_held = FALSE;
+        lck->lk.nodes[ i ].passes = 0;
+    }
+    lck->lk.owner_id = 0;      // no thread owns the lock.
+    lck->lk.depth_locked = -1; // >= 0 for nestable locks, -1 for simple locks.
+    lck->lk.owner_node = 0;
+    lck->lk.initialized = lck;
+
+    KA_TRACE(1000, ("__kmp_init_cohort_lock: lock %p initialized\n", lck));
+}
+
+static void
+__kmp_destroy_cohort_lock( kmp_cohort_lock_t *lck )
+{
+    lck->lk.initialized = NULL;
+    lck->lk.location    = NULL;
+    lck->lk.owner_id = 0;
+    lck->lk.depth_locked = -1;
+}
+
+static const ident_t *
+__kmp_get_cohort_lock_location( kmp_cohort_lock_t *lck )
+{
+    return lck->lk.location;
+}
+
+static void
+__kmp_set_cohort_lock_location( kmp_cohort_lock_t *lck, const ident_t *loc )
+{
+    lck->lk.location = loc;
+}
+
+static kmp_lock_flags_t
+__kmp_get_cohort_lock_flags( kmp_cohort_lock_t *lck )
+{
+    return lck->lk.flags;
+}
+
+static void
+__kmp_set_cohort_lock_flags( kmp_cohort_lock_t *lck, kmp_lock_flags_t flags )
+{
+    lck->lk.flags = flags;
+}
+
+/* ------------------------------------------------------------------------ */
+/* Tuned locks                                                              */
+
+#define KMP_TUNED_LOCK_WINDOW    64 // acquisitions between two decisions on the mode
+#define KMP_TUNED_LOCK_UPGRADE   16 // waits in a window that switch to a queuing mode
+#define KMP_TUNED_LOCK_DOWNGRADE 2  // waits in a window that still switch back to test and set
+
+static kmp_int32
+__kmp_get_tuned_lock_owner( kmp_tuned_lock_t *lck )
+{
+    return TCR_4( lck->lk.owner_id ) - 1;
+}
+
+static inline bool
+__kmp_is_tuned_lock_nestable( kmp_tuned_lock_t *lck )
+{
+    return lck->lk.depth_locked != -1;
+}
+
+static inline int
+__kmp_test_tuned_mode( kmp_tuned_lock_t *lck, kmp_uint32 mode, kmp_int32 gtid )
+{
+    switch ( mode ) {
+        case tuned_mode_queuing:
+            return __kmp_test_queuing_lock( lck->lk.queuing, gtid );
+        case tuned_mode_cohort:
+            return __kmp_test_cohort_lock( lck->lk.cohort, gtid );
+        default:
+            return __kmp_test_tas_lock( &lck->lk.tas, gtid );
+    }
+}
+
+static inline void
+__kmp_acquire_tuned_mode( kmp_tuned_lock_t *lck, kmp_uint32 mode, kmp_int32 gtid )
+{
+    switch ( mode ) {
+        case tuned_mode_queuing:
+            __kmp_acquire_queuing_lock( lck->lk.queuing, gtid );
+            break;
+        case tuned_mode_cohort:
+            __kmp_acquire_cohort_lock( lck->lk.cohort, gtid );
+            break;
+        default:
+            __kmp_acquire_tas_lock( &lck->lk.tas, gtid );
+    }
+}
+
+static inline void
+__kmp_release_tuned_mode( kmp_tuned_lock_t *lck, kmp_uint32 mode, kmp_int32 gtid )
+{
+    switch ( mode ) {
+        case tuned_mode_queuing:
+            __kmp_release_queuing_lock( lck->lk.queuing, gtid );
+            break;
+        case tuned_mode_cohort:
+            __kmp_release_cohort_lock( lck->lk.cohort, gtid );
+            break;
+        default:
+            __kmp_release_tas_lock( &lck->lk.tas, gtid );
+    }
+}
+
+// Called by the owner; takes the lock of the new mode before the mode is published, so the lock
+// stays owned while the threads queued on the old lock drain to the new one.
+static void
+__kmp_switch_tuned_lock( kmp_tuned_lock_t *lck, kmp_int32 gtid, kmp_uint32 to )
+{
+    kmp_uint32 from = lck->lk.owner_mode;
+
+    if ( to == tuned_mode_queuing && lck->lk.queuing == NULL ) {
+        kmp_queuing_lock_t *q = (kmp_queuing_lock_t *)__kmp_allocate( sizeof( kmp_queuing_lock_t ) );
+        __kmp_init_queuing_lock( q );
+        lck->lk.queuing = q;
+    } else if ( to == tuned_mode_cohort && lck->lk.cohort == NULL ) {
+        kmp_cohort_lock_t *c = (kmp_cohort_lock_t *)__kmp_allocate( sizeof( kmp_cohort_lock_t ) );
+        __kmp_init_cohort_lock( c );
+        lck->lk.cohort = c;
+    }
+    // Only threads that saw the new mode before an earlier switch can hold its lock, and they
+    // let go of it as soon as they see the current mode.
+    __kmp_acquire_tuned_mode( lck, to, gtid );
+    KMP_MB();
+    TCW_4( lck->lk.mode, to );
+    KMP_MB();
+    __kmp_release_tuned_mode( lck, from, gtid );
+    lck->lk.owner_mode = to;
+
+    KA_TRACE(1000, ("__kmp_switch_tuned_lock: lock %p switched from mode %d to %d\n", lck, from, to));
+}
+
+// Called by the owner after every acquisition.
+static inline void
+__kmp_tuned_lock_account( kmp_tuned_lock_t *lck, kmp_int32 gtid, int waited )
+{
+    kmp_uint32 mode = lck->lk.owner_mode;
+    kmp_uint32 to = mode;
+
+    lck->lk.contended += waited;
+    if ( ++lck->lk.acquires < KMP_TUNED_LOCK_WINDOW )
+        return;
+    if ( mode == tuned_mode_tas ) {
+        if ( lck->lk.contended >= KMP_TUNED_LOCK_UPGRADE )
+            to = __kmp_cohort_lock_spans_nodes() ? tuned_mode_cohort : tuned_mode_queuing;
+    } else if ( lck->lk.contended <= KMP_TUNED_LOCK_DOWNGRADE ) {
+        to = tuned_mode_tas;
+    }
+    lck->lk.acquires = 0;
+    lck->lk.contended = 0;
+    if ( to != mode )
+        __kmp_switch_tuned_lock( lck, gtid, to );
+}
+
+static int
+__kmp_acquire_tuned_lock( kmp_tuned_lock_t *lck, kmp_int32 gtid )
+{
+    int waited = FALSE;
+    kmp_uint32 mode;
+
+    for ( ;; ) {
+        mode = TCR_4( lck->lk.mode );
+        if ( ! __kmp_test_tuned_mode( lck, mode, gtid ) ) {
+            waited = TRUE;
+            __kmp_acquire_tuned_mode( lck, mode, gtid );
+        }
+        if ( TCR_4( lck->lk.mode ) == mode )
+            break;
+        // The owner switched the lock while this thread waited for the old mode
+        __kmp_release_tuned_mode( lck, mode, gtid );
+    }
+    lck->lk.owner_mode = mode;
+    __kmp_tuned_lock_account( lck, gtid, waited );
+    return KMP_LOCK_ACQUIRED_FIRST;
+}
+
+static int
+__kmp_acquire_tuned_lock_with_checks( kmp_tuned_lock_t *lck, kmp_int32 gtid )
+{
+    char const * const func = "omp_set_lock";
+    if ( lck->lk.initialized != lck ) {
+        KMP_FATAL( LockIsUninitialized, func );
+    }
+    if ( __kmp_is_tuned_lock_nestable( lck ) ) {
+        KMP_FATAL( LockNestableUsedAsSimple, func );
+    }
+    if ( ( gtid >= 0 ) && ( __kmp_get_tuned_lock_owner( lck ) == gtid ) ) {
+        KMP_FATAL( LockIsAlreadyOwned, func );
+    }
+
+    __kmp_acquire_tuned_lock( lck, gtid );
+
+    lck->lk.owner_id = gtid + 1;
+    return KMP_LOCK_ACQUIRED_FIRST;
+}
+
+static int
+__kmp_test_tuned_lock( kmp_tuned_lock_t *lck, kmp_int32 gtid )
+{
+    kmp_uint32 mode = TCR_4( lck->lk.mode );
+
+    if ( ! __kmp_test_tuned_mode( lck, mode, gtid ) )
+        return FALSE;
+    if ( TCR_4( lck->lk.mode ) != mode ) {
+        __kmp_release_tuned_mode( lck, mode, gtid );
+        return FALSE;
+    }
+    lck->lk.owner_mode = mode;
+    __kmp_tuned_lock_account( lck, gtid, FALSE );
+    return TRUE;
+}
+
+static int
+__kmp_test_tuned_lock_with_checks( kmp_tuned_lock_t *lck, kmp_int32 gtid )
+{
+    char const * const func = "omp_test_lock";
+    if ( lck->lk.initialized != lck ) {
+        KMP_FATAL( LockIsUninitialized, func );
+    }
+    if ( __kmp_is_tuned_lock_nestable( lck ) ) {
+        KMP_FATAL( LockNestableUsedAsSimple, func );
+    }
+
+    int retval = __kmp_test_tuned_lock( lck, gtid );
+
+    if ( retval ) {
+        lck->lk.owner_id = gtid + 1;
+    }
+    return retval;
+}
+
+static int
+__kmp_release_tuned_lock( kmp_tuned_lock_t *lck, kmp_int32 gtid )
+{
+    __kmp_release_tuned_mode( lck, lck->lk.owner_mode, gtid );
+    return KMP_LOCK_RELEASED;
+}
+
+static int
+__kmp_release_tuned_lock_with_checks( kmp_tuned_lock_t *lck, kmp_int32 gtid )
+{
+    char const * const func = "omp_unset_lock";
+    KMP_MB();  /* in case another processor initialized lock */
+    if ( lck->lk.initialized != lck ) {
+        KMP_FATAL( LockIsUninitialized, func );
+    }
+    if ( __kmp_is_tuned_lock_nestable( lck ) ) {
+        KMP_FATAL( LockNestableUsedAsSimple, func );
+    }
+    if ( __kmp_get_tuned_lock_owner( lck ) == -1 ) {
+        KMP_FATAL( LockUnsettingFree, func );
+    }
+    if ( ( gtid >= 0 ) && ( __kmp_get_tuned_lock_owner( lck ) >= 0 )
+      && ( __kmp_get_tuned_lock_owner( lck ) != gtid ) ) {
+        KMP_FATAL( LockUnsettingSetByAnother, func );
+    }
+    lck->lk.owner_id = 0;
+    return __kmp_release_tuned_lock( lck, gtid );
+}
+
+static void
+__kmp_init_tuned_lock( kmp_tuned_lock_t *lck )
+{
+    lck->lk.location = NULL;
+    lck->lk.flags = 0;
+    lck->lk.mode = tuned_mode_tas;
+    lck->lk.owner_mode = tuned_mode_tas;
+    lck->lk.acquires = 0;
+    lck->lk.contended = 0;
+    __kmp_init_tas_lock( &lck->lk.tas );
+    lck->lk.queuing = NULL;
+    lck->lk.cohort = NULL;
+    lck->lk.owner_id = 0;      // no thread owns the lock.
+    lck->lk.depth_locked = -1; // >= 0 for nestable locks, -1 for simple locks.
+    lck->lk.initialized = lck;
+
+    KA_TRACE(1000, ("__kmp_init_tuned_lock: lock %p initialized\n", lck));
+}
+
+static void
+__kmp_destroy_tuned_lock( kmp_tuned_lock_t *lck )
+{
+    lck->lk.initialized = NULL;
+    lck->lk.location    = NULL;
+    __kmp_destroy_tas_lock( &lck->lk.tas );
+    if ( lck->lk.queuing != NULL ) {
+        __kmp_destroy_queuing_lock( lck->lk.queuing );
+        __kmp_free( lck->lk.queuing );
+        lck->lk.queuing = NULL;
+    }
+    if ( lck->lk.cohort != NULL ) {
+        __kmp_destroy_cohort_lock( lck->lk.cohort );
+        __kmp_free( lck->lk.cohort );
+        lck->lk.cohort = NULL;
+    }
+    lck->lk.mode = tuned_mode_tas;
+    lck->lk.owner_id = 0;
+    lck->lk.depth_locked = -1;
+}
+
+static const ident_t *
+__kmp_get_tuned_lock_location( kmp_tuned_lock_t *lck )
+{
+    return lck->lk.location;
+}
+
+static void
+__kmp_set_tuned_lock_location( kmp_tuned_lock_t *lck, const ident_t *loc )
+{
+    lck->lk.location = loc;
+}
+
+static kmp_lock_flags_t
+__kmp_get_tuned_lock_flags( kmp_tuned_lock_t *lck )
+{
+    return lck->lk.flags;
+}
+
+static void
+__kmp_set_tuned_lock_flags( kmp_tuned_lock_t *lck, kmp_lock_flags_t flags )
+{
+    lck->lk.flags = flags;
+}
+
+/* ------------------------------------------------------------------------ */
+/* Combining locks                                                          */
+
+#define KMP_COMBINING_PASSES 4 // times a combiner collects the requests before it lets go of the lock
+
+static kmp_int32
+__kmp_get_combining_lock_owner( kmp_combining_lock_t *lck )
+{
+    return TCR_4( lck->lk.owner_id ) - 1;
+}
+
+static inline bool
+__kmp_is_combining_lock_nestable( kmp_combining_lock_t *lck )
+{
+    return lck->lk.depth_locked != -1;
+}
+
+// Runs body(data) under the lock: either this thread gets the lock and runs the published
+// requests, its own among them, or the thread that has the lock runs it on its behalf.
+void
+__kmp_combine_critical( kmp_combining_lock_t *lck, kmp_int32 gtid, void (*body)( void * ), void *data )
+{
+    struct kmp_combining_request req;
+    struct kmp_combining_request *head;
+    kmp_uint32 spins;
+
+    req.body = body;
+    req.data = data;
+    req.done = FALSE;
+    do {
+        head = lck->lk.requests;
+        req.next = head;
+    } while ( ! KMP_COMPARE_AND_STORE_PTR( &lck->lk.requests, head, &req ) );
+
+    KMP_FSYNC_PREPARE( lck );
+    KMP_INIT_YIELD( spins );
+    while ( ! TCR_4( req.done ) ) {
+        if ( __kmp_test_tas_lock( &lck->lk.lock, gtid ) ) {
+            // The request of this thread was published before it got the lock, so it is either in
+            // the first batch or an earlier combiner has run it.
+            int pass;
+            for ( pass = 0; pass < KMP_COMBINING_PASSES; ++pass ) {
+                struct kmp_combining_request *batch = NULL, *next;
+                do {
+                    head = lck->lk.requests;
+                } while ( head != NULL && ! KMP_COMPARE_AND_STORE_PTR( &lck->lk.requests, head, NULL ) );
+                if ( head == NULL )
+                    break;
+                // Run in the order of arrival
+                for ( ; head != NULL; head = next ) {
+                    next = head->next;
+                    head->next = batch;
+                    batch = head;
+                }
+                for ( ; batch != NULL; batch = next ) {
+                    next = batch->next;
+                    batch->body( batch->data );
+                    KMP_MB();
+                    TCW_4( batch->done, TRUE ); // the request lives on the stack of its thread
+                }
+            }
+            __kmp_release_tas_lock( &lck->lk.lock, gtid );
+            break;
+        }
+        KMP_YIELD( TCR_4( __kmp_nth ) > ( __kmp_avail_proc ? __kmp_avail_proc : __kmp_xproc ) );
+        KMP_YIELD_SPIN( spins );
+    }
+    KMP_MB();
+    KMP_FSYNC_ACQUIRED( lck );
+}
+
+static int
+__kmp_acquire_combining_lock( kmp_combining_lock_t *lck, kmp_int32 gtid )
+{
+    return __kmp_acquire_tas_lock( &lck->lk.lock, gtid );
+}
+
+static int
+__kmp_acquire_combining_lock_with_checks( kmp_combining_lock_t *lck, kmp_int32 gtid )
+{
+    char const * const func = "omp_set_lock";
+    if ( lck->lk.initialized != lck ) {
+        KMP_FATAL( LockIsUninitialized, func );
+    }
+    if ( __kmp_is_combining_lock_nestable( lck ) ) {
+        KMP_FATAL( LockNestableUsedAsSimple, func );
+    }
+    if ( ( gtid >= 0 ) && ( __kmp_get_combining_lock_owner( lck ) == gtid ) ) {
+        KMP_FATAL( LockIsAlreadyOwned, func );
+    }
+
+    __kmp_acquire_combining_lock( lck, gtid );
+
+    lck->lk.owner_id = gtid + 1;
+    return KMP_LOCK_ACQUIRED_FIRST;
+}
+
+static int
+__kmp_test_combining_lock( kmp_combining_lock_t *lck, kmp_int32 gtid )
+{
+    return __kmp_test_tas_lock( &lck->lk.lock, gtid );
+}
+
+static int
+__kmp_test_combining_lock_with_checks( kmp_combining_lock_t *lck, kmp_int32 gtid )
+{
+    char const * const func = "omp_test_lock";
+    if ( lck->lk.initialized != lck ) {
+        KMP_FATAL( LockIsUninitialized, func );
+    }
+    if ( __kmp_is_combining_lock_nestable( lck ) ) {
+        KMP_FATAL( LockNestableUsedAsSimple, func );
+    }
+
+    int retval = __kmp_test_combining_lock( lck, gtid );
+
+    if ( retval ) {
+        lck->lk.owner_id = gtid + 1;
+    }
+    return retval;
+}
+
+static int
+__kmp_release_combining_lock( kmp_combining_lock_t *lck, kmp_int32 gtid )
+{
+    return __kmp_release_tas_lock( &lck->lk.lock, gtid );
+}
+
+static int
+__kmp_release_combining_lock_with_checks( kmp_combining_lock_t *lck, kmp_int32 gtid )
+{
+    char const * const func = "omp_unset_lock";
+    KMP_MB();  /* in case another processor initialized lock */
+    if ( lck->lk.initialized != lck ) {
+        KMP_FATAL( LockIsUninitialized, func );
+    }
+    if ( __kmp_is_combining_lock_nestable( lck ) ) {
+        KMP_FATAL( LockNestableUsedAsSimple, func );
+    }
+    if ( __kmp_get_combining_lock_owner( lck ) == -1 ) {
+        KMP_FATAL( LockUnsettingFree, func );
+    }
+    if ( ( gtid >= 0 ) && ( __kmp_get_combining_lock_owner( lck ) >= 0 )
+      && ( __kmp_get_combining_lock_owner( lck ) != gtid ) ) {
+        KMP_FATAL( LockUnsettingSetByAnother, func );
+    }
+    lck->lk.owner_id = 0;
+    return __kmp_release_combining_lock( lck, gtid );
+}
+
+static void
+__kmp_init_combining_lock( kmp_combining_lock_t *lck )
+{
+    lck->lk.location = NULL;
+    lck->lk.flags = 0;
+    __kmp_init_tas_lock( &lck->lk.lock );
+    lck->lk.requests = NULL;
+    lck->lk.owner_id = 0;      // no thread owns the lock.
+    lck->lk.depth_locked = -1; // >= 0 for nestable locks, -1 for simple locks.
+    lck->lk.initialized = lck;
+
+    KA_TRACE(1000, ("__kmp_init_combining_lock: lock %p initialized\n", lck));
+}
+
+static void
+__kmp_destroy_combining_lock( kmp_combining_lock_t *lck )
+{
+    lck->lk.initialized = NULL;
+    lck->lk.location    = NULL;
+    __kmp_destroy_tas_lock( &lck->lk.lock );
+    lck->lk.owner_id = 0;
+    lck->lk.depth_locked = -1;
+}
+
+static const ident_t *
+__kmp_get_combining_lock_location( kmp_combining_lock_t *lck )
+{
+    return lck->lk.location;
+}
+
+static void
+__kmp_set_combining_lock_location( kmp_combining_lock_t *lck, const ident_t *loc )
+{
+    lck->lk.location = loc;
+}
+
+static kmp_lock_flags_t
+__kmp_get_combining_lock_flags( kmp_combining_lock_t *lck )
+{
+    return lck->lk.flags;
+}
+
+static void
+__kmp_set_combining_lock_flags( kmp_combining_lock_t *lck, kmp_lock_flags_t flags )
+{
+    lck->lk.flags = flags;
+}
+
+/* ------------------------------------------------------------------------ */
+/* Reader-writer locks                                                      */
+
+static kmp_int32
+__kmp_get_rw_lock_owner( kmp_rwlock_t *lck )
+{
+    return TCR_4( lck->lk.owner_id ) - 1;
+}
+
+static inline bool
+__kmp_is_rw_lock_nestable( kmp_rwlock_t *lck )
+{
+    return lck->lk.depth_locked != -1;
+}
+
+static inline volatile kmp_int32 *
+__kmp_get_rw_lock_slot( kmp_rwlock_t *lck, kmp_int32 gtid )
+{
+    return &lck->lk.slots[ (kmp_uint32)gtid % KMP_RW_LOCK_SLOTS ].readers;
+}
+
+int
+__kmp_acquire_rw_lock_read( kmp_rwlock_t *lck, kmp_int32 gtid )
+{
+    volatile kmp_int32 *slot = __kmp_get_rw_lock_slot( lck, gtid );
+
+    // The locked increment orders the store to the slot before the load of the flag, against
+    // the writer that raises the flag with an exchange before it reads the slots.
+    KMP_TEST_THEN_INC32( slot );
+    if ( TCR_4( lck->lk.writer ) ) {
+        KMP_FSYNC_PREPARE( lck );
+        do {
+            KMP_TEST_THEN_DEC32( slot );
+            KMP_WAIT_YIELD( (volatile kmp_uint32 *)&lck->lk.writer, 0, __kmp_eq_4, lck );
+            KMP_TEST_THEN_INC32( slot );
+        } while ( TCR_4( lck->lk.writer ) );
+    }
+    KMP_FSYNC_ACQUIRED( lck );
+    return KMP_LOCK_ACQUIRED_FIRST;
+}
+
+int
+__kmp_test_rw_lock_read( kmp_rwlock_t *lck, kmp_int32 gtid )
+{
+    volatile kmp_int32 *slot = __kmp_get_rw_lock_slot( lck, gtid );
+
+    if ( TCR_4( lck->lk.writer ) )
+        return FALSE;
+    KMP_TEST_THEN_INC32( slot );
+    if ( TCR_4( lck->lk.writer ) ) {
+        KMP_TEST_THEN_DEC32( slot );
+        return FALSE;
+    }
+    KMP_FSYNC_ACQUIRED( lck );
+    return TRUE;
+}
+
+static int
+__kmp_release_rw_lock_read( kmp_rwlock_t *lck, kmp_int32 gtid )
+{
+    KMP_FSYNC_RELEASING( lck );
+    KMP_MB();
+    KMP_TEST_THEN_DEC32( __kmp_get_rw_lock_slot( lck, gtid ) );
+    return KMP_LOCK_RELEASED;
+}
+
+// Raises the writer flag. A plain store could still sit in the store buffer while the writer reads
+// the slots, so that a reader and the writer would both miss each other: the exchange is a full
+// fence on x86, and KMP_MB() covers the other architectures.
+static inline void
+__kmp_raise_rw_lock_writer( kmp_rwlock_t *lck )
+{
+    KMP_XCHG_FIXED32( &lck->lk.writer, TRUE );
+    KMP_MB();
+}
+
+// Called by the only writer once it has raised the flag: waits for the readers that got in before.
+static void
+__kmp_drain_rw_lock_readers( kmp_rwlock_t *lck )
+{
+    int i;
+    for ( i = 0; i < KMP_RW_LOCK_SLOTS; ++i ) {
+        if ( TCR_4( lck->lk.slots[ i ].readers ) != 0 )
+            KMP_WAIT_YIELD( (volatile kmp_uint32 *)&lck->lk.slots[ i ].readers, 0, __kmp_eq_4, lck );
+    }
+}
+
+static int
+__kmp_acquire_rw_lock( kmp_rwlock_t *lck, kmp_int32 gtid )
+{
+    __kmp_acquire_queuing_lock( &lck->lk.writers, gtid );
+    __kmp_raise_rw_lock_writer( lck );
+    KMP_FSYNC_PREPARE( lck );
+    __kmp_drain_rw_lock_readers( lck );
+    KMP_FSYNC_ACQUIRED( lck );
+    // unlock tells a writer from a reader by the owner
+    lck->lk.owner_id = gtid + 1;
+    return KMP_LOCK_ACQUIRED_FIRST;
+}
+
+static int
+__kmp_acquire_rw_lock_with_checks( kmp_rwlock_t *lck, kmp_int32 gtid )
+{
+    char const * const func = "omp_set_lock";
+    if ( lck->lk.initialized != lck ) {
+        KMP_FATAL( LockIsUninitialized, func );
+    }
+    if ( __kmp_is_rw_lock_nestable( lck ) ) {
+        KMP_FATAL( LockNestableUsedAsSimple, func );
+    }
+    if ( ( gtid >= 0 ) && ( __kmp_get_rw_lock_owner( lck ) == gtid ) ) {
+        KMP_FATAL( LockIsAlreadyOwned, func );
+    }
+
+    return __kmp_acquire_rw_lock( lck, gtid );
+}
+
+static int
+__kmp_test_rw_lock( kmp_rwlock_t *lck, kmp_int32 gtid )
+{
+    int i;
+    if ( TCR_4( lck->lk.writer ) || ! __kmp_test_queuing_lock( &lck->lk.writers, gtid ) )
+        return FALSE;
+    __kmp_raise_rw_lock_writer( lck );
+    for ( i = 0; i < KMP_RW_LOCK_SLOTS; ++i ) {
+        if ( TCR_4( lck->lk.slots[ i ].readers ) != 0 ) {
+            TCW_4( lck->lk.writer, FALSE );
+            __kmp_release_queuing_lock( &lck->lk.writers, gtid );
+            return FALSE;
+        }
+    }
+    KMP_FSYNC_ACQUIRED( lck );
+    lck->lk.owner_id = gtid + 1;
+    return TRUE;
+}
+
+static int
+__kmp_test_rw_lock_with_checks( kmp_rwlock_t *lck, kmp_int32 gtid )
+{
+    char const * const func = "omp_test_lock";
+    if ( lck->lk.initialized != lck ) {
+        KMP_FATAL( LockIsUninitialized, func );
+    }
+    if ( __kmp_is_rw_lock_nestable( lck ) ) {
+        KMP_FATAL( LockNestableUsedAsSimple, func );
+    }
+
+    return __kmp_test_rw_lock( lck, gtid );
+}
+
+// Releases the lock held by the calling thread, for writing if it is the owner, else for reading.
+static int
+__kmp_release_rw_lock( kmp_rwlock_t *lck, kmp_int32 gtid )
+{
+    if ( TCR_4( lck->lk.owner_id ) != gtid + 1 )
+        return __kmp_release_rw_lock_read( lck, gtid );
+    KMP_FSYNC_RELEASING( lck );
+    lck->lk.owner_id = 0;
+    KMP_MB();
+    TCW_4( lck->lk.writer, FALSE );
+    return __kmp_release_queuing_lock( &lck->lk.writers, gtid );
+}
+
+static int
+__kmp_release_rw_lock_with_checks( kmp_rwlock_t *lck, kmp_int32 gtid )
+{
+    char const * const func = "omp_unset_lock";
+    KMP_MB();  /* in case another processor initialized lock */
+    if ( lck->lk.initialized != lck ) {
+        KMP_FATAL( LockIsUninitialized, func );
+    }
+    if ( __kmp_is_rw_lock_nestable( lck ) ) {
+        KMP_FATAL( LockNestableUsedAsSimple, func );
+    }
+    // A reader of the slot of the thread must be in unless a writer is
+    if ( __kmp_get_rw_lock_owner( lck ) == -1 && TCR_4( *__kmp_get_rw_lock_slot( lck, gtid ) ) <= 0 ) {
+        KMP_FATAL( LockUnsettingFree, func );
+    }
+    if ( ( gtid >= 0 ) && ( __kmp_get_rw_lock_owner( lck ) >= 0 )
+      && ( __kmp_get_rw_lock_owner( lck ) != gtid ) ) {
+        KMP_FATAL( LockUnsettingSetByAnother, func );
+    }
+    return __kmp_release_rw_lock( lck, gtid );
+}
+
+static void
+__kmp_init_rw_lock( kmp_rwlock_t *lck )
+{
+    int i;
+    lck->lk.location = NULL;
+    lck->lk.flags = 0;
+    __kmp_init_queuing_lock( &lck->lk.writers );
+    lck->lk.writer = FALSE;
+    for ( i = 0; i < KMP_RW_LOCK_SLOTS; ++i )
+        lck->lk.slots[ i ].readers = 0;
+    lck->lk.owner_id = 0;      // no thread owns the lock.
+    lck->lk.depth_locked = -1; // >= 0 for nestable locks, -1 for simple locks.
+    lck->lk.initialized = lck;
+
+    KA_TRACE(1000, ("__kmp_init_rw_lock: lock %p initialized\n", lck));
+}
+
+static void
+__kmp_destroy_rw_lock( kmp_rwlock_t *lck )
+{
+    lck->lk.initialized = NULL;
+    lck->lk.location    = NULL;
+    __kmp_destroy_queuing_lock( &lck->lk.writers );
+    lck->lk.owner_id = 0;
+    lck->lk.depth_locked = -1;
+}
+
+static const ident_t *
+__kmp_get_rw_lock_location( kmp_rwlock_t *lck )
+{
+    return lck->lk.location;
+}
+
+static void
+__kmp_set_rw_lock_location( kmp_rwlock_t *lck, const ident_t *loc )
+{
+    lck->lk.location = loc;
+}
+
+static kmp_lock_flags_t
+__kmp_get_rw_lock_flags( kmp_rwlock_t *lck )
+{
+    return lck->lk.flags;
+}
+
+static void
+__kmp_set_rw_lock_flags( kmp_rwlock_t *lck, kmp_lock_flags_t flags )
+{
+    lck->lk.flags = flags;
+}
+
+// Entry functions for indirect locks (first element of direct lock jump tables).
+static void __kmp_init_indirect_lock(kmp_dyna_lock_t * l, kmp_dyna_lockseq_t tag);
+static void __kmp_destroy_indirect_lock(kmp_dyna_lock_t * lock);
+static void __kmp_set_indirect_lock(kmp_dyna_lock_t * lock, kmp_int32);
+static int  __kmp_unset_indirect_lock(kmp_dyna_lock_t * lock, kmp_int32);
+static int  __kmp_test_indirect_lock(kmp_dyna_lock_t * lock, kmp_int32);
+static void __kmp_set_indirect_lock_with_checks(kmp_dyna_lock_t * lock, kmp_int32);
+static int  __kmp_unset_indirect_lock_with_checks(kmp_dyna_lock_t * lock, kmp_int32);
+static int  __kmp_test_indirect_lock_with_checks(kmp_dyna_lock_t * lock, kmp_int32);
+
+//
+// Jump tables for the indirect lock functions.
+// Only fill in the odd entries, that avoids the need to shift out the low bit.
+//
+
+// init functions
+#define expand(l, op) 0,__kmp_init_direct_lock,
+void (*__kmp_direct_init[])(kmp_dyna_lock_t *, kmp_dyna_lockseq_t)
+    = { __kmp_init_indirect_lock, 0, KMP_FOREACH_D_LOCK(expand, init) };
+#undef expand
+
+// destroy functions
+#define expand(l, op) 0,(void (*)(kmp_dyna_lock_t *))__kmp_##op##_##l##_lock,
+void (*__kmp_direct_destroy[])(kmp_dyna_lock_t *)
+    = { __kmp_destroy_indirect_lock, 0, KMP_FOREACH_D_LOCK(expand, destroy) };
+#undef expand
+
+// set/acquire functions
+#define expand(l, op) 0,(void (*)(kmp_dyna_lock_t *, kmp_int32))__kmp_##op##_##l##_lock,
+static void (*direct_set[])(kmp_dyna_lock_t *, kmp_int32)
+    = { __kmp_set_indirect_lock, 0, KMP_FOREACH_D_LOCK(expand, acquire) };
+#undef expand
+#define expand(l, op) 0,(void (*)(kmp_dyna_lock_t *, kmp_int32))__kmp_##op##_##l##_lock_with_checks,
+static void (*direct_set_check[])(kmp_dyna_lock_t *, kmp_int32)
+    = { __kmp_set_indirect_lock_with_checks, 0, KMP_FOREACH_D_LOCK(expand, acquire) };
+#undef expand
+
+// unset/release and test functions
+#define expand(l, op) 0,(int  (*)(kmp_dyna_lock_t *, kmp_int32))__kmp_##op##_##l##_lock,
+static int (*direct_unset[])(kmp_dyna_lock_t *, kmp_int32)
+    = { __kmp_unset_indirect_lock, 0, KMP_FOREACH_D_LOCK(expand, release) };
+static int  (*direct_test[])(kmp_dyna_lock_t *, kmp_int32)
+    = { __kmp_test_indirect_lock, 0, KMP_FOREACH_D_LOCK(expand, test) };
+#undef expand
+#define expand(l, op) 0,(int  (*)(kmp_dyna_lock_t *, kmp_int32))__kmp_##op##_##l##_lock_with_checks,
+static int (*direct_unset_check[])(kmp_dyna_lock_t *, kmp_int32)
+    = { __kmp_unset_indirect_lock_with_checks, 0, KMP_FOREACH_D_LOCK(expand, release) };
+static int (*direct_test_check[])(kmp_dyna_lock_t *, kmp_int32)
+    = { __kmp_test_indirect_lock_with_checks, 0, KMP_FOREACH_D_LOCK(expand, test) };
+#undef expand
+
+// Exposes only one set of jump tables (*lock or *lock_with_checks).
+void (*(*__kmp_direct_set))(kmp_dyna_lock_t *, kmp_int32) = 0;
+int (*(*__kmp_direct_unset))(kmp_dyna_lock_t *, kmp_int32) = 0;
+int (*(*__kmp_direct_test))(kmp_dyna_lock_t *, kmp_int32) = 0;
+
+//
+// Jump tables for the indirect lock functions.
+//
+#define expand(l, op) (void (*)(kmp_user_lock_p))__kmp_##op##_##l##_##lock,
+void (*__kmp_indirect_init[])(kmp_user_lock_p) = { KMP_FOREACH_I_LOCK(expand, init) };
+void (*__kmp_indirect_destroy[])(kmp_user_lock_p) = { KMP_FOREACH_I_LOCK(expand, destroy) };
+#undef expand
+
+// set/acquire functions
+#define expand(l, op) (void (*)(kmp_user_lock_p, kmp_int32))__kmp_##op##_##l##_##lock,
+static void (*indirect_set[])(kmp_user_lock_p, kmp_int32) = { KMP_FOREACH_I_LOCK(expand, acquire) };
+#undef expand
+#define expand(l, op) (void (*)(kmp_user_lock_p, kmp_int32))__kmp_##op##_##l##_##lock_with_checks,
+static void (*indirect_set_check[])(kmp_user_lock_p, kmp_int32) = { KMP_FOREACH_I_LOCK(expand, acquire) };
+#undef expand
+
+// unset/release and test functions
+#define expand(l, op) (int  (*)(kmp_user_lock_p, kmp_int32))__kmp_##op##_##l##_##lock,
+static int (*indirect_unset[])(kmp_user_lock_p, kmp_int32) = { KMP_FOREACH_I_LOCK(expand, release) };
+static int (*indirect_test[])(kmp_user_lock_p, kmp_int32) = { KMP_FOREACH_I_LOCK(expand, test) };
+#undef expand
+#define expand(l, op) (int  (*)(kmp_user_lock_p, kmp_int32))__kmp_##op##_##l##_##lock_with_checks,
+static int (*indirect_unset_check[])(kmp_user_lock_p, kmp_int32) = { KMP_FOREACH_I_LOCK(expand, release) };
+static int (*indirect_test_check[])(kmp_user_lock_p, kmp_int32) = { KMP_FOREACH_I_LOCK(expand, test) };
+#undef expand
+
+// Exposes only one jump tables (*lock or *lock_with_checks).
+void (*(*__kmp_indirect_set))(kmp_user_lock_p, kmp_int32) = 0;
+int (*(*__kmp_indirect_unset))(kmp_user_lock_p, kmp_int32) = 0;
+int (*(*__kmp_indirect_test))(kmp_user_lock_p, kmp_int32) = 0;
+
+// Lock index table.
+kmp_indirect_lock_table_t __kmp_i_lock_table;
+
+// Size of indirect locks.
+static kmp_uint32 __kmp_indirect_lock_size[KMP_NUM_I_LOCKS] = { 0 };
+
+// Jump tables for lock accessor/modifier.
+void (*__kmp_indirect_set_location[KMP_NUM_I_LOCKS])(kmp_user_lock_p, const ident_t *) = { 0 };
+void (*__kmp_indirect_set_flags[KMP_NUM_I_LOCKS])(kmp_user_lock_p, kmp_lock_flags_t) = { 0 };
+const ident_t * (*__kmp_indirect_get_location[KMP_NUM_I_LOCKS])(kmp_user_lock_p) = { 0 };
+kmp_lock_flags_t (*__kmp_indirect_get_flags[KMP_NUM_I_LOCKS])(kmp_user_lock_p) = { 0 };
+
+// Lock pools for different lock types, holding the locks that threads destroyed beyond what
+// they keep for themselves and the pools of reaped threads.
 static kmp_indirect_lock_t * __kmp_indirect_lock_pool[KMP_NUM_I_LOCKS] = { 0 };
 
+// Moves the destroyed locks of the given type beyond the first "keep" ones from the pool of the
+// thread to the global pool.
+static void
+__kmp_spill_indirect_locks(kmp_info_t *th, kmp_int32 gtid, kmp_indirect_locktag_t tag,
+                           kmp_uint32 keep)
+{
+    kmp_indirect_lock_t *head = th->th.th_i_lock_pool[tag];
+    kmp_indirect_lock_t *tail;
+    kmp_uint32 i;
+
+    if (keep > 0) {
+        kmp_indirect_lock_t *last = head;
+        for (i = 1; i < keep && last != NULL; ++i)
+            last = (kmp_indirect_lock_t *)last->lock->pool.next;
+        if (last == NULL)
+            return;
+        head = (kmp_indirect_lock_t *)last->lock->pool.next;
+        last->lock->pool.next = NULL;
+    } else {
+        th->th.th_i_lock_pool[tag] = NULL;
+    }
+    th->th.th_i_lock_pool_size[tag] = keep;
+    if (head == NULL)
+        return;
+    for (tail = head; tail->lock->pool.next != NULL; )
+        tail = (kmp_indirect_lock_t *)tail->lock->pool.next;
+
+    __kmp_acquire_lock(&__kmp_global_lock, gtid);
+    tail->lock->pool.next = (kmp_user_lock_p)__kmp_indirect_lock_pool[tag];
+    __kmp_indirect_lock_pool[tag] = head;
+    __kmp_release_lock(&__kmp_global_lock, gtid);
+}
+
+// Refills the empty pool of the thread with up to half a pool of locks from the global pool.
+static void
+__kmp_adopt_indirect_locks(kmp_info_t *th, kmp_int32 gtid, kmp_indirect_locktag_t tag)
+{
+    kmp_indirect_lock_t *head, *last;
+    kmp_uint32 n = 0;
+
+    __kmp_acquire_lock(&__kmp_global_lock, gtid);
+    head = last = __kmp_indirect_lock_pool[tag];
+    if (head != NULL) {
+        for (n = 1; n < KMP_I_LOCK_POOL_MAX / 2 && last->lock->pool.next != NULL; ++n)
+            last = (kmp_indirect_lock_t *)last->lock->pool.next;
+        __kmp_indirect_lock_pool[tag] = (kmp_indirect_lock_t *)last->lock->pool.next;
+        last->lock->pool.next = NULL;
+    }
+    __kmp_release_lock(&__kmp_global_lock, gtid);
+    th->th.th_i_lock_pool[tag] = head;
+    th->th.th_i_lock_pool_size[tag] = n;
+}
+
+// Reserves the next batch of lock table entries for the thread, allocating the chunk that holds
+// them if no other thread did so yet.
+static void
+__kmp_reserve_indirect_locks(kmp_info_t *th)
+{
+    kmp_lock_index_t idx = KMP_TEST_THEN_ADD32(&__kmp_i_lock_table.next, KMP_I_LOCK_BATCH);
+    kmp_lock_index_t row = idx / KMP_I_LOCK_CHUNK;
+
+    if (row >= KMP_I_LOCK_ROWS) {
+        KMP_FATAL(MemoryAllocFailed);
+    }
+    if (TCR_PTR(__kmp_i_lock_table.table[row]) == NULL) {
+        kmp_indirect_lock_t *chunk = (kmp_indirect_lock_t *)
+                                     __kmp_allocate(KMP_I_LOCK_CHUNK*sizeof(kmp_indirect_lock_t));
+        if (!KMP_COMPARE_AND_STORE_PTR(&__kmp_i_lock_table.table[row], NULL, chunk)) {
+            // Another thread got to the chunk first
+            __kmp_free(chunk);
+        }
+    }
+    th->th.th_i_lock_next = idx;
+    th->th.th_i_lock_end = idx + KMP_I_LOCK_BATCH;
+    KA_TRACE(20, ("__kmp_reserve_indirect_locks: T#%d reserved locks %u-%u\n",
+                  th->th.th_info.ds.ds_gtid, idx, idx + KMP_I_LOCK_BATCH - 1));
+}
+
 // User lock allocator for dynamically dispatched indirect locks.
 // Every entry of the indirect lock table holds the address and type of the allocated indrect lock
-// (kmp_indirect_lock_t), and the size of the table doubles when it is full. A destroyed indirect lock
-// object is returned to the reusable pool of locks, unique to each lock type.
+// (kmp_indirect_lock_t). A destroyed indirect lock object is returned to the reusable pool of locks
+// of the destroying thread, unique to each lock type. The pools of the threads are bounded and
+// exchange locks with the global pools in bulk, so that a thread that only creates locks reuses
+// those destroyed by the others.
 kmp_indirect_lock_t *
 __kmp_allocate_indirect_lock(void **user_lock, kmp_int32 gtid, kmp_indirect_locktag_t tag)
 {
+    kmp_info_t *th = __kmp_threads[gtid];
     kmp_indirect_lock_t *lck;
     kmp_lock_index_t idx;
 
-    __kmp_acquire_lock(&__kmp_global_lock, gtid);
+    if (th->th.th_i_lock_pool[tag] == NULL && TCR_PTR(__kmp_indirect_lock_pool[tag]) != NULL) {
+        // Adopt locks destroyed by other threads before reserving new ones
+        __kmp_adopt_indirect_locks(th, gtid, tag);
+    }
 
-    if (__kmp_indirect_lock_pool[tag] != NULL) {
+    if (th->th.th_i_lock_pool[tag] != NULL) {
         // Reuse the allocated and destroyed lock object
-        lck = __kmp_indirect_lock_pool[tag];
+        lck = th->th.th_i_lock_pool[tag];
         if (OMP_LOCK_T_SIZE < sizeof(void *))
             idx = lck->lock->pool.index;
-        __kmp_indirect_lock_pool[tag] = (kmp_indirect_lock_t *)lck->lock->pool.next;
+        th->th.th_i_lock_pool[tag] = (kmp_indirect_lock_t *)lck->lock->pool.next;
+        th->th.th_i_lock_pool_size[tag]--;
         KA_TRACE(20, ("__kmp_allocate_indirect_lock: reusing an existing lock %p\n", lck));
     } else {
-        idx = __kmp_i_lock_table.next;
-        // Check capacity and double the size if it is full
-        if (idx == __kmp_i_lock_table.size) {
-            // Double up the space for block pointers
-            int row = __kmp_i_lock_table.size/KMP_I_LOCK_CHUNK;
-            kmp_indirect_lock_t **old_table = __kmp_i_lock_table.table;
-            __kmp_i_lock_table.table = (kmp_indirect_lock_t **)__kmp_allocate(2*row*sizeof(kmp_indirect_lock_t *));
-            KMP_MEMCPY(__kmp_i_lock_table.table, old_table, row*sizeof(kmp_indirect_lock_t *));
-            __kmp_free(old_table);
-            // Allocate new objects in the new blocks
-            for (int i = row; i < 2*row; ++i)
-                *(__kmp_i_lock_table.table + i) = (kmp_indirect_lock_t *)
-                                                  __kmp_allocate(KMP_I_LOCK_CHUNK*sizeof(kmp_indirect_lock_t));
-            __kmp_i_lock_table.size = 2*idx;
+        if (th->th.th_i_lock_next == th->th.th_i_lock_end) {
+            __kmp_reserve_indirect_locks(th);
         }
-        __kmp_i_lock_table.next++;
+        idx = th->th.th_i_lock_next++;
         lck = KMP_GET_I_LOCK(idx);
         // Allocate a new base lock object
         lck->lock = (kmp_user_lock_p)__kmp_allocate(__kmp_indirect_lock_size[tag]);
         KA_TRACE(20, ("__kmp_allocate_indirect_lock: allocated a new lock %p\n", lck));
     }
 
-    __kmp_release_lock(&__kmp_global_lock, gtid);
-
     lck->type = tag;
 
     if (OMP_LOCK_T_SIZE < sizeof(void *)) {
@@ -3406,6 +4768,18 @@ __kmp_allocate_indirect_lock(void **user_lock, kmp_int32 gtid, kmp_indirect_lock
     return lck;
 }
 
+// Hands the lock pools of a thread being reaped over to the global pools. The table entries the
+// thread reserved but never used are left alone.
+void
+__kmp_reap_indirect_locks(kmp_info_t *th)
+{
+    int k;
+
+    for (k = 0; k < KMP_NUM_I_LOCKS; ++k) {
+        __kmp_spill_indirect_locks(th, __kmp_get_gtid(), (kmp_indirect_locktag_t)k, 0);
+    }
+}
+
 // User lock lookup for dynamically dispatched locks.
 static __forceinline
 kmp_indirect_lock_t *
@@ -3418,7 +4792,8 @@ __kmp_lookup_indirect_lock(void **user_lock, const char *func)
         }
         if (OMP_LOCK_T_SIZE < sizeof(void *)) {
             kmp_lock_index_t idx = KMP_EXTRACT_I_INDEX(user_lock);
-            if (idx >= __kmp_i_lock_table.size) {
+            if (idx >= TCR_4(__kmp_i_lock_table.next) || idx >= KMP_I_LOCK_ROWS*KMP_I_LOCK_CHUNK ||
+                __kmp_i_lock_table.table[idx/KMP_I_LOCK_CHUNK] == NULL) {
                 KMP_FATAL(LockIsUninitialized, func);
             }
             lck = KMP_GET_I_LOCK(idx);
@@ -3458,24 +4833,31 @@ __kmp_init_indirect_lock(kmp_dyna_lock_t * lock, kmp_dyna_lockseq_t seq)
     KA_TRACE(20, ("__kmp_init_indirect_lock: initialized indirect lock with type#%d\n", seq));
 }
 
+static void __kmp_lock_profile_forget(kmp_user_lock_p, kmp_indirect_locktag_t);
+
 static void
 __kmp_destroy_indirect_lock(kmp_dyna_lock_t * lock)
 {
-    kmp_uint32 gtid = __kmp_entry_gtid();
+    kmp_int32 gtid = __kmp_entry_gtid();
+    kmp_info_t *th = __kmp_threads[gtid];
     kmp_indirect_lock_t *l = __kmp_lookup_indirect_lock((void **)lock, "omp_destroy_lock");
+    if (__kmp_lock_profile) {
+        // The base lock goes back to a pool and may come back as another lock
+        __kmp_lock_profile_forget(l->lock, l->type);
+    }
     KMP_I_LOCK_FUNC(l, destroy)(l->lock);
     kmp_indirect_locktag_t tag = l->type;
 
-    __kmp_acquire_lock(&__kmp_global_lock, gtid);
-
     // Use the base lock's space to keep the pool chain.
-    l->lock->pool.next = (kmp_user_lock_p)__kmp_indirect_lock_pool[tag];
+    l->lock->pool.next = (kmp_user_lock_p)th->th.th_i_lock_pool[tag];
     if (OMP_LOCK_T_SIZE < sizeof(void *)) {
         l->lock->pool.index = KMP_EXTRACT_I_INDEX(lock);
     }
-    __kmp_indirect_lock_pool[tag] = l;
-
-    __kmp_release_lock(&__kmp_global_lock, gtid);
+    th->th.th_i_lock_pool[tag] = l;
+    if (++th->th.th_i_lock_pool_size[tag] > KMP_I_LOCK_POOL_MAX) {
+        // Keep half a pool and let the others reuse the rest
+        __kmp_spill_indirect_locks(th, gtid, tag, KMP_I_LOCK_POOL_MAX / 2);
+    }
 }
 
 static void
@@ -3547,11 +4929,394 @@ __kmp_get_user_lock_owner(kmp_user_lock_p lck, kmp_uint32 seq)
         case lockseq_drdpa:
         case lockseq_nested_drdpa:
             return __kmp_get_drdpa_lock_owner((kmp_drdpa_lock_t *)lck);
+        case lockseq_cohort:
+            return __kmp_get_cohort_lock_owner((kmp_cohort_lock_t *)lck);
+        case lockseq_tuned:
+            return __kmp_get_tuned_lock_owner((kmp_tuned_lock_t *)lck);
+        case lockseq_combining:
+            return __kmp_get_combining_lock_owner((kmp_combining_lock_t *)lck);
+        case lockseq_rw:
+            return __kmp_get_rw_lock_owner((kmp_rwlock_t *)lck);
         default:
             return 0;
     }
 }
 
+/* ------------------------------------------------------------------------ */
+/* Lock profile (KMP_LOCK_PROFILE).
+   The set/unset/test jump tables are replaced by wrappers that call the plain (or checking)
+   functions and record, per location, the acquisitions, the acquisitions that had to wait,
+   the failed tests, the total and the longest wait and the time the lock was held.  A set first
+   tries the lock, so an acquisition is contended when the try fails, and only then the wait is
+   timed.  User locks and critical sections alike go through the tables; a lock is counted under
+   the location of its indirect lock (the construct of a critical section, the __kmpc_init_lock
+   call of a user lock), under its own address when it has none.  An entry keyed by address is
+   retired when the lock is destroyed, so a lock that reuses the object starts afresh; it stays in
+   the report until a lookup finds no free entry and takes it over.  Lookups probe a bounded number
+   of entries and locks that find no room are not recorded.  The hold time is measured per thread.
+   Times are in __kmp_tsc() ticks. */
+
+int __kmp_lock_profile = FALSE;
+
+#define KMP_LOCK_PROFILE_SITES  1024 // locations that can be recorded
+#define KMP_LOCK_PROFILE_PROBES 16   // entries a lookup looks at
+
+typedef struct KMP_ALIGN_CACHE kmp_lock_profile_site {
+    void * volatile          key;           // the location, or the lock object when it has none
+    void * volatile          lock;          // the first lock seen (the user lock for direct locks)
+    const ident_t * volatile loc;
+    volatile kmp_uint64      acquires;
+    volatile kmp_uint64      contended;     // acquisitions that found the lock taken
+    volatile kmp_uint64      failed_tests;
+    volatile kmp_uint64      wait;
+    volatile kmp_uint64      max_wait;
+    volatile kmp_uint64      hold;
+} kmp_lock_profile_site_t;
+
+static kmp_lock_profile_site_t __kmp_lock_profile_sites[ KMP_LOCK_PROFILE_SITES ];
+
+// Keys no lock matches: of an entry whose lock was destroyed, of an entry being taken over.
+#define KMP_LOCK_PROFILE_RETIRED ( (void *)&__kmp_lock_profile_sites[ 0 ] )
+#define KMP_LOCK_PROFILE_BUSY    ( (void *)&__kmp_lock_profile_sites[ 1 ] )
+
+// The jump tables the wrappers call, plain or with checks.
+static void (**lock_profile_direct_set)(kmp_dyna_lock_t *, kmp_int32);
+static int  (**lock_profile_direct_unset)(kmp_dyna_lock_t *, kmp_int32);
+static int  (**lock_profile_direct_test)(kmp_dyna_lock_t *, kmp_int32);
+static void (**lock_profile_indirect_set)(kmp_user_lock_p, kmp_int32);
+static int  (**lock_profile_indirect_unset)(kmp_user_lock_p, kmp_int32);
+static int  (**lock_profile_indirect_test)(kmp_user_lock_p, kmp_int32);
+static void (*lock_profile_direct_destroy[ sizeof( direct_set ) / sizeof( direct_set[ 0 ] ) ])(kmp_dyna_lock_t *);
+
+// Finds or adds the entry keyed by key; NULL when the probed entries are taken by others.
+static kmp_lock_profile_site_t *
+__kmp_lock_profile_lookup( void *key, void *lck, const ident_t *loc )
+{
+    kmp_lock_profile_site_t *retired = NULL;
+    kmp_uint32 h, probe;
+
+    h = (kmp_uint32)( ( (kmp_uintptr_t)key >> 3 ) % KMP_LOCK_PROFILE_SITES );
+    for ( probe = 0; probe < KMP_LOCK_PROFILE_PROBES; ++probe, h = ( h + 1 ) % KMP_LOCK_PROFILE_SITES ) {
+        kmp_lock_profile_site_t *site = &__kmp_lock_profile_sites[ h ];
+        void *cur = TCR_PTR( site->key );
+        if ( cur == NULL ) {
+            if ( KMP_COMPARE_AND_STORE_PTR( &site->key, NULL, key ) ) {
+                TCW_PTR( site->lock, lck );
+                TCW_PTR( site->loc, loc );
+                return site;
+            }
+            cur = TCR_PTR( site->key );
+        }
+        if ( cur == key )
+            return site;
+        if ( cur == KMP_LOCK_PROFILE_RETIRED && retired == NULL )
+            retired = site;
+    }
+    // Take over the figures of a destroyed lock
+    if ( retired != NULL && KMP_COMPARE_AND_STORE_PTR( &retired->key, KMP_LOCK_PROFILE_RETIRED,
+                                                       KMP_LOCK_PROFILE_BUSY ) ) {
+        retired->acquires = retired->contended = retired->failed_tests = 0;
+        retired->wait = retired->max_wait = retired->hold = 0;
+        TCW_PTR( retired->lock, lck );
+        TCW_PTR( retired->loc, loc );
+        KMP_MB();
+        TCW_PTR( retired->key, key );
+        return retired;
+    }
+    return NULL;
+}
+
+// Finds or adds the entry of the lock; itag is the indirect lock tag, -1 for a direct lock.
+static kmp_lock_profile_site_t *
+__kmp_lock_profile_find( void *lck, kmp_int32 itag )
+{
+    const ident_t *loc = NULL;
+
+    if ( itag >= 0 && __kmp_indirect_get_location[ itag ] != NULL )
+        loc = __kmp_indirect_get_location[ itag ]( (kmp_user_lock_p)lck );
+    return __kmp_lock_profile_lookup( loc != NULL ? (void *)loc : lck, lck, loc );
+}
+
+// Retires the entry of a destroyed lock that was keyed by its address.
+static void
+__kmp_lock_profile_retire( void *lck )
+{
+    kmp_uint32 h, probe;
+
+    h = (kmp_uint32)( ( (kmp_uintptr_t)lck >> 3 ) % KMP_LOCK_PROFILE_SITES );
+    for ( probe = 0; probe < KMP_LOCK_PROFILE_PROBES; ++probe, h = ( h + 1 ) % KMP_LOCK_PROFILE_SITES ) {
+        kmp_lock_profile_site_t *site = &__kmp_lock_profile_sites[ h ];
+        void *cur = TCR_PTR( site->key );
+        if ( cur == NULL )
+            return;
+        if ( cur == lck ) {
+            KMP_COMPARE_AND_STORE_PTR( &site->key, cur, KMP_LOCK_PROFILE_RETIRED );
+            return;
+        }
+    }
+}
+
+// Called by __kmp_destroy_indirect_lock; the entries of locations are shared by all the locks
+// made there and stay.
+static void
+__kmp_lock_profile_forget( kmp_user_lock_p lck, kmp_indirect_locktag_t itag )
+{
+    if ( __kmp_indirect_get_location[ itag ] == NULL || __kmp_indirect_get_location[ itag ]( lck ) == NULL )
+        __kmp_lock_profile_retire( lck );
+}
+
+// Records an acquisition by a try (wait == 0, not contended) or a set.
+static void
+__kmp_lock_profile_acquired( kmp_lock_profile_site_t *site, void *lck, kmp_int32 gtid, int contended,
+                             kmp_uint64 wait )
+{
+    kmp_uint64 max_wait;
+    int i;
+
+    KMP_TEST_THEN_INC64( (volatile kmp_int64 *)&site->acquires );
+    if ( contended ) {
+        KMP_TEST_THEN_INC64( (volatile kmp_int64 *)&site->contended );
+        KMP_TEST_THEN_ADD64( (volatile kmp_int64 *)&site->wait, (kmp_int64)wait );
+        max_wait = site->max_wait;
+        while ( wait > max_wait && ! KMP_COMPARE_AND_STORE_ACQ64( (volatile kmp_int64 *)&site->max_wait,
+                                                                  (kmp_int64)max_wait, (kmp_int64)wait ) )
+            max_wait = site->max_wait;
+    }
+    if ( gtid >= 0 ) {
+        kmp_lock_profile_held_t *held = __kmp_threads[ gtid ]->th.th_lock_held;
+        for ( i = 0; i < KMP_LOCK_PROFILE_HELD; ++i ) {
+            if ( held[ i ].lock == NULL ) {
+                held[ i ].lock = lck;
+                held[ i ].acquired_at = __kmp_tsc();
+                break;
+            }
+        }
+    }
+}
+
+// A test returns the depth of a nestable lock, only the first acquisition is recorded.
+template< typename L >
+static void
+__kmp_lock_profile_set( kmp_lock_profile_site_t *site, L *lck, kmp_int32 gtid,
+                        int (*test)( L *, kmp_int32 ), void (*set)( L *, kmp_int32 ) )
+{
+    kmp_uint64 start;
+    int rc = test( lck, gtid );
+
+    if ( rc ) {
+        if ( site != NULL && rc == 1 )
+            __kmp_lock_profile_acquired( site, lck, gtid, FALSE, 0 );
+        return;
+    }
+    start = __kmp_tsc();
+    set( lck, gtid );
+    if ( site != NULL )
+        __kmp_lock_profile_acquired( site, lck, gtid, TRUE, __kmp_tsc() - start );
+}
+
+template< typename L >
+static int
+__kmp_lock_profile_test( kmp_lock_profile_site_t *site, L *lck, kmp_int32 gtid, int (*test)( L *, kmp_int32 ) )
+{
+    int rc = test( lck, gtid );
+
+    if ( site != NULL ) {
+        if ( rc == 1 )
+            __kmp_lock_profile_acquired( site, lck, gtid, FALSE, 0 );
+        else if ( ! rc )
+            KMP_TEST_THEN_INC64( (volatile kmp_int64 *)&site->failed_tests );
+    }
+    return rc;
+}
+
+// Only the thread's own acquisitions are timed, so a thread that did not acquire the lock through
+// the tables (a reader of a reader-writer lock) adds no hold time.
+template< typename L >
+static int
+__kmp_lock_profile_unset( kmp_lock_profile_site_t *site, L *lck, kmp_int32 gtid, int (*unset)( L *, kmp_int32 ) )
+{
+    kmp_lock_profile_held_t *held = NULL;
+    kmp_uint64 now = __kmp_tsc();
+    int i, rc;
+
+    if ( gtid >= 0 ) {
+        for ( i = 0; i < KMP_LOCK_PROFILE_HELD; ++i ) {
+            if ( __kmp_threads[ gtid ]->th.th_lock_held[ i ].lock == (void *)lck ) {
+                held = &__kmp_threads[ gtid ]->th.th_lock_held[ i ];
+                break;
+            }
+        }
+    }
+    rc = unset( lck, gtid );
+    if ( held != NULL && rc == KMP_LOCK_RELEASED ) { // a nestable lock may still be held
+        if ( site != NULL )
+            KMP_TEST_THEN_ADD64( (volatile kmp_int64 *)&site->hold, (kmp_int64)( now - held->acquired_at ) );
+        held->lock = NULL;
+    }
+    return rc;
+}
+
+// Direct locks; the indirect ones (tag 0) are recorded by the indirect wrappers.
+static void
+__kmp_profile_direct_set( kmp_dyna_lock_t *lck, kmp_int32 gtid )
+{
+    kmp_uint32 tag = KMP_EXTRACT_D_TAG( lck );
+    if ( tag == 0 ) {
+        lock_profile_direct_set[ 0 ]( lck, gtid );
+        return;
+    }
+    __kmp_lock_profile_set( __kmp_lock_profile_find( lck, -1 ), lck, gtid, lock_profile_direct_test[ tag ],
+                            lock_profile_direct_set[ tag ] );
+}
+
+static int
+__kmp_profile_direct_unset( kmp_dyna_lock_t *lck, kmp_int32 gtid )
+{
+    kmp_uint32 tag = KMP_EXTRACT_D_TAG( lck );
+    if ( tag == 0 )
+        return lock_profile_direct_unset[ 0 ]( lck, gtid );
+    return __kmp_lock_profile_unset( __kmp_lock_profile_find( lck, -1 ), lck, gtid, lock_profile_direct_unset[ tag ] );
+}
+
+static int
+__kmp_profile_direct_test( kmp_dyna_lock_t *lck, kmp_int32 gtid )
+{
+    kmp_uint32 tag = KMP_EXTRACT_D_TAG( lck );
+    if ( tag == 0 )
+        return lock_profile_direct_test[ 0 ]( lck, gtid );
+    return __kmp_lock_profile_test( __kmp_lock_profile_find( lck, -1 ), lck, gtid, lock_profile_direct_test[ tag ] );
+}
+
+static void
+__kmp_profile_direct_destroy( kmp_dyna_lock_t *lck )
+{
+    __kmp_lock_profile_retire( lck );
+    lock_profile_direct_destroy[ KMP_EXTRACT_D_TAG( lck ) ]( lck );
+}
+
+template< kmp_indirect_locktag_t tag >
+static void
+__kmp_profile_indirect_set( kmp_user_lock_p lck, kmp_int32 gtid )
+{
+    __kmp_lock_profile_set( __kmp_lock_profile_find( lck, tag ), lck, gtid, lock_profile_indirect_test[ tag ],
+                            lock_profile_indirect_set[ tag ] );
+}
+
+template< kmp_indirect_locktag_t tag >
+static int
+__kmp_profile_indirect_unset( kmp_user_lock_p lck, kmp_int32 gtid )
+{
+    return __kmp_lock_profile_unset( __kmp_lock_profile_find( lck, tag ), lck, gtid, lock_profile_indirect_unset[ tag ] );
+}
+
+template< kmp_indirect_locktag_t tag >
+static int
+__kmp_profile_indirect_test( kmp_user_lock_p lck, kmp_int32 gtid )
+{
+    return __kmp_lock_profile_test( __kmp_lock_profile_find( lck, tag ), lck, gtid, lock_profile_indirect_test[ tag ] );
+}
+
+static void (*direct_set_profile[ sizeof( direct_set ) / sizeof( direct_set[ 0 ] ) ])(kmp_dyna_lock_t *, kmp_int32);
+static int  (*direct_unset_profile[ sizeof( direct_set ) / sizeof( direct_set[ 0 ] ) ])(kmp_dyna_lock_t *, kmp_int32);
+static int  (*direct_test_profile[ sizeof( direct_set ) / sizeof( direct_set[ 0 ] ) ])(kmp_dyna_lock_t *, kmp_int32);
+
+#define expand(l, op) __kmp_profile_indirect_##op< locktag_##l >,
+static void (*indirect_set_profile[])(kmp_user_lock_p, kmp_int32) = { KMP_FOREACH_I_LOCK(expand, set) };
+static int (*indirect_unset_profile[])(kmp_user_lock_p, kmp_int32) = { KMP_FOREACH_I_LOCK(expand, unset) };
+static int (*indirect_test_profile[])(kmp_user_lock_p, kmp_int32) = { KMP_FOREACH_I_LOCK(expand, test) };
+#undef expand
+
+// Puts the profiling wrappers in front of the jump tables chosen by __kmp_init_dynamic_user_locks.
+static void
+__kmp_lock_profile_install()
+{
+    unsigned i;
+
+    lock_profile_direct_set     = __kmp_direct_set;
+    lock_profile_direct_unset   = __kmp_direct_unset;
+    lock_profile_direct_test    = __kmp_direct_test;
+    lock_profile_indirect_set   = __kmp_indirect_set;
+    lock_profile_indirect_unset = __kmp_indirect_unset;
+    lock_profile_indirect_test  = __kmp_indirect_test;
+    for ( i = 0; i < sizeof( direct_set ) / sizeof( direct_set[ 0 ] ); ++i ) {
+        direct_set_profile[ i ]   = __kmp_profile_direct_set;
+        direct_unset_profile[ i ] = __kmp_profile_direct_unset;
+        direct_test_profile[ i ]  = __kmp_profile_direct_test;
+        // The indirect locks (tag 0) forget themselves; the table stays wrapped across reinits
+        if ( i != 0 && __kmp_direct_destroy[ i ] != NULL &&
+             __kmp_direct_destroy[ i ] != __kmp_profile_direct_destroy ) {
+            lock_profile_direct_destroy[ i ] = __kmp_direct_destroy[ i ];
+            __kmp_direct_destroy[ i ] = __kmp_profile_direct_destroy;
+        }
+    }
+    __kmp_direct_set     = direct_set_profile;
+    __kmp_direct_unset   = direct_unset_profile;
+    __kmp_direct_test    = direct_test_profile;
+    __kmp_indirect_set   = indirect_set_profile;
+    __kmp_indirect_unset = indirect_unset_profile;
+    __kmp_indirect_test  = indirect_test_profile;
+}
+
+static int
+__kmp_lock_profile_compare( const void *a, const void *b )
+{
+    const kmp_lock_profile_site_t *x = *(const kmp_lock_profile_site_t * const *)a;
+    const kmp_lock_profile_site_t *y = *(const kmp_lock_profile_site_t * const *)b;
+    if ( x->wait != y->wait )
+        return x->wait < y->wait ? 1 : -1;
+    if ( x->acquires != y->acquires )
+        return x->acquires < y->acquires ? 1 : -1;
+    return 0;
+}
+
+// Prints the locks that were acquired, the longest total wait first.
+void
+__kmp_lock_profile_print( FILE *out )
+{
+    kmp_lock_profile_site_t *sorted[ KMP_LOCK_PROFILE_SITES ];
+    int i, n = 0;
+
+    for ( i = 0; i < KMP_LOCK_PROFILE_SITES; ++i ) {
+        if ( __kmp_lock_profile_sites[ i ].key != NULL && __kmp_lock_profile_sites[ i ].acquires != 0 )
+            sorted[ n++ ] = &__kmp_lock_profile_sites[ i ];
+    }
+    if ( n == 0 )
+        return;
+    qsort( sorted, n, sizeof( sorted[ 0 ] ), __kmp_lock_profile_compare );
+    fprintf( out, "\nLock,  Acquisitions,  Contended,  Failed tests,  Wait ticks,  Max wait,  Mean wait,"
+                  "  Hold ticks\n" );
+    for ( i = 0; i < n; ++i ) {
+        kmp_lock_profile_site_t const *site = sorted[ i ];
+        if ( site->loc != NULL && site->loc->psource != NULL ) {
+            kmp_str_loc_t loc = __kmp_str_loc_init( site->loc->psource, 1 );
+            fprintf( out, "%s:%d (%s)", loc.file ? loc.file : "unknown", loc.line,
+                     loc.func ? loc.func : "unknown" );
+            __kmp_str_loc_free( &loc );
+        } else {
+            fprintf( out, "lock %p", site->lock );
+        }
+        fprintf( out, ", %llu, %llu, %llu, %llu, %llu, %llu, %llu\n",
+                 (unsigned long long)site->acquires, (unsigned long long)site->contended,
+                 (unsigned long long)site->failed_tests, (unsigned long long)site->wait,
+                 (unsigned long long)site->max_wait,
+                 (unsigned long long)( site->contended ? site->wait / site->contended : 0 ),
+                 (unsigned long long)site->hold );
+    }
+}
+
+// Clears the figures; the locations keep their entries.
+void
+__kmp_lock_profile_reset()
+{
+    int i;
+    for ( i = 0; i < KMP_LOCK_PROFILE_SITES; ++i ) {
+        kmp_lock_profile_site_t *site = &__kmp_lock_profile_sites[ i ];
+        site->acquires = site->contended = site->failed_tests = 0;
+        site->wait = site->max_wait = site->hold = 0;
+    }
+    KMP_MB();
+}
+
 // Initializes data for dynamic user locks.
 void
 __kmp_init_dynamic_user_locks()
@@ -3573,13 +5338,11 @@ __kmp_init_dynamic_user_locks()
         __kmp_indirect_unset = indirect_unset;
         __kmp_indirect_test  = indirect_test;
     }
+    if (__kmp_lock_profile) {
+        __kmp_lock_profile_install();
+    }
 
-    // Initialize lock index table
-    __kmp_i_lock_table.size = KMP_I_LOCK_CHUNK;
-    __kmp_i_lock_table.table = (kmp_indirect_lock_t **)__kmp_allocate(sizeof(kmp_indirect_lock_t *));
-    *(__kmp_i_lock_table.table) = (kmp_indirect_lock_t *)
-                                  __kmp_allocate(KMP_I_LOCK_CHUNK*sizeof(kmp_indirect_lock_t));
-    __kmp_i_lock_table.next = 0;
+    // The lock index table starts empty and grows on demand (see __kmp_reserve_indirect_locks).
 
     // Indirect lock size
     __kmp_indirect_lock_size[locktag_ticket]         = sizeof(kmp_ticket_lock_t);
@@ -3591,6 +5354,10 @@ __kmp_init_dynamic_user_locks()
 #if KMP_USE_TSX
     __kmp_indirect_lock_size[locktag_rtm]            = sizeof(kmp_queuing_lock_t);
 #endif
+    __kmp_indirect_lock_size[locktag_cohort]         = sizeof(kmp_cohort_lock_t);
+    __kmp_indirect_lock_size[locktag_tuned]          = sizeof(kmp_tuned_lock_t);
+    __kmp_indirect_lock_size[locktag_combining]      = sizeof(kmp_combining_lock_t);
+    __kmp_indirect_lock_size[locktag_rw]             = sizeof(kmp_rwlock_t);
     __kmp_indirect_lock_size[locktag_nested_tas]     = sizeof(kmp_tas_lock_t);
 #if KMP_USE_FUTEX
     __kmp_indirect_lock_size[locktag_nested_futex]   = sizeof(kmp_futex_lock_t);
@@ -3607,15 +5374,23 @@ __kmp_init_dynamic_user_locks()
 }
 
 #if KMP_USE_ADAPTIVE_LOCKS
-# define fill_table(table, expand) {           \
-    fill_jumps(table, expand, _);              \
-    table[locktag_adaptive] = expand(queuing); \
-    fill_jumps(table, expand, _nested_);       \
+# define fill_table(table, expand) {              \
+    fill_jumps(table, expand, _);                 \
+    table[locktag_adaptive]  = expand(queuing);   \
+    table[locktag_cohort]    = expand(cohort);    \
+    table[locktag_tuned]     = expand(tuned);     \
+    table[locktag_combining] = expand(combining); \
+    table[locktag_rw]        = expand(rw);        \
+    fill_jumps(table, expand, _nested_);          \
 }
 #else
-# define fill_table(table, expand) {           \
-    fill_jumps(table, expand, _);              \
-    fill_jumps(table, expand, _nested_);       \
+# define fill_table(table, expand) {              \
+    fill_jumps(table, expand, _);                 \
+    table[locktag_cohort]    = expand(cohort);    \
+    table[locktag_tuned]     = expand(tuned);     \
+    table[locktag_combining] = expand(combining); \
+    table[locktag_rw]        = expand(rw);        \
+    fill_jumps(table, expand, _nested_);          \
 }
 #endif // KMP_USE_ADAPTIVE_LOCKS
 
@@ -3665,9 +5440,11 @@ __kmp_cleanup_indirect_user_locks()
         }
     }
     // Free the table
-    for (i = 0; i < __kmp_i_lock_table.size / KMP_I_LOCK_CHUNK; i++)
+    for (i = 0; i < KMP_I_LOCK_ROWS && i*KMP_I_LOCK_CHUNK < __kmp_i_lock_table.next; i++) {
         __kmp_free(__kmp_i_lock_table.table[i]);
-    __kmp_free(__kmp_i_lock_table.table);
+        __kmp_i_lock_table.table[i] = NULL;
+    }
+    __kmp_i_lock_table.next = 0;
 
     __kmp_init_user_locks = FALSE;
 }
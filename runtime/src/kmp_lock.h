@@ -252,6 +252,7 @@ struct kmp_base_ticket_lock {
     std::atomic_int       owner_id;       // (gtid+1) of owning thread, 0 if unlocked
     std::atomic_int       depth_locked;   // depth locked, for nested locks only
     kmp_lock_flags_t      flags;          // lock specifics, e.g. critical section lock
+    std::atomic_uint      parked;         // number of waiters asleep on now_serving (KMP_LOCK_PARK)
 };
 #else
 struct kmp_base_ticket_lock {
@@ -264,6 +265,7 @@ struct kmp_base_ticket_lock {
     std::atomic<int>      owner_id;       // (gtid+1) of owning thread, 0 if unlocked
     std::atomic<int>      depth_locked;   // depth locked, for nested locks only
     kmp_lock_flags_t      flags;          // lock specifics, e.g. critical section lock
+    std::atomic<unsigned> parked;         // number of waiters asleep on now_serving (KMP_LOCK_PARK)
 };
 #endif
 
@@ -310,6 +312,12 @@ extern int __kmp_release_nested_ticket_lock( kmp_ticket_lock_t *lck, kmp_int32 g
 extern void __kmp_init_nested_ticket_lock( kmp_ticket_lock_t *lck );
 extern void __kmp_destroy_nested_ticket_lock( kmp_ticket_lock_t *lck );
 
+#if KMP_USE_FUTEX
+// Spin-then-park (KMP_LOCK_PARK): ticket and queuing lock waiters sleep on a futex after
+// spinning for the blocktime.
+extern int __kmp_lock_park;
+#endif
+
 
 // ----------------------------------------------------------------------------
 // Queuing locks.
@@ -516,6 +524,214 @@ extern int __kmp_release_nested_drdpa_lock( kmp_drdpa_lock_t *lck, kmp_int32 gti
 extern void __kmp_init_nested_drdpa_lock( kmp_drdpa_lock_t *lck );
 extern void __kmp_destroy_nested_drdpa_lock( kmp_drdpa_lock_t *lck );
 
+#if KMP_USE_DYNAMIC_LOCK
+
+// ----------------------------------------------------------------------------
+// Cohort locks.
+// ----------------------------------------------------------------------------
+
+//
+// A cohort lock is a global ticket lock taken on behalf of a whole NUMA node
+// (package), plus one local ticket lock per node.  A thread first queues on
+// the lock of its node; the thread that releases the lock hands the global
+// lock over to the next waiter of its node, so that the protected data stays
+// in the caches of one node, until it has done so __kmp_cohort_lock_passes
+// times in a row or the node runs out of waiters.
+//
+#define KMP_COHORT_MAX_NODES 8
+
+struct KMP_ALIGN_CACHE kmp_cohort_node {
+    volatile kmp_uint32 next_ticket;    // local ticket lock of the node
+    volatile kmp_uint32 now_serving;
+    kmp_uint32          global_held;    // the node owns the global lock; only accessed under the local lock
+    kmp_uint32          passes;         // consecutive handovers within the node
+};
+
+struct kmp_base_cohort_lock {
+    KMP_ALIGN_CACHE
+
+    volatile union kmp_cohort_lock * initialized;   // points to the lock union if in initialized state
+    ident_t const *                  location;      // Source code location of omp_init_lock().
+    kmp_lock_flags_t                 flags;         // lock specifics, e.g. critical section lock
+
+    //
+    // The global ticket lock is written once per hand over between nodes.
+    //
+    KMP_ALIGN_CACHE
+
+    volatile kmp_uint32              global_next;
+    volatile kmp_uint32              global_serving;
+
+    KMP_ALIGN_CACHE
+
+    volatile kmp_int32               owner_id;      // (gtid+1) of owning thread, 0 if unlocked
+    kmp_int32                        depth_locked;  // -1 for simple locks
+    kmp_int32                        owner_node;    // node of the owning thread
+
+    struct kmp_cohort_node           nodes[ KMP_COHORT_MAX_NODES ];
+};
+
+typedef struct kmp_base_cohort_lock kmp_base_cohort_lock_t;
+
+union KMP_ALIGN_CACHE kmp_cohort_lock {
+    kmp_base_cohort_lock_t lk;      // This field must be first to allow static initializing. */
+    kmp_lock_pool_t pool;
+    double                 lk_align; // use worst case alignment
+    char                   lk_pad[ KMP_PAD( kmp_base_cohort_lock_t, CACHE_LINE ) ];
+};
+
+typedef union kmp_cohort_lock kmp_cohort_lock_t;
+
+extern int __kmp_cohort_lock_passes;    // max consecutive handovers within a node
+extern int __kmp_cohort_lock_nodes;     // nodes the threads are spread over, 0 - packages from the topology
+
+extern int __kmp_cohort_lock_spans_nodes();
+
+// ----------------------------------------------------------------------------
+// Tuned locks.
+// ----------------------------------------------------------------------------
+
+//
+// A tuned lock runs as a test and set lock while it is uncontended and
+// switches itself to a queuing lock (a cohort lock when the threads span
+// several NUMA nodes) when a window of acquisitions has waited often enough,
+// and back once the contention is gone.  The owner always holds the lock of
+// the current mode; it switches by taking the lock of the new mode before it
+// publishes the mode and drops the old one, so threads that queued on the old
+// lock find the mode changed, let go and retry.
+//
+enum kmp_tuned_lock_mode {
+    tuned_mode_tas = 0,
+    tuned_mode_queuing,
+    tuned_mode_cohort
+};
+
+struct kmp_base_tuned_lock {
+    volatile union kmp_tuned_lock * initialized;    // points to the lock union if in initialized state
+    ident_t const *                 location;       // Source code location of omp_init_lock().
+    kmp_lock_flags_t                flags;          // lock specifics, e.g. critical section lock
+    volatile kmp_uint32             mode;           // kmp_tuned_lock_mode the lock runs as
+    kmp_uint32                      owner_mode;     // mode the owner holds the lock in
+    kmp_uint32                      acquires;       // acquisitions in the current window, written by the owner
+    kmp_uint32                      contended;      // acquisitions of the window that had to wait
+    volatile kmp_int32              owner_id;       // (gtid+1) of owning thread, 0 if unlocked
+    kmp_int32                       depth_locked;   // -1 for simple locks
+    kmp_tas_lock_t                  tas;            // the lock while uncontended
+    kmp_queuing_lock_t * volatile   queuing;        // allocated at the first switch to a queuing mode
+    kmp_cohort_lock_t * volatile    cohort;
+};
+
+typedef struct kmp_base_tuned_lock kmp_base_tuned_lock_t;
+
+union kmp_tuned_lock {
+    kmp_base_tuned_lock_t lk;       // This field must be first to allow static initializing. */
+    kmp_lock_pool_t pool;
+    double                lk_align; // use worst case alignment
+};
+
+typedef union kmp_tuned_lock kmp_tuned_lock_t;
+
+// ----------------------------------------------------------------------------
+// Combining locks.
+// ----------------------------------------------------------------------------
+
+//
+// The lock of critical sections with kmp_lock_hint_combining.  Used as a lock
+// it is a test and set lock; __kmp_combine_critical instead publishes the
+// body of the critical section, and the thread that gets the lock runs the
+// published bodies of the waiting threads along with its own.
+//
+struct kmp_combining_request {
+    void                         (*body)( void * );
+    void *                         data;
+    struct kmp_combining_request * next;
+    volatile kmp_int32             done;
+};
+
+struct kmp_base_combining_lock {
+    KMP_ALIGN_CACHE
+
+    volatile union kmp_combining_lock * initialized;    // points to the lock union if in initialized state
+    ident_t const *                     location;       // Source code location of omp_init_lock().
+    kmp_lock_flags_t                    flags;          // lock specifics, e.g. critical section lock
+    volatile kmp_int32                  owner_id;       // (gtid+1) of owning thread, 0 if unlocked
+    kmp_int32                           depth_locked;   // -1 for simple locks
+
+    KMP_ALIGN_CACHE
+
+    kmp_tas_lock_t                      lock;           // held by the combiner
+
+    KMP_ALIGN_CACHE
+
+    struct kmp_combining_request * volatile requests;   // published bodies, latest first
+};
+
+typedef struct kmp_base_combining_lock kmp_base_combining_lock_t;
+
+union KMP_ALIGN_CACHE kmp_combining_lock {
+    kmp_base_combining_lock_t lk;       // This field must be first to allow static initializing. */
+    kmp_lock_pool_t pool;
+    double                    lk_align; // use worst case alignment
+    char                      lk_pad[ KMP_PAD( kmp_base_combining_lock_t, CACHE_LINE ) ];
+};
+
+typedef union kmp_combining_lock kmp_combining_lock_t;
+
+extern void __kmp_combine_critical( kmp_combining_lock_t *lck, kmp_int32 gtid, void (*body)( void * ),
+                                    void *data );
+
+// ----------------------------------------------------------------------------
+// Reader-writer locks.
+// ----------------------------------------------------------------------------
+
+//
+// The lock behind the kmp_rw_lock_* API.  A reader announces itself in one of
+// KMP_RW_LOCK_SLOTS counters picked by its gtid, each on a cache line of its
+// own, so that readers on different threads do not write the same line.  A
+// writer serializes with the other writers on a queuing lock, raises the
+// writer flag and waits for every counter to drain; readers that see the
+// flag back out and wait until it drops, so a stream of readers cannot starve
+// the writers.  The generic set/test/unset lock operations take the lock for
+// writing.
+//
+#define KMP_RW_LOCK_SLOTS 16
+
+struct KMP_ALIGN_CACHE kmp_rw_lock_slot {
+    volatile kmp_int32 readers;     // readers of the slot inside the lock or about to back out
+};
+
+struct kmp_base_rwlock {
+    KMP_ALIGN_CACHE
+
+    volatile union kmp_rwlock *     initialized;    // points to the lock union if in initialized state
+    ident_t const *                 location;       // Source code location of omp_init_lock().
+    kmp_lock_flags_t                flags;          // lock specifics, e.g. critical section lock
+    volatile kmp_int32              owner_id;       // (gtid+1) of the writer, 0 if not held for writing
+    kmp_int32                       depth_locked;   // -1 for simple locks
+    volatile kmp_int32              writer;         // a writer holds or waits for the lock
+
+    kmp_queuing_lock_t              writers;        // serializes the writers
+
+    struct kmp_rw_lock_slot         slots[ KMP_RW_LOCK_SLOTS ];
+};
+
+typedef struct kmp_base_rwlock kmp_base_rwlock_t;
+
+union KMP_ALIGN_CACHE kmp_rwlock {
+    kmp_base_rwlock_t lk;           // This field must be first to allow static initializing. */
+    kmp_lock_pool_t pool;
+    double            lk_align;     // use worst case alignment
+    char              lk_pad[ KMP_PAD( kmp_base_rwlock_t, CACHE_LINE ) ];
+};
+
+// kmp_rw_lock_t is the user type of omp.h
+typedef union kmp_rwlock kmp_rwlock_t;
+
+extern int __kmp_acquire_rw_lock_read( kmp_rwlock_t *lck, kmp_int32 gtid );
+extern int __kmp_test_rw_lock_read( kmp_rwlock_t *lck, kmp_int32 gtid );
+
+#endif // KMP_USE_DYNAMIC_LOCK
+
 
 // ============================================================================
 // Lock purposes.
@@ -633,6 +849,10 @@ enum kmp_lock_kind {
 #if KMP_USE_DYNAMIC_LOCK && KMP_USE_TSX
     lk_hle,
     lk_rtm,
+#endif
+#if KMP_USE_DYNAMIC_LOCK
+    lk_cohort,
+    lk_tuned,
 #endif
     lk_ticket,
     lk_queuing,
@@ -1093,7 +1313,7 @@ extern void __kmp_cleanup_user_locks();
 // allocated from heap. Depending on the size of the compiler-generated space for the lock (i.e.,
 // size of omp_lock_t), this omp_lock_t object stores either the address of the heap-allocated
 // indirect lock (void * fits in the object) or an index to the indirect lock table entry that
-// holds the address. Ticket/Queuing/DRDPA/Adaptive lock falls into this category, and the newly
+// holds the address. Ticket/Queuing/DRDPA/Adaptive/Cohort/Tuned/Combining/RW lock falls into this category, and the newly
 // introduced "rtm" lock is also an indirect lock which was implemented on top of the Queuing lock.
 // When the omp_lock_t object holds an index (not lock address), 0 is written to LSB to
 // differentiate the lock from a direct lock, and the remaining part is the actual index to the
@@ -1113,11 +1333,13 @@ extern void __kmp_cleanup_user_locks();
 # if KMP_USE_FUTEX
 #  define KMP_FOREACH_D_LOCK(m, a)  m(tas, a) m(futex, a) m(hle, a)
 #  define KMP_FOREACH_I_LOCK(m, a)  m(ticket, a) m(queuing, a) m(adaptive, a) m(drdpa, a) m(rtm, a) \
+                                    m(cohort, a) m(tuned, a) m(combining, a) m(rw, a)               \
                                     m(nested_tas, a) m(nested_futex, a) m(nested_ticket, a)         \
                                     m(nested_queuing, a) m(nested_drdpa, a)
 # else
 #  define KMP_FOREACH_D_LOCK(m, a)  m(tas, a)             m(hle, a)
 #  define KMP_FOREACH_I_LOCK(m, a)  m(ticket, a) m(queuing, a) m(adaptive, a) m(drdpa, a) m(rtm, a) \
+                                    m(cohort, a) m(tuned, a) m(combining, a) m(rw, a)               \
                                     m(nested_tas, a)                    m(nested_ticket, a)         \
                                     m(nested_queuing, a) m(nested_drdpa, a)
 # endif // KMP_USE_FUTEX
@@ -1126,12 +1348,14 @@ extern void __kmp_cleanup_user_locks();
 # if KMP_USE_FUTEX
 #  define KMP_FOREACH_D_LOCK(m, a)  m(tas, a) m(futex, a)
 #  define KMP_FOREACH_I_LOCK(m, a)  m(ticket, a) m(queuing, a)                m(drdpa, a)           \
+                                    m(cohort, a) m(tuned, a) m(combining, a) m(rw, a)               \
                                     m(nested_tas, a) m(nested_futex, a) m(nested_ticket, a)         \
                                     m(nested_queuing, a) m(nested_drdpa, a)
 #  define KMP_LAST_D_LOCK lockseq_futex
 # else
 #  define KMP_FOREACH_D_LOCK(m, a)  m(tas, a)
 #  define KMP_FOREACH_I_LOCK(m, a)  m(ticket, a) m(queuing, a)                m(drdpa, a)           \
+                                    m(cohort, a) m(tuned, a) m(combining, a) m(rw, a)               \
                                     m(nested_tas, a)                    m(nested_ticket, a)         \
                                     m(nested_queuing, a) m(nested_drdpa, a)
 #  define KMP_LAST_D_LOCK lockseq_tas
@@ -1237,6 +1461,28 @@ extern void __kmp_cleanup_indirect_user_locks();
 // Default user lock sequence when not using hinted locks.
 extern kmp_dyna_lockseq_t __kmp_user_lock_seq;
 
+// Lock profile (KMP_LOCK_PROFILE): the lock jump tables record acquisitions, waits and hold times
+// per lock, reported at exit or with __kmpc_lock_profile_report().
+extern int __kmp_lock_profile;
+
+#define KMP_LOCK_PROFILE_HELD 4     // locks a thread times the hold of at once
+
+// A lock the thread acquired through the profiled tables and when.
+typedef struct kmp_lock_profile_held {
+    void       *lock;
+    kmp_uint64  acquired_at;
+} kmp_lock_profile_held_t;
+
+#if KMP_USE_TSX
+// Speculative critical sections (KMP_CRITICAL_SPECULATION): critical sections without a hint use an
+// rtm lock; whether to speculate is learned per construct.
+extern int __kmp_critical_speculation;
+extern int __kmp_critical_speculation_stats;
+
+extern void __kmp_acquire_critical_speculative( kmp_queuing_lock_t *lck, ident_t const *loc, kmp_int32 gtid );
+extern int __kmp_release_critical_speculative( kmp_queuing_lock_t *lck, kmp_int32 gtid );
+#endif
+
 // Jump table for "set lock location", available only for indirect locks.
 extern void (*__kmp_indirect_set_location[KMP_NUM_I_LOCKS])(kmp_user_lock_p, const ident_t *);
 #define KMP_SET_I_LOCK_LOCATION(lck, loc) {                         \
@@ -1264,18 +1510,23 @@ extern kmp_lock_flags_t (*__kmp_indirect_get_flags[KMP_NUM_I_LOCKS])(kmp_user_lo
                                    : NULL )
 
 #define KMP_I_LOCK_CHUNK 1024       // number of kmp_indirect_lock_t objects to be allocated together
+#define KMP_I_LOCK_ROWS  65536      // max number of chunks in the indirect lock table
+#define KMP_I_LOCK_BATCH 64         // number of table entries a thread reserves at once
+#define KMP_I_LOCK_POOL_MAX 1024    // max number of destroyed locks of a type a thread keeps
 
 // Lock table for indirect locks.
+// The chunks never move once allocated, so readers index the table without synchronization while
+// threads grow it: each thread reserves a batch of entries by bumping "next", and the thread that
+// first reaches a chunk publishes it with a compare-and-store.
 typedef struct kmp_indirect_lock_table {
-    kmp_indirect_lock_t **table;    // blocks of indirect locks allocated
-    kmp_lock_index_t size;          // size of the indirect lock table
-    kmp_lock_index_t next;          // index to the next lock to be allocated
+    kmp_indirect_lock_t *table[KMP_I_LOCK_ROWS]; // blocks of indirect locks allocated
+    volatile kmp_lock_index_t next;              // index to the next batch of locks to be reserved
 } kmp_indirect_lock_table_t;
 
 extern kmp_indirect_lock_table_t __kmp_i_lock_table;
 
 // Returns the indirect lock associated with the given index.
-#define KMP_GET_I_LOCK(index) (*(__kmp_i_lock_table.table + (index)/KMP_I_LOCK_CHUNK) + (index)%KMP_I_LOCK_CHUNK)
+#define KMP_GET_I_LOCK(index) (__kmp_i_lock_table.table[(index)/KMP_I_LOCK_CHUNK] + (index)%KMP_I_LOCK_CHUNK)
 
 // Number of locks in a lock block, which is fixed to "1" now.
 // TODO: No lock block implementation now. If we do support, we need to manage lock block data
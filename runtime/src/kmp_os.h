@@ -546,6 +546,27 @@ extern kmp_real64 __kmp_xchg_real64( volatile kmp_real64 *p, kmp_real64 v );
 
 #endif /* KMP_ASM_INTRINS */
 
+/* 16-byte compare-and-store of two adjacent 8-byte words; p must be 16-byte aligned.
+   Only usable if the processor supports cmpxchg16b (__kmp_cpuinfo.cx16). */
+#if KMP_ARCH_X86_64 && KMP_OS_UNIX
+# define KMP_HAVE_CAS128 1
+static inline int
+__kmp_compare_and_store128( volatile kmp_int64 *p, kmp_int64 cv_lo, kmp_int64 cv_hi,
+                            kmp_int64 sv_lo, kmp_int64 sv_hi )
+{
+    unsigned char res;
+    __asm__ __volatile__( "lock; cmpxchg16b %1; sete %0"
+                          : "=q"( res ), "+m"( *(volatile kmp_int64 (*)[2])p ), "+a"( cv_lo ), "+d"( cv_hi )
+                          : "b"( sv_lo ), "c"( sv_hi )
+                          : "memory", "cc" );
+    return res;
+}
+# define KMP_COMPARE_AND_STORE_ACQ128(p, cv_lo, cv_hi, sv_lo, sv_hi) \
+    __kmp_compare_and_store128( (p), (cv_lo), (cv_hi), (sv_lo), (sv_hi) )
+#else
+# define KMP_HAVE_CAS128 0
+#endif
+
 
 /* ------------- relaxed consistency memory model stuff ------------------ */
 
@@ -95,6 +95,7 @@ static int __kmp_unregister_root_other_thread( int gtid );
 #endif
 static void __kmp_unregister_library( void ); // called by __kmp_internal_end()
 static void __kmp_reap_thread( kmp_info_t * thread, int is_root );
+static void __kmp_park_thread( kmp_info_t *this_th );
 static kmp_info_t *__kmp_thread_pool_insert_pt = NULL;
 
 /* ------------------------------------------------------------------------ */
@@ -828,6 +829,44 @@ __kmp_exit_single( int gtid )
         __kmp_pop_workshare( gtid, ct_psingle, NULL );
 }
 
+/*
+ * Workers of a nested team stay attached to the team while it is parked in the team pool (see
+ * __kmp_free_team).  Like the threads in the thread pool they are idle and do not count in
+ * __kmp_nth; they go back to the thread pool when the team is reaped, or when the thread limit
+ * does not allow new threads for other teams.
+ * The forkjoin lock is held by the caller.
+ */
+static void
+__kmp_release_team_pool_threads( kmp_team_t *team )
+{
+    int f;
+
+    for ( f = 1; f < team->t.t_pool_nth; ++ f ) {
+        KMP_DEBUG_ASSERT( team->t.t_threads[ f ] );
+        TCW_4(__kmp_nth, __kmp_nth + 1); // __kmp_free_thread() takes it out again
+        __kmp_free_thread( team->t.t_threads[ f ] );
+        team->t.t_threads[ f ] = NULL;
+    }
+    if ( team->t.t_pool_nth > 0 ) {
+        __kmp_team_pool_nth -= team->t.t_pool_nth - 1;
+        team->t.t_pool_nth = 0;
+    }
+}
+
+/* Releases the workers kept by parked teams until at least nth of them are back in the thread pool */
+static void
+__kmp_release_team_pool_threads_nth( int nth )
+{
+    kmp_team_t *team;
+    int released = 0;
+
+    for ( team = (kmp_team_t *) __kmp_team_pool; team != NULL && released < nth; team = team->t.t_next_pool ) {
+        if ( team->t.t_pool_nth > 1 ) {
+            released += team->t.t_pool_nth - 1;
+            __kmp_release_team_pool_threads( team );
+        }
+    }
+}
 
 /*
  * determine if we can go parallel or must use a serialized parallel region and
@@ -1070,10 +1109,20 @@ __kmp_fork_team_threads( kmp_root_t *root, kmp_team_t *team,
 
         /* now, install the worker threads */
         for ( i=1 ;  i < team->t.t_nproc ; i++ ) {
-
-            /* fork or reallocate a new thread and install it in team */
-            kmp_info_t *thr = __kmp_allocate_thread( root, team, i );
-            team->t.t_threads[ i ] = thr;
+            kmp_info_t *thr;
+
+            if ( i < team->t.t_pool_nth ) {
+                /* the team kept this worker while it was in the team pool, set it up again */
+                thr = team->t.t_threads[ i ];
+                __kmp_initialize_info( thr, team, i, thr->th.th_info.ds.ds_gtid );
+                thr->th.th_task_state = 0;
+                thr->th.th_task_state_top = 0;
+                thr->th.th_task_state_stack_sz = 4;
+            } else {
+                /* fork or reallocate a new thread and install it in team */
+                thr = __kmp_allocate_thread( root, team, i );
+                team->t.t_threads[ i ] = thr;
+            }
             KMP_DEBUG_ASSERT( thr );
             KMP_DEBUG_ASSERT( thr->th.th_team == team );
             /* align team and thread arrived states */
@@ -1100,6 +1149,8 @@ __kmp_fork_team_threads( kmp_root_t *root, kmp_team_t *team,
             }
         }
 
+        team->t.t_pool_nth = 0;
+
 #if OMP_40_ENABLED && KMP_AFFINITY_SUPPORTED
         __kmp_partition_places( team );
 #endif
@@ -2753,6 +2804,7 @@ __kmp_get_schedule( int gtid, kmp_sched_t * kind, int * chunk )
     case kmp_sch_static:
     case kmp_sch_static_greedy:
     case kmp_sch_static_balanced:
+    case kmp_sch_static_aligned:
         *kind = kmp_sched_static;
         *chunk = 0;   // chunk was not set, try to show this fact via zero value
         return;
@@ -2760,11 +2812,14 @@ __kmp_get_schedule( int gtid, kmp_sched_t * kind, int * chunk )
         *kind = kmp_sched_static;
         break;
     case kmp_sch_dynamic_chunked:
+    case kmp_sch_hier_dynamic_chunked:
+    case kmp_sch_sticky_dynamic_chunked:
         *kind = kmp_sched_dynamic;
         break;
     case kmp_sch_guided_chunked:
     case kmp_sch_guided_iterative_chunked:
     case kmp_sch_guided_analytical_chunked:
+    case kmp_sch_hier_guided_chunked:
         *kind = kmp_sched_guided;
         break;
     case kmp_sch_auto:
@@ -2992,6 +3047,24 @@ __kmp_allocate_team_arrays(kmp_team_t *team, int max_nth)
     }
 }
 
+static void
+__kmp_free_team_disp_buffer(kmp_team_t *team)
+{
+    int i;
+    int num_disp_buff = team->t.t_max_nproc > 1 ? __kmp_dispatch_num_buffers : 2;
+    /* per-domain counters of the hierarchical schedules and the chunk owners of the ordered
+       loops live as long as the buffers */
+    for ( i = 0; i < num_disp_buff; ++ i ) {
+        if ( team->t.t_disp_buffer[ i ].hier_domains != NULL ) {
+            __kmp_free( team->t.t_disp_buffer[ i ].hier_domains );
+        }
+        if ( team->t.t_disp_buffer[ i ].ordered_owners != NULL ) {
+            __kmp_free( team->t.t_disp_buffer[ i ].ordered_owners );
+        }
+    }
+    __kmp_free(team->t.t_disp_buffer);
+}
+
 static void
 __kmp_free_team_arrays(kmp_team_t *team) {
     /* Note: this does not free the threads in t_threads (__kmp_free_threads) */
@@ -3003,7 +3076,7 @@ __kmp_free_team_arrays(kmp_team_t *team) {
         }; // if
     }; // for
     __kmp_free(team->t.t_threads);
-    __kmp_free(team->t.t_disp_buffer);
+    __kmp_free_team_disp_buffer(team);
     __kmp_free(team->t.t_dispatch);
     __kmp_free(team->t.t_implicit_task_taskdata);
     team->t.t_threads     = NULL;
@@ -3016,7 +3089,7 @@ static void
 __kmp_reallocate_team_arrays(kmp_team_t *team, int max_nth) {
     kmp_info_t **oldThreads = team->t.t_threads;
 
-    __kmp_free(team->t.t_disp_buffer);
+    __kmp_free_team_disp_buffer(team);
     __kmp_free(team->t.t_dispatch);
     __kmp_free(team->t.t_implicit_task_taskdata);
     __kmp_allocate_team_arrays(team, max_nth);
@@ -4129,6 +4202,12 @@ __kmp_allocate_thread( kmp_root_t *root, kmp_team_t *team, int new_tid )
 #endif
     KMP_MB();
 
+    /* idle threads kept by parked teams come before new threads beyond the limits */
+    if ( __kmp_thread_pool == NULL && __kmp_team_pool_nth > 0 &&
+         ( __kmp_all_nth >= __kmp_max_nth || __kmp_all_nth + 1 >= __kmp_threads_capacity ) ) {
+        __kmp_release_team_pool_threads_nth( 1 );
+    }
+
     /* first, try to get one from the thread pool */
     if ( __kmp_thread_pool ) {
 
@@ -4187,7 +4266,7 @@ __kmp_allocate_thread( kmp_root_t *root, kmp_team_t *team, int new_tid )
 
 
     /* no, well fork a new one */
-    KMP_ASSERT( __kmp_nth    == __kmp_all_nth );
+    KMP_ASSERT( __kmp_nth + __kmp_team_pool_nth == __kmp_all_nth );
     KMP_ASSERT( __kmp_all_nth < __kmp_threads_capacity );
 
 #if KMP_USE_MONITOR
@@ -5101,13 +5180,50 @@ __kmp_allocate_team( kmp_root_t *root, int new_nproc, int max_nproc,
     }
 
     /* next, let's try to take one from the team pool */
+    /* Parked teams keep their arrays (thread slots, dispatch buffers, implicit tasks) and their
+       workers, so prefer the team that the same master last ran under the same parent at the same
+       level with the same size; it is usually the one this parallel region ran on before, and its
+       workers are taken back as they are.  Otherwise take the smallest team that is large enough
+       among those that kept no workers.  Other teams stay parked for later requests. */
     KMP_MB();
-    for( team = (kmp_team_t*) __kmp_team_pool ; (team) ; )
     {
-        /* TODO: consider resizing undersized teams instead of reaping them, now that we have a resizing mechanism */
-        if ( team->t.t_max_nproc >= max_nproc ) {
+        kmp_info_t *this_thr;
+        kmp_team_t *parent = NULL;
+        kmp_team_t **prev, **best_prev = NULL;
+#if KMP_NESTED_HOT_TEAMS
+        this_thr = master;
+#else
+        {
+            int gtid = __kmp_get_gtid();
+            this_thr = ( gtid >= 0 ) ? __kmp_threads[ gtid ] : NULL;
+        }
+#endif
+        if ( this_thr != NULL )
+            parent = this_thr->th.th_team;
+        for( prev = (kmp_team_t **) &__kmp_team_pool ; (team = *prev) != NULL ; prev = &team->t.t_next_pool ) {
+            if ( team->t.t_max_nproc < max_nproc )
+                continue;
+            if ( parent != NULL && team->t.t_pool_master == this_thr && team->t.t_pool_parent == parent &&
+                 team->t.t_pool_level == parent->t.t_level + 1 && team->t.t_nproc == new_nproc ) {
+                best_prev = prev;
+                break;
+            }
+            if ( team->t.t_pool_nth > 0 )
+                continue; // keeps its workers for its own region
+            if ( best_prev == NULL || team->t.t_max_nproc < (*best_prev)->t.t_max_nproc )
+                best_prev = prev;
+        }
+        team = ( best_prev != NULL ) ? *best_prev : NULL;
+        if ( team != NULL ) {
             /* take this team from the team pool */
-            __kmp_team_pool = team->t.t_next_pool;
+            *best_prev = team->t.t_next_pool;
+            team->t.t_next_pool = NULL;
+            --__kmp_team_pool_nteams;
+            if ( team->t.t_pool_nth > 0 ) {
+                /* __kmp_fork_team_threads() installs the kept workers again */
+                __kmp_team_pool_nth -= team->t.t_pool_nth - 1;
+                TCW_4(__kmp_nth, __kmp_nth + team->t.t_pool_nth - 1);
+            }
 
             /* setup the team for fresh use */
             __kmp_initialize_team( team, new_nproc, new_icvs, NULL );
@@ -5148,12 +5264,6 @@ __kmp_allocate_team( kmp_root_t *root, int new_nproc, int max_nproc,
 
             return team;
         }
-
-        /* reap team if it is too small, then loop back and check the next one */
-        /* not sure if this is wise, but, will be redone during the hot-teams rewrite. */
-        /* TODO: Use technique to find the right size hot-team, don't reap them */
-        team =  __kmp_reap_team( team );
-        __kmp_team_pool = team;
     }
 
     /* nothing available in the pool, no matter, make a new team! */
@@ -5277,22 +5387,48 @@ __kmp_free_team( kmp_root_t *root, kmp_team_t *team  USE_NESTED_HOT_ARG(kmp_info
             }
         }
 
-        // Reset pointer to parent team only for non-hot teams.
+        // Remember where the team ran so __kmp_allocate_team() can hand it back to the same
+        // parallel region, then reset pointer to parent team only for non-hot teams.
+        team->t.t_pool_parent = team->t.t_parent;
+        team->t.t_pool_level = team->t.t_level;
+        team->t.t_pool_master = team->t.t_threads[ 0 ];
         team->t.t_parent = NULL;
         team->t.t_level = 0;
         team->t.t_active_level = 0;
 
-        /* free the worker threads */
-        for ( f = 1; f < team->t.t_nproc; ++ f ) {
-            KMP_DEBUG_ASSERT( team->t.t_threads[ f ] );
-            __kmp_free_thread( team->t.t_threads[ f ] );
-            team->t.t_threads[ f ] = NULL;
+        if ( root->r.r_active && ! __kmp_global.g.g_dynamic ) {
+            /* a nested team keeps its workers asleep in the fork barrier, so that the next fork of
+               the region takes them back without going through the thread pool; with dyn-var set
+               they go back to the pool where the load balancing sees them as idle */
+            for ( f = 1; f < team->t.t_nproc; ++ f ) {
+                KMP_DEBUG_ASSERT( team->t.t_threads[ f ] );
+                __kmp_park_thread( team->t.t_threads[ f ] );
+            }
+            team->t.t_pool_nth = team->t.t_nproc;
+            __kmp_team_pool_nth += team->t.t_nproc - 1;
+            TCW_4(__kmp_nth, __kmp_nth - ( team->t.t_nproc - 1 ));
+        } else {
+            /* free the worker threads */
+            for ( f = 1; f < team->t.t_nproc; ++ f ) {
+                KMP_DEBUG_ASSERT( team->t.t_threads[ f ] );
+                __kmp_free_thread( team->t.t_threads[ f ] );
+                team->t.t_threads[ f ] = NULL;
+            }
         }
 
         /* put the team back in the team pool */
-        /* TODO limit size of team pool, call reap_team if pool too large */
         team->t.t_next_pool  = (kmp_team_t*) __kmp_team_pool;
         __kmp_team_pool        = (volatile kmp_team_t*) team;
+        if ( ++__kmp_team_pool_nteams > KMP_MAX_TEAM_POOL ) {
+            /* the pool is kept in LIFO order: reap the least recently parked team */
+            kmp_team_t **prev = (kmp_team_t **) &__kmp_team_pool;
+            while ( (*prev)->t.t_next_pool != NULL )
+                prev = &(*prev)->t.t_next_pool;
+            __kmp_release_team_pool_threads( *prev );
+            __kmp_reap_team( *prev );
+            *prev = NULL;
+            --__kmp_team_pool_nteams;
+        }
     }
 
     KMP_MB();
@@ -5324,6 +5460,25 @@ __kmp_reap_team( kmp_team_t *team )
     return next_pool;
 }
 
+//
+// Take the thread out of its team's barriers: it waits on its own b_go flag and
+// rebuilds the barrier hierarchy of the next team it joins.
+//
+static void
+__kmp_park_thread( kmp_info_t *this_th )
+{
+    // switch thread to wait on own b_go flag, and uninitialized (NULL team).
+    int b;
+    kmp_balign_t *balign = this_th->th.th_bar;
+    for (b=0; b<bs_last_barrier; ++b) {
+        if (balign[b].bb.wait_flag == KMP_BARRIER_PARENT_FLAG)
+            balign[b].bb.wait_flag = KMP_BARRIER_SWITCH_TO_OWN_FLAG;
+        balign[b].bb.team = NULL;
+        balign[b].bb.leaf_kids = 0;
+    }
+    this_th->th.th_task_state = 0;
+}
+
 //
 // Free the thread.  Don't reap it, just place it on the pool of available
 // threads.
@@ -5362,16 +5517,7 @@ __kmp_free_thread( kmp_info_t *this_th )
 
     KMP_DEBUG_ASSERT( this_th );
 
-    // When moving thread to pool, switch thread to wait on own b_go flag, and uninitialized (NULL team).
-    int b;
-    kmp_balign_t *balign = this_th->th.th_bar;
-    for (b=0; b<bs_last_barrier; ++b) {
-        if (balign[b].bb.wait_flag == KMP_BARRIER_PARENT_FLAG)
-            balign[b].bb.wait_flag = KMP_BARRIER_SWITCH_TO_OWN_FLAG;
-        balign[b].bb.team = NULL;
-        balign[b].bb.leaf_kids = 0;
-    }
-    this_th->th.th_task_state = 0;
+    __kmp_park_thread( this_th );
 
     /* put thread back on the free pool */
     TCW_PTR(this_th->th.th_team, NULL);
@@ -5716,6 +5862,10 @@ __kmp_reap_thread(
 
     __kmp_free_implicit_task(thread);
 
+#if KMP_USE_DYNAMIC_LOCK
+    __kmp_reap_indirect_locks(thread);
+#endif
+
     // Free the fast memory for tasking
     #if USE_FAST_MEMORY
         __kmp_free_fast_memory( thread );
@@ -5841,6 +5991,10 @@ __kmp_internal_end(void)
 
         KMP_MB();
 
+        // Workers kept by parked teams go back to the thread pool first.
+        for ( kmp_team_t *team = (kmp_team_t *) __kmp_team_pool; team != NULL; team = team->t.t_next_pool )
+            __kmp_release_team_pool_threads( team );
+
         // Reap the worker threads.
         // This is valid for now, but be careful if threads are reaped sooner.
         while ( __kmp_thread_pool != NULL ) {    // Loop thru all the thread in the pool.
@@ -5863,6 +6017,8 @@ __kmp_internal_end(void)
             team->t.t_next_pool = NULL;
             __kmp_reap_team( team );
         }; // while
+        __kmp_team_pool_nteams = 0;
+        __kmp_team_pool_nth = 0;
 
         __kmp_reap_task_teams( );
 
@@ -6349,18 +6505,9 @@ __kmp_do_serial_initialize( void )
     __kmp_init_queuing_lock( & __kmp_dispatch_lock );
     __kmp_init_lock( & __kmp_debug_lock      );
     __kmp_init_atomic_lock( & __kmp_atomic_lock     );
-    __kmp_init_atomic_lock( & __kmp_atomic_lock_1i  );
-    __kmp_init_atomic_lock( & __kmp_atomic_lock_2i  );
-    __kmp_init_atomic_lock( & __kmp_atomic_lock_4i  );
-    __kmp_init_atomic_lock( & __kmp_atomic_lock_4r  );
-    __kmp_init_atomic_lock( & __kmp_atomic_lock_8i  );
-    __kmp_init_atomic_lock( & __kmp_atomic_lock_8r  );
-    __kmp_init_atomic_lock( & __kmp_atomic_lock_8c  );
-    __kmp_init_atomic_lock( & __kmp_atomic_lock_10r );
-    __kmp_init_atomic_lock( & __kmp_atomic_lock_16r );
-    __kmp_init_atomic_lock( & __kmp_atomic_lock_16c );
-    __kmp_init_atomic_lock( & __kmp_atomic_lock_20c );
-    __kmp_init_atomic_lock( & __kmp_atomic_lock_32c );
+    for ( i = 0; i < KMP_ATOMIC_LOCK_TABLE_SIZE; ++ i ) {
+        __kmp_init_atomic_lock( & __kmp_atomic_lock_table[ i ] );
+    }
     __kmp_init_bootstrap_lock( & __kmp_forkjoin_lock  );
     __kmp_init_bootstrap_lock( & __kmp_exit_lock      );
 #if KMP_USE_MONITOR
@@ -6490,6 +6637,8 @@ __kmp_do_serial_initialize( void )
     __kmp_thread_pool = NULL;
     __kmp_thread_pool_insert_pt = NULL;
     __kmp_team_pool   = NULL;
+    __kmp_team_pool_nteams = 0;
+    __kmp_team_pool_nth = 0;
 
     /* Allocate all of the variable sized records */
     /* NOTE: __kmp_threads_capacity entries are allocated, but the arrays are expandable */
@@ -6898,6 +7047,9 @@ __kmp_teams_master( int gtid )
     kmp_team_t *team = thr->th.th_team;
     ident_t     *loc =  team->t.t_ident;
     thr->th.th_set_nproc = thr->th.th_teams_size.nth;
+    // the team starts its distribute loops on the block counters of the league
+    thr->th.th_dist_league = team->t.t_threads[ 0 ]->th.th_dist_league;
+    thr->th.th_dist_loops = 0;
     KMP_DEBUG_ASSERT( thr->th.th_teams_microtask );
     KMP_DEBUG_ASSERT( thr->th.th_set_nproc );
     KA_TRACE( 20, ("__kmp_teams_master: T#%d, Tid %d, microtask %p\n",
@@ -7281,6 +7433,12 @@ __kmp_cleanup( void )
     __kmp_threads_capacity = 0;
 
 #if KMP_USE_DYNAMIC_LOCK
+    if ( __kmp_lock_profile )
+        __kmp_lock_profile_print( stderr );
+#if KMP_USE_TSX
+    if ( __kmp_critical_speculation_stats )
+        __kmp_critical_speculation_print( stderr );
+#endif
     __kmp_cleanup_indirect_user_locks();
 #else
     __kmp_cleanup_user_locks();
@@ -7296,6 +7454,8 @@ __kmp_cleanup( void )
        __kmp_print_speculative_stats();
    #endif
    #endif
+    if ( __kmp_loop_stats )
+        __kmp_dispatch_loop_stats_print( stderr );
     KMP_INTERNAL_FREE( __kmp_nested_nth.nth );
     __kmp_nested_nth.nth = NULL;
     __kmp_nested_nth.size = 0;
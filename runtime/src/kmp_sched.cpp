@@ -70,6 +70,30 @@ struct i_maxmin< unsigned long long > {
 //-------------------------------------------------------------------------
 #endif
 
+// Start of the part of thread tid (in iterations) under kmp_sch_static_aligned: the balanced
+// boundary moved to the nearest iteration offset + k * align, so that the parts of adjacent
+// threads do not share the cache lines or vectors of the data indexed by the loop variable.
+// Also used by the dispatcher when the schedule comes from OMP_SCHEDULE or KMP_SCHEDULE.
+kmp_uint64
+__kmp_static_aligned_bound( kmp_uint64 trip_count, kmp_uint32 nth, kmp_uint32 tid, kmp_uint64 align,
+                            kmp_uint64 offset )
+{
+    kmp_uint64 bound, r;
+
+    if ( tid == 0 )
+        return 0;
+    if ( tid >= nth )
+        return trip_count;
+    bound = ( trip_count / nth ) * tid + ( tid < trip_count % nth ? tid : trip_count % nth );
+    if ( bound < offset ) {
+        bound = ( bound < offset - bound ) ? 0 : offset;
+    } else {
+        r = ( bound - offset ) % align;
+        bound = bound - r + ( r >= align - r ? align : 0 );
+    }
+    return bound < trip_count ? bound : trip_count;
+}
+
 template< typename T >
 static void
 __kmp_for_static_init(
@@ -259,6 +283,12 @@ __kmp_for_static_init(
     }
     KMP_COUNT_VALUE (FOR_static_iterations, trip_count);
 
+    if ( schedtype == kmp_sch_static && __kmp_static == kmp_sch_static_aligned ) {
+        // KMP_SCHEDULE=static,aligned: the loop gives no alignment
+        schedtype = kmp_sch_static_aligned;
+        chunk = KMP_DEFAULT_STATIC_ALIGN;
+    }
+
     /* compute remaining parameters */
     switch ( schedtype ) {
     case kmp_sch_static:
@@ -325,6 +355,36 @@ __kmp_for_static_init(
                 *plastiter = (tid == ((trip_count - 1)/( UT )chunk) % nth);
             break;
         }
+    case kmp_sch_static_aligned:
+        {
+            // chunk is the alignment in iterations, e.g. a cache line or vector of elements
+            register UT align = chunk < 1 ? 1 : chunk;
+            register UT offset = 0;
+            register UT start, end;
+
+            if ( incr == 1 || incr == -1 ) {
+                // first iteration whose index (plus one for decreasing loops) is a multiple of align
+                register ST rem = (ST)( ( incr == 1 ? *plower : *plower + 1 ) % (ST)align );
+                if ( rem < 0 )
+                    rem += align;
+                if ( incr == 1 )
+                    offset = rem ? align - rem : 0;
+                else
+                    offset = rem;
+            }
+            start = (UT)__kmp_static_aligned_bound( trip_count, nth, tid, align, offset );
+            end = (UT)__kmp_static_aligned_bound( trip_count, nth, tid + 1, align, offset );
+            if ( start < end ) {
+                *pupper = *plower + ( end - 1 ) * incr;
+                *plower = *plower + start * incr;
+            } else {
+                *plower = *pupper + incr;
+            }
+            if( plastiter != NULL )
+                *plastiter = ( start < end && end == trip_count );
+            *pstride = trip_count;
+            break;
+        }
 #if OMP_45_ENABLED
     case kmp_sch_static_balanced_chunked:
         {
@@ -363,7 +423,7 @@ __kmp_for_static_init(
     {
         kmp_uint64 cur_chunk = chunk;
         // Calculate chunk in case it was not specified; it is specified for kmp_sch_static_chunked
-        if ( schedtype == kmp_sch_static ) {
+        if ( schedtype == kmp_sch_static || schedtype == kmp_sch_static_aligned ) {
             cur_chunk = trip_count / nth + ( ( trip_count % nth ) ? 1 : 0);
         }
         // 0 - "static" schedule
@@ -481,7 +541,8 @@ __kmp_dist_for_static_init(
     if( trip_count <= nteams ) {
         KMP_DEBUG_ASSERT(
             __kmp_static == kmp_sch_static_greedy || \
-            __kmp_static == kmp_sch_static_balanced
+            __kmp_static == kmp_sch_static_balanced || \
+            __kmp_static == kmp_sch_static_aligned
         ); // Unknown static scheduling type.
         // only masters of some teams get single iteration, other threads get nothing
         if( team_id < trip_count && tid == 0 ) {
@@ -493,8 +554,9 @@ __kmp_dist_for_static_init(
         if( plastiter != NULL )
             *plastiter = ( tid == 0 && team_id == trip_count - 1 );
     } else {
-        // Get the team's chunk first (each team gets at most one chunk)
-        if( __kmp_static == kmp_sch_static_balanced ) {
+        // Get the team's chunk first (each team gets at most one chunk); static,aligned
+        // splits a distribute loop like static,balanced
+        if( __kmp_static != kmp_sch_static_greedy ) {
             register UT chunkD = trip_count / nteams;
             register UT extras = trip_count % nteams;
             *plower += incr * ( team_id * chunkD + ( team_id < extras ? team_id : extras ) );
@@ -553,7 +615,8 @@ __kmp_dist_for_static_init(
             if( trip_count <= nth ) {
                 KMP_DEBUG_ASSERT(
                     __kmp_static == kmp_sch_static_greedy || \
-                    __kmp_static == kmp_sch_static_balanced
+                    __kmp_static == kmp_sch_static_balanced || \
+                    __kmp_static == kmp_sch_static_aligned
                 ); // Unknown static scheduling type.
                 if( tid < trip_count )
                     *pupper = *plower = *plower + tid * incr;
@@ -563,7 +626,7 @@ __kmp_dist_for_static_init(
                     if( *plastiter != 0 && !( tid == trip_count - 1 ) )
                         *plastiter = 0;
             } else {
-                if( __kmp_static == kmp_sch_static_balanced ) {
+                if( __kmp_static != kmp_sch_static_greedy ) {
                     register UT chunkL = trip_count / nth;
                     register UT extras = trip_count % nth;
                     *plower += incr * (tid * chunkL + (tid < extras ? tid : extras));
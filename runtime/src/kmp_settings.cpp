@@ -1232,6 +1232,120 @@ __kmp_stg_print_disp_buffers( kmp_str_buf_t * buffer, char const * name, void *
     __kmp_stg_print_int( buffer, name, __kmp_dispatch_num_buffers );
 } // __kmp_stg_print_disp_buffers
 
+// -------------------------------------------------------------------------------------------------
+// KMP_AUTO_ADAPTIVE
+// -------------------------------------------------------------------------------------------------
+
+static void
+__kmp_stg_parse_auto_adaptive( char const * name, char const * value, void * data ) {
+    __kmp_stg_parse_bool( name, value, & __kmp_auto_adaptive );
+} // __kmp_stg_parse_auto_adaptive
+
+static void
+__kmp_stg_print_auto_adaptive( kmp_str_buf_t * buffer, char const * name, void * data ) {
+    __kmp_stg_print_bool( buffer, name, __kmp_auto_adaptive );
+} // __kmp_stg_print_auto_adaptive
+
+// -------------------------------------------------------------------------------------------------
+// KMP_DISP_HIER_DOMAINS
+// -------------------------------------------------------------------------------------------------
+
+static void
+__kmp_stg_parse_disp_hier_domains( char const * name, char const * value, void * data ) {
+    __kmp_stg_parse_int( name, value, 0, KMP_MAX_DISP_HIER_DOMAINS, & __kmp_dispatch_hier_domains );
+} // __kmp_stg_parse_disp_hier_domains
+
+static void
+__kmp_stg_print_disp_hier_domains( kmp_str_buf_t * buffer, char const * name, void * data ) {
+    __kmp_stg_print_int( buffer, name, __kmp_dispatch_hier_domains );
+} // __kmp_stg_print_disp_hier_domains
+
+// -------------------------------------------------------------------------------------------------
+// KMP_DOACROSS_WINDOW
+// -------------------------------------------------------------------------------------------------
+
+static void
+__kmp_stg_parse_doacross_window( char const * name, char const * value, void * data ) {
+    __kmp_stg_parse_int( name, value, 0, KMP_MAX_DOACROSS_WINDOW, & __kmp_doacross_window );
+} // __kmp_stg_parse_doacross_window
+
+static void
+__kmp_stg_print_doacross_window( kmp_str_buf_t * buffer, char const * name, void * data ) {
+    __kmp_stg_print_int( buffer, name, __kmp_doacross_window );
+} // __kmp_stg_print_doacross_window
+
+// -------------------------------------------------------------------------------------------------
+// KMP_LOOP_STATS
+// -------------------------------------------------------------------------------------------------
+
+static void
+__kmp_stg_parse_loop_stats( char const * name, char const * value, void * data ) {
+    __kmp_stg_parse_bool( name, value, & __kmp_loop_stats );
+} // __kmp_stg_parse_loop_stats
+
+static void
+__kmp_stg_print_loop_stats( kmp_str_buf_t * buffer, char const * name, void * data ) {
+    __kmp_stg_print_bool( buffer, name, __kmp_loop_stats );
+} // __kmp_stg_print_loop_stats
+
+// -------------------------------------------------------------------------------------------------
+// KMP_DISPATCH_FAST_PATH
+// -------------------------------------------------------------------------------------------------
+
+static void
+__kmp_stg_parse_dispatch_fast_path( char const * name, char const * value, void * data ) {
+    __kmp_stg_parse_bool( name, value, & __kmp_dispatch_fast_path );
+} // __kmp_stg_parse_dispatch_fast_path
+
+static void
+__kmp_stg_print_dispatch_fast_path( kmp_str_buf_t * buffer, char const * name, void * data ) {
+    __kmp_stg_print_bool( buffer, name, __kmp_dispatch_fast_path );
+} // __kmp_stg_print_dispatch_fast_path
+
+#if OMP_40_ENABLED
+// -------------------------------------------------------------------------------------------------
+// KMP_DIST_SCHEDULE: static | dynamic[,block]
+// -------------------------------------------------------------------------------------------------
+
+static void
+__kmp_stg_parse_dist_schedule( char const * name, char const * value, void * data ) {
+    char const *comma = strchr( value, ',' );
+
+    if ( ! __kmp_strcasecmp_with_sentinel( "static", value, ',' ) ) {
+        __kmp_dist_dynamic = FALSE;
+        if ( comma != NULL )
+            __kmp_msg( kmp_ms_warning, KMP_MSG( IgnoreChunk, name, comma ), __kmp_msg_null );
+    } else if ( ! __kmp_strcasecmp_with_sentinel( "dynamic", value, ',' ) ) {
+        __kmp_dist_dynamic = TRUE;
+        __kmp_dist_block = 0;
+        if ( comma != NULL ) {
+            __kmp_dist_block = __kmp_str_to_int( comma + 1, 0 );
+            if ( __kmp_dist_block < 1 ) {
+                __kmp_dist_block = 0;
+                __kmp_msg( kmp_ms_warning, KMP_MSG( InvalidChunk, name, comma + 1 ), __kmp_msg_null );
+            }
+        }
+    } else {
+        KMP_WARNING( StgInvalidValue, name, value );
+    }
+} // __kmp_stg_parse_dist_schedule
+
+static void
+__kmp_stg_print_dist_schedule( kmp_str_buf_t * buffer, char const * name, void * data ) {
+    if( __kmp_env_format ) {
+        KMP_STR_BUF_PRINT_NAME_EX(name);
+    } else {
+        __kmp_str_buf_print( buffer, "   %s='", name );
+    }
+    if ( ! __kmp_dist_dynamic )
+        __kmp_str_buf_print( buffer, "static'\n" );
+    else if ( __kmp_dist_block > 0 )
+        __kmp_str_buf_print( buffer, "dynamic,%d'\n", __kmp_dist_block );
+    else
+        __kmp_str_buf_print( buffer, "dynamic'\n" );
+} // __kmp_stg_print_dist_schedule
+#endif /* OMP_40_ENABLED */
+
 #if KMP_NESTED_HOT_TEAMS
 // -------------------------------------------------------------------------------------------------
 // KMP_HOT_TEAMS_MAX_LEVEL, KMP_HOT_TEAMS_MODE
@@ -3491,6 +3605,9 @@ __kmp_stg_parse_schedule( char const * name, char const * value, void * data ) {
                         } else if( !__kmp_strcasecmp_with_sentinel( "balanced", comma, ';' ) ) {
                             __kmp_static = kmp_sch_static_balanced;
                             continue;
+                        } else if( !__kmp_strcasecmp_with_sentinel( "aligned", comma, ';' ) ) {
+                            __kmp_static = kmp_sch_static_aligned;
+                            continue;
                         }
                     } else if ( !__kmp_strcasecmp_with_sentinel( "guided", value, sentinel ) ) {
                         if ( !__kmp_strcasecmp_with_sentinel( "iterative", comma, ';' ) ) {
@@ -3522,6 +3639,8 @@ __kmp_stg_print_schedule( kmp_str_buf_t * buffer, char const * name, void * data
         __kmp_str_buf_print( buffer, "%s", "static,greedy");
     } else if ( __kmp_static == kmp_sch_static_balanced ) {
         __kmp_str_buf_print ( buffer, "%s", "static,balanced");
+    } else if ( __kmp_static == kmp_sch_static_aligned ) {
+        __kmp_str_buf_print ( buffer, "%s", "static,aligned");
     }
     if ( __kmp_guided == kmp_sch_guided_iterative_chunked ) {
         __kmp_str_buf_print( buffer, ";%s'\n", "guided,iterative");
@@ -3561,10 +3680,18 @@ __kmp_stg_parse_omp_schedule( char const * name, char const * value, void * data
                 __kmp_sched = kmp_sch_trapezoidal;
             else if (!__kmp_strcasecmp_with_sentinel("static", value, ','))      /* STATIC */
                 __kmp_sched = kmp_sch_static;
+            else if (!__kmp_strcasecmp_with_sentinel("static_aligned", value, ',')) /* chunk - alignment */
+                __kmp_sched = kmp_sch_static_aligned;
 #if KMP_STATIC_STEAL_ENABLED
             else if (!__kmp_strcasecmp_with_sentinel("static_steal", value, ','))
                 __kmp_sched = kmp_sch_static_steal;
 #endif
+            else if (!__kmp_strcasecmp_with_sentinel("hier_dynamic", value, ','))
+                __kmp_sched = kmp_sch_hier_dynamic_chunked;
+            else if (!__kmp_strcasecmp_with_sentinel("hier_guided", value, ','))
+                __kmp_sched = kmp_sch_hier_guided_chunked;
+            else if (!__kmp_strcasecmp_with_sentinel("sticky", value, ','))
+                __kmp_sched = kmp_sch_sticky_dynamic_chunked;
             else {
                 KMP_WARNING( StgInvalidValue, name, value );
                 value = NULL; /* skip processing of comma */
@@ -3629,9 +3756,21 @@ __kmp_stg_print_omp_schedule( kmp_str_buf_t * buffer, char const * name, void *
             case kmp_sch_static_steal:
                 __kmp_str_buf_print( buffer, "%s,%d'\n", "static_steal", __kmp_chunk);
                 break;
+            case kmp_sch_static_aligned:
+                __kmp_str_buf_print( buffer, "%s,%d'\n", "static_aligned", __kmp_chunk);
+                break;
             case kmp_sch_auto:
                 __kmp_str_buf_print( buffer, "%s,%d'\n", "auto", __kmp_chunk);
                 break;
+            case kmp_sch_hier_dynamic_chunked:
+                __kmp_str_buf_print( buffer, "%s,%d'\n", "hier_dynamic", __kmp_chunk);
+                break;
+            case kmp_sch_hier_guided_chunked:
+                __kmp_str_buf_print( buffer, "%s,%d'\n", "hier_guided", __kmp_chunk);
+                break;
+            case kmp_sch_sticky_dynamic_chunked:
+                __kmp_str_buf_print( buffer, "%s,%d'\n", "sticky", __kmp_chunk);
+                break;
         }
     } else {
         switch ( __kmp_sched ) {
@@ -3654,9 +3793,21 @@ __kmp_stg_print_omp_schedule( kmp_str_buf_t * buffer, char const * name, void *
             case kmp_sch_static_steal:
                 __kmp_str_buf_print( buffer, "%s'\n", "static_steal");
                 break;
+            case kmp_sch_static_aligned:
+                __kmp_str_buf_print( buffer, "%s'\n", "static_aligned");
+                break;
             case kmp_sch_auto:
                 __kmp_str_buf_print( buffer, "%s'\n", "auto");
                 break;
+            case kmp_sch_hier_dynamic_chunked:
+                __kmp_str_buf_print( buffer, "%s'\n", "hier_dynamic");
+                break;
+            case kmp_sch_hier_guided_chunked:
+                __kmp_str_buf_print( buffer, "%s'\n", "hier_guided");
+                break;
+            case kmp_sch_sticky_dynamic_chunked:
+                __kmp_str_buf_print( buffer, "%s'\n", "sticky");
+                break;
         }
     }
 } // __kmp_stg_print_omp_schedule
@@ -4016,6 +4167,16 @@ __kmp_stg_parse_lock_kind( char const * name, char const * value, void * data )
         __kmp_user_lock_kind = lk_hle;
         KMP_STORE_LOCK_SEQ(hle);
     }
+#endif
+#if KMP_USE_DYNAMIC_LOCK
+    else if ( __kmp_str_match( "cohort", 1, value ) ) {
+        __kmp_user_lock_kind = lk_cohort;
+        KMP_STORE_LOCK_SEQ(cohort);
+    }
+    else if ( __kmp_str_match( "tuned", 2, value ) ) {
+        __kmp_user_lock_kind = lk_tuned;
+        KMP_STORE_LOCK_SEQ(tuned);
+    }
 #endif
     else {
         KMP_WARNING( StgInvalidValue, name, value );
@@ -4051,6 +4212,16 @@ __kmp_stg_print_lock_kind( kmp_str_buf_t * buffer, char const * name, void * dat
         break;
 #endif
 
+#if KMP_USE_DYNAMIC_LOCK
+        case lk_cohort:
+        value = "cohort";
+        break;
+
+        case lk_tuned:
+        value = "tuned";
+        break;
+#endif
+
         case lk_ticket:
         value = "ticket";
         break;
@@ -4074,6 +4245,93 @@ __kmp_stg_print_lock_kind( kmp_str_buf_t * buffer, char const * name, void * dat
     }
 }
 
+#if KMP_USE_DYNAMIC_LOCK
+// -------------------------------------------------------------------------------------------------
+// KMP_COHORT_LOCK_PASSES, KMP_COHORT_LOCK_NODES
+// -------------------------------------------------------------------------------------------------
+
+static void
+__kmp_stg_parse_cohort_lock_passes( char const * name, char const * value, void * data ) {
+    __kmp_stg_parse_int( name, value, 0, KMP_INT_MAX, & __kmp_cohort_lock_passes );
+} // __kmp_stg_parse_cohort_lock_passes
+
+static void
+__kmp_stg_print_cohort_lock_passes( kmp_str_buf_t * buffer, char const * name, void * data ) {
+    __kmp_stg_print_int( buffer, name, __kmp_cohort_lock_passes );
+} // __kmp_stg_print_cohort_lock_passes
+
+static void
+__kmp_stg_parse_cohort_lock_nodes( char const * name, char const * value, void * data ) {
+    __kmp_stg_parse_int( name, value, 0, KMP_COHORT_MAX_NODES, & __kmp_cohort_lock_nodes );
+} // __kmp_stg_parse_cohort_lock_nodes
+
+static void
+__kmp_stg_print_cohort_lock_nodes( kmp_str_buf_t * buffer, char const * name, void * data ) {
+    __kmp_stg_print_int( buffer, name, __kmp_cohort_lock_nodes );
+} // __kmp_stg_print_cohort_lock_nodes
+
+// -------------------------------------------------------------------------------------------------
+// KMP_LOCK_PROFILE
+// -------------------------------------------------------------------------------------------------
+
+static void
+__kmp_stg_parse_lock_profile( char const * name, char const * value, void * data ) {
+    __kmp_stg_parse_bool( name, value, & __kmp_lock_profile );
+} // __kmp_stg_parse_lock_profile
+
+static void
+__kmp_stg_print_lock_profile( kmp_str_buf_t * buffer, char const * name, void * data ) {
+    __kmp_stg_print_bool( buffer, name, __kmp_lock_profile );
+} // __kmp_stg_print_lock_profile
+
+#if KMP_USE_TSX
+
+// -------------------------------------------------------------------------------------------------
+// KMP_CRITICAL_SPECULATION, KMP_CRITICAL_SPECULATION_STATS
+// -------------------------------------------------------------------------------------------------
+
+static void
+__kmp_stg_parse_critical_speculation( char const * name, char const * value, void * data ) {
+    __kmp_stg_parse_bool( name, value, & __kmp_critical_speculation );
+} // __kmp_stg_parse_critical_speculation
+
+static void
+__kmp_stg_print_critical_speculation( kmp_str_buf_t * buffer, char const * name, void * data ) {
+    __kmp_stg_print_bool( buffer, name, __kmp_critical_speculation );
+} // __kmp_stg_print_critical_speculation
+
+static void
+__kmp_stg_parse_critical_speculation_stats( char const * name, char const * value, void * data ) {
+    __kmp_stg_parse_bool( name, value, & __kmp_critical_speculation_stats );
+} // __kmp_stg_parse_critical_speculation_stats
+
+static void
+__kmp_stg_print_critical_speculation_stats( kmp_str_buf_t * buffer, char const * name, void * data ) {
+    __kmp_stg_print_bool( buffer, name, __kmp_critical_speculation_stats );
+} // __kmp_stg_print_critical_speculation_stats
+
+#endif // KMP_USE_TSX
+
+#endif // KMP_USE_DYNAMIC_LOCK
+
+#if KMP_USE_FUTEX
+
+// -------------------------------------------------------------------------------------------------
+// KMP_LOCK_PARK
+// -------------------------------------------------------------------------------------------------
+
+static void
+__kmp_stg_parse_lock_park( char const * name, char const * value, void * data ) {
+    __kmp_stg_parse_bool( name, value, & __kmp_lock_park );
+} // __kmp_stg_parse_lock_park
+
+static void
+__kmp_stg_print_lock_park( kmp_str_buf_t * buffer, char const * name, void * data ) {
+    __kmp_stg_print_bool( buffer, name, __kmp_lock_park );
+} // __kmp_stg_print_lock_park
+
+#endif // KMP_USE_FUTEX
+
 // -------------------------------------------------------------------------------------------------
 // KMP_SPIN_BACKOFF_PARAMS
 // -------------------------------------------------------------------------------------------------
@@ -4708,6 +4966,14 @@ static kmp_setting_t __kmp_stg_table[] = {
     { "OMP_THREAD_LIMIT",                  __kmp_stg_parse_all_threads,        __kmp_stg_print_all_threads,        NULL, 0, 0 },
     { "OMP_WAIT_POLICY",                   __kmp_stg_parse_wait_policy,        __kmp_stg_print_wait_policy,        NULL, 0, 0 },
     { "KMP_DISP_NUM_BUFFERS",              __kmp_stg_parse_disp_buffers,       __kmp_stg_print_disp_buffers,       NULL, 0, 0 },
+    { "KMP_AUTO_ADAPTIVE",                 __kmp_stg_parse_auto_adaptive,      __kmp_stg_print_auto_adaptive,      NULL, 0, 0 },
+    { "KMP_DISP_HIER_DOMAINS",             __kmp_stg_parse_disp_hier_domains,  __kmp_stg_print_disp_hier_domains,  NULL, 0, 0 },
+    { "KMP_DOACROSS_WINDOW",               __kmp_stg_parse_doacross_window,    __kmp_stg_print_doacross_window,    NULL, 0, 0 },
+    { "KMP_LOOP_STATS",                    __kmp_stg_parse_loop_stats,         __kmp_stg_print_loop_stats,         NULL, 0, 0 },
+    { "KMP_DISPATCH_FAST_PATH",            __kmp_stg_parse_dispatch_fast_path, __kmp_stg_print_dispatch_fast_path, NULL, 0, 0 },
+#if OMP_40_ENABLED
+    { "KMP_DIST_SCHEDULE",                 __kmp_stg_parse_dist_schedule,      __kmp_stg_print_dist_schedule,      NULL, 0, 0 },
+#endif
 #if KMP_NESTED_HOT_TEAMS
     { "KMP_HOT_TEAMS_MAX_LEVEL",           __kmp_stg_parse_hot_teams_level,    __kmp_stg_print_hot_teams_level,    NULL, 0, 0 },
     { "KMP_HOT_TEAMS_MODE",                __kmp_stg_parse_hot_teams_mode,     __kmp_stg_print_hot_teams_mode,     NULL, 0, 0 },
@@ -4815,6 +5081,18 @@ static kmp_setting_t __kmp_stg_table[] = {
     { "KMP_NUM_LOCKS_IN_BLOCK",            __kmp_stg_parse_lock_block,         __kmp_stg_print_lock_block,         NULL, 0, 0 },
     { "KMP_LOCK_KIND",                     __kmp_stg_parse_lock_kind,          __kmp_stg_print_lock_kind,          NULL, 0, 0 },
     { "KMP_SPIN_BACKOFF_PARAMS",           __kmp_stg_parse_spin_backoff_params, __kmp_stg_print_spin_backoff_params, NULL, 0, 0 },
+#if KMP_USE_DYNAMIC_LOCK
+    { "KMP_COHORT_LOCK_PASSES",            __kmp_stg_parse_cohort_lock_passes, __kmp_stg_print_cohort_lock_passes, NULL, 0, 0 },
+    { "KMP_COHORT_LOCK_NODES",             __kmp_stg_parse_cohort_lock_nodes,  __kmp_stg_print_cohort_lock_nodes,  NULL, 0, 0 },
+    { "KMP_LOCK_PROFILE",                  __kmp_stg_parse_lock_profile,       __kmp_stg_print_lock_profile,       NULL, 0, 0 },
+#if KMP_USE_TSX
+    { "KMP_CRITICAL_SPECULATION",          __kmp_stg_parse_critical_speculation, __kmp_stg_print_critical_speculation, NULL, 0, 0 },
+    { "KMP_CRITICAL_SPECULATION_STATS",    __kmp_stg_parse_critical_speculation_stats, __kmp_stg_print_critical_speculation_stats, NULL, 0, 0 },
+#endif
+#endif
+#if KMP_USE_FUTEX
+    { "KMP_LOCK_PARK",                     __kmp_stg_parse_lock_park,          __kmp_stg_print_lock_park,          NULL, 0, 0 },
+#endif
 #if KMP_USE_ADAPTIVE_LOCKS
     { "KMP_ADAPTIVE_LOCK_PROPS",           __kmp_stg_parse_adaptive_lock_props,__kmp_stg_print_adaptive_lock_props,  NULL, 0, 0 },
 #if KMP_DEBUG_ADAPTIVE_LOCKS
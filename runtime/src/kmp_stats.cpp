@@ -73,6 +73,12 @@ static uint32_t statsPrinted = 0;
 // output interface
 static kmp_stats_output_module* __kmp_stats_global_output = NULL;
 
+// Per-site plain barrier statistics, an open addressed table keyed by ident_t.
+// Sites without an ident_t or that do not fit share the last entry.
+#define KMP_STATS_BARRIER_SITES 1024
+static barrierSiteStats barrierSites[KMP_STATS_BARRIER_SITES+1];
+static int barrierSitesUsed = 0;
+
 /* ****************************************************** */
 /* ************* statistic member functions ************* */
 
@@ -152,6 +158,35 @@ std::string statistic::format(char unit, bool total) const
     return result;
 }
 
+/* ********************************************************* */
+/* ************* logHistogram member functions ************* */
+
+void logHistogram::addSample(int64_t sample)
+{
+    int bin = 0;
+    for (uint64_t v = sample > 0 ? uint64_t(sample) : 0; v > 1 && bin < KMP_STATS_HISTOGRAM_BINS-1; v >>= 1)
+        bin++;
+    bins[bin]++;
+}
+
+logHistogram & logHistogram::operator+= (logHistogram const & other)
+{
+    for (int i=0; i<KMP_STATS_HISTOGRAM_BINS; i++)
+        bins[i] += other.bins[i];
+    return *this;
+}
+
+// Prints the non-empty bins as "2^bin:count" pairs
+std::string logHistogram::format() const
+{
+    std::stringstream ss;
+    for (int i=0; i<KMP_STATS_HISTOGRAM_BINS; i++) {
+        if (bins[i])
+            ss << " 2^" << i << ":" << bins[i];
+    }
+    return ss.str();
+}
+
 /* ********************************************************** */
 /* ************* explicitTimer member functions ************* */
 
@@ -362,6 +397,7 @@ const char* kmp_stats_output_module::eventsFileName = NULL;
 const char* kmp_stats_output_module::plotFileName   = NULL;
 int kmp_stats_output_module::printPerThreadFlag       = 0;
 int kmp_stats_output_module::printPerThreadEventsFlag = 0;
+int kmp_stats_output_module::printBarrierSites        = 10;
 
 // init() is called very near the beginning of execution time in the constructor of __kmp_stats_global_output
 void kmp_stats_output_module::init()
@@ -371,6 +407,7 @@ void kmp_stats_output_module::init()
     plotFileName          = getenv("KMP_STATS_PLOT_FILE");
     char * threadStats    = getenv("KMP_STATS_THREADS");
     char * threadEvents   = getenv("KMP_STATS_EVENTS");
+    char * barrierSites   = getenv("KMP_STATS_BARRIER_SITES");
 
     // set the stats output filenames based on environment variables and defaults
     if(statsFileName) {
@@ -397,6 +434,8 @@ void kmp_stats_output_module::init()
     // set the flags based on environment variables matching: true, on, 1, .true. , .t. , yes
     printPerThreadFlag        = __kmp_str_match_true(threadStats);
     printPerThreadEventsFlag  = __kmp_str_match_true(threadEvents);
+    if(barrierSites)
+        printBarrierSites = atoi(barrierSites);
 
     if(printPerThreadEventsFlag) {
         // assigns a color to each timer for printing
@@ -459,6 +498,42 @@ void kmp_stats_output_module::printCounters(FILE * statsOut, counter const * the
     }
 }
 
+static bool compareBarrierSites(barrierSiteStats const * a, barrierSiteStats const * b)
+{
+    return a->getTotal() > b->getTotal();
+}
+
+void kmp_stats_output_module::printBarrierSiteStats(FILE * statsOut)
+{
+    std::vector<barrierSiteStats const *> sites;
+    for (int i = 0; i<=KMP_STATS_BARRIER_SITES; i++) {
+        if (barrierSites[i].getSkew().getCount())
+            sites.push_back(&barrierSites[i]);
+    }
+    if (sites.empty())
+        return;
+    std::sort(sites.begin(), sites.end(), compareBarrierSites);
+    if ((int)sites.size() > printBarrierSites)
+        sites.resize(printBarrierSites);
+
+    fprintf (statsOut, "\nBarrier site,               SampleCount,    Min,      Mean,       Max,     Total,        SD\n");
+    for (size_t i = 0; i<sites.size(); i++) {
+        barrierSiteStats const * site = sites[i];
+        if (site->getLoc() == NULL) {
+            fprintf (statsOut, "<unknown or other sites>\n");
+        } else {
+            kmp_str_loc_t loc = __kmp_str_loc_init(site->getSource(), 1);
+            fprintf (statsOut, "%s:%d (%s)\n", loc.file ? loc.file : "unknown", loc.line,
+                     loc.func ? loc.func : "unknown");
+            __kmp_str_loc_free(&loc);
+        }
+        fprintf (statsOut, "  %-26s, %s\n", "arrival_skew", site->getSkew().format('T', true).c_str());
+        fprintf (statsOut, "  %-26s, %s\n", "release_latency", site->getRelease().format('T', true).c_str());
+        fprintf (statsOut, "  %-26s,%s\n", "arrival_skew_ticks", site->getSkewHist().format().c_str());
+        fprintf (statsOut, "  %-26s,%s\n", "release_latency_ticks", site->getReleaseHist().format().c_str());
+    }
+}
+
 void kmp_stats_output_module::printEvents(FILE* eventsOut, kmp_stats_event_vector* theEvents, int gtid) {
     // sort by start time before printing
     theEvents->sort();
@@ -654,6 +729,9 @@ void kmp_stats_output_module::outputStats(const char* heading)
     printTimerStats (statsOut, &allStats[0], &totalStats[0]);
     fprintf (statsOut, "\n");
     printCounterStats (statsOut, &allCounters[0]);
+    if (printBarrierSites > 0)
+        printBarrierSiteStats (statsOut);
+    __kmp_dispatch_auto_print (statsOut);
 
     if (statsOut != stderr)
         fclose(statsOut);
@@ -685,6 +763,9 @@ void __kmp_reset_stats()
         // reset the event vector so all previous events are "erased"
         (*it)->resetEventVector();
     }
+
+    for (int i = 0; i<=KMP_STATS_BARRIER_SITES; i++)
+        barrierSites[i].reset();
 }
 
 // This function will reset all stats and stop all threads' explicit timers if they haven't been stopped already.
@@ -703,9 +784,36 @@ void __kmp_accumulate_stats_at_exit(void)
     __kmp_output_stats("Statistics on exit");
 }
 
+// Records one barrier instance at the plain barrier site loc.
+void __kmp_stats_barrier_sample(int gtid, const void * loc, const char * psource, int64_t skew, int64_t release)
+{
+    barrierSiteStats * site = &barrierSites[KMP_STATS_BARRIER_SITES];
+    size_t h = ((size_t)loc >> 3) % KMP_STATS_BARRIER_SITES;
+
+    __kmp_acquire_tas_lock(&__kmp_stats_barrier_lock, gtid);
+    for (int probe = 0; loc && probe<KMP_STATS_BARRIER_SITES; probe++, h = (h+1) % KMP_STATS_BARRIER_SITES) {
+        if (barrierSites[h].getLoc() == loc) {
+            site = &barrierSites[h];
+            break;
+        }
+        if (barrierSites[h].getLoc() == NULL) {
+            if (barrierSitesUsed < KMP_STATS_BARRIER_SITES/2) {
+                // Keep the table at most half full so the probe sequences stay short
+                barrierSites[h].init(loc, psource);
+                barrierSitesUsed++;
+                site = &barrierSites[h];
+            }
+            break;
+        }
+    }
+    site->addSample(skew, release);
+    __kmp_release_tas_lock(&__kmp_stats_barrier_lock, gtid);
+}
+
 void __kmp_stats_init(void)
 {
     __kmp_init_tas_lock( & __kmp_stats_lock );
+    __kmp_init_tas_lock( & __kmp_stats_barrier_lock );
     __kmp_stats_start_time = tsc_tick_count::now();
     __kmp_stats_global_output = new kmp_stats_output_module();
     __kmp_stats_list = new kmp_stats_list();
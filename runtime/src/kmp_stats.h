@@ -412,6 +412,64 @@ class counter
     static bool  masterOnly (counter_e e) { return counterInfo[e].flags & stats_flags_e::onlyInMaster; }
 };
 
+/* ****************************************************************
+    Class to implement a log-scale histogram
+
+    Bin i counts the samples in [2^i, 2^(i+1)) ticks; bin 0 also takes
+    samples of zero (or less) and the last bin takes everything above it.
+**************************************************************** */
+#define KMP_STATS_HISTOGRAM_BINS 48
+
+class logHistogram
+{
+    uint64_t bins[KMP_STATS_HISTOGRAM_BINS];
+
+ public:
+    logHistogram() { reset(); }
+    void reset() { for (int i=0; i<KMP_STATS_HISTOGRAM_BINS; i++) bins[i] = 0; }
+    void addSample(int64_t sample);
+    uint64_t getBin(int i) const { return bins[i]; }
+    logHistogram & operator+= (logHistogram const & other);
+
+    std::string format() const;
+};
+
+/* ****************************************************************
+    Class to hold the statistics of one plain barrier source location
+
+    The master of a team records one sample per barrier instance:
+    the arrival skew (first to last arriving thread) which measures load
+    imbalance, and the release latency (last arrival to last departing
+    thread) which measures the barrier mechanism itself.  Sites are keyed
+    by the ident_t of the barrier and live in a global table that is
+    printed by kmp_stats_output_module::outputStats() sorted by total time.
+**************************************************************** */
+class barrierSiteStats
+{
+    const void * loc;      // ident_t of the barrier, NULL for the overflow entry
+    const char * psource;  // its source location string
+    statistic    skew;
+    statistic    release;
+    logHistogram skewHist;
+    logHistogram releaseHist;
+
+ public:
+    barrierSiteStats() : loc(NULL), psource(NULL) {}
+    void init(const void * l, const char * src) { loc = l; psource = src; reset(); }
+    void reset() { skew.reset(); release.reset(); skewHist.reset(); releaseHist.reset(); }
+    void addSample(int64_t skewTicks, int64_t releaseTicks) {
+        skew.addSample(double(skewTicks));       skewHist.addSample(skewTicks);
+        release.addSample(double(releaseTicks)); releaseHist.addSample(releaseTicks);
+    }
+    const void *         getLoc()         const { return loc; }
+    const char *         getSource()      const { return psource; }
+    statistic const &    getSkew()        const { return skew; }
+    statistic const &    getRelease()     const { return release; }
+    logHistogram const & getSkewHist()    const { return skewHist; }
+    logHistogram const & getReleaseHist() const { return releaseHist; }
+    double getTotal() const { return skew.getCount() ? skew.getTotal() + release.getTotal() : 0.0; }
+};
+
 /* ****************************************************************
     Class to implement an event
 
@@ -644,6 +702,8 @@ class kmp_stats_list {
    KMP_STATS_EVENTS -- if set to "on", then log events, otherwise, don't log events
    KMP_STATS_EVENTS_FILE -- if set, all events are outputted to this file,
                             otherwise, output is sent to "events.dat"
+   KMP_STATS_BARRIER_SITES -- number of plain barrier sites printed in the per-site
+                              barrier table (sorted by total time), default 10, 0 disables it
 
 **************************************************************** */
 class kmp_stats_output_module {
@@ -661,6 +721,7 @@ class kmp_stats_output_module {
     static const char* plotFileName;
     static int printPerThreadFlag;
     static int printPerThreadEventsFlag;
+    static int printBarrierSites;
     static const rgb_color globalColorArray[];
     static       rgb_color timerColorInfo[];
 
@@ -671,6 +732,7 @@ class kmp_stats_output_module {
     static void printTimerStats(FILE *statsOut, statistic const * theStats, statistic const * totalStats);
     static void printCounterStats(FILE *statsOut, statistic const * theStats);
     static void printCounters(FILE * statsOut, counter const * theCounters);
+    static void printBarrierSiteStats(FILE * statsOut);
     static void printEvents(FILE * eventsOut, kmp_stats_event_vector* theEvents, int gtid);
     static rgb_color getEventColor(timer_e e) { return timerColorInfo[e]; }
     static void windupExplicitTimers();
@@ -689,12 +751,15 @@ void __kmp_stats_fini();
 void __kmp_reset_stats();
 void __kmp_output_stats(const char *);
 void __kmp_accumulate_stats_at_exit(void);
+void __kmp_stats_barrier_sample(int gtid, const void * loc, const char * psource, int64_t skew, int64_t release);
 // thread local pointer to stats node within list
 extern __thread kmp_stats_list* __kmp_stats_thread_ptr;
 // head to stats list.
 extern kmp_stats_list* __kmp_stats_list;
 // lock for __kmp_stats_list
 extern kmp_tas_lock_t  __kmp_stats_lock;
+// lock for the per-site barrier table
+extern kmp_tas_lock_t  __kmp_stats_barrier_lock;
 // reference start time
 extern tsc_tick_count __kmp_stats_start_time;
 // interface to output
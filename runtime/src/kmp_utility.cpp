@@ -180,6 +180,9 @@ __kmp_query_cpuid( kmp_cpuinfo_t *p )
         }; // for
 
         p->sse2 = ( buf.edx >> 26 ) & 1;
+#if KMP_ARCH_X86_64
+        p->cx16 = ( buf.ecx >> 13 ) & 1;
+#endif
 
 #ifdef KMP_DEBUG
 
@@ -0,0 +1,110 @@
+// RUN: %libomp-compile-and-run
+// RUN: env KMP_ATOMIC_MODE=2 %libomp-run
+// Run with an argument to time double complex atomic updates; compare
+// KMP_ATOMIC_MODE=1 (cmpxchg16b) with KMP_ATOMIC_MODE=2 (one global lock).
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <complex.h>
+#include "omp_testsuite.h"
+
+#define NTHREADS 4
+#define NELEMS 8
+
+typedef struct ident {
+  int reserved_1;
+  int flags;
+  int reserved_2;
+  int reserved_3;
+  char const *psource;
+} ident_t;
+
+extern void __kmpc_atomic_cmplx8_add(ident_t *, int, double _Complex *,
+                                     double _Complex);
+extern void __kmpc_atomic_cmplx8_sub(ident_t *, int, double _Complex *,
+                                     double _Complex);
+extern double _Complex __kmpc_atomic_cmplx8_add_cpt(ident_t *, int,
+                                                    double _Complex *,
+                                                    double _Complex, int);
+extern double _Complex __kmpc_atomic_cmplx8_rd(ident_t *, int,
+                                               double _Complex *);
+extern void __kmpc_atomic_16(ident_t *, int, void *, void *,
+                             void (*)(void *, void *, void *));
+extern int __kmpc_global_thread_num(ident_t *);
+
+static ident_t loc = { 0, 2, 0, 0, ";kmp_atomic_cas128.c;test;30;1;;" };
+
+// 16-byte aligned elements take cmpxchg16b, the shifted copy the lock table
+static double _Complex buf[2 * NELEMS + 1] __attribute__((aligned(16)));
+
+static void add_cx(void *out, void *a, void *b)
+{
+  *(double _Complex *)out = *(double _Complex *)a + *(double _Complex *)b;
+}
+
+int test_kmp_atomic_cas128(int n, double _Complex *cx)
+{
+  int i, errors = 0;
+
+  memset(cx, 0, NELEMS * sizeof(*cx));
+  #pragma omp parallel num_threads(NTHREADS) reduction(+:errors)
+  {
+    int gtid = __kmpc_global_thread_num(&loc);
+    int j;
+    for (j = 0; j < n; j++) {
+      double _Complex *p = &cx[(j + omp_get_thread_num()) % NELEMS];
+      double _Complex one = 1.0 + 2.0 * I, v;
+      switch (j % 4) {
+      case 0:
+        __kmpc_atomic_cmplx8_add(&loc, gtid, p, 1.0 + 2.0 * I);
+        break;
+      case 1:
+        __kmpc_atomic_16(&loc, gtid, p, &one, add_cx);
+        break;
+      case 2:
+        v = __kmpc_atomic_cmplx8_add_cpt(&loc, gtid, p, 1.0 + 2.0 * I, j % 8);
+        if (creal(v) < 0 || cimag(v) != 2 * creal(v))
+          errors++;
+        break;
+      default:
+        v = __kmpc_atomic_cmplx8_rd(&loc, gtid, p);
+        if (cimag(v) != 2 * creal(v))
+          errors++;
+        __kmpc_atomic_cmplx8_sub(&loc, gtid, p, -1.0 - 2.0 * I);
+      }
+    }
+  }
+  for (i = 0; i < NELEMS; i++) {
+    if (creal(cx[i]) != n * NTHREADS / NELEMS ||
+        cimag(cx[i]) != 2 * creal(cx[i])) {
+      fprintf(stderr, "element %d: (%g, %g) (expected %d)\n", i, creal(cx[i]),
+              cimag(cx[i]), n * NTHREADS / NELEMS);
+      errors++;
+    }
+  }
+  return errors == 0;
+}
+
+int main(int argc, char **argv)
+{
+  int i;
+  int num_failed = 0;
+  double _Complex *aligned = buf;
+  double _Complex *shifted = (double _Complex *)((char *)buf + 8);
+
+  if (argc > 1) {
+    int n = atoi(argv[1]) / NELEMS * NELEMS;
+    double t = omp_get_wtime();
+    test_kmp_atomic_cas128(n, aligned);
+    printf("%.1f ns per update\n",
+           (omp_get_wtime() - t) * 1e9 / ((double)n * NTHREADS));
+    return 0;
+  }
+  for (i = 0; i < REPETITIONS; i++) {
+    if (!test_kmp_atomic_cas128(LOOPCOUNT, aligned) ||
+        !test_kmp_atomic_cas128(LOOPCOUNT, shifted)) {
+      num_failed++;
+    }
+  }
+  return num_failed;
+}
@@ -0,0 +1,100 @@
+// RUN: %libomp-compile-and-run
+// RUN: env KMP_ATOMIC_MODE=2 %libomp-run
+// Run with an argument to time long double atomic updates spread over many
+// addresses; compare KMP_ATOMIC_MODE=1 with KMP_ATOMIC_MODE=2.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <complex.h>
+#include "omp_testsuite.h"
+
+#define NTHREADS 4
+#define NELEMS 257
+
+typedef struct ident {
+  int reserved_1;
+  int flags;
+  int reserved_2;
+  int reserved_3;
+  char const *psource;
+} ident_t;
+
+extern void __kmpc_atomic_float10_add(ident_t *, int, long double *,
+                                      long double);
+extern long double __kmpc_atomic_float10_rd(ident_t *, int, long double *);
+extern void __kmpc_atomic_cmplx8_add(ident_t *, int, double _Complex *,
+                                     double _Complex);
+extern void __kmpc_atomic_10(ident_t *, int, void *, void *,
+                             void (*)(void *, void *, void *));
+extern int __kmpc_global_thread_num(ident_t *);
+
+static ident_t loc = { 0, 2, 0, 0, ";kmp_atomic_lock_table.c;test;30;1;;" };
+
+static long double ld[NELEMS];
+static double _Complex cx[NELEMS];
+
+static void add_ld(void *out, void *a, void *b)
+{
+  *(long double *)out = *(long double *)a + *(long double *)b;
+}
+
+// Every thread updates every element through the typed and the generic entry
+// points, so atomics on neighbouring and on the same addresses interleave.
+int test_kmp_atomic_lock_table(int n)
+{
+  int i, errors = 0;
+
+  memset(ld, 0, sizeof(ld));
+  memset(cx, 0, sizeof(cx));
+  #pragma omp parallel num_threads(NTHREADS)
+  {
+    int gtid = __kmpc_global_thread_num(&loc);
+    int j;
+    for (j = 0; j < n; j++) {
+      int k = (j * 31 + omp_get_thread_num()) % NELEMS;
+      long double one = 1.0L;
+      if (j % 3 == 0)
+        __kmpc_atomic_10(&loc, gtid, &ld[k], &one, add_ld);
+      else
+        __kmpc_atomic_float10_add(&loc, gtid, &ld[k], one);
+      __kmpc_atomic_cmplx8_add(&loc, gtid, &cx[k], 1.0 + 2.0 * _Complex_I);
+      (void)__kmpc_atomic_float10_rd(&loc, gtid, &ld[(k + 1) % NELEMS]);
+    }
+  }
+  for (i = 0; i < NELEMS; i++) {
+    int t, expected = 0;
+    for (t = 0; t < NTHREADS; t++) {
+      int j;
+      for (j = 0; j < n; j++)
+        expected += (j * 31 + t) % NELEMS == i;
+    }
+    if (ld[i] != expected || __real__ cx[i] != expected ||
+        __imag__ cx[i] != 2.0 * expected) {
+      fprintf(stderr, "element %d: %Lg, (%g, %g) (expected %d)\n", i, ld[i],
+              __real__ cx[i], __imag__ cx[i], expected);
+      errors++;
+    }
+  }
+  return errors == 0;
+}
+
+int main(int argc, char **argv)
+{
+  int i;
+  int num_failed = 0;
+
+  if (argc > 1) {
+    int n = atoi(argv[1]);
+    double t = omp_get_wtime();
+    test_kmp_atomic_lock_table(n);
+    printf("%.1f ns per update\n",
+           (omp_get_wtime() - t) * 1e9 / (3.0 * n * NTHREADS));
+    return 0;
+  }
+  for (i = 0; i < REPETITIONS; i++) {
+    if (!test_kmp_atomic_lock_table(LOOPCOUNT)) {
+      num_failed++;
+    }
+  }
+  return num_failed;
+}
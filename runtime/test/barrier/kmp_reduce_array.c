@@ -0,0 +1,173 @@
+// RUN: %libomp-compile-and-run
+// RUN: %libomp-compile -DNOWAIT && %libomp-run
+// RUN: %libomp-compile && env KMP_FORCE_REDUCTION=critical %libomp-run
+// RUN: %libomp-compile -DNOWAIT && env KMP_FORCE_REDUCTION=critical %libomp-run
+// RUN: %libomp-compile -DSMALL && %libomp-run
+// RUN: %libomp-compile -DSMALL -DNOWAIT && %libomp-run
+// RUN: %libomp-compile -DENTRY41 && %libomp-run
+// RUN: %libomp-compile -DENTRY41 -DNOWAIT && %libomp-run
+#include <stdio.h>
+#include <stdlib.h>
+#include <omp.h>
+#include "omp_testsuite.h"
+
+#ifdef SMALL
+#define N 3
+#else
+#define N 100003
+#endif
+
+typedef struct ident {
+  int reserved_1;
+  int flags;
+  int reserved_2;
+  int reserved_3;
+  char const *psource;
+} ident_t;
+
+typedef struct kmp_reduction_item {
+  int op;
+  int elem;
+  size_t count;
+} kmp_reduction_item_t;
+
+// enum kmp_reduction_op / enum kmp_reduction_elem
+#define RED_SUM 1
+#define RED_MIN 3
+#define ELEM_INT64 2
+#define ELEM_FLOAT64 4
+
+extern int __kmpc_global_thread_num(ident_t *);
+extern int __kmpc_reduce_array(ident_t *, int, int, size_t, void *,
+                               const kmp_reduction_item_t *,
+                               void (*)(void *, void *), int *);
+extern int __kmpc_reduce_nowait_array(ident_t *, int, int, size_t, void *,
+                                      const kmp_reduction_item_t *,
+                                      void (*)(void *, void *), int *);
+// the 4.1 entry points take no descriptor and reduce through reduce_func
+extern int __kmpc_reduce41(ident_t *, int, int, size_t, void *, void *,
+                           void (*)(void *, void *), int *);
+extern int __kmpc_reduce_nowait41(ident_t *, int, int, size_t, void *, void *,
+                                  void (*)(void *, void *), int *);
+extern void __kmpc_end_reduce(ident_t *, int, int *);
+extern void __kmpc_end_reduce_nowait(ident_t *, int, int *);
+
+static ident_t loc = { 0, 2, 0, 0, ";unknown;unknown;0;0;;" };
+static int crit[8];
+
+static void reduce_func(void *lhs, void *rhs)
+{
+  int i;
+  double *ld = ((double **)lhs)[0], *rd = ((double **)rhs)[0];
+  long long *li = ((long long **)lhs)[1], *ri = ((long long **)rhs)[1];
+  for (i = 0; i < N; ++i) {
+    ld[i] += rd[i];
+    if (ri[i] < li[i])
+      li[i] = ri[i];
+  }
+}
+
+int test_kmp_reduce_array()
+{
+  double *sum = (double *)malloc(N * sizeof(double));
+  long long *min = (long long *)malloc(N * sizeof(long long));
+  int i, nthreads = 0, ok = 1;
+
+  for (i = 0; i < N; ++i) {
+    sum[i] = 1.0;
+    min[i] = 1000;
+  }
+
+  #pragma omp parallel
+  {
+    int j, gtid = __kmpc_global_thread_num(&loc);
+    int tid = omp_get_thread_num();
+    double *priv_sum = (double *)malloc(N * sizeof(double));
+    long long *priv_min = (long long *)malloc(N * sizeof(long long));
+    void *red_list[2];
+    kmp_reduction_item_t desc[2] = { { RED_SUM, ELEM_FLOAT64, N },
+                                     { RED_MIN, ELEM_INT64, N } };
+    #pragma omp single
+    nthreads = omp_get_num_threads();
+    for (j = 0; j < N; ++j) {
+      priv_sum[j] = j;
+      priv_min[j] = (j + tid) % 7;
+    }
+    red_list[0] = priv_sum;
+    red_list[1] = priv_min;
+#if defined(ENTRY41) && defined(NOWAIT)
+    switch (__kmpc_reduce_nowait41(&loc, gtid, 2, sizeof(red_list), red_list,
+                                   NULL, reduce_func, crit)) {
+#elif defined(ENTRY41)
+    switch (__kmpc_reduce41(&loc, gtid, 2, sizeof(red_list), red_list, NULL,
+                            reduce_func, crit)) {
+#elif defined(NOWAIT)
+    switch (__kmpc_reduce_nowait_array(&loc, gtid, 2, sizeof(red_list),
+                                       red_list, desc, reduce_func, crit)) {
+#else
+    switch (__kmpc_reduce_array(&loc, gtid, 2, sizeof(red_list), red_list,
+                                desc, reduce_func, crit)) {
+#endif
+    case 1:
+      for (j = 0; j < N; ++j) {
+        sum[j] += priv_sum[j];
+        if (priv_min[j] < min[j])
+          min[j] = priv_min[j];
+      }
+#ifdef NOWAIT
+      __kmpc_end_reduce_nowait(&loc, gtid, crit);
+#else
+      __kmpc_end_reduce(&loc, gtid, crit);
+#endif
+      break;
+    case 2:
+      #pragma omp critical
+      for (j = 0; j < N; ++j) {
+        sum[j] += priv_sum[j];
+        if (priv_min[j] < min[j])
+          min[j] = priv_min[j];
+      }
+#ifndef NOWAIT
+      __kmpc_end_reduce(&loc, gtid, crit);
+#endif
+      break;
+    }
+#ifdef NOWAIT
+    #pragma omp barrier
+#endif
+    free(priv_sum);
+    free(priv_min);
+  }
+
+  for (i = 0; i < N; ++i) {
+    long long expected_min = 1000;
+    int t;
+    for (t = 0; t < nthreads; ++t)
+      if ((i + t) % 7 < expected_min)
+        expected_min = (i + t) % 7;
+    if (sum[i] != 1.0 + (double)i * nthreads || min[i] != expected_min) {
+      fprintf(stderr, "element %d: sum %g (expected %g), min %lld (expected "
+              "%lld)\n", i, sum[i], 1.0 + (double)i * nthreads, min[i],
+              expected_min);
+      ok = 0;
+      break;
+    }
+  }
+  free(sum);
+  free(min);
+  return ok;
+}
+
+int main()
+{
+  int i;
+  int num_failed = 0;
+
+  omp_set_num_threads(8);
+  for (i = 0; i < REPETITIONS; i++) {
+    if (!test_kmp_reduce_array()) {
+      num_failed++;
+    }
+  }
+  return num_failed;
+}
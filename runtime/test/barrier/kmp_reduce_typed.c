@@ -0,0 +1,130 @@
+// RUN: %libomp-compile && env KMP_FORCE_REDUCTION=tree %libomp-run
+// RUN: env KMP_FORCE_REDUCTION=tree KMP_REDUCTION_BARRIER_PATTERN=linear,linear %libomp-run
+// RUN: env KMP_FORCE_REDUCTION=tree KMP_REDUCTION_BARRIER_PATTERN=hyper,hyper %libomp-run
+#include <stdio.h>
+#include <omp.h>
+#include "omp_testsuite.h"
+
+#define N 100
+
+typedef struct ident {
+  int reserved_1;
+  int flags;
+  int reserved_2;
+  int reserved_3;
+  char const *psource;
+} ident_t;
+
+typedef struct kmp_reduction_item {
+  int op;
+  int elem;
+  size_t count;
+} kmp_reduction_item_t;
+
+// enum kmp_reduction_op / enum kmp_reduction_elem
+#define RED_SUM 1
+#define RED_MAX 4
+#define ELEM_INT32 1
+#define ELEM_FLOAT64 4
+
+extern int __kmpc_global_thread_num(ident_t *);
+extern int __kmpc_reduce_typed(ident_t *, int, int, size_t, void *,
+                               const kmp_reduction_item_t *,
+                               void (*)(void *, void *), int *);
+extern void __kmpc_end_reduce(ident_t *, int, int *);
+
+static ident_t loc = { 0, 2, 0, 0, ";unknown;unknown;0;0;;" };
+static int crit[8];
+static int callback_calls;
+
+// Only used if the runtime does not take the typed path
+static void reduce_func(void *lhs, void *rhs)
+{
+  int i;
+  double *ld = ((double **)lhs)[0], *rd = ((double **)rhs)[0];
+  int *li = ((int **)lhs)[1], *ri = ((int **)rhs)[1];
+  #pragma omp atomic
+  callback_calls++;
+  for (i = 0; i < N; ++i)
+    ld[i] += rd[i];
+  if (*ri > *li)
+    *li = *ri;
+}
+
+int test_kmp_reduce_typed()
+{
+  double sum[N];
+  int max = -1;
+  int i, nthreads = 0;
+
+  for (i = 0; i < N; ++i)
+    sum[i] = 0.0;
+  callback_calls = 0;
+
+  #pragma omp parallel
+  {
+    int j, gtid = __kmpc_global_thread_num(&loc);
+    double priv_sum[N];
+    int priv_max = omp_get_thread_num();
+    void *red_list[2];
+    kmp_reduction_item_t desc[2] = { { RED_SUM, ELEM_FLOAT64, N },
+                                     { RED_MAX, ELEM_INT32, 1 } };
+    #pragma omp single
+    nthreads = omp_get_num_threads();
+    for (j = 0; j < N; ++j)
+      priv_sum[j] = j;
+    red_list[0] = priv_sum;
+    red_list[1] = &priv_max;
+    switch (__kmpc_reduce_typed(&loc, gtid, 2, sizeof(red_list), red_list,
+                                desc, reduce_func, crit)) {
+    case 1:
+      for (j = 0; j < N; ++j)
+        sum[j] += priv_sum[j];
+      if (priv_max > max)
+        max = priv_max;
+      __kmpc_end_reduce(&loc, gtid, crit);
+      break;
+    case 2:
+      for (j = 0; j < N; ++j) {
+        #pragma omp atomic
+        sum[j] += priv_sum[j];
+      }
+      #pragma omp critical
+      if (priv_max > max)
+        max = priv_max;
+      __kmpc_end_reduce(&loc, gtid, crit);
+      break;
+    }
+  }
+
+  for (i = 0; i < N; ++i) {
+    if (sum[i] != (double)i * nthreads) {
+      fprintf(stderr, "sum[%d] = %g, expected %g\n", i, sum[i],
+              (double)i * nthreads);
+      return 0;
+    }
+  }
+  if (max != nthreads - 1) {
+    fprintf(stderr, "max = %d, expected %d\n", max, nthreads - 1);
+    return 0;
+  }
+  if (callback_calls != 0) {
+    fprintf(stderr, "reduce_func called %d times\n", callback_calls);
+    return 0;
+  }
+  return 1;
+}
+
+int main()
+{
+  int i;
+  int num_failed = 0;
+
+  omp_set_num_threads(8);
+  for (i = 0; i < REPETITIONS; i++) {
+    if (!test_kmp_reduce_typed()) {
+      num_failed++;
+    }
+  }
+  return num_failed;
+}
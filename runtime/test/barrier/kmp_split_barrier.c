@@ -0,0 +1,132 @@
+// RUN: %libomp-compile-and-run
+// RUN: env KMP_PLAIN_BARRIER_PATTERN=linear,linear %libomp-run
+// RUN: env KMP_PLAIN_BARRIER_PATTERN=tree,tree %libomp-run
+// RUN: env KMP_PLAIN_BARRIER_PATTERN=hyper,hyper %libomp-run
+// RUN: env KMP_PLAIN_BARRIER_PATTERN=hierarchical,hierarchical %libomp-run
+// RUN: env KMP_BLOCKTIME=0 %libomp-run
+#include <stdio.h>
+#include <omp.h>
+#include "omp_testsuite.h"
+
+#define NSTEPS 50
+#define NTHREADS 8
+
+int test_kmp_team_split_barrier()
+{
+  int halo[NTHREADS];
+  int errors = 0;
+
+  #pragma omp parallel num_threads(NTHREADS) shared(errors)
+  {
+    int step, interior = 0;
+    int tid = omp_get_thread_num();
+    int nthreads = omp_get_num_threads();
+    for (step = 0; step < NSTEPS; ++step) {
+      halo[tid] = step;
+      kmp_barrier_arrive();
+      interior += tid; // independent work overlapping the barrier
+      kmp_barrier_wait();
+      // every thread has published this step's halo
+      if (halo[(tid + 1) % nthreads] != step) {
+        #pragma omp atomic
+        errors++;
+      }
+      #pragma omp barrier
+    }
+    if (interior != tid * NSTEPS) {
+      #pragma omp atomic
+      errors++;
+    }
+  }
+  return errors == 0;
+}
+
+// Arriving must not wait for anybody: every thread arrives only once the
+// previous one (its parent in any gather tree) is past its own arrival, and
+// the old blocking arrival would hang here.
+int test_kmp_arrive_does_not_wait()
+{
+  int passed[NTHREADS];
+  int done = 0;
+  int i;
+
+  for (i = 0; i < NTHREADS; ++i)
+    passed[i] = 0;
+  #pragma omp parallel num_threads(NTHREADS) shared(done)
+  {
+    int tid = omp_get_thread_num();
+    int p = 0;
+    if (tid > 0) {
+      while (!p) {
+        #pragma omp atomic read
+        p = passed[tid - 1];
+      }
+    }
+    kmp_barrier_arrive();
+    #pragma omp atomic write
+    passed[tid] = 1;
+    kmp_barrier_wait();
+    #pragma omp atomic
+    done++;
+  }
+  return done == NTHREADS;
+}
+
+int test_kmp_named_barrier()
+{
+  kmp_named_barrier_t bar;
+  int counts[NTHREADS];
+  int errors = 0;
+  int i;
+
+  // only the even threads take part in the named barrier
+  kmp_init_named_barrier(&bar, NTHREADS / 2);
+  for (i = 0; i < NTHREADS; ++i)
+    counts[i] = 0;
+
+  #pragma omp parallel num_threads(NTHREADS) shared(errors)
+  {
+    int step, j, phase;
+    int tid = omp_get_thread_num();
+    if (omp_get_num_threads() == NTHREADS && tid % 2 == 0) {
+      for (step = 1; step <= NSTEPS; ++step) {
+        counts[tid] = step;
+        phase = kmp_named_barrier_arrive(&bar);
+        kmp_named_barrier_wait(&bar, phase);
+        for (j = 0; j < NTHREADS; j += 2) {
+          if (counts[j] < step) {
+            #pragma omp atomic
+            errors++;
+          }
+        }
+        // keep the next phase's writes after everybody's checks
+        phase = kmp_named_barrier_arrive(&bar);
+        kmp_named_barrier_wait(&bar, phase);
+      }
+    }
+  }
+  kmp_destroy_named_barrier(&bar);
+  return errors == 0;
+}
+
+int main()
+{
+  int i;
+  int num_failed = 0;
+
+  for (i = 0; i < REPETITIONS; i++) {
+    if (!test_kmp_team_split_barrier()) {
+      fprintf(stderr, "team split barrier failed\n");
+      num_failed++;
+    }
+    if (!test_kmp_arrive_does_not_wait()) {
+      fprintf(stderr, "team split barrier waited on arrival\n");
+      num_failed++;
+    }
+    if (!test_kmp_named_barrier()) {
+      fprintf(stderr, "named barrier failed\n");
+      num_failed++;
+    }
+  }
+  return num_failed;
+}
@@ -0,0 +1,84 @@
+// REQUIRES: stats
+// RUN: %libomp-compile && %libomp-run 2> %t.stats && %libomp-run %t.stats
+// The first run prints the statistics at exit; the second one checks that
+// the two barrier sites of the first run were recorded apart.
+#include <stdio.h>
+#include <string.h>
+#include "omp_testsuite.h"
+
+#define N 100
+
+typedef struct ident {
+  int reserved_1;
+  int flags;
+  int reserved_2;
+  int reserved_3;
+  char const *psource;
+} ident_t;
+
+extern int __kmpc_global_thread_num(ident_t *);
+extern void __kmpc_barrier(ident_t *, int);
+
+static ident_t loc_first = { 0, 2, 0, 0, ";kmp_stats_barrier_sites.c;first;40;1;;" };
+static ident_t loc_second = { 0, 2, 0, 0, ";kmp_stats_barrier_sites.c;second;50;1;;" };
+
+static void run_barriers()
+{
+  #pragma omp parallel num_threads(4)
+  {
+    int gtid = __kmpc_global_thread_num(&loc_first);
+    int i;
+    for (i = 0; i < N; i++) {
+      __kmpc_barrier(&loc_first, gtid);
+      __kmpc_barrier(&loc_second, gtid);
+    }
+  }
+}
+
+// Finds the line of the site and reads the sample count of its arrival skew,
+// which is printed scaled (e.g. "1.00 k").
+static double site_samples(FILE *f, char const *site)
+{
+  char line[1024];
+  double samples;
+  rewind(f);
+  while (fgets(line, sizeof(line), f)) {
+    if (strstr(line, site) == NULL)
+      continue;
+    if (fgets(line, sizeof(line), f) &&
+        sscanf(line, " arrival_skew , %lf", &samples) == 1)
+      return samples;
+    return -1;
+  }
+  return 0;
+}
+
+int test_kmp_stats_barrier_sites(char const *name)
+{
+  FILE *f = fopen(name, "r");
+  double first, second;
+  if (f == NULL) {
+    perror(name);
+    return 0;
+  }
+  first = site_samples(f, "kmp_stats_barrier_sites.c:40 (first)");
+  second = site_samples(f, "kmp_stats_barrier_sites.c:50 (second)");
+  fclose(f);
+  if (first <= 0 || second <= 0) {
+    fprintf(stderr, "barrier samples: first %g, second %g\n", first, second);
+    return 0;
+  }
+  return 1;
+}
+
+int main(int argc, char **argv)
+{
+  int i;
+
+  if (argc < 2) {
+    for (i = 0; i < REPETITIONS; i++)
+      run_barriers();
+    return 0;
+  }
+  return !test_kmp_stats_barrier_sites(argv[1]);
+}
@@ -0,0 +1,116 @@
+// RUN: %libomp-compile-and-run
+// RUN: env KMP_CONSISTENCY_CHECK=all %libomp-run
+// RUN: env KMP_LOCK_KIND=tas %libomp-run
+// Run with an argument to time histogram updates in a critical section with
+// and without kmp_lock_hint_combining.
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include "omp_testsuite.h"
+
+#define NTHREADS 4
+#define NBINS 61
+
+typedef struct ident {
+  int reserved_1;
+  int flags;
+  int reserved_2;
+  int reserved_3;
+  char const *psource;
+} ident_t;
+
+typedef int kmp_critical_name[8];
+
+extern void __kmpc_critical_combine(ident_t *, int, kmp_critical_name *,
+                                    uintptr_t, void (*)(void *), void *);
+extern void __kmpc_critical_with_hint(ident_t *, int, kmp_critical_name *,
+                                      uintptr_t);
+extern void __kmpc_end_critical(ident_t *, int, kmp_critical_name *);
+extern int __kmpc_global_thread_num(ident_t *);
+
+static ident_t loc = { 0, 2, 0, 0, ";kmp_critical_combine.c;test;30;1;;" };
+
+static volatile int inside;
+static int errors;
+static int hist[NBINS];
+
+// The critical body: a non-atomic histogram update that notices a second
+// thread in the critical section.
+static void add(void *p)
+{
+  int bin = *(int *)p;
+  if (inside++ != 0)
+    errors++;
+  hist[bin]++;
+  inside--;
+}
+
+int test_kmp_critical_combine(int n, uintptr_t hint)
+{
+  kmp_critical_name crit = { 0 };
+  int i;
+
+  inside = 0;
+  errors = 0;
+  for (i = 0; i < NBINS; i++)
+    hist[i] = 0;
+  #pragma omp parallel num_threads(NTHREADS)
+  {
+    int gtid = __kmpc_global_thread_num(&loc);
+    int j;
+    for (j = 0; j < n; j++) {
+      int bin = (j * 7 + omp_get_thread_num()) % NBINS;
+      if (j % 5 == 4) {
+        // the same construct entered as an inline body
+        __kmpc_critical_with_hint(&loc, gtid, &crit, hint);
+        add(&bin);
+        __kmpc_end_critical(&loc, gtid, &crit);
+      } else {
+        __kmpc_critical_combine(&loc, gtid, &crit, hint, add, &bin);
+      }
+    }
+  }
+  for (i = 0; i < NBINS; i++) {
+    int t, expected = 0;
+    for (t = 0; t < NTHREADS; t++) {
+      int j;
+      for (j = 0; j < n; j++)
+        expected += (j * 7 + t) % NBINS == i;
+    }
+    if (hist[i] != expected) {
+      fprintf(stderr, "hint %d: bin %d has %d (expected %d)\n", (int)hint, i,
+              hist[i], expected);
+      errors++;
+      break;
+    }
+  }
+  if (errors)
+    fprintf(stderr, "hint %d: %d errors\n", (int)hint, errors);
+  return errors == 0;
+}
+
+int main(int argc, char **argv)
+{
+  int i;
+  int num_failed = 0;
+
+  if (argc > 1) {
+    int n = atoi(argv[1]);
+    double t = omp_get_wtime();
+    test_kmp_critical_combine(n, omp_lock_hint_contended);
+    printf("contended: %.1f ns per update\n",
+           (omp_get_wtime() - t) * 1e9 / n / NTHREADS);
+    t = omp_get_wtime();
+    test_kmp_critical_combine(n, kmp_lock_hint_combining);
+    printf("combining: %.1f ns per update\n",
+           (omp_get_wtime() - t) * 1e9 / n / NTHREADS);
+    return 0;
+  }
+  for (i = 0; i < REPETITIONS; i++) {
+    if (!test_kmp_critical_combine(LOOPCOUNT, kmp_lock_hint_combining) ||
+        !test_kmp_critical_combine(LOOPCOUNT, omp_lock_hint_none)) {
+      num_failed++;
+    }
+  }
+  return num_failed;
+}
@@ -0,0 +1,92 @@
+// RUN: %libomp-compile-and-run
+// RUN: env KMP_CRITICAL_SPECULATION=1 KMP_CRITICAL_SPECULATION_STATS=1 %libomp-run
+// RUN: env KMP_CRITICAL_SPECULATION=1 KMP_CONSISTENCY_CHECK=all %libomp-run
+// RUN: env KMP_CRITICAL_SPECULATION=1 KMP_LOCK_KIND=tas %libomp-run
+// Critical sections keep mutual exclusion whether they speculate (on machines
+// with RTM) or not, with one lock entered from several constructs and nested
+// critical sections.
+#include <stdio.h>
+#include <stdint.h>
+#include "omp_testsuite.h"
+
+#define NTHREADS 4
+#define N 1000
+
+typedef struct ident {
+  int reserved_1;
+  int flags;
+  int reserved_2;
+  int reserved_3;
+  char const *psource;
+} ident_t;
+
+typedef int kmp_critical_name[8];
+
+extern void __kmpc_critical_with_hint(ident_t *, int, kmp_critical_name *,
+                                      uintptr_t);
+extern void __kmpc_end_critical(ident_t *, int, kmp_critical_name *);
+extern int __kmpc_global_thread_num(ident_t *);
+extern void __kmpc_critical_speculation_report(void);
+
+static ident_t loc_a = { 0, 2, 0, 0, ";kmp_critical_speculation.c;a;40;1;;" };
+static ident_t loc_b = { 0, 2, 0, 0, ";kmp_critical_speculation.c;b;50;1;;" };
+static ident_t loc_c = { 0, 2, 0, 0, ";kmp_critical_speculation.c;c;60;1;;" };
+
+static kmp_critical_name outer, inner, contended;
+static volatile int inside_outer, inside_inner;
+
+int test_kmp_critical_speculation()
+{
+  int count_a = 0, count_b = 0, count_c = 0;
+  int errors = 0;
+
+  #pragma omp parallel num_threads(NTHREADS) reduction(+:errors)
+  {
+    int gtid = __kmpc_global_thread_num(&loc_a);
+    int i;
+    for (i = 0; i < N; i++) {
+      // Two constructs on one lock; the second holds a nested critical
+      __kmpc_critical_with_hint(&loc_a, gtid, &outer, omp_lock_hint_none);
+      if (inside_outer++ != 0)
+        errors++;
+      count_a++;
+      inside_outer--;
+      __kmpc_end_critical(&loc_a, gtid, &outer);
+
+      __kmpc_critical_with_hint(&loc_b, gtid, &outer, omp_lock_hint_none);
+      if (inside_outer++ != 0)
+        errors++;
+      __kmpc_critical_with_hint(&loc_b, gtid, &inner, omp_lock_hint_none);
+      if (inside_inner++ != 0)
+        errors++;
+      count_b++;
+      inside_inner--;
+      __kmpc_end_critical(&loc_b, gtid, &inner);
+      inside_outer--;
+      __kmpc_end_critical(&loc_b, gtid, &outer);
+
+      // A hint that may pick another lock kind than the default one
+      __kmpc_critical_with_hint(&loc_c, gtid, &contended,
+                                omp_lock_hint_contended);
+      count_c++;
+      __kmpc_end_critical(&loc_c, gtid, &contended);
+    }
+  }
+  __kmpc_critical_speculation_report();
+
+  return errors == 0 && count_a == NTHREADS * N && count_b == NTHREADS * N &&
+         count_c == NTHREADS * N;
+}
+
+int main()
+{
+  int i;
+  int num_failed = 0;
+
+  for (i = 0; i < REPETITIONS; i++) {
+    if (!test_kmp_critical_speculation()) {
+      num_failed++;
+    }
+  }
+  return num_failed;
+}
@@ -0,0 +1,104 @@
+// RUN: %libomp-compile-and-run
+// RUN: env KMP_LOCK_KIND=cohort %libomp-run
+// RUN: env KMP_LOCK_KIND=cohort KMP_COHORT_LOCK_NODES=3 %libomp-run
+// RUN: env KMP_COHORT_LOCK_NODES=2 KMP_COHORT_LOCK_PASSES=0 %libomp-run
+// RUN: env KMP_COHORT_LOCK_NODES=4 KMP_COHORT_LOCK_PASSES=2 %libomp-run
+// Run with an argument to time contended lock hand overs; compare
+// KMP_LOCK_KIND=cohort with KMP_LOCK_KIND=queuing on a multi-socket machine.
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include "omp_testsuite.h"
+
+#define NTHREADS 6
+
+typedef struct ident {
+  int reserved_1;
+  int flags;
+  int reserved_2;
+  int reserved_3;
+  char const *psource;
+} ident_t;
+
+typedef int kmp_critical_name[8];
+
+extern void __kmpc_critical_with_hint(ident_t *, int, kmp_critical_name *,
+                                      uintptr_t);
+extern void __kmpc_end_critical(ident_t *, int, kmp_critical_name *);
+extern int __kmpc_global_thread_num(ident_t *);
+
+static ident_t loc = { 0, 2, 0, 0, ";kmp_cohort_lock.c;test;30;1;;" };
+static kmp_critical_name crit;
+
+static volatile int inside;
+static int counter;
+static int errors;
+
+// Non-atomic update that notices a second thread in the same critical region
+static void update(void)
+{
+  if (inside++ != 0)
+    errors++;
+  counter++;
+  inside--;
+}
+
+int test_kmp_cohort_lock(int n)
+{
+  omp_lock_t lck, hinted;
+  int expected = 3 * n * NTHREADS;
+
+  inside = 0;
+  counter = 0;
+  errors = 0;
+  omp_init_lock(&lck);
+  omp_init_lock_with_hint(&hinted, omp_lock_hint_contended);
+  #pragma omp parallel num_threads(NTHREADS)
+  {
+    int gtid = __kmpc_global_thread_num(&loc);
+    int i;
+    for (i = 0; i < n; i++) {
+      omp_set_lock(&lck);
+      update();
+      omp_unset_lock(&lck);
+
+      while (!omp_test_lock(&hinted))
+        ;
+      update();
+      omp_unset_lock(&hinted);
+
+      __kmpc_critical_with_hint(&loc, gtid, &crit, omp_lock_hint_contended);
+      update();
+      __kmpc_end_critical(&loc, gtid, &crit);
+    }
+  }
+  omp_destroy_lock(&lck);
+  omp_destroy_lock(&hinted);
+  if (counter != expected || errors) {
+    fprintf(stderr, "counter %d (expected %d), %d overlapping updates\n",
+            counter, expected, errors);
+    return 0;
+  }
+  return 1;
+}
+
+int main(int argc, char **argv)
+{
+  int i;
+  int num_failed = 0;
+
+  if (argc > 1) {
+    int n = atoi(argv[1]);
+    double t = omp_get_wtime();
+    test_kmp_cohort_lock(n);
+    printf("%.1f ns per acquisition\n",
+           (omp_get_wtime() - t) * 1e9 / (3.0 * n * NTHREADS));
+    return 0;
+  }
+  for (i = 0; i < REPETITIONS; i++) {
+    if (!test_kmp_cohort_lock(LOOPCOUNT)) {
+      num_failed++;
+    }
+  }
+  return num_failed;
+}
@@ -0,0 +1,82 @@
+// RUN: %libomp-compile-and-run
+// RUN: env KMP_LOCK_KIND=ticket %libomp-run
+// RUN: env KMP_LOCK_KIND=tas %libomp-run
+// RUN: env KMP_CONSISTENCY_CHECK=all %libomp-run
+// Threads create and destroy many locks at once, destroy locks created by
+// other threads, and reuse the slots of destroyed locks, while every lock
+// keeps protecting its own counter.
+#include <stdio.h>
+#include <stdlib.h>
+#include "omp_testsuite.h"
+
+#define NTHREADS 4
+#define NLOCKS 5000
+#define NROUNDS 4
+
+omp_lock_t locks[NTHREADS * NLOCKS];
+omp_nest_lock_t nlocks[NTHREADS * NLOCKS];
+int counts[NTHREADS * NLOCKS];
+
+int test_kmp_lock_alloc()
+{
+  int errors = 0;
+  int round, i;
+
+  for (round = 0; round < NROUNDS; round++) {
+    for (i = 0; i < NTHREADS * NLOCKS; i++)
+      counts[i] = 0;
+
+    #pragma omp parallel num_threads(NTHREADS) private(i)
+    {
+      // Each thread creates its share of the locks
+      int me = omp_get_thread_num();
+      for (i = me * NLOCKS; i < (me + 1) * NLOCKS; i++) {
+        omp_init_lock(&locks[i]);
+        omp_init_nest_lock(&nlocks[i]);
+      }
+      #pragma omp barrier
+
+      // Everybody uses every lock
+      for (i = 0; i < NTHREADS * NLOCKS; i++) {
+        int j = (i + me * NLOCKS) % (NTHREADS * NLOCKS);
+        omp_set_lock(&locks[j]);
+        omp_set_nest_lock(&nlocks[j]);
+        omp_set_nest_lock(&nlocks[j]);
+        counts[j]++;
+        omp_unset_nest_lock(&nlocks[j]);
+        omp_unset_nest_lock(&nlocks[j]);
+        omp_unset_lock(&locks[j]);
+      }
+      #pragma omp barrier
+
+      // Another thread destroys the locks
+      me = (me + 1) % NTHREADS;
+      for (i = me * NLOCKS; i < (me + 1) * NLOCKS; i++) {
+        omp_destroy_nest_lock(&nlocks[i]);
+        omp_destroy_lock(&locks[i]);
+      }
+    }
+
+    for (i = 0; i < NTHREADS * NLOCKS; i++) {
+      if (counts[i] != NTHREADS) {
+        fprintf(stderr, "lock %d was taken %d times\n", i, counts[i]);
+        errors++;
+        break;
+      }
+    }
+  }
+  return errors == 0;
+}
+
+int main()
+{
+  int i;
+  int num_failed = 0;
+
+  for (i = 0; i < REPETITIONS; i++) {
+    if (!test_kmp_lock_alloc()) {
+      num_failed++;
+    }
+  }
+  return num_failed;
+}
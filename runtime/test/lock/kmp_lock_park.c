@@ -0,0 +1,130 @@
+// RUN: %libomp-compile-and-run
+// RUN: env KMP_LOCK_PARK=1 KMP_LOCK_KIND=queuing %libomp-run
+// RUN: env KMP_LOCK_PARK=1 KMP_LOCK_KIND=ticket %libomp-run
+// RUN: env KMP_LOCK_PARK=1 KMP_LOCK_KIND=queuing KMP_BLOCKTIME=0 %libomp-run
+// RUN: env KMP_LOCK_PARK=1 KMP_LOCK_KIND=ticket KMP_BLOCKTIME=0 %libomp-run
+// RUN: env KMP_LOCK_PARK=1 KMP_LOCK_KIND=ticket KMP_BLOCKTIME=infinite %libomp-run
+#include <stdio.h>
+#include <stdlib.h>
+#include "omp_testsuite.h"
+#include "omp_my_sleep.h"
+
+// Oversubscribe so that waiters have to get out of the way of the holder
+#define NTHREADS 8
+#define NWAITERS 4
+
+omp_lock_t lck;
+omp_nest_lock_t nlck;
+
+// Waiters queue up one after another on a held lock and must get it in that
+// order, whether they spin or sleep.
+int test_fifo()
+{
+  int order[NWAITERS + 1];
+  int arrived = 0;
+  int served = 0;
+  int i, errors = 0;
+
+  omp_init_lock(&lck);
+  #pragma omp parallel num_threads(NWAITERS + 1) shared(arrived, served)
+  {
+    int me = omp_get_thread_num();
+    if (me == 0) {
+      omp_set_lock(&lck);
+      #pragma omp barrier
+      while (1) {
+        int a;
+        #pragma omp atomic read
+        a = arrived;
+        if (a == NWAITERS)
+          break;
+        my_sleep(0.001);
+      }
+      my_sleep(0.02);
+      order[served++] = 0;
+      omp_unset_lock(&lck);
+    } else {
+      #pragma omp barrier
+      while (1) {
+        int a;
+        #pragma omp atomic read
+        a = arrived;
+        if (a == me - 1)
+          break;
+        my_sleep(0.001);
+      }
+      // give the previous waiter time to queue up
+      my_sleep(0.01);
+      #pragma omp atomic
+      arrived++;
+      omp_set_lock(&lck);
+      order[served++] = me;
+      omp_unset_lock(&lck);
+    }
+  }
+  omp_destroy_lock(&lck);
+
+  for (i = 0; i <= NWAITERS; i++) {
+    if (order[i] != i) {
+      fprintf(stderr, "waiter %d acquired the lock in place %d\n", order[i], i);
+      errors++;
+    }
+  }
+  return errors == 0;
+}
+
+int test_mutual_exclusion()
+{
+  int in_lock = 0;
+  int result = 0;
+  int count = 0;
+  int i;
+
+  omp_init_lock(&lck);
+  omp_init_nest_lock(&nlck);
+  #pragma omp parallel num_threads(NTHREADS)
+  {
+    #pragma omp for
+    for (i = 0; i < LOOPCOUNT; i++) {
+      omp_set_lock(&lck);
+      in_lock++;
+      #pragma omp flush
+      if (i % 64 == 0)
+        my_sleep(1e-4);
+      result += in_lock - 1;
+      count++;
+      in_lock--;
+      omp_unset_lock(&lck);
+
+      omp_set_nest_lock(&nlck);
+      omp_set_nest_lock(&nlck);
+      count++;
+      omp_unset_nest_lock(&nlck);
+      omp_unset_nest_lock(&nlck);
+
+      #pragma omp critical
+      count++;
+    }
+  }
+  omp_destroy_nest_lock(&nlck);
+  omp_destroy_lock(&lck);
+
+  return result == 0 && count == 3 * LOOPCOUNT;
+}
+
+int main()
+{
+  int i;
+  int num_failed = 0;
+
+  for (i = 0; i < REPETITIONS; i++) {
+    if (!test_mutual_exclusion()) {
+      num_failed++;
+    }
+  }
+  // only the queuing and ticket locks are FIFO
+  if (getenv("KMP_LOCK_KIND") && !test_fifo()) {
+    num_failed++;
+  }
+  return num_failed;
+}
@@ -0,0 +1,199 @@
+// RUN: %libomp-compile-and-run
+// RUN: env KMP_LOCK_PROFILE=1 %libomp-run
+// RUN: env KMP_LOCK_PROFILE=1 KMP_LOCK_KIND=tas %libomp-run
+// RUN: env KMP_LOCK_PROFILE=1 KMP_CONSISTENCY_CHECK=all %libomp-run
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "omp_testsuite.h"
+#include "omp_my_sleep.h"
+
+#define NTHREADS 4
+#define N 100
+#define NMANY 2000
+#define NFIRST 10
+#define NSECOND 3
+
+typedef struct ident {
+  int reserved_1;
+  int flags;
+  int reserved_2;
+  int reserved_3;
+  char const *psource;
+} ident_t;
+
+typedef int kmp_critical_name[8];
+
+extern void __kmpc_critical(ident_t *, int, kmp_critical_name *);
+extern void __kmpc_end_critical(ident_t *, int, kmp_critical_name *);
+extern void __kmpc_init_lock(ident_t *, int, void **);
+extern int __kmpc_global_thread_num(ident_t *);
+extern void __kmpc_lock_profile_report(void);
+extern void __kmpc_lock_profile_reset(void);
+
+static ident_t loc_crit = { 0, 2, 0, 0, ";kmp_lock_profile.c;crit;40;1;;" };
+static ident_t loc_lock = { 0, 2, 0, 0, ";kmp_lock_profile.c;userlock;50;1;;" };
+static ident_t loc_many = { 0, 2, 0, 0, ";kmp_lock_profile.c;manylocks;60;1;;" };
+
+static kmp_critical_name crit;
+static omp_lock_t lck;
+static omp_lock_t many[NMANY];
+
+typedef struct row {
+  unsigned long long acquires, contended, failed, wait, max_wait, mean, hold;
+} row_t;
+
+// Finds the report line of a lock: by the function of its location, or by
+// its address when it has no location.
+static int find_row(FILE *f, char const *func, void *addr, row_t *r)
+{
+  char line[512], name[64], ptr[64];
+  rewind(f);
+  snprintf(name, sizeof(name), "(%s),", func);
+  snprintf(ptr, sizeof(ptr), "lock %p,", addr);
+  while (fgets(line, sizeof(line), f)) {
+    char *p = strstr(line, name);
+    if (p)
+      p += strlen(name);
+    else if (strncmp(line, ptr, strlen(ptr)) == 0)
+      p = line + strlen(ptr);
+    else
+      continue;
+    return sscanf(p, "%llu, %llu, %llu, %llu, %llu, %llu, %llu", &r->acquires,
+                  &r->contended, &r->failed, &r->wait, &r->max_wait, &r->mean,
+                  &r->hold) == 7;
+  }
+  return 0;
+}
+
+// Counts the report lines of locks without a location acquired n times.
+static int count_rows(FILE *f, unsigned long long n)
+{
+  char line[512];
+  unsigned long long acquires;
+  int count = 0;
+  rewind(f);
+  while (fgets(line, sizeof(line), f)) {
+    char *p = strchr(line, ',');
+    if (strncmp(line, "lock ", 5) == 0 && p &&
+        sscanf(p + 1, "%llu", &acquires) == 1 && acquires == n)
+      count++;
+  }
+  return count;
+}
+
+int test_kmp_lock_profile(int profiled, int direct)
+{
+  FILE *f = tmpfile();
+  int saved, errors = 0;
+  int i, gtid = __kmpc_global_thread_num(&loc_many);
+  omp_lock_t reused;
+  row_t r;
+
+  __kmpc_init_lock(&loc_lock, __kmpc_global_thread_num(&loc_lock),
+                   (void **)&lck);
+  __kmpc_lock_profile_reset();
+  #pragma omp parallel num_threads(NTHREADS)
+  {
+    int gtid = __kmpc_global_thread_num(&loc_crit);
+    int i;
+    for (i = 0; i < N; i++) {
+      __kmpc_critical(&loc_crit, gtid, &crit);
+      my_sleep(1e-5);
+      __kmpc_end_critical(&loc_crit, gtid, &crit);
+      if (i % 2)
+        omp_set_lock(&lck);
+      else
+        while (!omp_test_lock(&lck))
+          ;
+      my_sleep(1e-5);
+      omp_unset_lock(&lck);
+    }
+  }
+
+  // More locks from one place than the profile has entries
+  for (i = 0; i < NMANY; i++) {
+    __kmpc_init_lock(&loc_many, gtid, (void **)&many[i]);
+    omp_set_lock(&many[i]);
+    omp_unset_lock(&many[i]);
+  }
+  for (i = 0; i < NMANY; i++)
+    omp_destroy_lock(&many[i]);
+
+  // A lock without a location, destroyed and made again in its place
+  omp_init_lock(&reused);
+  for (i = 0; i < NFIRST; i++) {
+    omp_set_lock(&reused);
+    omp_unset_lock(&reused);
+  }
+  omp_destroy_lock(&reused);
+  omp_init_lock(&reused);
+  for (i = 0; i < NSECOND; i++) {
+    omp_set_lock(&reused);
+    omp_unset_lock(&reused);
+  }
+
+  // Catch the report on stderr
+  fflush(stderr);
+  saved = dup(2);
+  dup2(fileno(f), 2);
+  __kmpc_lock_profile_report();
+  fflush(stderr);
+  dup2(saved, 2);
+  close(saved);
+  omp_destroy_lock(&lck);
+  omp_destroy_lock(&reused);
+
+  if (!profiled) {
+    if (find_row(f, "crit", &crit, &r)) {
+      fprintf(stderr, "unexpected report without KMP_LOCK_PROFILE\n");
+      errors++;
+    }
+  } else {
+    if (!find_row(f, "crit", &crit, &r) || r.acquires != N * NTHREADS ||
+        r.contended > r.acquires || r.failed != 0 || r.max_wait > r.wait ||
+        r.hold == 0) {
+      fprintf(stderr, "critical: %llu acquires, %llu contended, %llu hold\n",
+              r.acquires, r.contended, r.hold);
+      errors++;
+    }
+    if (!find_row(f, "userlock", &lck, &r) || r.acquires != N * NTHREADS ||
+        r.contended > N * NTHREADS / 2 || r.hold == 0) {
+      fprintf(stderr, "lock: %llu acquires, %llu contended, %llu hold\n",
+              r.acquires, r.contended, r.hold);
+      errors++;
+    }
+    // Direct locks have no location
+    if (!direct && (!find_row(f, "manylocks", NULL, &r) ||
+                    r.acquires != NMANY || r.contended != 0 || r.hold == 0)) {
+      fprintf(stderr, "many locks: %llu acquires\n", r.acquires);
+      errors++;
+    }
+    // The first lock's row may be gone to make room
+    if (count_rows(f, NFIRST + NSECOND) != 0 || count_rows(f, NSECOND) != 1) {
+      fprintf(stderr, "reused lock: %d rows of %d, %d rows of %d\n",
+              count_rows(f, NFIRST + NSECOND), NFIRST + NSECOND,
+              count_rows(f, NSECOND), NSECOND);
+      errors++;
+    }
+  }
+  fclose(f);
+  return errors == 0;
+}
+
+int main()
+{
+  int i;
+  int num_failed = 0;
+  int profiled = getenv("KMP_LOCK_PROFILE") != NULL;
+  char const *kind = getenv("KMP_LOCK_KIND");
+  int direct = kind && (!strcmp(kind, "tas") || !strcmp(kind, "futex"));
+
+  for (i = 0; i < REPETITIONS; i++) {
+    if (!test_kmp_lock_profile(profiled, direct)) {
+      num_failed++;
+    }
+  }
+  return num_failed;
+}
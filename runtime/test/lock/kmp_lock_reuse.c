@@ -0,0 +1,80 @@
+// RUN: %libomp-compile-and-run
+// RUN: env KMP_LOCK_KIND=ticket %libomp-run
+// RUN: env KMP_CONSISTENCY_CHECK=all %libomp-run
+// One thread creates the locks and another one destroys them, round after
+// round: the destroyed locks must come back to the creating thread instead of
+// growing the lock table forever. After a few rounds the table has to stop
+// growing; it may still settle a little as the destroying thread keeps a
+// varying number of locks for itself, but far from another round's worth.
+#include <stdio.h>
+#include "omp_testsuite.h"
+
+#define NLOCKS 3000
+#define NROUNDS 50
+#define SETTLED 10
+
+omp_lock_t locks[NLOCKS];
+
+// On Linux, omp_lock_t holds twice the lock table index of indirect locks
+static unsigned table_index(omp_lock_t *lck)
+{
+#if defined(__linux__)
+  unsigned word = *(unsigned *)lck;
+  return (word & 1) ? 0 : word >> 1;
+#else
+  return 0;
+#endif
+}
+
+int test_kmp_lock_reuse()
+{
+  unsigned max_settled = 0, max_index = 0;
+  int errors = 0;
+
+  #pragma omp parallel num_threads(2) reduction(+:errors)
+  {
+    int me = omp_get_thread_num();
+    int round, i;
+    for (round = 0; round < NROUNDS; round++) {
+      if (me == 0) {
+        for (i = 0; i < NLOCKS; i++) {
+          omp_init_lock(&locks[i]);
+          if (table_index(&locks[i]) > max_index)
+            max_index = table_index(&locks[i]);
+        }
+        if (round == SETTLED)
+          max_settled = max_index;
+      }
+      #pragma omp barrier
+      for (i = me; i < NLOCKS; i += 2) {
+        omp_set_lock(&locks[i]);
+        omp_unset_lock(&locks[i]);
+      }
+      #pragma omp barrier
+      if (me == 1 || omp_get_num_threads() == 1) {
+        for (i = 0; i < NLOCKS; i++)
+          omp_destroy_lock(&locks[i]);
+      }
+      #pragma omp barrier
+    }
+  }
+  if (max_index - max_settled >= NLOCKS / 2 || max_index >= 2 * NLOCKS) {
+    fprintf(stderr, "lock table grew from %u to %u after round %d\n",
+            max_settled, max_index, SETTLED);
+    errors++;
+  }
+  return errors == 0;
+}
+
+int main()
+{
+  int i;
+  int num_failed = 0;
+
+  for (i = 0; i < REPETITIONS; i++) {
+    if (!test_kmp_lock_reuse()) {
+      num_failed++;
+    }
+  }
+  return num_failed;
+}
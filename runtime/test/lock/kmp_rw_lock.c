@@ -0,0 +1,147 @@
+// RUN: %libomp-compile-and-run
+// RUN: env KMP_CONSISTENCY_CHECK=all %libomp-run
+// Run with an argument (iterations[,percent writes]) to time a read-mostly
+// mix; compare with the same mix on an omp_lock_t by setting percent to -1.
+#include <stdio.h>
+#include <stdlib.h>
+#include "omp_testsuite.h"
+#include "omp_my_sleep.h"
+
+#define NTHREADS 4
+#define NELEMS 16
+
+static int data[NELEMS];
+static int readers, writers, max_readers;
+static int errors;
+
+// A writer bumps every element; a reader that sees them differ or meets a
+// writer inside the lock counts an error.
+static void write_data(void)
+{
+  int i;
+  #pragma omp atomic
+  writers++;
+  if (writers != 1 || readers != 0)
+    errors++;
+  for (i = 0; i < NELEMS; i++)
+    data[i]++;
+  #pragma omp atomic
+  writers--;
+}
+
+static void read_data(double hold)
+{
+  int i, r;
+  #pragma omp atomic capture
+  r = ++readers;
+  if (r > max_readers)
+    max_readers = r;
+  if (writers != 0)
+    errors++;
+  for (i = 1; i < NELEMS; i++) {
+    if (data[i] != data[0])
+      errors++;
+  }
+  if (hold > 0)
+    my_sleep(hold);
+  #pragma omp atomic
+  readers--;
+}
+
+int test_kmp_rw_lock(int n, int percent, double hold)
+{
+  kmp_rw_lock_t rw;
+  omp_lock_t lck;
+  int i, expected = 0;
+
+  for (i = 0; i < NELEMS; i++)
+    data[i] = 0;
+  readers = writers = max_readers = 0;
+  errors = 0;
+  kmp_rw_lock_init(&rw);
+  omp_init_lock(&lck);
+
+  // A read lock keeps writers out, and a write lock keeps everybody out
+  kmp_rw_lock_rdlock(&rw);
+  if (kmp_rw_lock_trywrlock(&rw) || !kmp_rw_lock_tryrdlock(&rw))
+    errors++;
+  else
+    kmp_rw_lock_unlock(&rw);
+  kmp_rw_lock_unlock(&rw);
+  kmp_rw_lock_wrlock(&rw);
+  #pragma omp parallel num_threads(2)
+  {
+    if (omp_get_thread_num() == 1 &&
+        (kmp_rw_lock_tryrdlock(&rw) || kmp_rw_lock_trywrlock(&rw)))
+      errors++;
+  }
+  kmp_rw_lock_unlock(&rw);
+
+  #pragma omp parallel num_threads(NTHREADS)
+  {
+    int j;
+    for (j = 0; j < n; j++) {
+      int write = (j * 7 + omp_get_thread_num()) % 100 < percent;
+      if (percent < 0) {
+        omp_set_lock(&lck);
+        read_data(0);
+        omp_unset_lock(&lck);
+      } else if (write) {
+        if (j % 2 == 0)
+          kmp_rw_lock_wrlock(&rw);
+        else
+          while (!kmp_rw_lock_trywrlock(&rw))
+            ;
+        write_data();
+        kmp_rw_lock_unlock(&rw);
+      } else {
+        if (j % 2 == 0)
+          kmp_rw_lock_rdlock(&rw);
+        else
+          while (!kmp_rw_lock_tryrdlock(&rw))
+            ;
+        read_data(hold);
+        kmp_rw_lock_unlock(&rw);
+      }
+    }
+  }
+  for (i = 0; i < NTHREADS; i++) {
+    int j;
+    for (j = 0; j < n; j++)
+      expected += (j * 7 + i) % 100 < percent;
+  }
+  kmp_rw_lock_destroy(&rw);
+  omp_destroy_lock(&lck);
+  if (data[0] != expected || errors) {
+    fprintf(stderr, "%d writes (expected %d), %d errors\n", data[0], expected,
+            errors);
+    return 0;
+  }
+  return 1;
+}
+
+int main(int argc, char **argv)
+{
+  int i;
+  int num_failed = 0;
+
+  if (argc > 1) {
+    int n = atoi(argv[1]);
+    double t = omp_get_wtime();
+    test_kmp_rw_lock(n, argc > 2 ? atoi(argv[2]) : 5, 0);
+    printf("%.1f ns per acquisition\n",
+           (omp_get_wtime() - t) * 1e9 / ((double)n * NTHREADS));
+    return 0;
+  }
+  for (i = 0; i < REPETITIONS; i++) {
+    if (!test_kmp_rw_lock(LOOPCOUNT, 10, 1e-5)) {
+      num_failed++;
+    }
+  }
+  // Readers held the lock together at least once
+  if (max_readers < 2) {
+    fprintf(stderr, "readers never overlapped\n");
+    num_failed++;
+  }
+  return num_failed;
+}
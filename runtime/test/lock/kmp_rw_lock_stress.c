@@ -0,0 +1,77 @@
+// RUN: %libomp-compile-and-run
+// Several readers and writers hammer one reader-writer lock with short
+// critical sections, so that a writer raising its flag races with readers
+// coming in; nobody may ever find a writer next to anybody else.
+#include <stdio.h>
+#include "omp_testsuite.h"
+
+#define NTHREADS 8
+#define N 20000
+
+static kmp_rw_lock_t rw;
+static int readers, writers;
+static int overlaps;
+
+int test_kmp_rw_lock_stress()
+{
+  int writes = 0;
+
+  overlaps = 0;
+  readers = writers = 0;
+  kmp_rw_lock_init(&rw);
+  #pragma omp parallel num_threads(NTHREADS) reduction(+:writes)
+  {
+    int me = omp_get_thread_num();
+    int j, r, w;
+    for (j = 0; j < N; j++) {
+      if (me % 2 == 0 || j % 64 == 0) {
+        // writers: every other thread, and the readers now and then
+        kmp_rw_lock_wrlock(&rw);
+        #pragma omp atomic capture
+        w = ++writers;
+        #pragma omp atomic read
+        r = readers;
+        if (w != 1 || r != 0) {
+          #pragma omp atomic
+          overlaps++;
+        }
+        writes++;
+        #pragma omp atomic
+        writers--;
+        kmp_rw_lock_unlock(&rw);
+      } else {
+        kmp_rw_lock_rdlock(&rw);
+        #pragma omp atomic
+        readers++;
+        #pragma omp atomic read
+        w = writers;
+        if (w != 0) {
+          #pragma omp atomic
+          overlaps++;
+        }
+        #pragma omp atomic
+        readers--;
+        kmp_rw_lock_unlock(&rw);
+      }
+    }
+  }
+  kmp_rw_lock_destroy(&rw);
+  if (overlaps) {
+    fprintf(stderr, "%d overlaps in %d writes\n", overlaps, writes);
+    return 0;
+  }
+  return 1;
+}
+
+int main()
+{
+  int i;
+  int num_failed = 0;
+
+  for (i = 0; i < REPETITIONS; i++) {
+    if (!test_kmp_rw_lock_stress()) {
+      num_failed++;
+    }
+  }
+  return num_failed;
+}
@@ -0,0 +1,94 @@
+// RUN: %libomp-compile-and-run
+// RUN: env KMP_LOCK_KIND=tuned %libomp-run
+// RUN: env KMP_LOCK_KIND=tuned KMP_COHORT_LOCK_NODES=2 %libomp-run
+// RUN: env KMP_LOCK_KIND=tuned KMP_CONSISTENCY_CHECK=all %libomp-run
+// Run with an argument (iterations[,hold seconds]) to time the phases; compare
+// KMP_LOCK_KIND=tuned with tas and queuing.
+#include <stdio.h>
+#include <stdlib.h>
+#include "omp_testsuite.h"
+#include "omp_my_sleep.h"
+
+#define NTHREADS 4
+
+static volatile int inside;
+static int counter;
+static int errors;
+
+// Non-atomic update that notices a second thread in the lock; a hold time
+// keeps the lock long enough for the other threads to queue up.
+static void update(double hold)
+{
+  if (inside++ != 0)
+    errors++;
+  counter++;
+  if (hold > 0)
+    my_sleep(hold);
+  inside--;
+}
+
+// Alternates contended and uncontended phases so the lock switches its mode
+// in both directions, with omp_set_lock and omp_test_lock.
+int test_kmp_tuned_lock(int n, double hold)
+{
+  omp_lock_t lck;
+  int phase, expected = 0;
+
+  inside = 0;
+  counter = 0;
+  errors = 0;
+  omp_init_lock(&lck);
+  for (phase = 0; phase < 4; phase++) {
+    #pragma omp parallel num_threads(NTHREADS)
+    {
+      int i;
+      if (phase % 2 == 0) {
+        for (i = 0; i < n; i++) {
+          omp_set_lock(&lck);
+          update(hold);
+          omp_unset_lock(&lck);
+        }
+      } else if (omp_get_thread_num() == 0) {
+        for (i = 0; i < n * NTHREADS; i++) {
+          if (i % 2) {
+            omp_set_lock(&lck);
+          } else {
+            while (!omp_test_lock(&lck))
+              ;
+          }
+          update(0);
+          omp_unset_lock(&lck);
+        }
+      }
+    }
+    expected += n * NTHREADS;
+  }
+  omp_destroy_lock(&lck);
+  if (counter != expected || errors) {
+    fprintf(stderr, "counter %d (expected %d), %d overlapping updates\n",
+            counter, expected, errors);
+    return 0;
+  }
+  return 1;
+}
+
+int main(int argc, char **argv)
+{
+  int i;
+  int num_failed = 0;
+
+  if (argc > 1) {
+    int n = atoi(argv[1]);
+    double t = omp_get_wtime();
+    test_kmp_tuned_lock(n, argc > 2 ? atof(argv[2]) : 0);
+    printf("%.1f ns per acquisition\n",
+           (omp_get_wtime() - t) * 1e9 / (4.0 * n * NTHREADS));
+    return 0;
+  }
+  for (i = 0; i < REPETITIONS; i++) {
+    if (!test_kmp_tuned_lock(LOOPCOUNT, 1e-5)) {
+      num_failed++;
+    }
+  }
+  return num_failed;
+}
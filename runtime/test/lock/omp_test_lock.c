@@ -1,6 +1,7 @@
 // RUN: %libomp-compile-and-run
 // RUN: env KMP_LOCK_KIND=tas %libomp-run
 // RUN: env KMP_LOCK_KIND=futex %libomp-run
+// RUN: env KMP_LOCK_KIND=cohort KMP_COHORT_LOCK_NODES=2 %libomp-run
 #include <stdio.h>
 #include "omp_testsuite.h"
 
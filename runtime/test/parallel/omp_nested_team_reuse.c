@@ -0,0 +1,139 @@
+// RUN: %libomp-compile-and-run
+// RUN: env KMP_HOT_TEAMS_MAX_LEVEL=1 %libomp-run
+// RUN: env KMP_HOT_TEAMS_MAX_LEVEL=2 KMP_HOT_TEAMS_MODE=1 %libomp-run
+#include <stdio.h>
+#include "omp_testsuite.h"
+
+#define NSTEPS 100
+#define NFORKS 20
+
+// The address of a threadprivate variable tells the threads apart
+static int thread_tag;
+#pragma omp threadprivate(thread_tag)
+
+// Nested regions alternate between team sizes so that inner teams are parked
+// in the team pool and handed out again under different parents and sizes.
+int test_omp_nested_team_reuse()
+{
+  int errors = 0;
+  int step;
+
+  omp_set_nested(1);
+  for (step = 0; step < NSTEPS; ++step) {
+    int outer = (step % 2) ? 2 : 3;
+    #pragma omp parallel num_threads(outer) shared(errors)
+    {
+      int inner = (omp_get_thread_num() + step) % 3 + 1;
+      int count = 0;
+      if (omp_get_level() != 1) {
+        #pragma omp atomic
+        errors++;
+      }
+      #pragma omp parallel num_threads(inner) shared(count)
+      {
+        if (omp_get_level() != 2 || omp_get_num_threads() > inner) {
+          #pragma omp atomic
+          errors++;
+        }
+        #pragma omp atomic
+        count++;
+        #pragma omp barrier
+        #pragma omp for schedule(static, 7)
+        for (int i = 0; i < 100; ++i) {
+          #pragma omp atomic
+          count++;
+        }
+      }
+      if (count < 101) {
+        #pragma omp atomic
+        errors++;
+      }
+    }
+  }
+  return errors == 0;
+}
+
+// Two masters fork the same nested region at the same time, taking turns at
+// forking first.  The first one to fork would get the lowest idle threads;
+// each master must get the workers of its own previous fork back instead.
+static int started[NFORKS][2];
+
+static void wait_started(int fork, int who)
+{
+  int done = 0;
+  while (!done) {
+    #pragma omp atomic read
+    done = started[fork][who];
+  }
+}
+
+int test_omp_nested_team_reuse_workers()
+{
+  int *tags[2][NFORKS][3];
+  int sizes[2][NFORKS];
+  int outer = 0;
+  int errors = 0;
+  int m, k, t;
+
+  for (k = 0; k < NFORKS; ++k)
+    started[k][0] = started[k][1] = 0;
+  omp_set_nested(1);
+  #pragma omp parallel num_threads(2) shared(outer)
+  {
+    int me = omp_get_thread_num();
+    int fork;
+    #pragma omp master
+    outer = omp_get_num_threads();
+    #pragma omp barrier
+    for (fork = 0; fork < NFORKS && outer == 2; ++fork) {
+      int second = (me != fork % 2);
+      if (second)
+        wait_started(fork, 0);
+      // the first team stays up until the second one is formed
+      #pragma omp parallel num_threads(3)
+      {
+        tags[me][fork][omp_get_thread_num()] = &thread_tag;
+        #pragma omp master
+        {
+          sizes[me][fork] = omp_get_num_threads();
+          #pragma omp atomic write
+          started[fork][second] = 1;
+          if (!second)
+            wait_started(fork, 1);
+        }
+      }
+      #pragma omp barrier
+    }
+  }
+  if (outer != 2)
+    return 1; // no second master to check
+  for (m = 0; m < 2; ++m) {
+    if (sizes[m][0] != 3)
+      continue;
+    for (k = 1; k < NFORKS; ++k) {
+      for (t = 1; t < 3; ++t) {
+        if (sizes[m][k] == 3 && tags[m][k][t] != tags[m][0][t]) {
+          fprintf(stderr, "master %d fork %d: worker %d changed\n", m, k, t);
+          errors++;
+        }
+      }
+    }
+  }
+  return errors == 0;
+}
+
+int main()
+{
+  int i;
+  int num_failed = 0;
+
+  for (i = 0; i < REPETITIONS; i++) {
+    if (!test_omp_nested_team_reuse()) {
+      num_failed++;
+    }
+    if (!test_omp_nested_team_reuse_workers()) {
+      num_failed++;
+    }
+  }
+  return num_failed;
+}
@@ -0,0 +1,146 @@
+// RUN: %libomp-compile-and-run
+// RUN: env KMP_DISPATCH_FAST_PATH=0 %libomp-run
+// Run with an argument to time the dispatch of one-iteration chunks; compare
+// with KMP_DISPATCH_FAST_PATH=0 for the cost of the general path.
+#include <stdio.h>
+#include <stdlib.h>
+#include <omp.h>
+#include "omp_testsuite.h"
+
+#define N 2000
+
+typedef struct ident {
+  int reserved_1;
+  int flags;
+  int reserved_2;
+  int reserved_3;
+  char const *psource;
+} ident_t;
+
+// enum sched_type
+#define kmp_sch_dynamic_chunked 35
+#define kmp_sch_guided_chunked 36
+
+extern int __kmpc_global_thread_num(ident_t *);
+extern void __kmpc_dispatch_init_4(ident_t *, int, int, int, int, int, int);
+extern int __kmpc_dispatch_next_4(ident_t *, int, int *, int *, int *, int *);
+extern void __kmpc_dispatch_init_4u(ident_t *, int, int, unsigned, unsigned,
+                                    int, int);
+extern int __kmpc_dispatch_next_4u(ident_t *, int, int *, unsigned *,
+                                   unsigned *, int *);
+extern void __kmpc_dispatch_init_8(ident_t *, int, int, long long, long long,
+                                   long long, long long);
+extern int __kmpc_dispatch_next_8(ident_t *, int, int *, long long *,
+                                  long long *, long long *);
+extern void __kmpc_dispatch_init_8u(ident_t *, int, int, unsigned long long,
+                                    unsigned long long, long long, long long);
+extern int __kmpc_dispatch_next_8u(ident_t *, int, int *, unsigned long long *,
+                                   unsigned long long *, long long *);
+
+static ident_t loc = { 0, 2, 0, 0, ";unknown;unknown;0;0;;" };
+static int hits[N];
+
+// Runs the loop lo..hi by st (hi included, st may be negative) through the
+// entry point of type T and checks every iteration runs once and exactly one
+// chunk is flagged last.
+#define TEST_LOOP(SUFFIX, T, ST, sched, lo, hi, st, chunk)                     \
+  {                                                                            \
+    int lasts = 0, n = (int)(((hi) - (lo)) / (st)) + 1;                        \
+    for (i = 0; i < n; i++)                                                    \
+      hits[i] = 0;                                                             \
+    _Pragma("omp parallel num_threads(4)")                                     \
+    {                                                                          \
+      int gtid = __kmpc_global_thread_num(&loc);                               \
+      int last = 0;                                                            \
+      T lb, ub, j;                                                             \
+      ST stride;                                                               \
+      __kmpc_dispatch_init_##SUFFIX(&loc, gtid, sched, lo, hi, st, chunk);     \
+      while (__kmpc_dispatch_next_##SUFFIX(&loc, gtid, &last, &lb, &ub,        \
+                                           &stride)) {                         \
+        if (stride != (st)) {                                                  \
+          _Pragma("omp atomic")                                                \
+          errors++;                                                            \
+          break;                                                               \
+        }                                                                      \
+        for (j = lb; (st) > 0 ? j <= ub : j >= ub; j += stride) {              \
+          _Pragma("omp atomic")                                                \
+          hits[(int)((j - (lo)) / (st))]++;                                    \
+        }                                                                      \
+        if (last) {                                                            \
+          _Pragma("omp atomic")                                                \
+          lasts++;                                                             \
+        }                                                                      \
+      }                                                                        \
+    }                                                                          \
+    for (i = 0; i < n; i++) {                                                  \
+      if (hits[i] != 1) {                                                      \
+        fprintf(stderr, #SUFFIX " sched %d: iteration %d ran %d times\n",      \
+                sched, i, hits[i]);                                            \
+        errors++;                                                              \
+        break;                                                                 \
+      }                                                                        \
+    }                                                                          \
+    if (lasts != 1) {                                                          \
+      fprintf(stderr, #SUFFIX " sched %d: %d last chunks\n", sched, lasts);    \
+      errors++;                                                                \
+    }                                                                          \
+  }
+
+int test_kmp_dispatch_fast_path(int sched)
+{
+  int i, errors = 0;
+
+  TEST_LOOP(4, int, int, sched, 0, N - 1, 1, 7)
+  TEST_LOOP(4, int, int, sched, N - 1, 0, -1, 1)
+  TEST_LOOP(4u, unsigned, int, sched, 3000000000u, 3000000000u + 3 * (N - 1),
+            3, 5)
+  TEST_LOOP(8, long long, long long, sched, -5000000000LL,
+            -5000000000LL + 2 * (N - 1), 2, 3)
+  TEST_LOOP(8u, unsigned long long, long long, sched, 10ULL, 10ULL + N - 1, 1,
+            64)
+  return errors == 0;
+}
+
+// Time per chunk of nloops executions of a loop of n iterations with chunk
+// size 1 and an empty body; includes the loop start under guided.
+double bench(int sched, int n, int nloops, int nthreads)
+{
+  long long chunks = 0;
+  double t = omp_get_wtime();
+  #pragma omp parallel num_threads(nthreads) reduction(+:chunks)
+  {
+    int gtid = __kmpc_global_thread_num(&loc);
+    int lb, ub, st, last, l;
+    for (l = 0; l < nloops; l++) {
+      __kmpc_dispatch_init_4(&loc, gtid, sched, 0, n - 1, 1, 1);
+      while (__kmpc_dispatch_next_4(&loc, gtid, &last, &lb, &ub, &st))
+        chunks++;
+    }
+  }
+  return (omp_get_wtime() - t) * 1e9 / chunks;
+}
+
+int main(int argc, char **argv)
+{
+  int i;
+  int num_failed = 0;
+
+  if (argc > 1) {
+    int nloops = argc > 2 ? atoi(argv[2]) : 100;
+    int nthreads = argc > 3 ? atoi(argv[3]) : omp_get_num_procs();
+    printf("threads=%d\n", nthreads);
+    bench(kmp_sch_dynamic_chunked, 100000, 10, nthreads); // warm up the team
+    printf("dynamic,1: %.2f ns/chunk\n",
+           bench(kmp_sch_dynamic_chunked, 100000, nloops, nthreads));
+    printf("guided,1:  %.2f ns/chunk\n",
+           bench(kmp_sch_guided_chunked, 100000, nloops * 100, nthreads));
+    return 0;
+  }
+  for (i = 0; i < REPETITIONS; i++) {
+    if (!test_kmp_dispatch_fast_path(kmp_sch_dynamic_chunked) ||
+        !test_kmp_dispatch_fast_path(kmp_sch_guided_chunked)) {
+      num_failed++;
+    }
+  }
+  return num_failed;
+}
@@ -0,0 +1,152 @@
+// RUN: %libomp-compile-and-run
+// RUN: env KMP_DIST_SCHEDULE=dynamic %libomp-run
+// RUN: env KMP_DIST_SCHEDULE=dynamic,7 %libomp-run
+// RUN: env KMP_DIST_SCHEDULE=dynamic OMP_SCHEDULE=dynamic,3 %libomp-run
+// Run with an argument to time a loop whose iterations get more expensive
+// towards its end; compare KMP_DIST_SCHEDULE=static with dynamic.
+#include <stdio.h>
+#include <stdlib.h>
+#include <omp.h>
+#include "omp_testsuite.h"
+
+#define N 3001
+#define NLOOPS 10 // more distribute loops than the league has counters
+
+typedef struct ident {
+  int reserved_1;
+  int flags;
+  int reserved_2;
+  int reserved_3;
+  char const *psource;
+} ident_t;
+
+// enum sched_type
+#define kmp_sch_dynamic_chunked 35
+#define kmp_sch_runtime 37
+
+typedef void (*kmpc_micro)(int *, int *, ...);
+extern int __kmpc_global_thread_num(ident_t *);
+extern void __kmpc_push_num_teams(ident_t *, int, int, int);
+extern void __kmpc_fork_teams(ident_t *, int, kmpc_micro, ...);
+extern void __kmpc_fork_call(ident_t *, int, kmpc_micro, ...);
+extern void __kmpc_dist_dispatch_init_4(ident_t *, int, int, int *, int, int,
+                                        int, int);
+extern int __kmpc_dispatch_next_4(ident_t *, int, int *, int *, int *, int *);
+extern void __kmpc_dist_dispatch_init_8(ident_t *, int, int, int *, long long,
+                                        long long, long long, long long);
+extern int __kmpc_dispatch_next_8(ident_t *, int, int *, long long *,
+                                  long long *, long long *);
+
+static ident_t loc = { 0, 2, 0, 0, ";kmp_dist_dynamic.c;test;40;1;;" };
+static int hits[NLOOPS][N];
+static int lasts[NLOOPS];
+static int errors;
+static int work;
+
+static void count(int l, int i, int last)
+{
+  volatile double x = 0;
+  int k;
+  #pragma omp atomic
+  hits[l][i]++;
+  if (last) {
+    #pragma omp atomic
+    lasts[l]++;
+  }
+  for (k = 0; k < work * i; k++)
+    x += k;
+}
+
+// distribute parallel for schedule(dynamic) over the loops as the compiler
+// emits it; the last iteration is in the last chunk of the team that has it
+static void loops(int *gtid, int *btid)
+{
+  int l, team_last, last, lb, ub, st, i;
+  long long lb8, ub8, st8, i8;
+
+  for (l = 0; l < NLOOPS; l++) {
+    int sched = (l % 3 == 2) ? kmp_sch_runtime : kmp_sch_dynamic_chunked;
+    team_last = 0;
+    if (l % 2 == 0) {
+      // 0..N-1 by 1
+      __kmpc_dist_dispatch_init_4(&loc, *gtid, sched, &team_last, 0, N - 1, 1,
+                                  5);
+      while (__kmpc_dispatch_next_4(&loc, *gtid, &last, &lb, &ub, &st)) {
+        for (i = lb; i <= ub; i += st)
+          count(l, i, team_last && last && i == ub);
+      }
+    } else {
+      // 3*(N-1)..0 by -3, 64-bit
+      __kmpc_dist_dispatch_init_8(&loc, *gtid, sched, &team_last, 3LL * (N - 1),
+                                  0, -3, 2);
+      while (__kmpc_dispatch_next_8(&loc, *gtid, &last, &lb8, &ub8, &st8)) {
+        if (st8 != -3) {
+          #pragma omp atomic
+          errors++;
+          break;
+        }
+        for (i8 = lb8; i8 >= ub8; i8 += st8)
+          count(l, N - 1 - (int)(i8 / 3), team_last && last && i8 == ub8);
+      }
+    }
+  }
+}
+
+static void teams(int *gtid, int *btid)
+{
+  __kmpc_fork_call(&loc, 0, (kmpc_micro)loops);
+}
+
+int test_kmp_dist_dynamic(int nteams, int nth)
+{
+  int l, i;
+  int gtid = __kmpc_global_thread_num(&loc);
+
+  errors = 0;
+  for (l = 0; l < NLOOPS; l++) {
+    lasts[l] = 0;
+    for (i = 0; i < N; i++)
+      hits[l][i] = 0;
+  }
+  __kmpc_push_num_teams(&loc, gtid, nteams, nth);
+  __kmpc_fork_teams(&loc, 0, (kmpc_micro)teams);
+  for (l = 0; l < NLOOPS; l++) {
+    for (i = 0; i < N; i++) {
+      if (hits[l][i] != 1) {
+        fprintf(stderr, "%d teams of %d: loop %d: iteration %d ran %d times\n",
+                nteams, nth, l, i, hits[l][i]);
+        errors++;
+        break;
+      }
+    }
+    if (lasts[l] != 1) {
+      fprintf(stderr, "%d teams of %d: loop %d: %d last iterations\n", nteams,
+              nth, l, lasts[l]);
+      errors++;
+    }
+  }
+  return errors == 0;
+}
+
+int main(int argc, char **argv)
+{
+  int i;
+  int num_failed = 0;
+
+  if (argc > 1) {
+    double t;
+    work = argc > 2 ? atoi(argv[2]) : 10;
+    t = omp_get_wtime();
+    test_kmp_dist_dynamic(4, 1);
+    printf("4 teams of 1 thread: %.3f s\n", omp_get_wtime() - t);
+    return 0;
+  }
+  for (i = 0; i < REPETITIONS; i++) {
+    if (!test_kmp_dist_dynamic(4, 2) ||
+        !test_kmp_dist_dynamic(3, 1) || // serialized teams
+        !test_kmp_dist_dynamic(1, 3)) {
+      num_failed++;
+    }
+  }
+  return num_failed;
+}
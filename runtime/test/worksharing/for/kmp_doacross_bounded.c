@@ -0,0 +1,88 @@
+// RUN: %libomp-compile-and-run
+#include <stdio.h>
+#include <omp.h>
+#include "omp_testsuite.h"
+
+// 2^44 iterations: one flag per iteration would take 2TB, so the loop only
+// runs if the tracking memory stays bounded by the window and the runs.
+#define N (1LL << 22)
+#define M (1LL << 22)
+#define NT 4
+// iterations posted per run
+#define POSTS 1000
+
+struct dim {
+  long long lo; // lower
+  long long up; // upper
+  long long st; // stride
+};
+extern void __kmpc_doacross_init(void*, int, int, struct dim *);
+extern void __kmpc_doacross_wait(void*, int, long long*);
+extern void __kmpc_doacross_post(void*, int, long long*);
+extern void __kmpc_doacross_fini(void*, int);
+extern int __kmpc_global_thread_num(void*);
+
+int test_doacross_bounded()
+{
+  struct dim dims[2];
+  int started = 0;
+  dims[0].lo = 0;
+  dims[0].up = N - 1;
+  dims[0].st = 1;
+  dims[1].lo = 0;
+  dims[1].up = M - 1;
+  dims[1].st = 1;
+  #pragma omp parallel num_threads(NT)
+  {
+    int gtid = __kmpc_global_thread_num(NULL);
+    int tid = omp_get_thread_num();
+    int other = (tid + 1) % omp_get_num_threads();
+    long long vec[2], j;
+    __kmpc_doacross_init(NULL, gtid, 2, dims);
+    #pragma omp atomic
+    started++;
+    // the first two rows of the static block of each thread: every thread but
+    // the master posts far beyond the window, the second row is a separate run
+    vec[0] = N / NT * tid;
+    for (j = 0; j < POSTS; ++j) {
+      vec[1] = j;
+      __kmpc_doacross_post(NULL, gtid, vec);
+    }
+    vec[0] = N / NT * tid + 1;
+    for (j = 0; j < POSTS; ++j) {
+      vec[1] = j;
+      __kmpc_doacross_post(NULL, gtid, vec);
+    }
+    #pragma omp barrier
+    // the posts of another thread are seen without the sink waiting
+    vec[0] = N / NT * other;
+    for (j = 0; j < POSTS; ++j) {
+      vec[1] = j;
+      __kmpc_doacross_wait(NULL, gtid, vec);
+    }
+    vec[0] = N / NT * other + 1;
+    for (j = POSTS - 1; j >= 0; --j) {
+      vec[1] = j;
+      __kmpc_doacross_wait(NULL, gtid, vec);
+    }
+    __kmpc_doacross_fini(NULL, gtid);
+  }
+  if (started != NT) {
+    fprintf(stderr, "%d threads started the loop, expected %d\n", started, NT);
+    return 0;
+  }
+  return 1;
+}
+
+int main()
+{
+  int i;
+  int num_failed = 0;
+
+  for (i = 0; i < REPETITIONS; i++) {
+    if (!test_doacross_bounded()) {
+      num_failed++;
+    }
+  }
+  return num_failed;
+}
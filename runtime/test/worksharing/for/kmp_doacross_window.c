@@ -0,0 +1,136 @@
+// RUN: %libomp-compile-and-run
+// RUN: env KMP_DOACROSS_WINDOW=0 %libomp-run
+// RUN: env KMP_DOACROSS_WINDOW=32 %libomp-run
+#include <stdio.h>
+#include <omp.h>
+#include "omp_testsuite.h"
+
+// 2-D wavefront big enough to be tracked by a window of flags
+#define N 600
+#define M 700
+
+struct dim {
+  long long lo; // lower
+  long long up; // upper
+  long long st; // stride
+};
+extern void __kmpc_doacross_init(void*, int, int, struct dim *);
+extern void __kmpc_doacross_wait(void*, int, long long*);
+extern void __kmpc_doacross_post(void*, int, long long*);
+extern void __kmpc_doacross_fini(void*, int);
+extern int __kmpc_global_thread_num(void*);
+
+static int a[N][M];
+
+int test_doacross_window(int chunk)
+{
+  int i, j;
+  struct dim dims[2];
+  for (i = 0; i < N; ++i)
+    for (j = 0; j < M; ++j)
+      a[i][j] = 0;
+  // for (i = 1; i < N; ++i) for (j = M - 1; j > 0; --j)
+  dims[0].lo = 1;
+  dims[0].up = N - 1;
+  dims[0].st = 1;
+  dims[1].lo = M - 1;
+  dims[1].up = 1;
+  dims[1].st = -1;
+  #pragma omp parallel num_threads(4) private(i, j)
+  {
+    int gtid = __kmpc_global_thread_num(NULL);
+    long long vec[2];
+    __kmpc_doacross_init(NULL, gtid, 2, dims);
+    #pragma omp for nowait schedule(static, chunk)
+    for (i = 1; i < N; ++i) {
+      for (j = M - 1; j > 0; --j) {
+        // ordered depend(sink: i-1, j) depend(sink: i, j+1)
+        vec[0] = i - 1;
+        vec[1] = j;
+        __kmpc_doacross_wait(NULL, gtid, vec);
+        vec[0] = i;
+        vec[1] = j + 1;
+        __kmpc_doacross_wait(NULL, gtid, vec);
+        a[i][j] = (a[i - 1][j] > a[i][(j + 1) % M] ? a[i - 1][j]
+                                                   : a[i][(j + 1) % M]) + 1;
+        // ordered depend(source)
+        vec[0] = i;
+        vec[1] = j;
+        __kmpc_doacross_post(NULL, gtid, vec);
+      }
+    }
+    __kmpc_doacross_fini(NULL, gtid);
+  }
+  for (i = 1; i < N; ++i) {
+    for (j = M - 1; j > 0; --j) {
+      if (a[i][j] != i + (M - 1 - j)) {
+        fprintf(stderr, "a[%d][%d] = %d, expected %d\n", i, j, a[i][j],
+                i + (M - 1 - j));
+        return 0;
+      }
+    }
+  }
+  return 1;
+}
+
+// Rows depend on nothing but themselves, so with big static blocks every thread
+// but the first posts far beyond the lowest unposted iteration.
+int test_doacross_static_blocks()
+{
+  int i, j;
+  struct dim dims[2];
+  for (i = 0; i < N; ++i)
+    for (j = 0; j < M; ++j)
+      a[i][j] = 0;
+  // for (i = 0; i < N; ++i) for (j = 1; j < M; ++j)
+  dims[0].lo = 0;
+  dims[0].up = N - 1;
+  dims[0].st = 1;
+  dims[1].lo = 1;
+  dims[1].up = M - 1;
+  dims[1].st = 1;
+  #pragma omp parallel num_threads(4) private(i, j)
+  {
+    int gtid = __kmpc_global_thread_num(NULL);
+    long long vec[2];
+    __kmpc_doacross_init(NULL, gtid, 2, dims);
+    #pragma omp for nowait schedule(static)
+    for (i = 0; i < N; ++i) {
+      for (j = 1; j < M; ++j) {
+        // ordered depend(sink: i, j-1)
+        vec[0] = i;
+        vec[1] = j - 1;
+        __kmpc_doacross_wait(NULL, gtid, vec);
+        a[i][j] = a[i][j - 1] + 1;
+        // ordered depend(source)
+        vec[0] = i;
+        vec[1] = j;
+        __kmpc_doacross_post(NULL, gtid, vec);
+      }
+    }
+    __kmpc_doacross_fini(NULL, gtid);
+  }
+  for (i = 0; i < N; ++i) {
+    for (j = 1; j < M; ++j) {
+      if (a[i][j] != j) {
+        fprintf(stderr, "a[%d][%d] = %d, expected %d\n", i, j, a[i][j], j);
+        return 0;
+      }
+    }
+  }
+  return 1;
+}
+
+int main()
+{
+  int i;
+  int num_failed = 0;
+
+  for (i = 0; i < REPETITIONS; i++) {
+    if (!test_doacross_window(1) || !test_doacross_window(3) ||
+        !test_doacross_static_blocks()) {
+      num_failed++;
+    }
+  }
+  return num_failed;
+}
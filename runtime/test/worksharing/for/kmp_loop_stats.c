@@ -0,0 +1,118 @@
+// RUN: %libomp-compile-and-run
+// RUN: env KMP_LOOP_STATS=1 %libomp-run
+#include <stdio.h>
+#include <omp.h>
+#include "omp_testsuite.h"
+
+#define N 1000
+#define CHUNK 7
+#define NLOOPS 10
+#define NTHREADS 4
+
+typedef struct ident {
+  int reserved_1;
+  int flags;
+  int reserved_2;
+  int reserved_3;
+  char const *psource;
+} ident_t;
+
+// enum sched_type
+#define kmp_sch_dynamic_chunked 35
+
+extern int __kmpc_global_thread_num(ident_t *);
+extern void __kmpc_dispatch_init_4(ident_t *, int, int, int, int, int, int);
+extern int __kmpc_dispatch_next_4(ident_t *, int, int *, int *, int *, int *);
+extern void __kmpc_set_loop_stats(int);
+extern int __kmpc_loop_stats_sites(void);
+extern ident_t *__kmpc_loop_stats_site(int, int *, unsigned long long *,
+                                       unsigned long long *);
+extern unsigned long long __kmpc_loop_stats_thread(int, int,
+                                                   unsigned long long *,
+                                                   unsigned long long *,
+                                                   unsigned long long *);
+extern void __kmpc_loop_stats_reset(void);
+
+static ident_t loc = { 0, 2, 0, 0, ";kmp_loop_stats.c;test;40;1;;" };
+
+static void run_loops(int *chunks)
+{
+  #pragma omp parallel num_threads(NTHREADS)
+  {
+    int gtid = __kmpc_global_thread_num(&loc);
+    int tid = omp_get_thread_num();
+    int l, lb, ub, st, last, i;
+    volatile int sink = 0;
+    for (l = 0; l < NLOOPS; l++) {
+      __kmpc_dispatch_init_4(&loc, gtid, kmp_sch_dynamic_chunked, 0, N - 1, 1,
+                             CHUNK);
+      while (__kmpc_dispatch_next_4(&loc, gtid, &last, &lb, &ub, &st)) {
+        chunks[tid]++;
+        for (i = lb; i <= ub; i++)
+          sink += i;
+      }
+    }
+  }
+}
+
+int test_kmp_loop_stats()
+{
+  int chunks[NTHREADS] = { 0 };
+  int i, t, site = -1, sched = 0, errors = 0;
+  unsigned long long runs = 0, iters = 0, total = 0;
+
+  // turn the recording on from the program as a tool would
+  __kmpc_set_loop_stats(1);
+  __kmpc_loop_stats_reset();
+  run_loops(chunks);
+
+  for (i = 0; i < __kmpc_loop_stats_sites(); i++) {
+    if (__kmpc_loop_stats_site(i, &sched, &runs, &iters) == &loc)
+      site = i;
+  }
+  if (site < 0) {
+    fprintf(stderr, "loop site not found\n");
+    return 0;
+  }
+  __kmpc_loop_stats_site(site, &sched, &runs, &iters);
+  if (sched != kmp_sch_dynamic_chunked || runs != NLOOPS ||
+      iters != (unsigned long long)N * NLOOPS) {
+    fprintf(stderr, "site: schedule %d, runs %llu, iterations %llu\n", sched,
+            runs, iters);
+    errors++;
+  }
+  for (t = 0; t < NTHREADS; t++) {
+    unsigned long long c = 0, busy, wait;
+    unsigned long long loops = __kmpc_loop_stats_thread(site, t, &c, &busy,
+                                                        &wait);
+    if (c != (unsigned long long)chunks[t] || (c && loops != NLOOPS)) {
+      fprintf(stderr, "thread %d: %llu chunks (expected %d), %llu loops\n", t,
+              c, chunks[t], loops);
+      errors++;
+    }
+    total += c;
+  }
+  if (total != (unsigned long long)NLOOPS * ((N + CHUNK - 1) / CHUNK)) {
+    fprintf(stderr, "%llu chunks in total\n", total);
+    errors++;
+  }
+  if (__kmpc_loop_stats_thread(-1, 0, NULL, NULL, NULL) != 0 ||
+      __kmpc_loop_stats_site(__kmpc_loop_stats_sites(), NULL, NULL, NULL)) {
+    fprintf(stderr, "out of range site returned data\n");
+    errors++;
+  }
+  return errors == 0;
+}
+
+int main()
+{
+  int i;
+  int num_failed = 0;
+
+  for (i = 0; i < REPETITIONS; i++) {
+    if (!test_kmp_loop_stats()) {
+      num_failed++;
+    }
+  }
+  return num_failed;
+}
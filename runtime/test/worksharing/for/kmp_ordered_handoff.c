@@ -0,0 +1,89 @@
+// RUN: %libomp-compile-and-run
+#include <stdio.h>
+#include <omp.h>
+#include "omp_testsuite.h"
+
+#define N 2001
+#define NLOOPS 20
+
+typedef struct ident {
+  int reserved_1;
+  int flags;
+  int reserved_2;
+  int reserved_3;
+  char const *psource;
+} ident_t;
+
+// enum sched_type
+#define kmp_ord_static_chunked 65
+#define kmp_ord_static 66
+#define kmp_ord_dynamic_chunked 67
+#define kmp_ord_guided_chunked 68
+
+extern int __kmpc_global_thread_num(ident_t *);
+extern void __kmpc_dispatch_init_4(ident_t *, int, int, int, int, int, int);
+extern int __kmpc_dispatch_next_4(ident_t *, int, int *, int *, int *, int *);
+extern void __kmpc_dispatch_fini_4(ident_t *, int);
+extern void __kmpc_ordered(ident_t *, int);
+extern void __kmpc_end_ordered(ident_t *, int);
+
+static ident_t loc = { 0, 2, 0, 0, ";unknown;unknown;0;0;;" };
+
+// Every loop checks the iterations enter the ordered region in order; the
+// ordered region is skipped in some iterations to exercise the finish path.
+int test_ordered_handoff(int sched, int chunk)
+{
+  int errors = 0;
+  int next = 0;
+  int loop;
+
+  for (loop = 0; loop < NLOOPS; ++loop) {
+    next = 0;
+    #pragma omp parallel shared(errors, next)
+    {
+      int gtid = __kmpc_global_thread_num(&loc);
+      int lb, ub, st, last, i;
+      __kmpc_dispatch_init_4(&loc, gtid, sched, 0, N - 1, 1, chunk);
+      while (__kmpc_dispatch_next_4(&loc, gtid, &last, &lb, &ub, &st)) {
+        for (i = lb; i <= ub; ++i) {
+          if (i % 5 != 3) {
+            __kmpc_ordered(&loc, gtid);
+            if (next > i) {
+              #pragma omp atomic
+              errors++;
+            }
+            next = i + 1;
+            __kmpc_end_ordered(&loc, gtid);
+          }
+          __kmpc_dispatch_fini_4(&loc, gtid);
+        }
+      }
+    }
+    if (next != N) // iteration N - 1 enters the region last
+      errors++;
+  }
+  if (errors)
+    fprintf(stderr, "schedule %d chunk %d: %d errors\n", sched, chunk, errors);
+  return errors == 0;
+}
+
+int main()
+{
+  int i;
+  int num_failed = 0;
+
+  omp_set_num_threads(4);
+  for (i = 0; i < REPETITIONS; i++) {
+    if (!test_ordered_handoff(kmp_ord_static, 0))
+      num_failed++;
+    if (!test_ordered_handoff(kmp_ord_static_chunked, 3))
+      num_failed++;
+    if (!test_ordered_handoff(kmp_ord_dynamic_chunked, 1))
+      num_failed++;
+    if (!test_ordered_handoff(kmp_ord_dynamic_chunked, 7))
+      num_failed++;
+    if (!test_ordered_handoff(kmp_ord_guided_chunked, 2))
+      num_failed++;
+  }
+  return num_failed;
+}
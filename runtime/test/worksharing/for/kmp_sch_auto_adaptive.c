@@ -0,0 +1,89 @@
+// RUN: %libomp-compile-and-run
+// RUN: env KMP_AUTO_ADAPTIVE=true %libomp-run
+// RUN: env KMP_AUTO_ADAPTIVE=true KMP_DISP_NUM_BUFFERS=2 %libomp-run
+#include <stdio.h>
+#include <omp.h>
+#include "omp_testsuite.h"
+
+#define N 1000
+#define NLOOPS 300
+
+typedef struct ident {
+  int reserved_1;
+  int flags;
+  int reserved_2;
+  int reserved_3;
+  char const *psource;
+} ident_t;
+
+// enum sched_type
+#define kmp_sch_auto 38
+
+extern int __kmpc_global_thread_num(ident_t *);
+extern void __kmpc_dispatch_init_4(ident_t *, int, int, int, int, int, int);
+extern int __kmpc_dispatch_next_4(ident_t *, int, int *, int *, int *, int *);
+
+static ident_t loc1 = { 0, 2, 0, 0, ";kmp_sch_auto_adaptive.c;test;40;1;;" };
+static ident_t loc2 = { 0, 2, 0, 0, ";kmp_sch_auto_adaptive.c;test;50;1;;" };
+static int hits[2][N];
+
+// Runs one schedule(auto) loop nowait, the work per iteration grows with i
+// in the second loop so the tuner sees an imbalanced loop as well.
+static void auto_loop(ident_t *loc, int gtid, int which)
+{
+  int lb, ub, st, last, i;
+  __kmpc_dispatch_init_4(loc, gtid, kmp_sch_auto, 0, N - 1, 1, 0);
+  while (__kmpc_dispatch_next_4(loc, gtid, &last, &lb, &ub, &st)) {
+    for (i = lb; i <= ub; i++) {
+      volatile int w, k = which ? i / 10 : 1;
+      for (w = 0; w < k; w++)
+        ;
+      #pragma omp atomic
+      hits[which][i]++;
+    }
+  }
+}
+
+int test_kmp_sch_auto_adaptive()
+{
+  int i, j, errors = 0;
+
+  for (j = 0; j < 2; j++)
+    for (i = 0; i < N; i++)
+      hits[j][i] = 0;
+
+  #pragma omp parallel num_threads(4)
+  {
+    int gtid = __kmpc_global_thread_num(&loc1);
+    int n;
+    for (n = 0; n < NLOOPS; n++) {
+      auto_loop(&loc1, gtid, 0);
+      auto_loop(&loc2, gtid, 1);
+    }
+  }
+
+  for (j = 0; j < 2; j++) {
+    for (i = 0; i < N; i++) {
+      if (hits[j][i] != NLOOPS) {
+        fprintf(stderr, "loop %d iteration %d executed %d times, expected %d\n",
+                j, i, hits[j][i], NLOOPS);
+        errors++;
+        break;
+      }
+    }
+  }
+  return errors == 0;
+}
+
+int main()
+{
+  int i;
+  int num_failed = 0;
+
+  for (i = 0; i < REPETITIONS; i++) {
+    if (!test_kmp_sch_auto_adaptive()) {
+      num_failed++;
+    }
+  }
+  return num_failed;
+}
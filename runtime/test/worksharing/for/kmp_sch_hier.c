@@ -0,0 +1,127 @@
+// RUN: %libomp-compile-and-run
+// RUN: env KMP_DISP_HIER_DOMAINS=2 %libomp-run
+// RUN: env KMP_DISP_HIER_DOMAINS=3 OMP_SCHEDULE=hier_dynamic,2 %libomp-run
+// RUN: env KMP_DISP_HIER_DOMAINS=4 OMP_SCHEDULE=hier_guided %libomp-run
+#include <stdio.h>
+#include <omp.h>
+#include "omp_testsuite.h"
+
+#define N 3001
+#define NLOOPS 50
+
+typedef struct ident {
+  int reserved_1;
+  int flags;
+  int reserved_2;
+  int reserved_3;
+  char const *psource;
+} ident_t;
+
+// enum sched_type
+#define kmp_sch_runtime 37
+#define kmp_sch_hier_dynamic_chunked 46
+#define kmp_sch_hier_guided_chunked 47
+
+extern int __kmpc_global_thread_num(ident_t *);
+extern void __kmpc_dispatch_init_4(ident_t *, int, int, int, int, int, int);
+extern int __kmpc_dispatch_next_4(ident_t *, int, int *, int *, int *, int *);
+extern void __kmpc_dispatch_init_8(ident_t *, int, int, long long, long long,
+                                   long long, long long);
+extern int __kmpc_dispatch_next_8(ident_t *, int, int *, long long *,
+                                  long long *, long long *);
+
+static ident_t loc = { 0, 2, 0, 0, ";kmp_sch_hier.c;test;30;1;;" };
+static int hits[3][N];
+static int lasts[3];
+
+// The work per iteration grows with i, so the domains owning the upper
+// part of the iteration space are helped by the others.
+static void work(int which, long long i)
+{
+  volatile int w, k = (int)(i / 8);
+  for (w = 0; w < k; w++)
+    ;
+  #pragma omp atomic
+  hits[which][i]++;
+}
+
+int test_kmp_sch_hier()
+{
+  int i, j, errors = 0;
+
+  for (j = 0; j < 3; j++) {
+    lasts[j] = 0;
+    for (i = 0; i < N; i++)
+      hits[j][i] = 0;
+  }
+
+  #pragma omp parallel num_threads(4)
+  {
+    int gtid = __kmpc_global_thread_num(&loc);
+    int n;
+    for (n = 0; n < NLOOPS; n++) {
+      int lb, ub, st, last, i;
+      long long lb8, ub8, st8, k;
+      __kmpc_dispatch_init_4(&loc, gtid, kmp_sch_hier_dynamic_chunked, 0,
+                             N - 1, 1, 3);
+      while (__kmpc_dispatch_next_4(&loc, gtid, &last, &lb, &ub, &st)) {
+        for (i = lb; i <= ub; i++)
+          work(0, i);
+        if (last) {
+          #pragma omp atomic
+          lasts[0]++;
+        }
+      }
+      __kmpc_dispatch_init_8(&loc, gtid, kmp_sch_hier_guided_chunked, 0,
+                             N - 1, 1, 2);
+      while (__kmpc_dispatch_next_8(&loc, gtid, &last, &lb8, &ub8, &st8)) {
+        for (k = lb8; k <= ub8; k++)
+          work(1, k);
+        if (last) {
+          #pragma omp atomic
+          lasts[1]++;
+        }
+      }
+      // schedule(runtime), hierarchical if OMP_SCHEDULE asks for it
+      __kmpc_dispatch_init_4(&loc, gtid, kmp_sch_runtime, 0, N - 1, 1, 0);
+      while (__kmpc_dispatch_next_4(&loc, gtid, &last, &lb, &ub, &st)) {
+        for (i = lb; i <= ub; i++)
+          work(2, i);
+        if (last) {
+          #pragma omp atomic
+          lasts[2]++;
+        }
+      }
+    }
+  }
+
+  for (j = 0; j < 3; j++) {
+    if (lasts[j] != NLOOPS) {
+      fprintf(stderr, "loop %d: last chunk seen %d times, expected %d\n",
+              j, lasts[j], NLOOPS);
+      errors++;
+    }
+    for (i = 0; i < N; i++) {
+      if (hits[j][i] != NLOOPS) {
+        fprintf(stderr, "loop %d iteration %d executed %d times, expected %d\n",
+                j, i, hits[j][i], NLOOPS);
+        errors++;
+        break;
+      }
+    }
+  }
+  return errors == 0;
+}
+
+int main()
+{
+  int i;
+  int num_failed = 0;
+
+  for (i = 0; i < REPETITIONS; i++) {
+    if (!test_kmp_sch_hier()) {
+      num_failed++;
+    }
+  }
+  return num_failed;
+}
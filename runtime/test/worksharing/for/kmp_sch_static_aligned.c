@@ -0,0 +1,207 @@
+// RUN: %libomp-compile-and-run
+// RUN: env OMP_SCHEDULE=static_aligned,16 %libomp-run
+// RUN: env KMP_SCHEDULE=static,aligned %libomp-run
+// Run with an argument to time a streaming kernel under both schedules:
+// the parts of adjacent threads share a cache line under the balanced
+// schedule, but not under the aligned one.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <omp.h>
+#include "omp_testsuite.h"
+
+#define ALIGN 16 // elements of 4 bytes per 64-byte cache line
+#define ENV_ALIGN 8 // KMP_DEFAULT_STATIC_ALIGN, the least alignment selected
+
+typedef struct ident {
+  int reserved_1;
+  int flags;
+  int reserved_2;
+  int reserved_3;
+  char const *psource;
+} ident_t;
+
+// enum sched_type
+#define kmp_sch_static 34
+#define kmp_sch_runtime 37
+#define kmp_sch_static_aligned 48
+
+extern int __kmpc_global_thread_num(ident_t *);
+extern void __kmpc_for_static_init_4(ident_t *, int, int, int *, int *, int *,
+                                     int *, int, int);
+extern void __kmpc_for_static_fini(ident_t *, int);
+extern void __kmpc_dispatch_init_4(ident_t *, int, int, int, int, int, int);
+extern int __kmpc_dispatch_next_4(ident_t *, int, int *, int *, int *, int *);
+
+static ident_t loc = { 0, 2, 0, 0, ";unknown;unknown;0;0;;" };
+
+// Checks every iteration is executed once, the thread boundaries are aligned
+// and the parts are balanced up to the alignment.
+int test_static_aligned(int lo, int up, int incr, int nthreads)
+{
+  int n = (up - lo) / incr + 1;
+  int *count = (int *)calloc(n, sizeof(int));
+  int errors = 0, lasts = 0;
+  int i;
+
+  #pragma omp parallel num_threads(nthreads) shared(errors, lasts)
+  {
+    int gtid = __kmpc_global_thread_num(&loc);
+    int nth = omp_get_num_threads();
+    int lower = lo, upper = up, stride, last = 0, j, size;
+    __kmpc_for_static_init_4(&loc, gtid, kmp_sch_static_aligned, &last, &lower,
+                             &upper, &stride, incr, ALIGN);
+    size = 0;
+    if (incr > 0 ? upper >= lower : upper <= lower)
+      size = (upper - lower) / incr + 1;
+    if (size > 0) {
+      for (j = lower; incr > 0 ? j <= upper : j >= upper; j += incr) {
+        #pragma omp atomic
+        count[(j - lo) / incr]++;
+      }
+      // the part starts at the loop bound or at an aligned element; with
+      // other strides, at a multiple of the alignment in iterations
+      if (lower != lo && (incr == 1 || incr == -1
+                              ? (incr > 0 ? lower : lower + 1) % ALIGN != 0
+                              : (lower - lo) / incr % ALIGN != 0)) {
+        #pragma omp atomic
+        errors++;
+      }
+    }
+    if (size > n / nth + ALIGN) {
+      #pragma omp atomic
+      errors++;
+    }
+    if (last) {
+      #pragma omp atomic
+      lasts++;
+    }
+    __kmpc_for_static_fini(&loc, gtid);
+  }
+  for (i = 0; i < n; ++i)
+    if (count[i] != 1)
+      errors++;
+  if (lasts != 1)
+    errors++;
+  free(count);
+  if (errors)
+    fprintf(stderr, "loop [%d,%d] by %d on %d threads: %d errors\n", lo, up,
+            incr, nthreads, errors);
+  return errors == 0;
+}
+
+// Checks a schedule(runtime) and a schedule(static) loop, as the compiler
+// would run them: every iteration is
+// executed once and, when the environment selects the aligned schedule, the
+// thread boundaries are aligned.
+int test_env_aligned(int lo, int up, int incr, int nthreads)
+{
+  char const *omp = getenv("OMP_SCHEDULE");
+  char const *kmp = getenv("KMP_SCHEDULE");
+  int n = (up - lo) / incr + 1;
+  int *owner = (int *)malloc(n * sizeof(int));
+  int aligned_runtime = omp != NULL && strncmp(omp, "static_aligned", 14) == 0;
+  int aligned_static = kmp != NULL && strstr(kmp, "aligned") != NULL;
+  int errors = 0;
+  int pass, i;
+
+  // with KMP_SCHEDULE alone the runtime schedule is static, which it refines
+  aligned_runtime = aligned_runtime || (omp == NULL && aligned_static);
+  for (pass = 0; pass < 2; ++pass) {
+    for (i = 0; i < n; ++i)
+      owner[i] = -1;
+    #pragma omp parallel num_threads(nthreads) private(i)
+    {
+      int gtid = __kmpc_global_thread_num(&loc);
+      int me = omp_get_thread_num();
+      int lower = lo, upper = up, stride, last = 0;
+      if (pass == 0) {
+        __kmpc_dispatch_init_4(&loc, gtid, kmp_sch_runtime, lo, up, incr, 0);
+        while (__kmpc_dispatch_next_4(&loc, gtid, &last, &lower, &upper,
+                                      &stride))
+          for (i = lower; incr > 0 ? i <= upper : i >= upper; i += incr)
+            owner[(i - lo) / incr] = owner[(i - lo) / incr] == -1 ? me : -2;
+      } else {
+        __kmpc_for_static_init_4(&loc, gtid, kmp_sch_static, &last, &lower,
+                                 &upper, &stride, incr, 1);
+        for (i = lower; incr > 0 ? i <= upper : i >= upper; i += incr)
+          owner[(i - lo) / incr] = owner[(i - lo) / incr] == -1 ? me : -2;
+        __kmpc_for_static_fini(&loc, gtid);
+      }
+    }
+    for (i = 0; i < n; ++i) {
+      int j = lo + i * incr;
+      if (owner[i] < 0)
+        errors++;
+      else if ((pass == 0 ? aligned_runtime : aligned_static) && i > 0 &&
+               owner[i] != owner[i - 1] &&
+               (incr > 0 ? j : j + 1) % ENV_ALIGN != 0)
+        errors++;
+    }
+  }
+  free(owner);
+  if (errors)
+    fprintf(stderr, "loop [%d,%d] by %d on %d threads: %d errors\n", lo, up,
+            incr, nthreads, errors);
+  return errors == 0;
+}
+
+// Time NREP sweeps over an array small enough for the boundary lines to matter.
+double stream(int sched, int n, int nrep)
+{
+  float *a = (float *)malloc(n * sizeof(float) + 64);
+  float *b = (float *)malloc(n * sizeof(float) + 64);
+  // start both arrays at a cache line
+  float *pa = (float *)(((size_t)a + 63) & ~(size_t)63);
+  float *pb = (float *)(((size_t)b + 63) & ~(size_t)63);
+  double t;
+  int i;
+
+  for (i = 0; i < n; ++i)
+    pa[i] = pb[i] = 1.0f;
+  t = omp_get_wtime();
+  #pragma omp parallel
+  {
+    int gtid = __kmpc_global_thread_num(&loc);
+    int lower = 0, upper = n - 1, stride, last, r, j;
+    __kmpc_for_static_init_4(&loc, gtid, sched, &last, &lower, &upper,
+                             &stride, 1, ALIGN);
+    for (r = 0; r < nrep; ++r)
+      for (j = lower; j <= upper; ++j)
+        pa[j] = pa[j] * 0.5f + pb[j];
+    __kmpc_for_static_fini(&loc, gtid);
+  }
+  t = omp_get_wtime() - t;
+  free(a);
+  free(b);
+  return t;
+}
+
+int main(int argc, char **argv)
+{
+  int i;
+  int num_failed = 0;
+
+  if (argc > 1) {
+    int n = argc > 2 ? atoi(argv[2]) : 1000;
+    int nrep = argc > 3 ? atoi(argv[3]) : 100000;
+    printf("n=%d nrep=%d threads=%d\n", n, nrep, omp_get_max_threads());
+    printf("static:         %.3f s\n", stream(kmp_sch_static, n, nrep));
+    printf("static_aligned: %.3f s\n", stream(kmp_sch_static_aligned, n, nrep));
+    return 0;
+  }
+  for (i = 0; i < REPETITIONS; i++) {
+    if (!test_static_aligned(0, 999, 1, 4) ||
+        !test_static_aligned(3, 1001, 1, 7) ||
+        !test_static_aligned(-37, 20, 1, 3) ||
+        !test_static_aligned(1000, -5, -1, 6) ||
+        !test_static_aligned(5, 40, 1, 8) ||
+        !test_static_aligned(0, 997, 3, 5) ||
+        !test_env_aligned(0, 999, 1, 4) ||
+        !test_env_aligned(3, 1001, 1, 7) ||
+        !test_env_aligned(1000, -5, -1, 6)) {
+      num_failed++;
+    }
+  }
+  return num_failed;
+}
@@ -0,0 +1,122 @@
+// RUN: %libomp-compile-and-run
+// RUN: env OMP_SCHEDULE=static_steal %libomp-run
+#include <stdio.h>
+#include <omp.h>
+#include "omp_testsuite.h"
+
+#define N 3000
+#define NLOOPS 100
+
+typedef struct ident {
+  int reserved_1;
+  int flags;
+  int reserved_2;
+  int reserved_3;
+  char const *psource;
+} ident_t;
+
+// enum sched_type
+#define kmp_sch_runtime 37
+#define kmp_sch_static_steal 44
+
+extern int __kmpc_global_thread_num(ident_t *);
+extern void __kmpc_dispatch_init_4(ident_t *, int, int, int, int, int, int);
+extern int __kmpc_dispatch_next_4(ident_t *, int, int *, int *, int *, int *);
+extern void __kmpc_dispatch_init_8(ident_t *, int, int, long long, long long,
+                                   long long, long long);
+extern int __kmpc_dispatch_next_8(ident_t *, int, int *, long long *,
+                                  long long *, long long *);
+
+static ident_t loc = { 0, 2, 0, 0, ";kmp_sch_static_steal.c;test;30;1;;" };
+static int hits[2][N];
+
+// The work per iteration grows with i, so the threads owning the upper
+// part of the iteration space get robbed by the others.
+static void work(int which, long long i)
+{
+  volatile int w, k = (int)(i / 4);
+  for (w = 0; w < k; w++)
+    ;
+  #pragma omp atomic
+  hits[which][i]++;
+}
+
+int test_kmp_sch_static_steal()
+{
+  int i, j, errors = 0;
+
+  for (j = 0; j < 2; j++)
+    for (i = 0; i < N; i++)
+      hits[j][i] = 0;
+
+  #pragma omp parallel num_threads(4)
+  {
+    int gtid = __kmpc_global_thread_num(&loc);
+    int n;
+    for (n = 0; n < NLOOPS; n++) {
+      int lb, ub, st, last, i;
+      long long lb8, ub8, st8;
+      // 4-byte induction variable: pairs are updated with 8-byte CAS
+      __kmpc_dispatch_init_4(&loc, gtid, kmp_sch_static_steal, 0, N - 1, 1, 3);
+      while (__kmpc_dispatch_next_4(&loc, gtid, &last, &lb, &ub, &st))
+        for (i = lb; i <= ub; i++)
+          work(0, i);
+      // 8-byte induction variable: 16-byte CAS or per-thread locks
+      __kmpc_dispatch_init_8(&loc, gtid, kmp_sch_static_steal, 0, N - 1, 1, 3);
+      while (__kmpc_dispatch_next_8(&loc, gtid, &last, &lb8, &ub8, &st8)) {
+        long long k;
+        for (k = lb8; k <= ub8; k++)
+          work(1, k);
+      }
+    }
+  }
+
+  for (j = 0; j < 2; j++) {
+    for (i = 0; i < N; i++) {
+      if (hits[j][i] != NLOOPS) {
+        fprintf(stderr, "loop %d iteration %d executed %d times, expected %d\n",
+                j, i, hits[j][i], NLOOPS);
+        errors++;
+        break;
+      }
+    }
+  }
+  return errors == 0;
+}
+
+// schedule(runtime), picks up static_steal from OMP_SCHEDULE
+int test_kmp_sch_runtime_static_steal()
+{
+  int sum = 0;
+  #pragma omp parallel num_threads(4) reduction(+:sum)
+  {
+    int gtid = __kmpc_global_thread_num(&loc);
+    int lb, ub, st, last, i;
+    __kmpc_dispatch_init_4(&loc, gtid, kmp_sch_runtime, 0, N - 1, 1, 0);
+    while (__kmpc_dispatch_next_4(&loc, gtid, &last, &lb, &ub, &st)) {
+      for (i = lb; i <= ub; i++) {
+        volatile int w, k = i / 4;
+        for (w = 0; w < k; w++)
+          ;
+        sum += i;
+      }
+    }
+  }
+  return sum == N * (N - 1) / 2;
+}
+
+int main()
+{
+  int i;
+  int num_failed = 0;
+
+  for (i = 0; i < REPETITIONS; i++) {
+    if (!test_kmp_sch_static_steal()) {
+      num_failed++;
+    }
+    if (!test_kmp_sch_runtime_static_steal()) {
+      num_failed++;
+    }
+  }
+  return num_failed;
+}
@@ -0,0 +1,115 @@
+// RUN: %libomp-compile-and-run
+// RUN: env OMP_SCHEDULE=sticky,3 %libomp-run
+#include <stdio.h>
+#include <omp.h>
+#include "omp_testsuite.h"
+
+#define N 4001
+#define CHUNK 16
+#define NCHUNKS ((N + CHUNK - 1) / CHUNK)
+#define NSTEPS 20
+#define NTHREADS 4
+
+typedef struct ident {
+  int reserved_1;
+  int flags;
+  int reserved_2;
+  int reserved_3;
+  char const *psource;
+} ident_t;
+
+// enum sched_type
+#define kmp_sch_runtime 37
+#define kmp_sch_sticky_dynamic_chunked 49
+
+extern int __kmpc_global_thread_num(ident_t *);
+extern void __kmpc_dispatch_init_4(ident_t *, int, int, int, int, int, int);
+extern int __kmpc_dispatch_next_4(ident_t *, int, int *, int *, int *, int *);
+
+static ident_t loc = { 0, 2, 0, 0, ";kmp_sch_sticky.c;test;30;1;;" };
+static ident_t loc_rt = { 0, 2, 0, 0, ";kmp_sch_sticky.c;test;31;1;;" };
+static int hits[N];
+static int owner[2][NCHUNKS];
+
+// Runs the loop NSTEPS times as a time-stepping program would; checks that
+// every iteration runs once per step and counts the chunks that stayed with
+// the thread that ran them in the previous step.
+int test_kmp_sch_sticky(ident_t *lp, int sched, int chunk, int *kept)
+{
+  int i, s, errors = 0;
+
+  *kept = 0;
+  for (i = 0; i < NCHUNKS; i++)
+    owner[0][i] = owner[1][i] = -1;
+  for (s = 0; s < NSTEPS; s++) {
+    for (i = 0; i < N; i++)
+      hits[i] = 0;
+    #pragma omp parallel num_threads(NTHREADS)
+    {
+      int gtid = __kmpc_global_thread_num(lp);
+      int tid = omp_get_thread_num();
+      int lb, ub, st, last, j, lasts = 0;
+      __kmpc_dispatch_init_4(lp, gtid, sched, 0, N - 1, 1, chunk);
+      while (__kmpc_dispatch_next_4(lp, gtid, &last, &lb, &ub, &st)) {
+        if (st != 1 || lb < 0 || ub >= N || lb > ub) {
+          #pragma omp atomic
+          errors++;
+          break;
+        }
+        if (last)
+          lasts++;
+        owner[s % 2][lb / CHUNK] = tid;
+        for (j = lb; j <= ub; j++) {
+          #pragma omp atomic
+          hits[j]++;
+        }
+      }
+      if (lasts > 1) {
+        #pragma omp atomic
+        errors++;
+      }
+    }
+    for (i = 0; i < N; i++) {
+      if (hits[i] != 1) {
+        fprintf(stderr, "step %d: iteration %d ran %d times\n", s, i, hits[i]);
+        errors++;
+        break;
+      }
+    }
+    if (s > 0 && chunk == CHUNK) {
+      for (i = 0; i < NCHUNKS; i++)
+        if (owner[s % 2][i] == owner[(s - 1) % 2][i])
+          (*kept)++;
+    }
+  }
+  return errors == 0;
+}
+
+int main(int argc, char **argv)
+{
+  int i, kept;
+  int num_failed = 0;
+
+  for (i = 0; i < REPETITIONS; i++) {
+    if (!test_kmp_sch_sticky(&loc, kmp_sch_sticky_dynamic_chunked, CHUNK,
+                             &kept)) {
+      num_failed++;
+    }
+    // With a processor per thread, nearly every chunk should stay with its
+    // thread; oversubscribed threads run whatever they find.
+    if (omp_get_num_procs() >= NTHREADS &&
+        kept < (NSTEPS - 1) * NCHUNKS / 2) {
+      fprintf(stderr, "only %d of %d chunks stayed with their thread\n", kept,
+              (NSTEPS - 1) * NCHUNKS);
+      num_failed++;
+    }
+    if (argc > 1)
+      printf("%d of %d chunks stayed with their thread\n", kept,
+             (NSTEPS - 1) * NCHUNKS);
+    // OMP_SCHEDULE=sticky goes through schedule(runtime)
+    if (!test_kmp_sch_sticky(&loc_rt, kmp_sch_runtime, 0, &kept)) {
+      num_failed++;
+    }
+  }
+  return num_failed;
+}